@@ -5,13 +5,33 @@
 # Add inputs and outputs from these tool invocations to the build variables 
 C_SRCS += \
 ../source/adc.c \
+../source/arena.c \
 ../source/autocorrelate.c \
+../source/bench.c \
+../source/boot.c \
+../source/cents.c \
+../source/clocks.c \
+../source/command.c \
 ../source/dac.c \
+../source/dlog.c \
 ../source/dma.c \
+../source/event.c \
+../source/frame.c \
+../source/gate.c \
+../source/idle.c \
+../source/instr.c \
 ../source/main.c \
 ../source/mtb.c \
+../source/note.c \
+../source/note_table.c \
+../source/pipeline.c \
+../source/ram.c \
 ../source/semihost_hardfault.c \
+../source/spsc.c \
+../source/store.c \
+../source/stream.c \
 ../source/systick.c \
+../source/task.c \
 ../source/test_sine.c \
 ../source/tone.c \
 ../source/tpm.c 
@@ -21,26 +41,66 @@ O_SRCS += \
 
 C_DEPS += \
 ./source/adc.d \
+./source/arena.d \
 ./source/autocorrelate.d \
+./source/bench.d \
+./source/boot.d \
+./source/cents.d \
+./source/clocks.d \
+./source/command.d \
 ./source/dac.d \
+./source/dlog.d \
 ./source/dma.d \
+./source/event.d \
+./source/frame.d \
+./source/gate.d \
+./source/idle.d \
+./source/instr.d \
 ./source/main.d \
 ./source/mtb.d \
+./source/note.d \
+./source/note_table.d \
+./source/pipeline.d \
+./source/ram.d \
 ./source/semihost_hardfault.d \
+./source/spsc.d \
+./source/store.d \
+./source/stream.d \
 ./source/systick.d \
+./source/task.d \
 ./source/test_sine.d \
 ./source/tone.d \
 ./source/tpm.d 
 
 OBJS += \
 ./source/adc.o \
+./source/arena.o \
 ./source/autocorrelate.o \
+./source/bench.o \
+./source/boot.o \
+./source/cents.o \
+./source/clocks.o \
+./source/command.o \
 ./source/dac.o \
+./source/dlog.o \
 ./source/dma.o \
+./source/event.o \
+./source/frame.o \
+./source/gate.o \
+./source/idle.o \
+./source/instr.o \
 ./source/main.o \
 ./source/mtb.o \
+./source/note.o \
+./source/note_table.o \
+./source/pipeline.o \
+./source/ram.o \
 ./source/semihost_hardfault.o \
+./source/spsc.o \
+./source/store.o \
+./source/stream.o \
 ./source/systick.o \
+./source/task.o \
 ./source/test_sine.o \
 ./source/tone.o \
 ./source/tpm.o 
@@ -50,7 +110,7 @@ OBJS += \
 source/%.o: ../source/%.c source/subdir.mk
 	@echo 'Building file: $<'
 	@echo 'Invoking: MCU C Compiler'
-	arm-none-eabi-gcc -D__REDLIB__ -DCPU_MKL25Z128VLK4 -DCPU_MKL25Z128VLK4_cm0plus -DFSL_RTOS_BM -DSDK_OS_BAREMETAL -DSDK_DEBUGCONSOLE=0 -DPRINTF_FLOAT_ENABLE=1 -DSDK_DEBUGCONSOLE_UART -D__MCUXPRESSO -D__USE_CMSIS -DDEBUG -I"C:\Users\dayton.flores\Documents\MCUXpressoIDE_11.6.0_8187\workspace\GettingInTune\board" -I"C:\Users\dayton.flores\Documents\MCUXpressoIDE_11.6.0_8187\workspace\GettingInTune\source" -I"C:\Users\dayton.flores\Documents\MCUXpressoIDE_11.6.0_8187\workspace\GettingInTune" -I"C:\Users\dayton.flores\Documents\MCUXpressoIDE_11.6.0_8187\workspace\GettingInTune\drivers" -I"C:\Users\dayton.flores\Documents\MCUXpressoIDE_11.6.0_8187\workspace\GettingInTune\CMSIS" -I"C:\Users\dayton.flores\Documents\MCUXpressoIDE_11.6.0_8187\workspace\GettingInTune\utilities" -I"C:\Users\dayton.flores\Documents\MCUXpressoIDE_11.6.0_8187\workspace\GettingInTune\startup" -O0 -fno-common -g3 -Wall -c -fmessage-length=0 -fno-builtin -ffunction-sections -fdata-sections -fmerge-constants -fmacro-prefix-map="$(<D)/"= -mcpu=cortex-m0plus -mthumb -D__REDLIB__ -fstack-usage -specs=redlib.specs -MMD -MP -MF"$(@:%.o=%.d)" -MT"$(@:%.o=%.o)" -MT"$(@:%.o=%.d)" -o "$@" "$<"
+	arm-none-eabi-gcc -D__REDLIB__ -DCPU_MKL25Z128VLK4 -DCPU_MKL25Z128VLK4_cm0plus -DFSL_RTOS_BM -DSDK_OS_BAREMETAL -DSDK_DEBUGCONSOLE=1 -DPRINTF_FLOAT_ENABLE=1 -DPRINTF_ADVANCED_ENABLE=1 -DSDK_DEBUGCONSOLE_UART -D__MCUXPRESSO -D__USE_CMSIS -DDEBUG -I"C:\Users\dayton.flores\Documents\MCUXpressoIDE_11.6.0_8187\workspace\GettingInTune\board" -I"C:\Users\dayton.flores\Documents\MCUXpressoIDE_11.6.0_8187\workspace\GettingInTune\source" -I"C:\Users\dayton.flores\Documents\MCUXpressoIDE_11.6.0_8187\workspace\GettingInTune" -I"C:\Users\dayton.flores\Documents\MCUXpressoIDE_11.6.0_8187\workspace\GettingInTune\drivers" -I"C:\Users\dayton.flores\Documents\MCUXpressoIDE_11.6.0_8187\workspace\GettingInTune\CMSIS" -I"C:\Users\dayton.flores\Documents\MCUXpressoIDE_11.6.0_8187\workspace\GettingInTune\utilities" -I"C:\Users\dayton.flores\Documents\MCUXpressoIDE_11.6.0_8187\workspace\GettingInTune\startup" -O0 -fno-common -g3 -Wall -c -fmessage-length=0 -fno-builtin -ffunction-sections -fdata-sections -fmerge-constants -fmacro-prefix-map="$(<D)/"= -mcpu=cortex-m0plus -mthumb -D__REDLIB__ -fstack-usage -specs=redlib.specs -MMD -MP -MF"$(@:%.o=%.d)" -MT"$(@:%.o=%.o)" -MT"$(@:%.o=%.d)" -o "$@" "$<"
 	@echo 'Finished building: $<'
 	@echo ' '
 
@@ -58,7 +118,7 @@ source/%.o: ../source/%.c source/subdir.mk
 clean: clean-source
 
 clean-source:
-	-$(RM) ./source/adc.d ./source/adc.o ./source/autocorrelate.d ./source/autocorrelate.o ./source/dac.d ./source/dac.o ./source/dma.d ./source/dma.o ./source/main.d ./source/main.o ./source/mtb.d ./source/mtb.o ./source/semihost_hardfault.d ./source/semihost_hardfault.o ./source/systick.d ./source/systick.o ./source/test_sine.d ./source/test_sine.o ./source/tone.d ./source/tone.o ./source/tpm.d ./source/tpm.o
+	-$(RM) ./source/adc.d ./source/adc.o ./source/arena.d ./source/arena.o ./source/autocorrelate.d ./source/autocorrelate.o ./source/bench.d ./source/bench.o ./source/boot.d ./source/boot.o ./source/cents.d ./source/cents.o ./source/clocks.d ./source/clocks.o ./source/command.d ./source/command.o ./source/dac.d ./source/dac.o ./source/dlog.d ./source/dlog.o ./source/dma.d ./source/dma.o ./source/event.d ./source/event.o ./source/frame.d ./source/frame.o ./source/gate.d ./source/gate.o ./source/idle.d ./source/idle.o ./source/instr.d ./source/instr.o ./source/main.d ./source/main.o ./source/mtb.d ./source/mtb.o ./source/note.d ./source/note.o ./source/note_table.d ./source/note_table.o ./source/pipeline.d ./source/pipeline.o ./source/ram.d ./source/ram.o ./source/semihost_hardfault.d ./source/semihost_hardfault.o ./source/spsc.d ./source/spsc.o ./source/store.d ./source/store.o ./source/stream.d ./source/stream.o ./source/systick.d ./source/systick.o ./source/task.d ./source/task.o ./source/test_sine.d ./source/test_sine.o ./source/tone.d ./source/tone.o ./source/tpm.d ./source/tpm.o
 
 .PHONY: clean-source
 
@@ -0,0 +1,110 @@
+/**
+ * \file    board_host.c
+ * \author	Dayton Flores (dafl2542@colorado.edu)
+ * \date	10/19/2026
+ * \brief   Host replacements for the board bring-up code
+ * \detail	The board sources program MCG, OSC and LPSCI and spin on their status bits, which the
+ * 			simulator does not model. On the host, clocks are whatever sim_kl25z.h says
+ * 			and the console is stdout. With HOST_UART_CONSOLE, stdout goes through the SDK
+ * 			debug console to the simulated UART0 instead, as printf does on the board
+ */
+
+#define _GNU_SOURCE
+#include <poll.h>
+#include <stdio.h>
+#include <unistd.h>
+#include "board.h"
+#include "fsl_debug_console.h"
+#include "clock_config.h"
+#include "peripherals.h"
+#include "pin_mux.h"
+
+/**
+ * User-defined libraries
+ */
+#include "sim_kl25z.h"
+
+/**
+ * \var		SystemCoreClock
+ * \brief	Normally defined in CMSIS/system_MKL25Z4.c and updated by BOARD_BootClockRUN
+ */
+uint32_t SystemCoreClock = SIM_CORE_CLOCK_HZ;
+
+void BOARD_InitBootPins(void)
+{
+}
+
+void BOARD_InitPins(void)
+{
+}
+
+void BOARD_InitBootClocks(void)
+{
+	BOARD_BootClockRUN();
+}
+
+void BOARD_BootClockRUN(void)
+{
+	SystemCoreClock = SIM_CORE_CLOCK_HZ;
+}
+
+void BOARD_InitBootPeripherals(void)
+{
+}
+
+#if defined(HOST_UART_CONSOLE)
+
+/**
+ * \fn		int _write
+ * \brief	Defined in utilities/fsl_debug_console.c, the newlib counterpart of __sys_write
+ */
+int _write(int handle, char *buffer, int size);
+
+/**
+ * \fn		ssize_t console_write
+ * \param	void *cookie
+ * \param	const char *buffer
+ * \param	size_t size
+ * \return	Bytes taken
+ * \brief   stdout's write function: hands glibc's buffer to the debug console
+ */
+static ssize_t console_write(void *cookie, const char *buffer, size_t size)
+{
+	(void)cookie;
+	return (_write(1, (char *)buffer, (int)size) < 0) ? -1 : (ssize_t)size;
+}
+
+#else
+
+/**
+ * \fn		status_t DbgConsole_TryGetchar
+ * \param	char *ch
+ * \return	kStatus_Success if ch holds the next character of stdin, kStatus_Fail otherwise
+ * \brief   Stands in for the debug console's receiver, which is only built with
+ * 			HOST_UART_CONSOLE. Never waits
+ */
+status_t DbgConsole_TryGetchar(char *ch)
+{
+	struct pollfd pfd = { .fd = STDIN_FILENO, .events = POLLIN };
+
+	if((poll(&pfd, 1, 0) <= 0) || !(pfd.revents & POLLIN) || (read(STDIN_FILENO, ch, 1) != 1)){
+		return kStatus_Fail;
+	}
+	return kStatus_Success;
+}
+
+#endif /* HOST_UART_CONSOLE */
+
+void BOARD_InitDebugConsole(void)
+{
+#if defined(HOST_UART_CONSOLE)
+	cookie_io_functions_t io = { .write = console_write };
+
+	/**
+	 * UART0 is clocked from MCGPLLCLK/2, which the simulator runs at the core clock
+	 */
+	DbgConsole_Init(BOARD_DEBUG_UART_BASEADDR, BOARD_DEBUG_UART_BAUDRATE, BOARD_DEBUG_UART_TYPE, SIM_CORE_CLOCK_HZ);
+	stdout = fopencookie(NULL, "w", io);
+	setvbuf(stdout, NULL, _IOLBF, 0);
+#endif /* HOST_UART_CONSOLE */
+}
@@ -0,0 +1,210 @@
+/**
+ * \file    cents_bench.c
+ * \author	Dayton Flores (dafl2542@colorado.edu)
+ * \date	10/19/2026
+ * \brief   Host accuracy and speed benchmark of the fixed-point cents conversion
+ * \detail
+ * 		Runs source/cents.c against double precision log2. make cents-bench builds and
+ * 		runs it.
+ *
+ * 		Accuracy: cents_log2 over a sweep of its whole input range, then cents_note over
+ * 		every Q16 frequency step from half a semitone below A0 to half a semitone above
+ * 		C8, in steps of a hundredth of a cent. The note must match the nearest one in
+ * 		double precision (a frequency right on the edge between two may go either way)
+ * 		and the offset must be within CENTS_BENCH_MAX_ERROR.
+ *
+ * 		Speed: host CPU time per call, for cents_note and for the same conversion in
+ * 		double. They rank the two, they are not Cortex-M0+ cycles; the loopback
+ * 		benchmark (make bench) counts those on the target.
+ */
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#if defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+
+#include "cents.h"
+#include "note.h"
+
+/**
+ * \def		CENTS_BENCH_MAX_ERROR
+ * \brief	Most a reported offset may be off, in cents: the rounding to tenths, plus
+ * 			what the table and its interpolation lose
+ */
+#define CENTS_BENCH_MAX_ERROR\
+	(0.1)
+
+/**
+ * \def		CENTS_BENCH_LOG2_ERROR
+ * \brief	Most cents_log2 may be off, in cents (1200 to the octave)
+ */
+#define CENTS_BENCH_LOG2_ERROR\
+	(0.05)
+
+/**
+ * \def		CENTS_BENCH_EDGE
+ * \brief	How near, in cents, a frequency may be to the edge between two notes for
+ * 			either note to count as right
+ */
+#define CENTS_BENCH_EDGE\
+	(0.05)
+
+/**
+ * \def		BENCH_ITERATIONS
+ * \brief	Calls timed per conversion
+ */
+#define BENCH_ITERATIONS\
+	(2000000)
+
+static uint64_t bench_ns(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static uint64_t bench_tsc(void)
+{
+#if defined(__x86_64__)
+	return __rdtsc();
+#else
+	return 0;
+#endif
+}
+
+/**
+ * \fn		double reference_cents
+ * \param	uint32_t hz_q16
+ * \param	int *midi Where to put the nearest note
+ * \return	Cents from the nearest note, in double
+ */
+static double reference_cents(uint32_t hz_q16, int *midi)
+{
+	double semitones = 12.0 * log2(hz_q16 / 65536.0 / NOTE_A4_HZ);
+
+	*midi = NOTE_MIDI_A4 + (int)floor(semitones + 0.5);
+	return (semitones - (*midi - NOTE_MIDI_A4)) * 100.0;
+}
+
+/**
+ * \fn		int bench_log2
+ * \param	N/A
+ * \return	0 if cents_log2 is within CENTS_BENCH_LOG2_ERROR of log2, 1 otherwise
+ */
+static int bench_log2(void)
+{
+	double error_max = 0.0;
+	uint32_t worst = 0;
+
+	for(uint64_t x = 1; x <= UINT32_MAX; x += 1 + x / 4096){
+		double error = fabs(cents_log2((uint32_t)x) / 65536.0 - log2((double)x));
+
+		if(error > error_max){
+			error_max = error;
+			worst = (uint32_t)x;
+		}
+	}
+
+	printf("cents_log2: max error = %.6f octaves (%.4f cents) at %u: %s\n",
+			error_max,
+			error_max * 1200.0,
+			worst,
+			(error_max * 1200.0 <= CENTS_BENCH_LOG2_ERROR) ? "passed" : "FAILED");
+	return (error_max * 1200.0 <= CENTS_BENCH_LOG2_ERROR) ? 0 : 1;
+}
+
+/**
+ * \fn		int bench_notes
+ * \param	N/A
+ * \return	0 if every note and offset is right, 1 otherwise
+ */
+static int bench_notes(void)
+{
+	uint32_t first = note_table[0].low_q16;
+	uint32_t last = note_table[NOTE_COUNT - 1].high_q16 - 1;
+	double error_max = 0.0;
+	double error_sum = 0.0;
+	uint32_t worst = 0;
+	uint32_t checked = 0;
+	uint32_t wrong = 0;
+
+	/**
+	 * A hundredth of a cent is a ratio of 2^(1 / 120000)
+	 */
+	for(double f = first; f <= last; f *= 1.0000057762){
+		uint32_t hz_q16 = (uint32_t)f;
+		int32_t tenths;
+		const note_t *note = cents_note(hz_q16, &tenths);
+		int midi;
+		double cents = reference_cents(hz_q16, &midi);
+		double error;
+
+		if((note == NULL) || (note->midi != midi)){
+			if(fabs(fabs(cents) - 50.0) > CENTS_BENCH_EDGE){
+				if(wrong++ < 5){
+					printf("  %.4f Hz: %s, expected MIDI %d\n",
+							hz_q16 / 65536.0, note ? note->name : "no note", midi);
+				}
+			}
+			continue;
+		}
+		error = fabs(tenths / 10.0 - cents);
+		error_sum += error;
+		checked++;
+		if(error > error_max){
+			error_max = error;
+			worst = hz_q16;
+		}
+	}
+
+	printf("cents_note: %u frequencies, mean error = %.4f cents, max error = %.4f cents at %.4f Hz, wrong notes = %u: %s\n",
+			checked,
+			error_sum / checked,
+			error_max,
+			worst / 65536.0,
+			wrong,
+			((error_max <= CENTS_BENCH_MAX_ERROR) && !wrong) ? "passed" : "FAILED");
+	return ((error_max <= CENTS_BENCH_MAX_ERROR) && !wrong) ? 0 : 1;
+}
+
+int main(void)
+{
+	volatile uint32_t sink = 0;
+	uint32_t hz_q16 = note_table[0].hz_q16;
+	uint32_t step = (note_table[NOTE_COUNT - 1].hz_q16 - hz_q16) / BENCH_ITERATIONS;
+	int failures = 0;
+	uint64_t t0;
+	uint64_t c0;
+
+	failures += bench_log2();
+	failures += bench_notes();
+
+#define BENCH(label, expr)\
+	do{\
+		t0 = bench_ns();\
+		c0 = bench_tsc();\
+		for(uint32_t i = 0; i < BENCH_ITERATIONS; i++){\
+			uint32_t x = hz_q16 + i * step;\
+			sink += (uint32_t)(expr);\
+		}\
+		printf("  %-8s %7.1f ns/call, %7.0f TSC cycles/call\n",\
+				label,\
+				(double)(bench_ns() - t0) / BENCH_ITERATIONS,\
+				(double)(bench_tsc() - c0) / BENCH_ITERATIONS);\
+	}while(0)
+
+	{
+		int32_t tenths;
+		int midi;
+
+		BENCH("fixed", cents_note(x, &tenths)->midi + tenths);
+		BENCH("double", reference_cents(x, &midi) * 10.0 + midi);
+	}
+	(void)sink;
+
+	return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,395 @@
+/**
+ * \file    dlog_decode.c
+ * \author	Dayton Flores (dafl2542@colorado.edu)
+ * \date	10/19/2026
+ * \brief   Host decoder for the firmware's deferred binary log (source/dlog.h)
+ * \detail
+ * 		Reads the console stream from a file or stdin, passes text through and turns
+ * 		every DLOG record back into the line it stands for. Format strings and %s
+ * 		arguments are read from the ELF the stream came from, at the addresses in the
+ * 		records: Debug/GettingInTune.axf for the board, build/GettingInTune_host for
+ * 		the simulator.
+ *
+ * 			dlog_decode [-r timestamp_hz] [-n] elf [capture]
+ *
+ * 		-r sets the timestamp rate (default SYSTICK_TIMESTAMP_HZ), -n drops the
+ * 		timestamps. Records that fail their checksum are passed through as text.
+ */
+
+#include <elf.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/**
+ * User-defined libraries
+ */
+#include "dlog.h"
+#include "systick.h"
+
+/**
+ * \def		PUSHBACK_SIZE
+ * \brief	Bytes that can be handed back to the input when a record turns out to be text
+ */
+#define PUSHBACK_SIZE\
+	(DLOG_MAX_RECORD_SIZE)
+
+/**
+ * \typedef	typedef struct section_s section_t
+ * \brief   An allocated section of the ELF image
+ */
+typedef struct section_s section_t;
+
+/**
+ * \struct	struct section_s
+ * \brief   An allocated section of the ELF image
+ */
+struct section_s{
+	uint64_t addr;
+	uint64_t size;
+	uint64_t offset;
+};
+
+/**
+ * The ELF image and its allocated PROGBITS sections
+ */
+static uint8_t *elf;
+static size_t elf_size;
+static section_t *sections;
+static size_t section_count;
+
+/**
+ * Input stream with a pushback stack
+ */
+static FILE *in;
+static uint8_t pushback[PUSHBACK_SIZE];
+static size_t pushback_count;
+
+/**
+ * \fn		bool load_elf
+ * \param	const char *path
+ * \return	true if path is a 32- or 64-bit little-endian ELF, false otherwise
+ * \brief   Reads the file and indexes the sections that hold initialized target memory
+ */
+static bool load_elf(const char *path)
+{
+	FILE *f = fopen(path, "rb");
+	long size;
+	bool is64;
+	uint64_t shoff;
+	uint32_t shnum;
+	uint32_t shentsize;
+
+	if(!f || (fseek(f, 0, SEEK_END) != 0) || ((size = ftell(f)) < (long)sizeof(Elf32_Ehdr))){
+		return false;
+	}
+	rewind(f);
+	elf_size = (size_t)size;
+	elf = malloc(elf_size);
+	if(!elf || (fread(elf, 1, elf_size, f) != elf_size)){
+		return false;
+	}
+	fclose(f);
+
+	if((memcmp(elf, ELFMAG, SELFMAG) != 0) || (elf[EI_DATA] != ELFDATA2LSB)){
+		return false;
+	}
+	is64 = (elf[EI_CLASS] == ELFCLASS64);
+	if(is64){
+		const Elf64_Ehdr *eh = (const Elf64_Ehdr *)elf;
+		shoff = eh->e_shoff;
+		shnum = eh->e_shnum;
+		shentsize = eh->e_shentsize;
+	}
+	else{
+		const Elf32_Ehdr *eh = (const Elf32_Ehdr *)elf;
+		shoff = eh->e_shoff;
+		shnum = eh->e_shnum;
+		shentsize = eh->e_shentsize;
+	}
+	if(shoff + (uint64_t)shnum * shentsize > elf_size){
+		return false;
+	}
+
+	sections = calloc(shnum, sizeof(section_t));
+	for(uint32_t i = 0; i < shnum; i++){
+		const uint8_t *sh = elf + shoff + (uint64_t)i * shentsize;
+		uint32_t type;
+		uint64_t flags;
+		section_t s;
+
+		if(is64){
+			const Elf64_Shdr *h = (const Elf64_Shdr *)sh;
+			type = h->sh_type;
+			flags = h->sh_flags;
+			s = (section_t){ h->sh_addr, h->sh_size, h->sh_offset };
+		}
+		else{
+			const Elf32_Shdr *h = (const Elf32_Shdr *)sh;
+			type = h->sh_type;
+			flags = h->sh_flags;
+			s = (section_t){ h->sh_addr, h->sh_size, h->sh_offset };
+		}
+		if((type == SHT_PROGBITS) && (flags & SHF_ALLOC) && (s.offset + s.size <= elf_size)){
+			sections[section_count++] = s;
+		}
+	}
+	return true;
+}
+
+/**
+ * \fn		const char *elf_string
+ * \param	uint32_t addr Target address
+ * \return	The NUL-terminated string at addr in the image, or NULL if there is none
+ */
+static const char *elf_string(uint32_t addr)
+{
+	for(size_t i = 0; i < section_count; i++){
+		const section_t *s = &sections[i];
+
+		if((addr >= s->addr) && (addr - s->addr < s->size)){
+			const char *p = (const char *)elf + s->offset + (addr - s->addr);
+
+			return memchr(p, '\0', s->size - (addr - s->addr)) ? p : NULL;
+		}
+	}
+	return NULL;
+}
+
+/**
+ * \fn		int get_byte
+ * \param	N/A
+ * \return	Next input byte, or EOF
+ */
+static int get_byte(void)
+{
+	if(pushback_count){
+		return pushback[--pushback_count];
+	}
+	return fgetc(in);
+}
+
+/**
+ * \fn		void unget_bytes
+ * \param	const uint8_t *bytes
+ * \param	size_t n
+ * \return	N/A
+ * \brief   Returns bytes to the input so they are read again, in order
+ */
+static void unget_bytes(const uint8_t *bytes, size_t n)
+{
+	while(n--){
+		pushback[pushback_count++] = bytes[n];
+	}
+}
+
+/**
+ * \fn		uint32_t get32
+ * \param	const uint8_t *p
+ * \return	Little-endian word at p
+ */
+static uint32_t get32(const uint8_t *p)
+{
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/**
+ * \fn		void print_record
+ * \param	const char *fmt
+ * \param	const uint32_t *args
+ * \param	uint32_t nargs
+ * \return	N/A
+ * \brief   printf for a record: each conversion takes one 32-bit argument, reinterpreted
+ * 			by the conversion as signed, unsigned, float bits or a string address
+ */
+static void print_record(const char *fmt, const uint32_t *args, uint32_t nargs)
+{
+	char spec[32];
+	uint32_t arg = 0;
+
+	while(*fmt){
+		const char *start = fmt;
+		size_t len = 0;
+		char conv;
+		uint32_t v;
+
+		if(*fmt != '%'){
+			putchar(*fmt++);
+			continue;
+		}
+		if(fmt[1] == '%'){
+			putchar('%');
+			fmt += 2;
+			continue;
+		}
+
+		/**
+		 * Keep flags, width and precision, drop length modifiers: every argument is 32 bits
+		 */
+		spec[len++] = *fmt++;
+		while(*fmt && !strchr("diouxXcsfFeEgGaAp", *fmt)){
+			if(!strchr("hlLqjzt", *fmt) && (len < sizeof(spec) - 3)){
+				spec[len++] = *fmt;
+			}
+			fmt++;
+		}
+		if(!*fmt){
+			fputs(start, stdout);
+			return;
+		}
+		conv = *fmt++;
+		v = (arg < nargs) ? args[arg] : 0;
+		if(arg++ >= nargs){
+			printf("<missing>");
+			continue;
+		}
+
+		switch(conv){
+		case 'd':
+		case 'i':
+			spec[len++] = conv;
+			spec[len] = '\0';
+			printf(spec, (int32_t)v);
+			break;
+		case 's':
+			spec[len++] = 's';
+			spec[len] = '\0';
+			if(elf_string(v)){
+				printf(spec, elf_string(v));
+			}
+			else{
+				printf("<0x%08x>", v);
+			}
+			break;
+		case 'f':
+		case 'F':
+		case 'e':
+		case 'E':
+		case 'g':
+		case 'G':
+		case 'a':
+		case 'A':
+		{
+			union{
+				uint32_t u;
+				float f;
+			} bits = { .u = v };
+
+			spec[len++] = conv;
+			spec[len] = '\0';
+			printf(spec, (double)bits.f);
+			break;
+		}
+		case 'p':
+			printf("0x%08x", v);
+			break;
+		default:
+			spec[len++] = conv;
+			spec[len] = '\0';
+			printf(spec, v);
+			break;
+		}
+	}
+}
+
+int main(int argc, char **argv)
+{
+	double rate = SYSTICK_TIMESTAMP_HZ;
+	bool timestamps = true;
+	uint64_t epoch = 0;
+	uint32_t last = 0;
+	uint8_t record[DLOG_MAX_RECORD_SIZE];
+	uint32_t args[DLOG_MAX_ARGS];
+	int opt;
+	int c;
+
+	while((opt = getopt(argc, argv, "r:n")) != -1){
+		switch(opt){
+		case 'r':
+			rate = atof(optarg);
+			break;
+		case 'n':
+			timestamps = false;
+			break;
+		default:
+			fprintf(stderr, "usage: %s [-r timestamp_hz] [-n] elf [capture]\n", argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
+	if((optind >= argc) || (rate <= 0)){
+		fprintf(stderr, "usage: %s [-r timestamp_hz] [-n] elf [capture]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+	if(!load_elf(argv[optind])){
+		fprintf(stderr, "%s: cannot read ELF file %s\n", argv[0], argv[optind]);
+		return EXIT_FAILURE;
+	}
+	in = (optind + 1 < argc) ? fopen(argv[optind + 1], "rb") : stdin;
+	if(!in){
+		fprintf(stderr, "%s: cannot open %s\n", argv[0], argv[optind + 1]);
+		return EXIT_FAILURE;
+	}
+
+	while((c = get_byte()) != EOF){
+		size_t n = 1;
+		size_t size;
+		uint8_t sum = 0;
+		const char *fmt;
+		uint32_t ts;
+
+		if(c != DLOG_MARKER){
+			putchar(c);
+			if(c == '\n'){
+				fflush(stdout);
+			}
+			continue;
+		}
+
+		/**
+		 * Collect a whole record. Anything that doesn't check out was text after all:
+		 * print the marker and read the rest again
+		 */
+		record[0] = (uint8_t)c;
+		size = DLOG_HEADER_SIZE + 1;
+		while(n < size){
+			if((c = get_byte()) == EOF){
+				break;
+			}
+			record[n++] = (uint8_t)c;
+			if((n == 2) && (record[1] <= DLOG_MAX_ARGS)){
+				size += 4 * record[1];
+			}
+			if((n == 2) && (record[1] > DLOG_MAX_ARGS)){
+				break;
+			}
+		}
+		for(size_t i = 1; i < n; i++){
+			sum += record[i];
+		}
+		fmt = (n == size) ? elf_string(get32(&record[2])) : NULL;
+		if((n != size) || (sum != 0) || !fmt){
+			putchar(record[0]);
+			unget_bytes(&record[1], n - 1);
+			continue;
+		}
+
+		ts = get32(&record[6]);
+		if(ts < last){
+			epoch += 1ull << 32;
+		}
+		last = ts;
+		for(uint32_t i = 0; i < record[1]; i++){
+			args[i] = get32(&record[DLOG_HEADER_SIZE + 4 * i]);
+		}
+
+		if(timestamps){
+			printf("[%12.6f] ", (double)(epoch + ts) / rate);
+		}
+		print_record(fmt, args, record[1]);
+		fflush(stdout);
+	}
+	return EXIT_SUCCESS;
+}
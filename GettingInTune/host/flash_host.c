@@ -0,0 +1,186 @@
+/**
+ * \file    flash_host.c
+ * \author	Dayton Flores (dafl2542@colorado.edu)
+ * \date	10/19/2026
+ * \brief   Host implementation of the fsl_flash.h calls the firmware makes, see flash_host.h
+ */
+
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "flash_host.h"
+
+/**
+ * \def		FLASH_HOST_SECTOR_SIZE
+ * \brief	Erase unit
+ */
+#define FLASH_HOST_SECTOR_SIZE\
+	(FSL_FEATURE_FLASH_PFLASH_BLOCK_SECTOR_SIZE)
+
+uint32_t flash_host_erases[FLASH_HOST_SIZE / FLASH_HOST_SECTOR_SIZE];
+uint32_t flash_host_programs = 0;
+int32_t flash_host_power = -1;
+
+/**
+ * \var		flash_view
+ * \brief	Writable view of the simulated flash. The firmware's view at FLASH_HOST_BASE
+ * 			is read-only
+ */
+static uint8_t *flash_view = NULL;
+
+/**
+ * \fn		bool flash_host_powered
+ * \param	N/A
+ * \return	true if one more word (or erase) can be written
+ * \brief   Uses up one of flash_host_power
+ */
+static bool flash_host_powered(void)
+{
+	if(flash_host_power == 0){
+		return false;
+	}
+	if(flash_host_power > 0){
+		flash_host_power--;
+	}
+	return true;
+}
+
+/**
+ * \fn		void flash_host_init
+ * \param	N/A
+ * \return	N/A
+ * \brief   Maps the simulated flash before the firmware's main() runs
+ */
+__attribute__((constructor)) static void flash_host_init(void)
+{
+	const char *path = getenv("SIM_FLASH");
+	struct stat st;
+	bool fresh;
+	void *p;
+	int fd;
+
+	if(path != NULL){
+		fd = open(path, O_RDWR | O_CREAT, 0644);
+	}
+	else{
+		fd = memfd_create("kl25z-flash", 0);
+	}
+	if((fd < 0) || (fstat(fd, &st) != 0)){
+		fprintf(stderr, "flash: %s: %s\r\n", path ? path : "memfd", strerror(errno));
+		exit(EXIT_FAILURE);
+	}
+	fresh = (st.st_size != FLASH_HOST_SIZE);
+	if(fresh && (ftruncate(fd, FLASH_HOST_SIZE) != 0)){
+		fprintf(stderr, "flash: %s: %s\r\n", path ? path : "memfd", strerror(errno));
+		exit(EXIT_FAILURE);
+	}
+
+	p = mmap((void *)(uintptr_t)FLASH_HOST_BASE, FLASH_HOST_SIZE, PROT_READ,
+			MAP_SHARED | MAP_FIXED_NOREPLACE, fd, 0);
+	if((p == MAP_FAILED) || ((uintptr_t)p != FLASH_HOST_BASE)){
+		fprintf(stderr, "flash: cannot map flash at 0x%05x: %s\r\n",
+				(unsigned)FLASH_HOST_BASE, strerror(errno));
+		exit(EXIT_FAILURE);
+	}
+	flash_view = mmap(NULL, FLASH_HOST_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if(flash_view == MAP_FAILED){
+		fprintf(stderr, "flash: cannot map simulator view: %s\r\n", strerror(errno));
+		exit(EXIT_FAILURE);
+	}
+	close(fd);
+
+	if(fresh){
+		memset(flash_view, 0xFF, FLASH_HOST_SIZE);
+	}
+}
+
+/**
+ * \fn		bool flash_host_range
+ * \param	uint32_t start
+ * \param	uint32_t bytes
+ * \return	true if [start, start + bytes) is all simulated flash
+ */
+static bool flash_host_range(uint32_t start, uint32_t bytes)
+{
+	return (start >= FLASH_HOST_BASE) && (bytes <= FLASH_HOST_SIZE) &&
+			(start - FLASH_HOST_BASE <= FLASH_HOST_SIZE - bytes);
+}
+
+status_t FLASH_Init(flash_config_t *config)
+{
+	memset(config, 0, sizeof(*config));
+	config->PFlashBlockBase = 0;
+	config->PFlashTotalSize = FSL_FEATURE_FLASH_PFLASH_BLOCK_COUNT * FSL_FEATURE_FLASH_PFLASH_BLOCK_SIZE;
+	config->PFlashBlockCount = FSL_FEATURE_FLASH_PFLASH_BLOCK_COUNT;
+	config->PFlashSectorSize = FLASH_HOST_SECTOR_SIZE;
+	return kStatus_FLASH_Success;
+}
+
+status_t FLASH_Erase(flash_config_t *config, uint32_t start, uint32_t lengthInBytes, uint32_t key)
+{
+	if(key != kFLASH_ApiEraseKey){
+		return kStatus_FLASH_EraseKeyError;
+	}
+	if((start % FLASH_HOST_SECTOR_SIZE) || (lengthInBytes % FLASH_HOST_SECTOR_SIZE)){
+		return kStatus_FLASH_AlignmentError;
+	}
+	if(!flash_host_range(start, lengthInBytes)){
+		return kStatus_FLASH_AddressError;
+	}
+
+	for(uint32_t addr = start; addr < start + lengthInBytes; addr += FLASH_HOST_SECTOR_SIZE){
+		if(!flash_host_powered()){
+			return kStatus_FLASH_CommandFailure;
+		}
+		memset(&flash_view[addr - FLASH_HOST_BASE], 0xFF, FLASH_HOST_SECTOR_SIZE);
+		flash_host_erases[(addr - FLASH_HOST_BASE) / FLASH_HOST_SECTOR_SIZE]++;
+	}
+	return kStatus_FLASH_Success;
+}
+
+status_t FLASH_Program(flash_config_t *config, uint32_t start, uint32_t *src, uint32_t lengthInBytes)
+{
+	if((start % FSL_FEATURE_FLASH_PFLASH_BLOCK_WRITE_UNIT_SIZE) ||
+			(lengthInBytes % FSL_FEATURE_FLASH_PFLASH_BLOCK_WRITE_UNIT_SIZE)){
+		return kStatus_FLASH_AlignmentError;
+	}
+	if(!flash_host_range(start, lengthInBytes)){
+		return kStatus_FLASH_AddressError;
+	}
+
+	/**
+	 * Programming can only clear bits
+	 */
+	for(uint32_t i = 0; i < lengthInBytes / sizeof(uint32_t); i++){
+		uint32_t *word = (uint32_t *)&flash_view[start - FLASH_HOST_BASE + i * sizeof(uint32_t)];
+
+		if(!flash_host_powered()){
+			return kStatus_FLASH_CommandFailure;
+		}
+		*word &= src[i];
+		flash_host_programs++;
+	}
+	return kStatus_FLASH_Success;
+}
+
+void flash_host_poke(uint32_t addr, uint32_t value)
+{
+	if(flash_host_range(addr, sizeof(uint32_t)) && !(addr % sizeof(uint32_t))){
+		memcpy(&flash_view[addr - FLASH_HOST_BASE], &value, sizeof(value));
+	}
+}
+
+void flash_host_wipe(void)
+{
+	memset(flash_view, 0xFF, FLASH_HOST_SIZE);
+	memset(flash_host_erases, 0, sizeof(flash_host_erases));
+	flash_host_programs = 0;
+	flash_host_power = -1;
+}
@@ -0,0 +1,78 @@
+/**
+ * \file    flash_host.h
+ * \author	Dayton Flores (dafl2542@colorado.edu)
+ * \date	10/19/2026
+ * \brief   Host implementation of the fsl_flash.h calls the firmware makes
+ * \detail
+ * 		Simulates the top FLASH_HOST_SIZE bytes of the KL25Z's program flash, mapped at
+ * 		their real addresses so the firmware reads them like it would on the target.
+ * 		The firmware's mapping is read-only: flash only changes through FLASH_Erase and
+ * 		FLASH_Program, which behave like NOR flash. Erase sets a sector to 0xFF, and
+ * 		programming can only clear bits.
+ *
+ * 		With SIM_FLASH set to a file name, the simulated flash lives in that file and
+ * 		survives between runs. Otherwise it starts erased every run.
+ *
+ * 		The rest of this header is for tests (store_test.c). They can count erases,
+ * 		cut the power partway through a write, and corrupt words behind the firmware's
+ * 		back.
+ */
+
+#ifndef FLASH_HOST_H_
+#define FLASH_HOST_H_
+
+#include <stdint.h>
+#include "fsl_flash.h"
+
+/**
+ * \def		FLASH_HOST_SIZE
+ * \brief	Bytes of simulated flash, at the top of the program flash
+ */
+#define FLASH_HOST_SIZE\
+	(16 * FSL_FEATURE_FLASH_PFLASH_BLOCK_SECTOR_SIZE)
+
+/**
+ * \def		FLASH_HOST_BASE
+ * \brief	Address of the first simulated byte
+ */
+#define FLASH_HOST_BASE\
+	(FSL_FEATURE_FLASH_PFLASH_BLOCK_COUNT * FSL_FEATURE_FLASH_PFLASH_BLOCK_SIZE - FLASH_HOST_SIZE)
+
+/**
+ * \var		flash_host_erases
+ * \brief	Erases of each simulated sector
+ */
+extern uint32_t flash_host_erases[FLASH_HOST_SIZE / FSL_FEATURE_FLASH_PFLASH_BLOCK_SECTOR_SIZE];
+
+/**
+ * \var		flash_host_programs
+ * \brief	Words programmed so far
+ */
+extern uint32_t flash_host_programs;
+
+/**
+ * \var		flash_host_power
+ * \brief	Words that can still be written (a sector erase counts as one) before the
+ * 			power fails, or -1 for no failure. Once it reaches 0 nothing more is written
+ * 			and every call fails, until it is set again
+ */
+extern int32_t flash_host_power;
+
+/**
+ * \fn		void flash_host_poke
+ * \param	uint32_t addr Word aligned, in the simulated flash
+ * \param	uint32_t value
+ * \return	N/A
+ * \brief   Overwrites a word directly, as bit rot or a stray write would
+ */
+void flash_host_poke(uint32_t addr, uint32_t value);
+
+/**
+ * \fn		void flash_host_wipe
+ * \param	N/A
+ * \return	N/A
+ * \brief   Erases everything and zeroes the counters, as a fresh chip
+ */
+void flash_host_wipe(void);
+
+#endif /* FLASH_HOST_H_ */
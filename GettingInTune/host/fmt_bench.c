@@ -0,0 +1,159 @@
+/**
+ * \file    fmt_bench.c
+ * \author	Dayton Flores (dafl2542@colorado.edu)
+ * \date	10/19/2026
+ * \brief   Host benchmark of the debug console's printf formatter profiles
+ * \detail
+ * 		Builds utilities/fsl_debug_console.c into this file, so its static formatter
+ * 		(DbgConsole_PrintfFormattedData) can be driven without a UART, once per
+ * 		PRINTF_PROFILE (make fmt-bench builds and runs all three). Each run checks %q
+ * 		against known strings, then times the telemetry line of main.c formatted with
+ * 		%d, %q and %f, whichever the profile has.
+ *
+ * 		Times are host CPU time: they rank the profiles, they are not Cortex-M0+ cycles,
+ * 		where the soft-float %f path is relatively far slower still.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#if defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+
+#include "fsl_debug_console.c"
+
+/**
+ * \def		BENCH_ITERATIONS
+ * \brief	Calls timed per format
+ */
+#define BENCH_ITERATIONS\
+	(200000)
+
+/**
+ * \def		Q16
+ * \brief	Converts a constant to Q16
+ */
+#define Q16(x)\
+	((int32_t)((x) * 65536.0))
+
+/**
+ * \var		bench_out
+ * \brief	Where the formatter's characters go
+ */
+static char bench_out[256];
+static size_t bench_len;
+
+static int bench_putchar(int c)
+{
+	if(bench_len < sizeof(bench_out) - 1){
+		bench_out[bench_len++] = (char)c;
+	}
+	return c;
+}
+
+/**
+ * \fn		const char *bench_format
+ * \param	const char *fmt
+ * \return	The formatted string
+ * \brief   sprintf through the debug console formatter
+ */
+static const char *bench_format(const char *fmt, ...)
+{
+	va_list ap;
+
+	bench_len = 0;
+	va_start(ap, fmt);
+	DbgConsole_PrintfFormattedData(bench_putchar, fmt, ap);
+	va_end(ap);
+	bench_out[bench_len] = '\0';
+	return bench_out;
+}
+
+static uint64_t bench_ns(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static uint64_t bench_tsc(void)
+{
+#if defined(__x86_64__)
+	return __rdtsc();
+#else
+	return 0;
+#endif
+}
+
+/**
+ * \fn		int check
+ * \param	const char *got
+ * \param	const char *expected
+ * \return	0 if they match, 1 otherwise
+ */
+static int check(const char *got, const char *expected)
+{
+	if(strcmp(got, expected) != 0){
+		printf("  FAIL: got \"%s\", expected \"%s\"\n", got, expected);
+		return 1;
+	}
+	return 0;
+}
+
+int main(void)
+{
+	static const char * const names[] = { "integer", "fixed", "full" };
+	volatile int32_t period = 109;
+	volatile int32_t frequency = 456;
+	volatile int32_t period_q16 = Q16(109.0);
+	volatile int32_t frequency_q16 = Q16(456.8);
+	volatile double period_f = 109.0;
+	volatile double frequency_f = 456.8;
+	uint64_t t0;
+	uint64_t c0;
+	int failures = 0;
+
+	printf("profile %s (PRINTF_PROFILE=%u)\n", names[PRINTF_PROFILE], PRINTF_PROFILE);
+
+#if PRINTF_FIXED_ENABLE
+	failures += check(bench_format("%.4q", 15, 0x4000), "0.5000");
+	failures += check(bench_format("%.1q", 16, -Q16(1.5)), "-1.5");
+	failures += check(bench_format("%.2q", 8, 0x180), "1.50");
+	failures += check(bench_format("%.0q", 1, 3), "2");
+	failures += check(bench_format("%.3q", 16, 0xFFFF), "1.000");
+	failures += check(bench_format("%q", 0, 42), "42.000000");
+	failures += check(bench_format("%8.2q|", 16, Q16(3.25)), "    3.25|");
+	failures += check(bench_format("%.1q Hz", 16, frequency_q16), "456.8 Hz");
+#endif
+	failures += check(bench_format("%d %u %x", 109, 456u, 0xBEEFu), "109 456 beef");
+	printf("  format checks: %s\n", failures ? "FAILED" : "passed");
+
+#define BENCH(label, ...)\
+	do{\
+		t0 = bench_ns();\
+		c0 = bench_tsc();\
+		for(int i = 0; i < BENCH_ITERATIONS; i++){\
+			bench_format(__VA_ARGS__);\
+		}\
+		printf("  %-8s %7.1f ns/call, %7.0f TSC cycles/call: %s",\
+				label,\
+				(double)(bench_ns() - t0) / BENCH_ITERATIONS,\
+				(double)(bench_tsc() - c0) / BENCH_ITERATIONS,\
+				bench_out);\
+	}while(0)
+
+	BENCH("%d", "period = %d samples, frequency = %d Hz\r\n", period, frequency);
+#if PRINTF_FIXED_ENABLE
+	BENCH("%q", "period = %.1q samples, frequency = %.1q Hz\r\n", 16, period_q16, 16, frequency_q16);
+#endif
+#if PRINTF_FLOAT_ENABLE
+	BENCH("%f", "period = %.1f samples, frequency = %.1f Hz\r\n", period_f, frequency_f);
+#endif
+	(void)period_q16;
+	(void)frequency_q16;
+	(void)period_f;
+	(void)frequency_f;
+
+	return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
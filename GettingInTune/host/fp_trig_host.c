@@ -0,0 +1,50 @@
+/**
+ * \file    fp_trig_host.c
+ * \author	Dayton Flores (dafl2542@colorado.edu)
+ * \date	10/19/2026
+ * \brief   Host implementation of fp_trig.h
+ * \detail	The firmware links the prebuilt Cortex-M0+ object source/fp_trig.o, which
+ * 			cannot be linked into a host executable. This implements the same contract
+ * 			(see fp_trig.h) on top of libm, rounded to the nearest scaled integer
+ */
+
+#include <math.h>
+#include "fp_trig.h"
+
+int32_t fp_radians(int degrees)
+{
+	return (int32_t)lround(PI * (double)degrees / 180.0);
+}
+
+int32_t fp_sin(int32_t x)
+{
+	return (int32_t)lround(sin((double)x / TRIG_SCALE_FACTOR) * TRIG_SCALE_FACTOR);
+}
+
+int32_t taylor_fp_sin(int32_t x)
+{
+	return fp_sin(x);
+}
+
+int32_t fp_cos(int32_t x)
+{
+	return (int32_t)lround(cos((double)x / TRIG_SCALE_FACTOR) * TRIG_SCALE_FACTOR);
+}
+
+int32_t fp_asin(int32_t x)
+{
+	return (int32_t)lround(asin((double)x / TRIG_SCALE_FACTOR) * TRIG_SCALE_FACTOR);
+}
+
+int32_t fp_acos(int32_t x)
+{
+	return (int32_t)lround(acos((double)x / TRIG_SCALE_FACTOR) * TRIG_SCALE_FACTOR);
+}
+
+int32_t fp_interpolate(int32_t x, int32_t x1, int32_t y1, int32_t x2, int32_t y2)
+{
+	if(x2 == x1){
+		return y1;
+	}
+	return y1 + ((x - x1) * (y2 - y1)) / (x2 - x1);
+}
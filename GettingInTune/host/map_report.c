@@ -0,0 +1,551 @@
+/**
+ * \file    map_report.c
+ * \author	Dayton Flores (dafl2542@colorado.edu)
+ * \date	10/19/2026
+ * \brief   Breaks a GNU ld map file down into flash, .data, .bss and .noinit by module
+ * \detail
+ * 		make map-report runs it on Debug/GettingInTune.map, which the target link writes
+ * 		(-Map in Debug/makefile), or on MAP=<file>. The host link writes
+ * 		build/GettingInTune_host.map the same way.
+ *
+ * 		Every input section listed under "Linker script and memory map" is charged to
+ * 		the object it came from, or to its library with -a left out. What it counts as
+ * 		depends on the output section it went into:
+ * 			- flash: anything in a region without write access (.text, .rodata,
+ * 			  .ARM.exidx), plus the flash copy of .data
+ * 			- .data: output sections with a load address, copied to SRAM by ResetISR
+ * 			- .bss: writable output sections with bss in their name, zeroed by ResetISR
+ * 			- noinit: every other writable one (.noinit, the MTB and USB buffers)
+ * 		.heap, .heap2stackfill and .stack only reserve room, and are listed on their own.
+ * 		Maps without memory regions (the host's) are sorted by output section name
+ * 		instead.
+ *
+ * 		Usage: map_report [-a] <file.map>
+ * 			-a	List library members one by one
+ */
+
+#include <ctype.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * \def		MAP_LINE_LEN
+ * \brief	Longest map line read in one go
+ */
+#define MAP_LINE_LEN\
+	(4096)
+
+/**
+ * \def		MAP_MAX_REGIONS
+ * \brief	Most memory regions kept from the map's Memory Configuration
+ */
+#define MAP_MAX_REGIONS\
+	(16)
+
+/**
+ * \def		MAP_MAX_TOKENS
+ * \brief	Most words looked at on a map line
+ */
+#define MAP_MAX_TOKENS\
+	(8)
+
+/**
+ * \enum	enum kind_e
+ * \brief   What an output section's bytes count as
+ */
+enum kind_e{
+	KIND_FLASH,
+	KIND_DATA,
+	KIND_BSS,
+	KIND_NOINIT,
+	KINDS,
+	KIND_RESERVED = KINDS,	/* Room held for the heap or the stack */
+	KIND_SKIP				/* Not loaded: debug info and such */
+};
+
+/**
+ * \struct	struct region_s
+ * \brief   A memory region from the map's Memory Configuration
+ */
+struct region_s{
+	char name[32];
+	uint64_t origin;
+	uint64_t length;
+	uint64_t used;
+	bool writable;
+};
+
+/**
+ * \struct	struct module_s
+ * \brief   What one object or library adds to each kind
+ */
+struct module_s{
+	char *name;
+	uint64_t bytes[KINDS];
+};
+
+/**
+ * \struct	struct reservation_s
+ * \brief   An output section that only holds room, like .stack
+ */
+struct reservation_s{
+	char name[32];
+	uint64_t size;
+};
+
+static struct region_s regions[MAP_MAX_REGIONS];
+static int region_count = 0;
+
+static struct reservation_s reservations[MAP_MAX_REGIONS];
+static int reservation_count = 0;
+
+static struct module_s *modules = NULL;
+static int module_count = 0;
+static int module_capacity = 0;
+
+/**
+ * \var		split_archives
+ * \brief	Set by -a: charge library members to themselves instead of their library
+ */
+static bool split_archives = false;
+
+/**
+ * \fn		bool parse_hex
+ * \param	const char *word
+ * \param	uint64_t *value
+ * \return	true if word is 0x followed by hex digits only
+ */
+static bool parse_hex(const char *word, uint64_t *value)
+{
+	char *end;
+
+	if((word == NULL) || (strncmp(word, "0x", 2) != 0) || !isxdigit((unsigned char)word[2])){
+		return false;
+	}
+	*value = strtoull(word + 2, &end, 16);
+	return *end == '\0';
+}
+
+/**
+ * \fn		int split
+ * \param	char *line Split in place
+ * \param	char **words
+ * \return	Words found, up to MAP_MAX_TOKENS
+ */
+static int split(char *line, char **words)
+{
+	int count = 0;
+
+	line[strcspn(line, "\r\n")] = '\0';
+	while(count < MAP_MAX_TOKENS){
+		while(isspace((unsigned char)*line)){
+			line++;
+		}
+		if(*line == '\0'){
+			break;
+		}
+		words[count++] = line;
+		line += strcspn(line, " \t");
+		if(*line != '\0'){
+			*line++ = '\0';
+		}
+	}
+	return count;
+}
+
+/**
+ * \fn		struct region_s *find_region
+ * \param	uint64_t address
+ * \return	The first region holding address, NULL if none does
+ */
+static struct region_s *find_region(uint64_t address)
+{
+	for(int i = 0; i < region_count; i++){
+		if((address >= regions[i].origin) && (address - regions[i].origin < regions[i].length)){
+			return &regions[i];
+		}
+	}
+	return NULL;
+}
+
+/**
+ * \fn		enum kind_e classify
+ * \param	const char *name Output section
+ * \param	uint64_t address
+ * \param	bool loaded true if the map gives it a load address of its own
+ * \return	What the output section's bytes count as
+ */
+static enum kind_e classify(const char *name, uint64_t address, bool loaded)
+{
+	static const char * const skipped[] = {
+		".debug", ".comment", ".ARM.attributes", ".stab", ".gnu.attributes",
+		".gnu_debug", ".note.GNU-stack", "/DISCARD/"
+	};
+	static const char * const reserved[] = { ".heap", ".heap2stackfill", ".stack" };
+	static const char * const writable[] = {
+		".data", ".tdata", ".got", ".init_array", ".fini_array", ".dynamic"
+	};
+	struct region_s *region = find_region(address);
+
+	for(size_t i = 0; i < sizeof(skipped) / sizeof(skipped[0]); i++){
+		if(strncmp(name, skipped[i], strlen(skipped[i])) == 0){
+			return KIND_SKIP;
+		}
+	}
+	for(size_t i = 0; i < sizeof(reserved) / sizeof(reserved[0]); i++){
+		if(strcmp(name, reserved[i]) == 0){
+			return KIND_RESERVED;
+		}
+	}
+	if(loaded){
+		return KIND_DATA;
+	}
+	if(strstr(name, "bss") != NULL){
+		return KIND_BSS;
+	}
+	if(region != NULL){
+		return region->writable ? KIND_NOINIT : KIND_FLASH;
+	}
+
+	/**
+	 * No regions to go by
+	 */
+	if(strcmp(name, ".noinit") == 0){
+		return KIND_NOINIT;
+	}
+	for(size_t i = 0; i < sizeof(writable) / sizeof(writable[0]); i++){
+		if(strncmp(name, writable[i], strlen(writable[i])) == 0){
+			return KIND_DATA;
+		}
+	}
+	return KIND_FLASH;
+}
+
+/**
+ * \fn		struct module_s *find_module
+ * \param	const char *file As the map gives it: a path, library(member), or one of
+ * 			(padding) and (linker)
+ * \return	The module file is charged to, added if it is new
+ */
+static struct module_s *find_module(const char *file)
+{
+	char name[256];
+	const char *member = (file[0] != '(') ? strchr(file, '(') : NULL;
+	const char *base;
+	size_t length = member ? (size_t)(member - file) : strlen(file);
+
+	/**
+	 * Directories and, unless -a, library members are left out
+	 */
+	for(base = file + length; (base > file) && (base[-1] != '/') && (base[-1] != '\\'); base--){
+	}
+	if(split_archives && (member != NULL)){
+		length = strlen(base);
+	}
+	else{
+		length = (size_t)(file + length - base);
+	}
+	snprintf(name, sizeof(name), "%.*s", (int)length, base);
+
+	for(int i = 0; i < module_count; i++){
+		if(strcmp(modules[i].name, name) == 0){
+			return &modules[i];
+		}
+	}
+	if(module_count == module_capacity){
+		module_capacity = module_capacity ? (module_capacity * 2) : 64;
+		modules = realloc(modules, module_capacity * sizeof(*modules));
+		if(modules == NULL){
+			fprintf(stderr, "map_report: out of memory\n");
+			exit(EXIT_FAILURE);
+		}
+	}
+	memset(&modules[module_count], 0, sizeof(modules[module_count]));
+	modules[module_count].name = strdup(name);
+	return &modules[module_count++];
+}
+
+/**
+ * \fn		void charge
+ * \param	enum kind_e kind Of the output section
+ * \param	const char *file
+ * \param	uint64_t size
+ * \return	N/A
+ */
+static void charge(enum kind_e kind, const char *file, uint64_t size)
+{
+	struct module_s *module;
+
+	if((kind >= KINDS) || (size == 0)){
+		return;
+	}
+	module = find_module(file);
+	module->bytes[kind] += size;
+	if(kind == KIND_DATA){
+		module->bytes[KIND_FLASH] += size;
+	}
+}
+
+/**
+ * \fn		const char *input_file
+ * \param	char **words From the address on
+ * \param	int count
+ * \param	const char *line The line words were split from
+ * \param	const char *copy A copy of it from before the split
+ * \return	Who an input section's bytes belong to. File names may hold spaces (the
+ * 			linker's own "linker stubs"), so the rest of the line is taken from copy
+ */
+static const char *input_file(char **words, int count, const char *line, char *copy)
+{
+	static const char * const statements[] = { "BYTE", "SHORT", "LONG", "QUAD", "SQUAD", "FILL" };
+	char *file;
+
+	if(count < 3){
+		return "(padding)";
+	}
+	for(size_t i = 0; i < sizeof(statements) / sizeof(statements[0]); i++){
+		if(strcmp(words[2], statements[i]) == 0){
+			return "(linker)";
+		}
+	}
+	file = copy + (words[2] - line);
+	file[strcspn(file, "\r\n")] = '\0';
+	for(size_t end = strlen(file); (end > 0) && isspace((unsigned char)file[end - 1]); end--){
+		file[end - 1] = '\0';
+	}
+	return file;
+}
+
+/**
+ * \fn		void output_section
+ * \param	const char *name
+ * \param	char **words The address on
+ * \param	int count
+ * \param	enum kind_e *kind Where to put what its bytes count as
+ * \return	N/A
+ * \brief   Classifies an output section and charges it to its memory regions
+ */
+static void output_section(const char *name, char **words, int count, enum kind_e *kind)
+{
+	uint64_t address;
+	uint64_t size;
+	uint64_t load = 0;
+	bool loaded;
+	struct region_s *region;
+
+	if((count < 2) || !parse_hex(words[0], &address) || !parse_hex(words[1], &size)){
+		*kind = KIND_SKIP;
+		return;
+	}
+	loaded = (count >= 5) && (strcmp(words[2], "load") == 0) && parse_hex(words[4], &load);
+	*kind = classify(name, address, loaded);
+	if(*kind == KIND_SKIP){
+		return;
+	}
+	if((*kind == KIND_RESERVED) && (size > 0) && (reservation_count < MAP_MAX_REGIONS)){
+		snprintf(reservations[reservation_count].name, sizeof(reservations[0].name), "%s", name);
+		reservations[reservation_count++].size = size;
+	}
+	if((region = find_region(address)) != NULL){
+		region->used += size;
+	}
+	if(loaded && ((region = find_region(load)) != NULL)){
+		region->used += size;
+	}
+}
+
+/**
+ * \fn		int compare_modules
+ * \param	const void *a
+ * \param	const void *b
+ * \return	Order of a and b: most SRAM first, then most flash, then by name
+ */
+static int compare_modules(const void *a, const void *b)
+{
+	const struct module_s *x = a;
+	const struct module_s *y = b;
+	uint64_t ram_x = x->bytes[KIND_DATA] + x->bytes[KIND_BSS] + x->bytes[KIND_NOINIT];
+	uint64_t ram_y = y->bytes[KIND_DATA] + y->bytes[KIND_BSS] + y->bytes[KIND_NOINIT];
+
+	if(ram_x != ram_y){
+		return (ram_x < ram_y) ? 1 : -1;
+	}
+	if(x->bytes[KIND_FLASH] != y->bytes[KIND_FLASH]){
+		return (x->bytes[KIND_FLASH] < y->bytes[KIND_FLASH]) ? 1 : -1;
+	}
+	return strcmp(x->name, y->name);
+}
+
+int main(int argc, char **argv)
+{
+	static char line[MAP_LINE_LEN];
+	static char copy[MAP_LINE_LEN];
+	char pending_output[256] = "";
+	char pending_input[256] = "";
+	enum kind_e kind = KIND_SKIP;
+	uint64_t totals[KINDS] = { 0 };
+	bool in_regions = false;
+	bool in_layout = false;
+	const char *path = NULL;
+	FILE *map;
+
+	for(int i = 1; i < argc; i++){
+		if(strcmp(argv[i], "-a") == 0){
+			split_archives = true;
+		}
+		else{
+			path = argv[i];
+		}
+	}
+	if(path == NULL){
+		fprintf(stderr, "usage: map_report [-a] <file.map>\n");
+		return EXIT_FAILURE;
+	}
+	if((map = fopen(path, "r")) == NULL){
+		fprintf(stderr, "map_report: cannot open %s\n", path);
+		return EXIT_FAILURE;
+	}
+	printf("%s\n", path);
+
+	while(fgets(line, sizeof(line), map) != NULL){
+		char *words[MAP_MAX_TOKENS];
+		int count;
+		bool indented = isspace((unsigned char)line[0]);
+
+		if(strncmp(line, "Memory Configuration", 20) == 0){
+			in_regions = true;
+			continue;
+		}
+		if(strncmp(line, "Linker script and memory map", 28) == 0){
+			in_regions = false;
+			in_layout = true;
+			continue;
+		}
+		if(in_layout && ((strncmp(line, "OUTPUT(", 7) == 0) || (strncmp(line, "Cross Reference Table", 21) == 0))){
+			break;
+		}
+		memcpy(copy, line, sizeof(copy));
+		count = split(line, words);
+		if(count == 0){
+			continue;
+		}
+
+		/**
+		 * Name, origin, length and attributes. *default* has no attributes and holds
+		 * everything, so it is left out
+		 */
+		if(in_regions){
+			uint64_t origin;
+			uint64_t length;
+
+			if((count >= 4) && (region_count < MAP_MAX_REGIONS) &&
+					parse_hex(words[1], &origin) && parse_hex(words[2], &length)){
+				struct region_s *region = &regions[region_count++];
+
+				snprintf(region->name, sizeof(region->name), "%s", words[0]);
+				region->origin = origin;
+				region->length = length;
+				region->used = 0;
+				region->writable = strchr(words[3], 'w') != NULL;
+			}
+			continue;
+		}
+		if(!in_layout){
+			continue;
+		}
+
+		/**
+		 * An output section starts in the first column. A long name goes on a line of
+		 * its own, with its address and size on the next
+		 */
+		if(!indented){
+			pending_input[0] = '\0';
+			pending_output[0] = '\0';
+			kind = KIND_SKIP;
+			if(words[0][0] != '.'){
+				continue;
+			}
+			if(count == 1){
+				snprintf(pending_output, sizeof(pending_output), "%s", words[0]);
+				continue;
+			}
+			output_section(words[0], &words[1], count - 1, &kind);
+			continue;
+		}
+		if(pending_output[0] != '\0'){
+			output_section(pending_output, words, count, &kind);
+			pending_output[0] = '\0';
+			continue;
+		}
+
+		/**
+		 * Input sections: name, address, size and file, the name on a line of its own
+		 * if it is long. Lines that are an address then anything but a size are symbols
+		 * and assignments; lines with no address are the script's patterns
+		 */
+		{
+			uint64_t address;
+			uint64_t size;
+
+			if(parse_hex(words[0], &address)){
+				if((count >= 2) && parse_hex(words[1], &size)){
+					charge(kind, (pending_input[0] != '\0') ? input_file(words, count, line, copy) : "(linker)", size);
+				}
+			}
+			else if((count >= 3) && parse_hex(words[1], &address) && parse_hex(words[2], &size)){
+				charge(kind, (strcmp(words[0], "*fill*") == 0) ? "(padding)" : input_file(&words[1], count - 1, line, copy), size);
+			}
+			else if((count == 1) && (strchr(words[0], '(') == NULL)){
+				snprintf(pending_input, sizeof(pending_input), "%s", words[0]);
+				continue;
+			}
+			pending_input[0] = '\0';
+		}
+	}
+	fclose(map);
+
+	if(!in_layout){
+		fprintf(stderr, "map_report: %s has no memory map, link with -Map\n", path);
+		return EXIT_FAILURE;
+	}
+
+	qsort(modules, module_count, sizeof(*modules), compare_modules);
+	printf("\n%-28s %9s %9s %9s %9s\n", "module", "flash", ".data", ".bss", "noinit");
+	for(int i = 0; i < module_count; i++){
+		printf("%-28s %9llu %9llu %9llu %9llu\n",
+				modules[i].name,
+				(unsigned long long)modules[i].bytes[KIND_FLASH],
+				(unsigned long long)modules[i].bytes[KIND_DATA],
+				(unsigned long long)modules[i].bytes[KIND_BSS],
+				(unsigned long long)modules[i].bytes[KIND_NOINIT]);
+		for(int k = 0; k < KINDS; k++){
+			totals[k] += modules[i].bytes[k];
+		}
+	}
+	printf("%-28s %9llu %9llu %9llu %9llu\n\n",
+			"total",
+			(unsigned long long)totals[KIND_FLASH],
+			(unsigned long long)totals[KIND_DATA],
+			(unsigned long long)totals[KIND_BSS],
+			(unsigned long long)totals[KIND_NOINIT]);
+
+	for(int i = 0; i < region_count; i++){
+		if(regions[i].length == 0){
+			continue;
+		}
+		printf("%-28s %9llu of %llu bytes (%.1f%%)\n",
+				regions[i].name,
+				(unsigned long long)regions[i].used,
+				(unsigned long long)regions[i].length,
+				100.0 * regions[i].used / regions[i].length);
+	}
+	for(int i = 0; i < reservation_count; i++){
+		printf("%-28s %9llu bytes reserved\n",
+				reservations[i].name,
+				(unsigned long long)reservations[i].size);
+	}
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,89 @@
+/**
+ * \file    note_gen.c
+ * \author	Dayton Flores (dafl2542@colorado.edu)
+ * \date	10/19/2026
+ * \brief   Host generator for the firmware's note table (source/note.h)
+ * \detail
+ * 		Writes source/note_table.c to stdout. The host Makefile runs it whenever
+ * 		note.h, dac.h or adc.h change, and the MCUXpresso build compiles the file it
+ * 		wrote, so the checked-in table always matches the sample rates.
+ *
+ * 		Everything is computed in double and rounded once, so the table doesn't
+ * 		depend on the target's (missing) FPU.
+ */
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "adc.h"
+#include "dac.h"
+#include "note.h"
+
+/**
+ * \var		note_names
+ * \brief	Names of the notes of an octave from C, in sharps
+ */
+static const char * const note_names[12] = {
+	"C", "C#", "D", "D#", "E", "F", "F#", "G", "G#", "A", "A#", "B"
+};
+
+/**
+ * \fn		double note_hz
+ * \param	double midi May be between notes
+ * \return	Frequency of midi in equal temperament from A4
+ */
+static double note_hz(double midi)
+{
+	return NOTE_A4_HZ * pow(2.0, (midi - NOTE_MIDI_A4) / 12.0);
+}
+
+/**
+ * \fn		uint32_t note_round
+ * \param	double x
+ * \return	x rounded to the nearest uint32_t, saturated
+ */
+static uint32_t note_round(double x)
+{
+	x = floor(x + 0.5);
+	if(x >= 4294967295.0){
+		return UINT32_MAX;
+	}
+	return (x <= 0.0) ? 0 : (uint32_t)x;
+}
+
+int main(void)
+{
+	printf("/**\n");
+	printf(" * \\file    note_table.c\n");
+	printf(" * \\author\tDayton Flores (dafl2542@colorado.edu)\n");
+	printf(" * \\date\t10/19/2026\n");
+	printf(" * \\brief   The note table, see note.h. Generated by host/note_gen.c for\n");
+	printf(" * \t\t\tA4 = %d Hz, a %d Hz DAC and a %d Hz ADC: don't edit\n",
+			NOTE_A4_HZ, SAMPLE_RATE_DAC_HZ, SAMPLE_RATE_ADC_HZ);
+	printf(" */\n\n");
+	printf("#include <stdint.h>\n\n");
+	printf("/**\n * User-defined libraries\n */\n");
+	printf("#include \"note.h\"\n\n");
+	printf("const note_t note_table[NOTE_COUNT] = {\n");
+	printf("\t/*%11s%13s%13s%13s%13s%6s  %-6s */\n",
+			"hz_q16", "low_q16", "high_q16", "dac_step", "adc_per_q8", "midi", "name");
+
+	for(int midi = NOTE_MIDI_FIRST; midi <= NOTE_MIDI_LAST; midi++){
+		double hz = note_hz(midi);
+		char name[8];
+
+		snprintf(name, sizeof(name), "\"%s%d\"", note_names[midi % 12], midi / 12 - 1);
+		printf("\t{ %10uu, %10uu, %10uu, %10uu, %10uu, %4d, %-6s },\n",
+				note_round(hz * 65536.0),
+				note_round(note_hz(midi - 0.5) * 65536.0),
+				note_round(note_hz(midi + 0.5) * 65536.0),
+				note_round(hz / SAMPLE_RATE_DAC_HZ * 4294967296.0),
+				note_round(SAMPLE_RATE_ADC_HZ / hz * 256.0),
+				midi,
+				name);
+	}
+	printf("};\n");
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,1862 @@
+/**
+ * \file    sim_kl25z.c
+ * \author	Dayton Flores (dafl2542@colorado.edu)
+ * \date	10/19/2026
+ * \brief   Host-side register simulator for the KL25Z peripherals used by the firmware
+ * \detail
+ * 		Every region of the KL25Z memory map is a memfd mapped twice: once at the real
+ * 		address for the firmware, and once anywhere for the simulator (its "view").
+ *
+ * 		Plain memory cannot express write-1-to-clear flags, write-1-to-set enables or
+ * 		"writing this register starts a conversion". Register blocks that need those
+ * 		semantics are kept read-only at the firmware address. A store from the firmware
+ * 		faults, the page is opened, the store is single-stepped, and the block's write
+ * 		hook then sees the old and the newly written value (x86-64 hosts only; elsewhere
+ * 		the hooks are skipped and those registers behave like plain memory).
+ */
+
+#define _GNU_SOURCE
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <ucontext.h>
+#include <unistd.h>
+#include "fsl_device_registers.h"
+
+/**
+ * User-defined libraries
+ */
+#include "sim_kl25z.h"
+
+/**
+ * \def		NSEC_PER_SEC
+ * \brief	Used for unit conversions
+ */
+#define NSEC_PER_SEC\
+	(1000000000ULL)
+
+/**
+ * \def		SIM_PAGE_SIZE
+ * \brief	Granularity of write trapping
+ */
+#define SIM_PAGE_SIZE\
+	(0x1000u)
+
+/**
+ * \def		EFLAGS_TF
+ * \brief	x86 trap flag: raise SIGTRAP after the next instruction
+ */
+#define EFLAGS_TF\
+	(0x100)
+
+/**
+ * \def		SYSTICK_EXT_CLOCK_DIV
+ * \brief	SysTick external reference clock is the core clock divided by 16 on the KL25Z
+ */
+#define SYSTICK_EXT_CLOCK_DIV\
+	(16)
+
+/**
+ * \def		DMAMUX_SOURCE_UART0_TX
+ * \brief	DMAMUX request source for UART0 transmit
+ */
+#define DMAMUX_SOURCE_UART0_TX\
+	(3)
+
+/**
+ * \def		DMAMUX_SOURCE_TPM0_CH
+ * \brief	DMAMUX request source for TPM0 channel 0. Channels 1-5 follow
+ */
+#define DMAMUX_SOURCE_TPM0_CH\
+	(24)
+
+/**
+ * \def		DMAMUX_SOURCE_TPM1_CH
+ * \brief	DMAMUX request source for TPM1 channel 0. TPM1 CH1, TPM2 CH0 and CH1 follow
+ */
+#define DMAMUX_SOURCE_TPM1_CH\
+	(32)
+
+/**
+ * \def		DMAMUX_SOURCE_ADC0
+ * \brief	DMAMUX request source for ADC0 conversion complete
+ */
+#define DMAMUX_SOURCE_ADC0\
+	(40)
+
+/**
+ * \def		DMAMUX_SOURCE_TPM_OVERFLOW
+ * \brief	DMAMUX request source for TPM0 overflow. TPM1 and TPM2 follow
+ */
+#define DMAMUX_SOURCE_TPM_OVERFLOW\
+	(54)
+
+/**
+ * \def		DMAMUX_SOURCE_ALWAYS_ON
+ * \brief	First DMAMUX always-enabled request source (60-63)
+ */
+#define DMAMUX_SOURCE_ALWAYS_ON\
+	(60)
+
+/**
+ * \def		ADC0TRGSEL_TPM_OVERFLOW
+ * \brief	SOPT7[ADC0TRGSEL] value selecting TPM0 overflow. TPM1 and TPM2 follow
+ */
+#define ADC0TRGSEL_TPM_OVERFLOW\
+	(8)
+
+/**
+ * \def		ADCH_DISABLED
+ * \brief	SC1[ADCH] value that disables the ADC
+ */
+#define ADCH_DISABLED\
+	(31)
+
+/**
+ * \def		ADCH_DAC0
+ * \brief	ADC0 input channel wired to the DAC0 output (AD23, PTE30)
+ */
+#define ADCH_DAC0\
+	(23)
+
+/**
+ * \def		TPM_CHANNELS
+ * \brief	Channels per TPM instance (TPM1 and TPM2 only implement 2)
+ */
+#define TPM_CHANNELS\
+	(6)
+
+/**
+ * \def		TPM_CnSC_MODE_MASK
+ * \brief	CnSC bits that must be non-zero for a channel to be in use
+ */
+#define TPM_CnSC_MODE_MASK\
+	(TPM_CnSC_MSB_MASK | TPM_CnSC_MSA_MASK | TPM_CnSC_ELSB_MASK | TPM_CnSC_ELSA_MASK)
+
+/**
+ * \def		DMA_DSR_BCR_STATUS_W1C
+ * \brief	Status bits cleared by writing DSR[DONE] = 1
+ */
+#define DMA_DSR_BCR_STATUS_W1C\
+	(DMA_DSR_BCR_DONE_MASK | DMA_DSR_BCR_BED_MASK | DMA_DSR_BCR_BES_MASK | DMA_DSR_BCR_CE_MASK)
+
+/**
+ * \typedef	typedef struct sim_region_s sim_region_t
+ * \brief   A block of the KL25Z memory map backed by host memory
+ */
+typedef struct sim_region_s sim_region_t;
+
+/**
+ * \struct	struct sim_region_s
+ * \brief   A block of the KL25Z memory map backed by host memory
+ */
+struct sim_region_s{
+	uintptr_t base;
+	size_t size;
+	uint8_t *view;
+};
+
+/**
+ * \var		sim_regions
+ * \brief	Every address range the firmware may touch through MKL25Z4.h / core_cm0plus.h
+ */
+static sim_region_t sim_regions[] = {
+	{ 0x40000000u, 0x00100000u, NULL },	/* AIPS peripherals and GPIO */
+	{ 0xE000E000u, 0x00001000u, NULL },	/* SCS: SysTick, NVIC, SCB */
+	{ 0xF0000000u, 0x00004000u, NULL },	/* MTB, MTBDWT, ROM table, MCM */
+	{ 0xF80FF000u, 0x00001000u, NULL },	/* FGPIO */
+};
+
+/**
+ * \typedef	typedef void (*sim_write_hook_t)(uintptr_t addr, uint32_t old, volatile uint32_t *word)
+ * \brief   Called after the firmware stored to a trapped register block
+ * \param	addr Word-aligned firmware address that was written
+ * \param	old Value of the word before the store
+ * \param	word The simulator's view of the word, holding the value just stored
+ */
+typedef void (*sim_write_hook_t)(uintptr_t addr, uint32_t old, volatile uint32_t *word);
+
+/**
+ * \typedef	typedef struct sim_trap_s sim_trap_t
+ * \brief   A page whose stores go through a write hook
+ */
+typedef struct sim_trap_s sim_trap_t;
+
+/**
+ * \struct	struct sim_trap_s
+ * \brief   A page whose stores go through a write hook
+ */
+struct sim_trap_s{
+	uintptr_t page;
+	sim_write_hook_t hook;
+};
+
+static void scs_write(uintptr_t addr, uint32_t old, volatile uint32_t *word);
+static void dma_write(uintptr_t addr, uint32_t old, volatile uint32_t *word);
+static void tpm_write(uintptr_t addr, uint32_t old, volatile uint32_t *word);
+static void adc_write(uintptr_t addr, uint32_t old, volatile uint32_t *word);
+static void uart_write(uintptr_t addr, uint32_t old, volatile uint32_t *word);
+
+/**
+ * \var		sim_traps
+ * \brief	Register blocks with write semantics plain memory cannot provide
+ */
+static const sim_trap_t sim_traps[] = {
+	{ 0xE000E000u, scs_write },
+	{ DMA_BASE,    dma_write },
+	{ TPM0_BASE,   tpm_write },
+	{ TPM1_BASE,   tpm_write },
+	{ TPM2_BASE,   tpm_write },
+	{ ADC0_BASE,   adc_write },
+	{ UART0_BASE,  uart_write },
+};
+
+/**
+ * \typedef	typedef void (*sim_handler_t)(void)
+ * \brief   An entry of the simulated vector table
+ */
+typedef void (*sim_handler_t)(void);
+
+/**
+ * Weak default handlers, mirroring startup/startup_mkl25z4.c. The firmware's own
+ * definitions (e.g. DMA0_IRQHandler in dma.c) override these
+ */
+static void sim_default_handler(void);
+void SysTick_Handler(void) __attribute__((weak, alias("sim_default_handler")));
+void DMA0_IRQHandler(void) __attribute__((weak, alias("sim_default_handler")));
+void DMA1_IRQHandler(void) __attribute__((weak, alias("sim_default_handler")));
+void DMA2_IRQHandler(void) __attribute__((weak, alias("sim_default_handler")));
+void DMA3_IRQHandler(void) __attribute__((weak, alias("sim_default_handler")));
+void FTFA_IRQHandler(void) __attribute__((weak, alias("sim_default_handler")));
+void UART0_IRQHandler(void) __attribute__((weak, alias("sim_default_handler")));
+void ADC0_IRQHandler(void) __attribute__((weak, alias("sim_default_handler")));
+void TPM0_IRQHandler(void) __attribute__((weak, alias("sim_default_handler")));
+void TPM1_IRQHandler(void) __attribute__((weak, alias("sim_default_handler")));
+void TPM2_IRQHandler(void) __attribute__((weak, alias("sim_default_handler")));
+void DAC0_IRQHandler(void) __attribute__((weak, alias("sim_default_handler")));
+void LPTMR0_IRQHandler(void) __attribute__((weak, alias("sim_default_handler")));
+
+/**
+ * \var		sim_vectors
+ * \brief	Handlers for external IRQs, indexed by IRQn. NULL entries are not modeled
+ */
+static sim_handler_t const sim_vectors[SIM_NUM_IRQS] = {
+	[DMA0_IRQn]   = DMA0_IRQHandler,
+	[DMA1_IRQn]   = DMA1_IRQHandler,
+	[DMA2_IRQn]   = DMA2_IRQHandler,
+	[DMA3_IRQn]   = DMA3_IRQHandler,
+	[FTFA_IRQn]   = FTFA_IRQHandler,
+	[UART0_IRQn]  = UART0_IRQHandler,
+	[ADC0_IRQn]   = ADC0_IRQHandler,
+	[TPM0_IRQn]   = TPM0_IRQHandler,
+	[TPM1_IRQn]   = TPM1_IRQHandler,
+	[TPM2_IRQn]   = TPM2_IRQHandler,
+	[DAC0_IRQn]   = DAC0_IRQHandler,
+	[LPTMR0_IRQn] = LPTMR0_IRQHandler,
+};
+
+/**
+ * \var		sim_stats
+ * \brief	Counters kept by the simulator
+ */
+volatile sim_stats_t sim_stats;
+
+/**
+ * Simulator views of the register blocks. The simulator only ever accesses peripherals
+ * through these, never through the firmware addresses (which may be read-only)
+ */
+static SIM_Type *v_sim;
+static ADC_Type *v_adc;
+static DAC_Type *v_dac;
+static DMA_Type *v_dma;
+static DMAMUX_Type *v_dmamux;
+static TPM_Type *v_tpm[3];
+static SysTick_Type *v_systick;
+static NVIC_Type *v_nvic;
+static SCB_Type *v_scb;
+static UART0_Type *v_uart0;
+
+/**
+ * Simulator state, guarded by sim_lock. Interrupt dispatch also touches the NVIC
+ * state, but only while the simulator thread is parked in deliver_irqs()
+ */
+static pthread_t firmware_thread;
+static pthread_t sim_thread;
+static uint64_t sim_end_cycles;
+static double sim_speed = 1.0;
+static uint32_t sim_adc_noise;
+static uint32_t nvic_enabled;
+static uint32_t nvic_pending;
+static bool systick_pending;
+static uint64_t tpm_prescale_acc[3];
+static uint64_t systick_acc;
+static uint32_t sim_core_hz = SIM_CORE_CLOCK_HZ;
+static uint32_t sim_periph_hz = SIM_TPM_CLOCK_HZ;
+static bool adc_busy;
+static bool adc_sw_trigger;
+static int64_t adc_remaining;
+static bool adc_sw_paced;
+static uint64_t adc_sw_due;
+static uint64_t adc_sw_wall;
+static bool trap_yield;
+static bool uart_shifting;
+static int64_t uart_remaining;
+static uint8_t uart_tx_data;
+static uint8_t uart_rx_data;
+static int64_t uart_rx_remaining;
+static bool uart_rx_eof;
+static bool uart_rx_pended;
+static char uart_line[128];
+static size_t uart_line_len;
+static sim_analog_fn_t analog_fn[32];
+static void *analog_ctx[32];
+static struct timespec wall_start;
+static volatile char sim_lock;
+
+/**
+ * Write trap state, only used on the firmware thread
+ */
+static uintptr_t trap_addr;
+static uintptr_t trap_store_addr;
+static uint32_t trap_old;
+static const sim_trap_t *trap_page;
+static bool trap_usr1_was_blocked;
+
+/**
+ * Handshake between the simulator thread and the firmware thread. The simulator
+ * sleeps on irq_done rather than spinning, which matters on single-CPU hosts
+ */
+static sem_t irq_done;
+static volatile int exit_request;
+
+static uint64_t wall_ns(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+static void lock(void)
+{
+	while(__atomic_test_and_set(&sim_lock, __ATOMIC_ACQUIRE)){
+		sched_yield();
+	}
+}
+
+static void unlock(void)
+{
+	__atomic_clear(&sim_lock, __ATOMIC_RELEASE);
+}
+
+static void sim_default_handler(void)
+{
+	/**
+	 * On the board IntDefaultHandler spins forever; fail loudly instead
+	 */
+	fprintf(stderr, "sim: unhandled interrupt\r\n");
+	abort();
+}
+
+/**
+ * \fn		void *sim_view
+ * \param	uintptr_t addr A firmware address
+ * \return	The simulator's alias of addr, or addr itself if it is ordinary host memory
+ * \brief   Translates firmware addresses (register pointers, DMA SAR/DAR) for the simulator
+ */
+static void *sim_view(uintptr_t addr)
+{
+	for(size_t i = 0; i < sizeof(sim_regions) / sizeof(sim_regions[0]); i++){
+		if((addr >= sim_regions[i].base) && (addr - sim_regions[i].base < sim_regions[i].size)){
+			return sim_regions[i].view + (addr - sim_regions[i].base);
+		}
+	}
+	return (void *)addr;
+}
+
+uint64_t sim_now_cycles(void)
+{
+	return __atomic_load_n(&sim_stats.cycles, __ATOMIC_RELAXED);
+}
+
+void sim_set_analog_source(uint32_t channel, sim_analog_fn_t fn, void *ctx)
+{
+	if(channel < 32){
+		analog_ctx[channel] = ctx;
+		analog_fn[channel] = fn;
+	}
+}
+
+void sim_irq_disable(void)
+{
+	sigset_t set;
+
+	sigemptyset(&set);
+	sigaddset(&set, SIGUSR1);
+	pthread_sigmask(SIG_BLOCK, &set, NULL);
+}
+
+void sim_irq_enable(void)
+{
+	sigset_t set;
+
+	sigemptyset(&set);
+	sigaddset(&set, SIGUSR1);
+	pthread_sigmask(SIG_UNBLOCK, &set, NULL);
+}
+
+bool sim_irq_masked(void)
+{
+	sigset_t set;
+
+	pthread_sigmask(SIG_BLOCK, NULL, &set);
+	return sigismember(&set, SIGUSR1) == 1;
+}
+
+void sim_wfi(void)
+{
+	sigset_t set;
+
+	/**
+	 * Wait with SIGUSR1 unblocked: one already pending is taken straight away
+	 */
+	pthread_sigmask(SIG_BLOCK, NULL, &set);
+	sigdelset(&set, SIGUSR1);
+	sim_stats.wfi_count++;
+
+	/**
+	 * Whatever was polling the ADC has stopped
+	 */
+	lock();
+	adc_sw_paced = false;
+	unlock();
+	sigsuspend(&set);
+}
+
+void sim_set_clocks(uint32_t core_hz, uint32_t periph_hz, bool vlpr)
+{
+	lock();
+	sim_core_hz = core_hz;
+	sim_periph_hz = periph_hz;
+	*(volatile uint8_t *)sim_view((uintptr_t)&SMC->PMSTAT) = SMC_PMSTAT_PMSTAT(vlpr ? 4 : 1);
+	unlock();
+}
+
+uint16_t sim_dac_output(void)
+{
+	uint32_t code;
+	uint32_t i = 0;
+
+	if(!(v_sim->SCGC6 & SIM_SCGC6_DAC0_MASK) || !(v_dac->C0 & DAC_C0_DACEN_MASK)){
+		return 0;
+	}
+
+	/**
+	 * With the buffer enabled the output is the word at the read pointer
+	 */
+	if(v_dac->C1 & DAC_C1_DACBFEN_MASK){
+		i = (v_dac->C2 & DAC_C2_DACBFRP_MASK) >> DAC_C2_DACBFRP_SHIFT;
+	}
+
+	/**
+	 * Only DATH[3:0] is implemented, so signed samples wrap just like on the board
+	 */
+	code = ((uint32_t)(v_dac->DAT[i].DATH & 0x0F) << 8) | v_dac->DAT[i].DATL;
+	return (uint16_t)((code * 0xFFFFu) / 0x0FFFu);
+}
+
+/**
+ * \fn		void mirror_nvic
+ * \param	N/A
+ * \return	N/A
+ * \brief   Makes ISER/ICER read back the enables and ISPR/ICPR the pending bits
+ */
+static void mirror_nvic(void)
+{
+	v_nvic->ISER[0] = nvic_enabled;
+	v_nvic->ICER[0] = nvic_enabled;
+	v_nvic->ISPR[0] = nvic_pending;
+	v_nvic->ICPR[0] = nvic_pending;
+	v_scb->ICSR = (v_scb->ICSR & ~SCB_ICSR_PENDSTSET_Msk) | (systick_pending ? SCB_ICSR_PENDSTSET_Msk : 0);
+}
+
+/**
+ * \fn		void pend_irq
+ * \param	IRQn_Type irq
+ * \return	N/A
+ * \brief   Marks an interrupt as pending in the simulated NVIC
+ */
+static void pend_irq(IRQn_Type irq)
+{
+	if(irq == SysTick_IRQn){
+		systick_pending = true;
+	}
+	else{
+		nvic_pending |= (1u << irq);
+	}
+	mirror_nvic();
+}
+
+/**
+ * \fn		void scs_write
+ * \brief   NVIC set/clear registers, SysTick VAL (any write clears it) and SCB ICSR
+ */
+static void scs_write(uintptr_t addr, uint32_t old, volatile uint32_t *word)
+{
+	uint32_t v = *word;
+
+	if(addr == (uintptr_t)&NVIC->ISER[0]){
+		nvic_enabled |= v;
+	}
+	else if(addr == (uintptr_t)&NVIC->ICER[0]){
+		nvic_enabled &= ~v;
+	}
+	else if(addr == (uintptr_t)&NVIC->ISPR[0]){
+		nvic_pending |= v;
+	}
+	else if(addr == (uintptr_t)&NVIC->ICPR[0]){
+		nvic_pending &= ~v;
+	}
+	else if(addr == (uintptr_t)&SysTick->VAL){
+		*word = 0;
+		v_systick->CTRL &= ~SysTick_CTRL_COUNTFLAG_Msk;
+		systick_acc = 0;
+	}
+	else if(addr == (uintptr_t)&SCB->ICSR){
+		if(v & SCB_ICSR_PENDSTSET_Msk){
+			systick_pending = true;
+		}
+		if(v & SCB_ICSR_PENDSTCLR_Msk){
+			systick_pending = false;
+		}
+	}
+	else{
+		return;
+	}
+	mirror_nvic();
+}
+
+/**
+ * \fn		void dma_write
+ * \brief   Writing DSR[DONE] = 1 clears the status bits; the rest of DSR is read-only
+ */
+static void dma_write(uintptr_t addr, uint32_t old, volatile uint32_t *word)
+{
+	for(uint32_t ch = 0; ch < 4; ch++){
+		if(addr == (uintptr_t)&DMA0->DMA[ch].DSR_BCR){
+			uint32_t status = old & ~DMA_DSR_BCR_BCR_MASK;
+
+			if(*word & DMA_DSR_BCR_DONE_MASK){
+				status &= ~DMA_DSR_BCR_STATUS_W1C;
+			}
+			*word = status | (*word & DMA_DSR_BCR_BCR_MASK);
+		}
+	}
+}
+
+/**
+ * \fn		void tpm_write
+ * \brief   TOF and CHF are write-1-to-clear, as is STATUS; any write to CNT clears it
+ */
+static void tpm_write(uintptr_t addr, uint32_t old, volatile uint32_t *word)
+{
+	for(uint32_t i = 0; i < 3; i++){
+		TPM_Type *tpm = (TPM_Type *)((i == 0) ? TPM0_BASE : ((i == 1) ? TPM1_BASE : TPM2_BASE));
+		uint32_t cleared;
+
+		if(addr == (uintptr_t)&tpm->SC){
+			cleared = *word & TPM_SC_TOF_MASK;
+			*word = (*word & ~TPM_SC_TOF_MASK) | (old & TPM_SC_TOF_MASK & ~cleared);
+			if(cleared){
+				v_tpm[i]->STATUS &= ~TPM_STATUS_TOF_MASK;
+			}
+		}
+		else if(addr == (uintptr_t)&tpm->CNT){
+			*word = 0;
+			tpm_prescale_acc[i] = 0;
+		}
+		else if(addr == (uintptr_t)&tpm->STATUS){
+			cleared = *word;
+			*word = old & ~cleared;
+			if(cleared & TPM_STATUS_TOF_MASK){
+				v_tpm[i]->SC &= ~TPM_SC_TOF_MASK;
+			}
+			for(uint32_t ch = 0; ch < TPM_CHANNELS; ch++){
+				if(cleared & (1u << ch)){
+					v_tpm[i]->CONTROLS[ch].CnSC &= ~TPM_CnSC_CHF_MASK;
+				}
+			}
+		}
+		else{
+			for(uint32_t ch = 0; ch < TPM_CHANNELS; ch++){
+				if(addr == (uintptr_t)&tpm->CONTROLS[ch].CnSC){
+					cleared = *word & TPM_CnSC_CHF_MASK;
+					*word = (*word & ~TPM_CnSC_CHF_MASK) | (old & TPM_CnSC_CHF_MASK & ~cleared);
+					if(cleared){
+						v_tpm[i]->STATUS &= ~(1u << ch);
+					}
+				}
+			}
+		}
+	}
+}
+
+/**
+ * \fn		void adc_write
+ * \brief   A write to SC1[0] aborts the conversion in flight, clears COCO and, in software
+ * 			trigger mode, starts a new conversion on the selected channel
+ */
+static void adc_write(uintptr_t addr, uint32_t old, volatile uint32_t *word)
+{
+	(void)old;
+	if(addr == (uintptr_t)&ADC0->SC1[0]){
+		*word &= ~ADC_SC1_COCO_MASK;
+		adc_busy = false;
+		adc_sw_trigger = !(v_adc->SC2 & ADC_SC2_ADTRG_MASK) &&
+				(((*word & ADC_SC1_ADCH_MASK) >> ADC_SC1_ADCH_SHIFT) != ADCH_DISABLED);
+
+		/**
+		 * The firmware is about to poll COCO: on a single-CPU host it would spin out its
+		 * time slice before the simulator thread got to the conversion
+		 */
+		trap_yield = adc_sw_trigger;
+	}
+}
+
+/**
+ * \fn		uint64_t uart_char_cycles
+ * \param	N/A
+ * \return	Simulated cycles to shift out one character, or 0 while the baud generator is off
+ * \brief   Baud rate per the KL25 reference manual: UART0 clock / ((OSR + 1) * SBR). The
+ * 			UART0 clock is whatever sim_set_clocks last said, whichever SOPT2[UART0SRC] is
+ */
+static uint64_t uart_char_cycles(void)
+{
+	uint32_t sbr = ((uint32_t)(v_uart0->BDH & UART0_BDH_SBR_MASK) << 8) | v_uart0->BDL;
+	uint32_t osr = ((v_uart0->C4 & UART0_C4_OSR_MASK) >> UART0_C4_OSR_SHIFT) + 1;
+	uint32_t bits = 1 + ((v_uart0->C1 & UART0_C1_M_MASK) ? 9 : 8) +
+			((v_uart0->C1 & UART0_C1_PE_MASK) ? 1 : 0) + ((v_uart0->BDH & UART0_BDH_SBNS_MASK) ? 2 : 1);
+
+	return (uint64_t)bits * osr * sbr * SIM_CORE_CLOCK_HZ / sim_periph_hz;
+}
+
+/**
+ * \fn		void uart_flush
+ * \param	N/A
+ * \return	N/A
+ * \brief   Writes out what uart_emit has collected. Binary output, DLOG records for one,
+ * 			may never contain a newline, so this also runs when the line goes idle
+ */
+static void uart_flush(void)
+{
+	if(uart_line_len && (write(STDOUT_FILENO, uart_line, uart_line_len) < 0)){
+		/* Nowhere to report it */
+	}
+	uart_line_len = 0;
+}
+
+/**
+ * \fn		void uart_emit
+ * \param	uint8_t c
+ * \return	N/A
+ * \brief   A character reached the wire: pass it to stdout a line at a time. This runs in a
+ * 			signal handler on the firmware thread, possibly inside stdio, so it uses write(2)
+ */
+static void uart_emit(uint8_t c)
+{
+	sim_stats.uart_tx_bytes++;
+	uart_line[uart_line_len++] = (char)c;
+	if((c == '\n') || (uart_line_len == sizeof(uart_line))){
+		uart_flush();
+	}
+}
+
+/**
+ * \fn		void uart_load
+ * \param	N/A
+ * \return	N/A
+ * \brief   D was written, by the CPU or the DMA: start sending it. D reads back the last
+ * 			character received, so the one to send is kept aside
+ */
+static void uart_load(void)
+{
+	uart_tx_data = v_uart0->D;
+	v_uart0->D = uart_rx_data;
+	if(!(v_uart0->C2 & UART0_C2_TE_MASK) || !(v_sim->SCGC4 & SIM_SCGC4_UART0_MASK) ||
+	   (uart_char_cycles() == 0)){
+		return;
+	}
+
+	/**
+	 * Double buffered: D goes straight to the shifter if it is idle, else it waits in
+	 * the data register with TDRE clear
+	 */
+	v_uart0->S1 &= ~UART0_S1_TC_MASK;
+	if(!uart_shifting){
+		uart_shifting = true;
+		uart_remaining = (int64_t)uart_char_cycles();
+		uart_emit(uart_tx_data);
+	}
+	else{
+		v_uart0->S1 &= ~UART0_S1_TDRE_MASK;
+	}
+}
+
+/**
+ * \fn		void uart_write
+ * \brief   UART0 D starts a transmission; S1 is read-only or write-1-to-clear
+ */
+static void uart_write(uintptr_t addr, uint32_t old, volatile uint32_t *word)
+{
+	const uint32_t w1c = UART0_S1_OR_MASK | UART0_S1_NF_MASK | UART0_S1_FE_MASK | UART0_S1_PF_MASK;
+
+	if(addr != (uintptr_t)&UART0->S1){
+		return;
+	}
+
+	/**
+	 * The word holds S1, S2, C3 and D. Keep S1 as it was, less the error flags
+	 * written with 1
+	 */
+	if(trap_store_addr == (uintptr_t)&UART0->S1){
+		old &= ~(*word & w1c);
+	}
+	*word = (*word & ~0xFFu) | (old & 0xFFu);
+
+	if(trap_store_addr == (uintptr_t)&UART0->D){
+		uart_load();
+	}
+}
+
+/**
+ * \fn		uint32_t dma_size_bytes
+ * \param	uint32_t size SSIZE or DSIZE field
+ * \return	Bytes per bus cycle, or 0 for the reserved encoding
+ * \brief   Decodes DCR[SSIZE]/DCR[DSIZE]
+ */
+static uint32_t dma_size_bytes(uint32_t size)
+{
+	switch(size){
+	case 0:
+		return 4;
+	case 1:
+		return 1;
+	case 2:
+		return 2;
+	default:
+		return 0;
+	}
+}
+
+/**
+ * \fn		uint32_t dma_next_address
+ * \param	uint32_t addr
+ * \param	uint32_t inc Bytes to increment by
+ * \param	uint32_t mod SMOD or DMOD field
+ * \return	The incremented address, wrapped inside the modulo window if one is selected
+ * \brief   Implements DCR[SINC]/DCR[DINC] together with DCR[SMOD]/DCR[DMOD]
+ */
+static uint32_t dma_next_address(uint32_t addr, uint32_t inc, uint32_t mod)
+{
+	uint32_t window;
+
+	if(mod == 0){
+		return addr + inc;
+	}
+	window = 16u << (mod - 1);
+	return (addr & ~(window - 1)) | ((addr + inc) & (window - 1));
+}
+
+/**
+ * \fn		void dma_service
+ * \param	uint32_t ch DMA channel
+ * \return	N/A
+ * \brief   Serves one request on a DMA channel: a single transfer with cycle steal,
+ * 			otherwise until BCR reaches 0
+ */
+static void dma_service(uint32_t ch)
+{
+	uint32_t dcr = v_dma->DMA[ch].DCR;
+	uint32_t dsr_bcr = v_dma->DMA[ch].DSR_BCR;
+	uint32_t bcr = dsr_bcr & DMA_DSR_BCR_BCR_MASK;
+	uint32_t ssize = dma_size_bytes((dcr & DMA_DCR_SSIZE_MASK) >> DMA_DCR_SSIZE_SHIFT);
+	uint32_t dsize = dma_size_bytes((dcr & DMA_DCR_DSIZE_MASK) >> DMA_DCR_DSIZE_SHIFT);
+	uint32_t sar = v_dma->DMA[ch].SAR;
+	uint32_t dar = v_dma->DMA[ch].DAR;
+	void *src;
+	void *dst;
+
+	if(bcr == 0){
+		return;
+	}
+
+	/**
+	 * Only matching source and destination sizes are modeled
+	 */
+	if((ssize == 0) || (ssize != dsize) || (bcr % ssize) || (sar % ssize) || (dar % dsize)){
+		v_dma->DMA[ch].DSR_BCR = dsr_bcr | DMA_DSR_BCR_CE_MASK;
+		return;
+	}
+
+	do{
+		src = sim_view(sar);
+		dst = sim_view(dar);
+		switch(ssize){
+		case 1:
+			*(volatile uint8_t *)dst = *(volatile uint8_t *)src;
+			break;
+		case 2:
+			*(volatile uint16_t *)dst = *(volatile uint16_t *)src;
+			break;
+		default:
+			*(volatile uint32_t *)dst = *(volatile uint32_t *)src;
+			break;
+		}
+
+		/**
+		 * Reading the result register acknowledges the conversion
+		 */
+		if(sar == (uint32_t)(uintptr_t)&ADC0->R[0]){
+			v_adc->SC1[0] &= ~ADC_SC1_COCO_MASK;
+		}
+		if((dar >= (uint32_t)(uintptr_t)&DAC0->DAT[0]) && (dar < (uint32_t)(uintptr_t)&DAC0->SR)){
+			sim_stats.dac_updates++;
+		}
+		if(dar == (uint32_t)(uintptr_t)&UART0->D){
+			uart_load();
+		}
+
+		if(dcr & DMA_DCR_SINC_MASK){
+			sar = dma_next_address(sar, ssize, (dcr & DMA_DCR_SMOD_MASK) >> DMA_DCR_SMOD_SHIFT);
+		}
+		if(dcr & DMA_DCR_DINC_MASK){
+			dar = dma_next_address(dar, dsize, (dcr & DMA_DCR_DMOD_MASK) >> DMA_DCR_DMOD_SHIFT);
+		}
+		bcr -= ssize;
+		sim_stats.dma_transfers[ch]++;
+	} while(!(dcr & DMA_DCR_CS_MASK) && (bcr > 0));
+
+	v_dma->DMA[ch].SAR = sar;
+	v_dma->DMA[ch].DAR = dar;
+
+	if(bcr == 0){
+		v_dma->DMA[ch].DSR_BCR = (dsr_bcr & ~(DMA_DSR_BCR_BCR_MASK | DMA_DSR_BCR_BSY_MASK)) | DMA_DSR_BCR_DONE_MASK;
+		sim_stats.dma_done[ch]++;
+
+		/**
+		 * Disable request at the end of the major loop if asked to
+		 */
+		if(dcr & DMA_DCR_D_REQ_MASK){
+			v_dma->DMA[ch].DCR = dcr & ~DMA_DCR_ERQ_MASK;
+		}
+		if(dcr & DMA_DCR_EINT_MASK){
+			pend_irq((IRQn_Type)(DMA0_IRQn + ch));
+		}
+	}
+	else{
+		v_dma->DMA[ch].DSR_BCR = (dsr_bcr & ~DMA_DSR_BCR_BCR_MASK) | bcr | DMA_DSR_BCR_BSY_MASK;
+	}
+}
+
+/**
+ * \fn		bool dma_request
+ * \param	uint32_t source DMAMUX request source
+ * \return	true if a channel took the request
+ * \brief   Routes a peripheral DMA request through DMAMUX0 to the enabled channels
+ */
+static bool dma_request(uint32_t source)
+{
+	bool taken = false;
+
+	if(!(v_sim->SCGC7 & SIM_SCGC7_DMA_MASK) || !(v_sim->SCGC6 & SIM_SCGC6_DMAMUX_MASK)){
+		return false;
+	}
+
+	for(uint32_t ch = 0; ch < 4; ch++){
+		uint8_t chcfg = v_dmamux->CHCFG[ch];
+
+		if((chcfg & DMAMUX_CHCFG_ENBL_MASK) &&
+		   (((chcfg & DMAMUX_CHCFG_SOURCE_MASK) >> DMAMUX_CHCFG_SOURCE_SHIFT) == source) &&
+		   (v_dma->DMA[ch].DCR & DMA_DCR_ERQ_MASK)){
+			dma_service(ch);
+			taken = true;
+		}
+	}
+	return taken;
+}
+
+/**
+ * \fn		void step_dma
+ * \param	N/A
+ * \return	N/A
+ * \brief   Handles software START and the always-enabled DMAMUX sources
+ */
+static void step_dma(void)
+{
+	if(!(v_sim->SCGC7 & SIM_SCGC7_DMA_MASK)){
+		return;
+	}
+
+	for(uint32_t ch = 0; ch < 4; ch++){
+		uint32_t dcr = v_dma->DMA[ch].DCR;
+
+		if(dcr & DMA_DCR_START_MASK){
+			v_dma->DMA[ch].DCR = dcr & ~DMA_DCR_START_MASK;
+			dma_service(ch);
+		}
+	}
+	for(uint32_t source = DMAMUX_SOURCE_ALWAYS_ON; source < DMAMUX_SOURCE_ALWAYS_ON + 4; source++){
+		dma_request(source);
+	}
+}
+
+/**
+ * \fn		uint64_t adc_conversion_cycles
+ * \param	N/A
+ * \return	Core clock cycles for one conversion with the current configuration
+ * \brief   Conversion time per the KL25 reference manual: single-first-conversion adder,
+ * 			base conversion time, long sample adder, times the hardware average count
+ */
+static uint64_t adc_conversion_cycles(void)
+{
+	static const uint32_t bct[4] = { 17, 20, 20, 25 };
+	static const uint32_t lst[4] = { 20, 12, 6, 2 };
+	uint32_t cfg1 = v_adc->CFG1;
+	uint32_t cfg2 = v_adc->CFG2;
+	uint32_t sc3 = v_adc->SC3;
+	uint64_t adck_hz;
+	uint32_t adck;
+	uint32_t avg = 1;
+
+	switch((cfg1 & ADC_CFG1_ADICLK_MASK) >> ADC_CFG1_ADICLK_SHIFT){
+	case 0:
+		adck_hz = SIM_BUS_CLOCK_HZ;
+		break;
+	case 1:
+		adck_hz = SIM_BUS_CLOCK_HZ / 2;
+		break;
+	case 2:
+		adck_hz = 8000000;		/* OSCERCLK */
+		break;
+	default:
+		adck_hz = 4000000;		/* ADACK, typical */
+		break;
+	}
+	adck_hz >>= (cfg1 & ADC_CFG1_ADIV_MASK) >> ADC_CFG1_ADIV_SHIFT;
+
+	if(sc3 & ADC_SC3_AVGE_MASK){
+		avg = 4u << ((sc3 & ADC_SC3_AVGS_MASK) >> ADC_SC3_AVGS_SHIFT);
+	}
+	adck = bct[(cfg1 & ADC_CFG1_MODE_MASK) >> ADC_CFG1_MODE_SHIFT];
+	if(cfg1 & ADC_CFG1_ADLSMP_MASK){
+		adck += lst[(cfg2 & ADC_CFG2_ADLSTS_MASK) >> ADC_CFG2_ADLSTS_SHIFT];
+	}
+	adck = 3 + avg * adck;
+
+	return (adck * SIM_CORE_CLOCK_HZ) / adck_hz + 5 * (SIM_CORE_CLOCK_HZ / SIM_BUS_CLOCK_HZ);
+}
+
+/**
+ * \fn		void adc_start
+ * \param	N/A
+ * \return	N/A
+ * \brief   Begins a conversion on SC1[0]
+ */
+static void adc_start(void)
+{
+	adc_busy = true;
+	adc_remaining = (int64_t)adc_conversion_cycles();
+}
+
+/**
+ * \fn		uint64_t adc_sw_period
+ * \param	N/A
+ * \return	Core clock cycles between back-to-back software-triggered conversions
+ * \brief   TPM1's overflow period, which the firmware runs at SAMPLE_RATE_ADC_HZ, or the
+ * 			conversion time while TPM1 is stopped
+ */
+static uint64_t adc_sw_period(void)
+{
+	uint32_t sc = v_tpm[1]->SC;
+	uint64_t counts = (uint64_t)((v_tpm[1]->MOD & TPM_MOD_MOD_MASK) + 1) <<
+			((sc & TPM_SC_PS_MASK) >> TPM_SC_PS_SHIFT);
+
+	if(!(v_sim->SCGC6 & SIM_SCGC6_TPM1_MASK) ||
+	   !(v_sim->SOPT2 & SIM_SOPT2_TPMSRC_MASK) ||
+	   (((sc & TPM_SC_CMOD_MASK) >> TPM_SC_CMOD_SHIFT) != 1)){
+		return adc_conversion_cycles();
+	}
+	return counts * SIM_CORE_CLOCK_HZ / sim_periph_hz;
+}
+
+/**
+ * \fn		bool adc_hold
+ * \param	N/A
+ * \return	true while simulated time has to wait for the firmware's next polled conversion
+ * \brief   Called by the simulator thread before each step
+ */
+static bool adc_hold(void)
+{
+	bool hold;
+
+	lock();
+	hold = adc_sw_paced && !adc_sw_trigger && !adc_busy && (sim_stats.cycles >= adc_sw_due);
+	if(hold && (wall_ns() - adc_sw_wall > SIM_ADC_HOLD_NS)){
+		adc_sw_paced = false;
+		hold = false;
+	}
+	unlock();
+	return hold;
+}
+
+/**
+ * \fn		void adc_complete
+ * \param	N/A
+ * \return	N/A
+ * \brief   Samples the selected input, loads R[0] and raises COCO plus its interrupt/DMA request
+ */
+static void adc_complete(void)
+{
+	uint32_t sc1 = v_adc->SC1[0];
+	uint32_t ch = (sc1 & ADC_SC1_ADCH_MASK) >> ADC_SC1_ADCH_SHIFT;
+	int32_t v;
+
+	if(analog_fn[ch]){
+		v = analog_fn[ch](ch, sim_stats.cycles, analog_ctx[ch]);
+	}
+	else if(ch == ADCH_DAC0){
+		v = sim_dac_output();
+	}
+	else{
+		v = 0x8000;
+	}
+
+	if(sim_adc_noise){
+		v += (int32_t)(rand() % (2 * sim_adc_noise + 1)) - (int32_t)sim_adc_noise;
+		v = (v < 0) ? 0 : ((v > 0xFFFF) ? 0xFFFF : v);
+	}
+
+	/**
+	 * Scale to the conversion mode: 8, 12, 10 or 16 bits
+	 */
+	switch((v_adc->CFG1 & ADC_CFG1_MODE_MASK) >> ADC_CFG1_MODE_SHIFT){
+	case 0:
+		v >>= 8;
+		break;
+	case 1:
+		v >>= 4;
+		break;
+	case 2:
+		v >>= 6;
+		break;
+	default:
+		break;
+	}
+
+	/**
+	 * R[0] is read-only to the firmware, but it is hardware's to write
+	 */
+	*(volatile uint32_t *)&v_adc->R[0] = (uint32_t)v;
+	v_adc->SC1[0] = sc1 | ADC_SC1_COCO_MASK;
+	adc_busy = false;
+	sim_stats.adc_conversions++;
+	if(adc_sw_paced){
+		adc_sw_wall = wall_ns();
+	}
+
+	if(sc1 & ADC_SC1_AIEN_MASK){
+		pend_irq(ADC0_IRQn);
+	}
+	if(v_adc->SC2 & ADC_SC2_DMAEN_MASK){
+		dma_request(DMAMUX_SOURCE_ADC0);
+	}
+	if(v_adc->SC3 & ADC_SC3_ADCO_MASK){
+		adc_start();
+	}
+}
+
+/**
+ * \fn		void adc_hw_trigger
+ * \param	N/A
+ * \return	N/A
+ * \brief   A hardware trigger event arrived (only honored with SC2[ADTRG] set)
+ */
+static void adc_hw_trigger(void)
+{
+	if((v_sim->SCGC6 & SIM_SCGC6_ADC0_MASK) &&
+	   (v_adc->SC2 & ADC_SC2_ADTRG_MASK) &&
+	   (((v_adc->SC1[0] & ADC_SC1_ADCH_MASK) >> ADC_SC1_ADCH_SHIFT) != ADCH_DISABLED)){
+		adc_start();
+	}
+}
+
+/**
+ * \fn		void step_adc
+ * \param	uint32_t cycles
+ * \return	N/A
+ * \brief   Starts software-triggered conversions and finishes the one in flight
+ */
+static void step_adc(uint32_t cycles)
+{
+	if(!(v_sim->SCGC6 & SIM_SCGC6_ADC0_MASK)){
+		return;
+	}
+
+	/**
+	 * A trigger that follows the last conversion waits for its slot
+	 */
+	if(adc_sw_trigger && (!adc_sw_paced || (sim_stats.cycles >= adc_sw_due))){
+		if(adc_sw_paced){
+			sim_stats.adc_paced++;
+			adc_sw_due += adc_sw_period();
+		}
+		if(!adc_sw_paced || (adc_sw_due <= sim_stats.cycles)){
+			adc_sw_due = sim_stats.cycles + adc_sw_period();
+		}
+		adc_sw_trigger = false;
+		adc_sw_paced = true;
+		adc_sw_wall = wall_ns();
+		adc_start();
+	}
+
+	if(adc_busy){
+		adc_remaining -= cycles;
+		if(adc_remaining <= 0){
+			adc_complete();
+		}
+	}
+}
+
+/**
+ * \fn		void tpm_overflow
+ * \param	uint32_t i TPM instance
+ * \return	N/A
+ * \brief   Sets TOF and fans the overflow out to DMA, NVIC and the ADC trigger mux
+ */
+static void tpm_overflow(uint32_t i)
+{
+	uint32_t sc = v_tpm[i]->SC | TPM_SC_TOF_MASK;
+	uint32_t sopt7 = v_sim->SOPT7;
+
+	sim_stats.tpm_overflows[i]++;
+
+	/**
+	 * With SC[DMA] set, the DMA acknowledge clears TOF
+	 */
+	if((sc & TPM_SC_DMA_MASK) && dma_request(DMAMUX_SOURCE_TPM_OVERFLOW + i)){
+		sc &= ~TPM_SC_TOF_MASK;
+	}
+	v_tpm[i]->SC = sc;
+	if(sc & TPM_SC_TOF_MASK){
+		v_tpm[i]->STATUS |= TPM_STATUS_TOF_MASK;
+	}
+
+	if(sc & TPM_SC_TOIE_MASK){
+		pend_irq((IRQn_Type)(TPM0_IRQn + i));
+	}
+	if((sopt7 & SIM_SOPT7_ADC0ALTTRGEN_MASK) &&
+	   (((sopt7 & SIM_SOPT7_ADC0TRGSEL_MASK) >> SIM_SOPT7_ADC0TRGSEL_SHIFT) == ADC0TRGSEL_TPM_OVERFLOW + i)){
+		adc_hw_trigger();
+	}
+}
+
+/**
+ * \fn		void tpm_channel_match
+ * \param	uint32_t i TPM instance
+ * \param	uint32_t ch Channel
+ * \return	N/A
+ * \brief   Sets CHF and fans the match out to DMA and NVIC
+ */
+static void tpm_channel_match(uint32_t i, uint32_t ch)
+{
+	uint32_t cnsc = v_tpm[i]->CONTROLS[ch].CnSC | TPM_CnSC_CHF_MASK;
+	uint32_t source = (i == 0) ? (DMAMUX_SOURCE_TPM0_CH + ch) : (DMAMUX_SOURCE_TPM1_CH + 2 * (i - 1) + ch);
+
+	if((cnsc & TPM_CnSC_DMA_MASK) && dma_request(source)){
+		cnsc &= ~TPM_CnSC_CHF_MASK;
+	}
+	v_tpm[i]->CONTROLS[ch].CnSC = cnsc;
+	if(cnsc & TPM_CnSC_CHF_MASK){
+		v_tpm[i]->STATUS |= (1u << ch);
+	}
+	if(cnsc & TPM_CnSC_CHIE_MASK){
+		pend_irq((IRQn_Type)(TPM0_IRQn + i));
+	}
+}
+
+/**
+ * \fn		void tpm_count
+ * \param	uint32_t i TPM instance
+ * \param	uint32_t from Counter value already reached
+ * \param	uint32_t to Counter value reached now, to >= from
+ * \param	bool from_reload true if the counter just reloaded to 0 (so 0 itself matches)
+ * \return	N/A
+ * \brief   Raises channel matches for CnV in (from, to]
+ */
+static void tpm_count(uint32_t i, uint32_t from, uint32_t to, bool from_reload)
+{
+	uint32_t channels = (i == 0) ? TPM_CHANNELS : 2;
+
+	for(uint32_t ch = 0; ch < channels; ch++){
+		uint32_t cnv = v_tpm[i]->CONTROLS[ch].CnV & TPM_CnV_VAL_MASK;
+
+		if((v_tpm[i]->CONTROLS[ch].CnSC & TPM_CnSC_MODE_MASK) &&
+		   (((cnv > from) || (from_reload && (cnv == from))) && (cnv <= to))){
+			tpm_channel_match(i, ch);
+		}
+	}
+}
+
+/**
+ * \fn		void step_tpm
+ * \param	uint32_t i TPM instance
+ * \param	uint32_t cycles
+ * \return	N/A
+ * \brief   Advances an up-counting TPM by the prescaled number of counter clocks
+ */
+static void step_tpm(uint32_t i, uint32_t cycles)
+{
+	static const uint32_t gate[3] = { SIM_SCGC6_TPM0_MASK, SIM_SCGC6_TPM1_MASK, SIM_SCGC6_TPM2_MASK };
+	uint32_t sc = v_tpm[i]->SC;
+	uint32_t ps = (sc & TPM_SC_PS_MASK) >> TPM_SC_PS_SHIFT;
+	uint32_t mod;
+	uint32_t cnt;
+	uint32_t ticks;
+	uint32_t to_overflow;
+
+	if(!(v_sim->SCGC6 & gate[i]) ||
+	   !(v_sim->SOPT2 & SIM_SOPT2_TPMSRC_MASK) ||
+	   (((sc & TPM_SC_CMOD_MASK) >> TPM_SC_CMOD_SHIFT) != 1)){
+		return;
+	}
+
+	tpm_prescale_acc[i] += (uint64_t)cycles * sim_periph_hz;
+	ticks = (uint32_t)(tpm_prescale_acc[i] / ((uint64_t)SIM_CORE_CLOCK_HZ << ps));
+	tpm_prescale_acc[i] %= (uint64_t)SIM_CORE_CLOCK_HZ << ps;
+
+	mod = v_tpm[i]->MOD & TPM_MOD_MOD_MASK;
+	cnt = v_tpm[i]->CNT & TPM_CNT_COUNT_MASK;
+	while(ticks){
+
+		/**
+		 * Overflow happens when the counter steps past MOD. If CNT is already above MOD
+		 * it first rolls over 0xFFFF without setting TOF
+		 */
+		to_overflow = (cnt <= mod) ? (mod - cnt + 1) : ((TPM_CNT_COUNT_MASK + 1) - cnt + mod + 1);
+		if(ticks >= to_overflow){
+			if(cnt <= mod){
+				tpm_count(i, cnt, mod, false);
+			}
+			ticks -= to_overflow;
+			cnt = 0;
+			v_tpm[i]->CNT = 0;
+			tpm_overflow(i);
+			tpm_count(i, 0, 0, true);
+			mod = v_tpm[i]->MOD & TPM_MOD_MOD_MASK;
+		}
+		else{
+			if(cnt + ticks <= TPM_CNT_COUNT_MASK){
+				tpm_count(i, cnt, cnt + ticks, false);
+			}
+			cnt = (cnt + ticks) & TPM_CNT_COUNT_MASK;
+			ticks = 0;
+		}
+	}
+	v_tpm[i]->CNT = cnt;
+}
+
+/**
+ * \fn		void uart_receive
+ * \param	uint32_t cycles
+ * \return	N/A
+ * \brief   Feeds stdin to the receiver, at most one character per character time and
+ * 			never waiting for input. Reading D can't be trapped, so RDRF clears once the
+ * 			interrupt it raised has been taken; a character arriving before then is
+ * 			an overrun
+ */
+static void uart_receive(uint32_t cycles)
+{
+	struct pollfd pfd = { .fd = STDIN_FILENO, .events = POLLIN };
+	uint8_t c;
+	ssize_t n;
+
+	if(uart_rx_pended && !(nvic_pending & (1u << UART0_IRQn))){
+		uart_rx_pended = false;
+		v_uart0->S1 &= ~UART0_S1_RDRF_MASK;
+	}
+	if(uart_rx_eof || !(v_uart0->C2 & UART0_C2_RE_MASK) || !(v_sim->SCGC4 & SIM_SCGC4_UART0_MASK) ||
+	   (uart_char_cycles() == 0)){
+		return;
+	}
+	uart_rx_remaining -= cycles;
+	if(uart_rx_remaining > 0){
+		return;
+	}
+	uart_rx_remaining = (int64_t)uart_char_cycles();
+
+	if(poll(&pfd, 1, 0) <= 0){
+		return;
+	}
+	n = read(STDIN_FILENO, &c, 1);
+	if(n <= 0){
+		uart_rx_eof = (n == 0) || (errno != EINTR && errno != EAGAIN);
+		return;
+	}
+	sim_stats.uart_rx_bytes++;
+	if(v_uart0->S1 & UART0_S1_RDRF_MASK){
+		v_uart0->S1 |= UART0_S1_OR_MASK;
+		return;
+	}
+	uart_rx_data = c;
+	v_uart0->D = c;
+	v_uart0->S1 |= UART0_S1_RDRF_MASK;
+}
+
+/**
+ * \fn		void step_uart
+ * \param	uint32_t cycles
+ * \return	N/A
+ * \brief   Shifts UART0 characters in and out and raises its interrupts. Like the
+ * 			hardware, the interrupt stays requested for as long as TDRE/TC/RDRF and
+ * 			their enables are set
+ */
+static void step_uart(uint32_t cycles)
+{
+	uint32_t c2 = v_uart0->C2;
+
+	uart_receive(cycles);
+
+	if(uart_shifting){
+		uart_remaining -= cycles;
+		if(uart_remaining <= 0){
+			if(!(v_uart0->S1 & UART0_S1_TDRE_MASK)){
+				uart_remaining += (int64_t)uart_char_cycles();
+				uart_emit(uart_tx_data);
+				v_uart0->S1 |= UART0_S1_TDRE_MASK;
+			}
+			else{
+				uart_shifting = false;
+				v_uart0->S1 |= UART0_S1_TC_MASK;
+				uart_flush();
+			}
+		}
+	}
+
+	/**
+	 * With C5[TDMAE] set, TDRE requests the DMA. A request that finds the shifter idle
+	 * leaves TDRE set, so the data register is filled by a second one
+	 */
+	for(uint32_t i = 0; i < 2; i++){
+		if(!(v_uart0->C5 & UART0_C5_TDMAE_MASK) || !(v_uart0->S1 & UART0_S1_TDRE_MASK) ||
+		   !dma_request(DMAMUX_SOURCE_UART0_TX)){
+			break;
+		}
+	}
+
+	if((c2 & UART0_C2_RIE_MASK) && (v_uart0->S1 & UART0_S1_RDRF_MASK)){
+		uart_rx_pended = true;
+		pend_irq(UART0_IRQn);
+	}
+	if(((c2 & UART0_C2_TIE_MASK) && (v_uart0->S1 & UART0_S1_TDRE_MASK)) ||
+	   ((c2 & UART0_C2_TCIE_MASK) && (v_uart0->S1 & UART0_S1_TC_MASK))){
+		pend_irq(UART0_IRQn);
+	}
+}
+
+/**
+ * \fn		void step_systick
+ * \param	uint32_t cycles
+ * \return	N/A
+ * \brief   Advances the 24-bit SysTick down counter
+ */
+static void step_systick(uint32_t cycles)
+{
+	uint32_t ctrl = v_systick->CTRL;
+	uint32_t div = (ctrl & SysTick_CTRL_CLKSOURCE_Msk) ? 1 : SYSTICK_EXT_CLOCK_DIV;
+	uint32_t load = v_systick->LOAD & SysTick_LOAD_RELOAD_Msk;
+	uint32_t val = v_systick->VAL & SysTick_VAL_CURRENT_Msk;
+	uint32_t ticks;
+
+	if(!(ctrl & SysTick_CTRL_ENABLE_Msk)){
+		return;
+	}
+
+	systick_acc += (uint64_t)cycles * sim_core_hz;
+	ticks = (uint32_t)(systick_acc / ((uint64_t)SIM_CORE_CLOCK_HZ * div));
+	systick_acc %= (uint64_t)SIM_CORE_CLOCK_HZ * div;
+
+	while(ticks){
+
+		/**
+		 * The clock after reaching 0 reloads from LOAD
+		 */
+		if(val == 0){
+			if(load == 0){
+				break;
+			}
+			val = load;
+			ticks--;
+		}
+		else if(ticks >= val){
+			ticks -= val;
+			val = 0;
+			v_systick->CTRL |= SysTick_CTRL_COUNTFLAG_Msk;
+			sim_stats.systick_count++;
+			if(ctrl & SysTick_CTRL_TICKINT_Msk){
+				pend_irq(SysTick_IRQn);
+			}
+		}
+		else{
+			val -= ticks;
+			ticks = 0;
+		}
+	}
+	v_systick->VAL = val;
+}
+
+/**
+ * \fn		int irq_to_dispatch
+ * \param	N/A
+ * \return	Highest priority pending and enabled exception as an IRQn, or NotAvail_IRQn
+ * \brief   Lower priority values win; on a tie the lower exception number wins
+ */
+static int irq_to_dispatch(void)
+{
+	int best = NotAvail_IRQn;
+	uint32_t best_prio = UINT32_MAX;
+	uint32_t ready = nvic_pending & nvic_enabled;
+
+	if(systick_pending){
+		best = SysTick_IRQn;
+		best_prio = NVIC_GetPriority(SysTick_IRQn);
+	}
+	for(int irq = 0; irq < SIM_NUM_IRQS; irq++){
+		if((ready & (1u << irq)) && (NVIC_GetPriority((IRQn_Type)irq) < best_prio)){
+			best = irq;
+			best_prio = NVIC_GetPriority((IRQn_Type)irq);
+		}
+	}
+	return best;
+}
+
+/**
+ * \fn		void sim_irq_signal
+ * \param	int sig
+ * \return	N/A
+ * \brief   Runs on the firmware thread: takes the pending exceptions in priority order,
+ * 			like the NVIC would on exception entry, then hands control back
+ */
+static void sim_irq_signal(int sig)
+{
+	int irq;
+	uint64_t start;
+
+	(void)sig;
+	while((irq = irq_to_dispatch()) != NotAvail_IRQn){
+		start = wall_ns();
+		v_scb->ICSR = (v_scb->ICSR & ~SCB_ICSR_VECTACTIVE_Msk) | (uint32_t)(irq + 16);
+		if(irq == SysTick_IRQn){
+			systick_pending = false;
+			mirror_nvic();
+			SysTick_Handler();
+		}
+		else{
+			nvic_pending &= ~(1u << irq);
+			mirror_nvic();
+			sim_stats.irq_count[irq]++;
+			if(sim_vectors[irq]){
+				sim_vectors[irq]();
+			}
+			else{
+				sim_default_handler();
+			}
+		}
+		v_scb->ICSR &= ~SCB_ICSR_VECTACTIVE_Msk;
+		sim_stats.isr_wall_ns += wall_ns() - start;
+	}
+
+	if(exit_request){
+		uart_flush();
+		sim_report();
+		exit(EXIT_SUCCESS);
+	}
+	sem_post(&irq_done);
+}
+
+/**
+ * \fn		void deliver_irqs
+ * \param	N/A
+ * \return	N/A
+ * \brief   Interrupts the firmware thread and waits until its handlers have returned.
+ * 			Simulated time stands still while ISRs run, as it would from the point of
+ * 			view of code the ISR preempted
+ */
+static void deliver_irqs(void)
+{
+	if(!systick_pending && !(nvic_pending & nvic_enabled) && !exit_request){
+		return;
+	}
+
+	pthread_kill(firmware_thread, SIGUSR1);
+	while((sem_wait(&irq_done) != 0) && (errno == EINTR));
+}
+
+/**
+ * \fn		void sim_step
+ * \param	uint32_t cycles
+ * \return	N/A
+ * \brief   Advances every modeled peripheral by a number of core clock cycles
+ */
+static void sim_step(uint32_t cycles)
+{
+	lock();
+	step_dma();
+	for(uint32_t i = 0; i < 3; i++){
+		step_tpm(i, cycles);
+	}
+	step_systick(cycles);
+	step_adc(cycles);
+	step_uart(cycles);
+	__atomic_store_n(&sim_stats.cycles, sim_stats.cycles + cycles, __ATOMIC_RELAXED);
+	unlock();
+	deliver_irqs();
+}
+
+/**
+ * \fn		void *sim_main
+ * \param	void *arg
+ * \return	N/A
+ * \brief   The simulator thread: keeps simulated time paced against wall-clock time
+ */
+static void *sim_main(void *arg)
+{
+	sigset_t set;
+	uint64_t start = wall_ns();
+	uint64_t target;
+	uint64_t held;
+
+	/**
+	 * Interrupts are for the firmware thread only
+	 */
+	sigemptyset(&set);
+	sigaddset(&set, SIGUSR1);
+	pthread_sigmask(SIG_BLOCK, &set, NULL);
+
+	(void)arg;
+	while(sim_stats.cycles < sim_end_cycles){
+
+		/**
+		 * While the firmware polls the ADC, adc_hold() paces simulated time instead
+		 */
+		if((sim_speed > 0) && !adc_sw_paced){
+			target = (uint64_t)((double)(wall_ns() - start) * sim_speed * SIM_CORE_CLOCK_HZ / NSEC_PER_SEC);
+			if(target > sim_end_cycles){
+				target = sim_end_cycles;
+			}
+			if(sim_stats.cycles >= target){
+				usleep(50);
+				continue;
+			}
+		}
+		else{
+			target = sim_stats.cycles + SIM_STEP_CYCLES;
+		}
+		while(sim_stats.cycles < target){
+
+			/**
+			 * Time spent holding for the firmware doesn't count against SIM_SPEED
+			 */
+			if(adc_hold()){
+				held = wall_ns();
+				while(adc_hold()){
+					sched_yield();
+				}
+				held = wall_ns() - held;
+				sim_stats.adc_hold_ns += held;
+				start += held;
+				continue;
+			}
+			sim_step(SIM_STEP_CYCLES);
+		}
+	}
+
+	exit_request = 1;
+	deliver_irqs();
+	return NULL;
+}
+
+#if defined(__x86_64__)
+
+/**
+ * \fn		void sim_segv_signal
+ * \param	int sig
+ * \param	siginfo_t *info
+ * \param	void *ctx
+ * \return	N/A
+ * \brief   A store to a trapped page: remember the old word, open the page and
+ * 			single-step the store. Interrupts stay masked until the step completes
+ */
+static void sim_segv_signal(int sig, siginfo_t *info, void *ctx)
+{
+	ucontext_t *uc = ctx;
+	uintptr_t addr = (uintptr_t)info->si_addr;
+
+	trap_page = NULL;
+	for(size_t i = 0; i < sizeof(sim_traps) / sizeof(sim_traps[0]); i++){
+		if((addr & ~(uintptr_t)(SIM_PAGE_SIZE - 1)) == sim_traps[i].page){
+			trap_page = &sim_traps[i];
+		}
+	}
+	if(!trap_page || !pthread_equal(pthread_self(), firmware_thread)){
+		signal(sig, SIG_DFL);
+		return;
+	}
+
+	lock();
+	trap_store_addr = addr;
+	trap_addr = addr & ~(uintptr_t)3;
+	trap_old = *(volatile uint32_t *)trap_addr;
+	mprotect((void *)trap_page->page, SIM_PAGE_SIZE, PROT_READ | PROT_WRITE);
+
+	trap_usr1_was_blocked = sigismember(&uc->uc_sigmask, SIGUSR1);
+	sigaddset(&uc->uc_sigmask, SIGUSR1);
+	uc->uc_mcontext.gregs[REG_EFL] |= EFLAGS_TF;
+}
+
+/**
+ * \fn		void sim_trap_signal
+ * \param	int sig
+ * \param	siginfo_t *info
+ * \param	void *ctx
+ * \return	N/A
+ * \brief   The trapped store has executed: let the block's hook apply its semantics
+ */
+static void sim_trap_signal(int sig, siginfo_t *info, void *ctx)
+{
+	ucontext_t *uc = ctx;
+
+	(void)sig;
+	(void)info;
+	uc->uc_mcontext.gregs[REG_EFL] &= ~EFLAGS_TF;
+	if(!trap_page){
+		return;
+	}
+
+	trap_page->hook(trap_addr, trap_old, sim_view(trap_addr));
+	mprotect((void *)trap_page->page, SIM_PAGE_SIZE, PROT_READ);
+	trap_page = NULL;
+	unlock();
+	if(trap_yield){
+		trap_yield = false;
+		sched_yield();
+	}
+
+	if(!trap_usr1_was_blocked){
+		sigdelset(&uc->uc_sigmask, SIGUSR1);
+	}
+}
+
+#endif /* __x86_64__ */
+
+void sim_report(void)
+{
+	static const char * const irq_names[SIM_NUM_IRQS] = {
+		[DMA0_IRQn] = "DMA0", [DMA1_IRQn] = "DMA1", [DMA2_IRQn] = "DMA2", [DMA3_IRQn] = "DMA3",
+		[FTFA_IRQn] = "FTFA", [UART0_IRQn] = "UART0", [ADC0_IRQn] = "ADC0",
+		[TPM0_IRQn] = "TPM0", [TPM1_IRQn] = "TPM1", [TPM2_IRQn] = "TPM2",
+		[DAC0_IRQn] = "DAC0", [LPTMR0_IRQn] = "LPTMR0",
+	};
+	struct timespec now;
+	struct timespec cpu = { 0, 0 };
+	clockid_t cpu_clock;
+	uint64_t isrs = sim_stats.systick_count;
+	double simulated;
+	double wall;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	if(pthread_getcpuclockid(firmware_thread, &cpu_clock) == 0){
+		clock_gettime(cpu_clock, &cpu);
+	}
+
+	simulated = (double)sim_stats.cycles / SIM_CORE_CLOCK_HZ;
+	wall = (now.tv_sec - wall_start.tv_sec) + (now.tv_nsec - wall_start.tv_nsec) / 1e9;
+
+	fprintf(stderr, "\r\n==== sim report ====\r\n");
+	fprintf(stderr, "simulated time   : %.3f s (%llu cycles)\r\n", simulated, (unsigned long long)sim_stats.cycles);
+	fprintf(stderr, "wall time        : %.3f s\r\n", wall);
+	if((sim_speed > 0) && (simulated < 0.9 * (wall - sim_stats.adc_hold_ns / 1e9) * sim_speed)){
+
+		/**
+		 * Catching up, the simulator thread crowds out the firmware's main loop, which
+		 * then looks much slower than a 48 MHz Cortex-M0+
+		 */
+		fprintf(stderr, "warning          : simulator fell behind SIM_SPEED=%g, main loop timing is pessimistic\r\n",
+				sim_speed);
+	}
+	fprintf(stderr, "firmware CPU time: %.3f s\r\n", cpu.tv_sec + cpu.tv_nsec / 1e9);
+	for(uint32_t i = 0; i < 3; i++){
+		fprintf(stderr, "TPM%u overflows   : %llu\r\n", i, (unsigned long long)sim_stats.tpm_overflows[i]);
+	}
+	for(uint32_t ch = 0; ch < 4; ch++){
+		if(sim_stats.dma_transfers[ch]){
+			fprintf(stderr, "DMA%u transfers   : %llu (%llu major loops)\r\n", ch,
+					(unsigned long long)sim_stats.dma_transfers[ch],
+					(unsigned long long)sim_stats.dma_done[ch]);
+		}
+	}
+	fprintf(stderr, "DAC DMA writes   : %llu\r\n", (unsigned long long)sim_stats.dac_updates);
+	fprintf(stderr, "ADC conversions  : %llu\r\n", (unsigned long long)sim_stats.adc_conversions);
+	if(sim_stats.adc_paced){
+		fprintf(stderr, "polled ADC paced : %llu, held %.3f s of wall time\r\n",
+				(unsigned long long)sim_stats.adc_paced, sim_stats.adc_hold_ns / 1e9);
+	}
+	if(sim_stats.uart_tx_bytes){
+		fprintf(stderr, "UART0 TX bytes   : %llu\r\n", (unsigned long long)sim_stats.uart_tx_bytes);
+	}
+	if(sim_stats.wfi_count){
+		fprintf(stderr, "WFI sleeps       : %llu\r\n", (unsigned long long)sim_stats.wfi_count);
+	}
+	if(sim_stats.uart_rx_bytes){
+		fprintf(stderr, "UART0 RX bytes   : %llu\r\n", (unsigned long long)sim_stats.uart_rx_bytes);
+	}
+	fprintf(stderr, "SysTick wraps    : %llu\r\n", (unsigned long long)sim_stats.systick_count);
+	for(int irq = 0; irq < SIM_NUM_IRQS; irq++){
+		if(sim_stats.irq_count[irq]){
+			fprintf(stderr, "%-6s IRQs      : %llu\r\n", irq_names[irq] ? irq_names[irq] : "IRQ",
+					(unsigned long long)sim_stats.irq_count[irq]);
+			isrs += sim_stats.irq_count[irq];
+		}
+	}
+	if(isrs){
+		fprintf(stderr, "avg ISR wall time: %.0f ns\r\n", (double)sim_stats.isr_wall_ns / isrs);
+	}
+}
+
+/**
+ * \fn		void sim_map
+ * \param	sim_region_t *r
+ * \return	N/A
+ * \brief   Backs a region with a memfd mapped at its real address and at a simulator view
+ */
+static void sim_map(sim_region_t *r)
+{
+	int fd = memfd_create("kl25z", 0);
+	void *p;
+
+	if((fd < 0) || (ftruncate(fd, (off_t)r->size) != 0)){
+		fprintf(stderr, "sim: memfd: %s\r\n", strerror(errno));
+		exit(EXIT_FAILURE);
+	}
+
+	p = mmap((void *)r->base, r->size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED_NOREPLACE, fd, 0);
+	if((p == MAP_FAILED) || ((uintptr_t)p != r->base)){
+		fprintf(stderr, "sim: cannot map peripheral space at 0x%08lx: %s\r\n",
+				(unsigned long)r->base, strerror(errno));
+		exit(EXIT_FAILURE);
+	}
+
+	r->view = mmap(NULL, r->size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if(r->view == MAP_FAILED){
+		fprintf(stderr, "sim: cannot map simulator view: %s\r\n", strerror(errno));
+		exit(EXIT_FAILURE);
+	}
+	close(fd);
+}
+
+/**
+ * \fn		void sim_reset
+ * \param	N/A
+ * \return	N/A
+ * \brief   Loads reset values that differ from 0 into the register blocks
+ */
+static void sim_reset(void)
+{
+	v_adc->SC1[0] = ADC_SC1_ADCH(ADCH_DISABLED);
+	v_adc->SC1[1] = ADC_SC1_ADCH(ADCH_DISABLED);
+	for(uint32_t i = 0; i < 3; i++){
+		v_tpm[i]->MOD = TPM_MOD_MOD_MASK;
+	}
+	v_uart0->BDL = UART0_BDL_SBR(4);
+	v_uart0->C4 = UART0_C4_OSR(15);
+	v_uart0->S1 = UART0_S1_TDRE_MASK | UART0_S1_TC_MASK;
+	*(volatile uint8_t *)sim_view((uintptr_t)&SMC->PMSTAT) = SMC_PMSTAT_PMSTAT(1);
+}
+
+/**
+ * \fn		void sim_init
+ * \param	N/A
+ * \return	N/A
+ * \brief   Runs before the firmware's main(): maps the peripheral address space, loads
+ * 			reset values, arms the write traps and starts the simulator thread
+ */
+__attribute__((constructor)) static void sim_init(void)
+{
+	struct sigaction sa;
+	const char *env;
+	double seconds = 5.0;
+
+	for(size_t i = 0; i < sizeof(sim_regions) / sizeof(sim_regions[0]); i++){
+		sim_map(&sim_regions[i]);
+	}
+	v_sim = sim_view((uintptr_t)SIM);
+	v_adc = sim_view((uintptr_t)ADC0);
+	v_dac = sim_view((uintptr_t)DAC0);
+	v_dma = sim_view((uintptr_t)DMA0);
+	v_dmamux = sim_view((uintptr_t)DMAMUX0);
+	v_tpm[0] = sim_view((uintptr_t)TPM0);
+	v_tpm[1] = sim_view((uintptr_t)TPM1);
+	v_tpm[2] = sim_view((uintptr_t)TPM2);
+	v_systick = sim_view((uintptr_t)SysTick);
+	v_nvic = sim_view((uintptr_t)NVIC);
+	v_scb = sim_view((uintptr_t)SCB);
+	v_uart0 = sim_view((uintptr_t)UART0);
+	sim_reset();
+
+	if((env = getenv("SIM_SECONDS")) != NULL){
+		seconds = atof(env);
+	}
+	if((env = getenv("SIM_SPEED")) != NULL){
+		sim_speed = atof(env);
+	}
+	if((env = getenv("SIM_ADC_NOISE")) != NULL){
+		sim_adc_noise = (uint32_t)atoi(env);
+	}
+	sim_end_cycles = (uint64_t)(seconds * SIM_CORE_CLOCK_HZ);
+
+	firmware_thread = pthread_self();
+	sem_init(&irq_done, 0, 0);
+	memset(&sa, 0, sizeof(sa));
+	sa.sa_handler = sim_irq_signal;
+	sa.sa_flags = SA_RESTART;
+	sigemptyset(&sa.sa_mask);
+	sigaction(SIGUSR1, &sa, NULL);
+
+#if defined(__x86_64__)
+	memset(&sa, 0, sizeof(sa));
+	sa.sa_sigaction = sim_segv_signal;
+	sa.sa_flags = SA_SIGINFO | SA_RESTART;
+	sigemptyset(&sa.sa_mask);
+	sigaddset(&sa.sa_mask, SIGUSR1);
+	sigaction(SIGSEGV, &sa, NULL);
+	sa.sa_sigaction = sim_trap_signal;
+	sigaction(SIGTRAP, &sa, NULL);
+
+	for(size_t i = 0; i < sizeof(sim_traps) / sizeof(sim_traps[0]); i++){
+		mprotect((void *)sim_traps[i].page, SIM_PAGE_SIZE, PROT_READ);
+	}
+#endif
+
+	setvbuf(stdout, NULL, _IOLBF, 0);
+	clock_gettime(CLOCK_MONOTONIC, &wall_start);
+	if(pthread_create(&sim_thread, NULL, sim_main, NULL) != 0){
+		fprintf(stderr, "sim: cannot start simulator thread\r\n");
+		exit(EXIT_FAILURE);
+	}
+}
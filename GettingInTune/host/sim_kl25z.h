@@ -0,0 +1,218 @@
+/**
+ * \file    sim_kl25z.h
+ * \author	Dayton Flores (dafl2542@colorado.edu)
+ * \date	10/19/2026
+ * \brief   Host-side register simulator for the KL25Z peripherals used by the firmware
+ * \detail
+ * 		The firmware in source/ is compiled unchanged for Linux. Instead of redirecting
+ * 		ADC0, DAC0, DMA0, TPM0, SysTick, ... to new symbols, the simulator maps host memory
+ * 		at the real peripheral base addresses from MKL25Z4.h and core_cm0plus.h, so every
+ * 		register access in the firmware lands in a simulated register block.
+ *
+ * 		A simulator thread then steps a cycle-based model of the peripherals:
+ * 			- TPM0/1/2 count on the prescaled TPM clock and set TOF on overflow
+ * 			- TPM overflow raises DMA requests (DMAMUX sources 54-56) and ADC hardware triggers
+ * 			- DMA channels move data between SAR and DAR (e.g. dac_buffer into DAC0->DAT[0])
+ * 			- DAC0 output is looped back to ADC0 input channel 23 (PTE30)
+ * 			- ADC0 converts on software or hardware trigger with a realistic conversion time.
+ * 			  Back-to-back software triggers are paced one TPM1 period apart (see below)
+ * 			- SysTick counts down and raises its exception
+ * 			- UART0 shifts out characters at its programmed baud rate onto stdout, written by
+ * 			  the CPU or, with C5[TDMAE], pulled by the DMA (DMAMUX source 3)
+ * 			- UART0 receives stdin, one character per character time while C2[RE] is set
+ * 			- TPM channels in a compare mode set CHF on a match and can interrupt
+ *
+ * 		Interrupts are delivered to the firmware thread with a signal, so ISRs preempt the
+ * 		main loop exactly like they do on the Cortex-M0+ and run to completion before the
+ * 		simulated clock moves on.
+ *
+ * 		The firmware runs at host speed, which has nothing to do with a Cortex-M0+: a
+ * 		polled conversion loop takes hundreds of simulated microseconds per sample, and
+ * 		a different number each run. A software-triggered conversion that follows
+ * 		another therefore starts one TPM1 overflow period (the ADC's sample clock,
+ * 		SAMPLE_RATE_ADC_HZ) after the last one, and simulated time holds there until the
+ * 		firmware asks for it, so a polled block comes out at the rate its pitch is
+ * 		reported against. The hold ends when the firmware sleeps or has not triggered
+ * 		again within SIM_ADC_HOLD_NS of wall time, and the next trigger starts afresh.
+ *
+ * 		Runtime knobs (environment variables):
+ * 			SIM_SECONDS    Simulated seconds to run before reporting and exiting (default 5)
+ * 			SIM_SPEED      Simulated seconds per wall-clock second, 0 = as fast as possible (default 1)
+ * 			SIM_ADC_NOISE  Peak noise added to each ADC conversion, in 16-bit LSBs (default 0)
+ *
+ * 		The host build requires static data below 4 GB (-no-pie) since DMA SAR/DAR are 32 bits.
+ */
+
+#ifndef SIM_KL25Z_H_
+#define SIM_KL25Z_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * \def		SIM_CORE_CLOCK_HZ
+ * \brief	Core clock of the simulated KL25Z in RUN mode (BOARD_BootClockRUN)
+ */
+#define SIM_CORE_CLOCK_HZ\
+	(48000000UL)
+
+/**
+ * \def		SIM_BUS_CLOCK_HZ
+ * \brief	Bus clock of the simulated KL25Z in RUN mode (OUTDIV4 = 2)
+ */
+#define SIM_BUS_CLOCK_HZ\
+	(24000000UL)
+
+/**
+ * \def		SIM_TPM_CLOCK_HZ
+ * \brief	TPM counter clock selected by SOPT2[TPMSRC] = 1 (MCGPLLCLK / 2), until
+ * 			sim_set_clocks says otherwise
+ */
+#define SIM_TPM_CLOCK_HZ\
+	(48000000UL)
+
+/**
+ * \def		SIM_STEP_CYCLES
+ * \brief	Core clock cycles simulated per step. Events are resolved within a step, so this
+ * 			only bounds how late the simulator notices a register write by the firmware
+ */
+#define SIM_STEP_CYCLES\
+	(16)
+
+/**
+ * \def		SIM_ADC_HOLD_NS
+ * \brief	Wall-clock time simulated time waits for the next polled conversion before the
+ * 			firmware is taken to have stopped polling
+ */
+#define SIM_ADC_HOLD_NS\
+	(2000000ULL)
+
+/**
+ * \def		SIM_NUM_IRQS
+ * \brief	Number of external interrupt lines on the KL25Z NVIC
+ */
+#define SIM_NUM_IRQS\
+	(32)
+
+/**
+ * \typedef	typedef uint16_t (*sim_analog_fn_t)(uint32_t channel, uint64_t cycles, void *ctx)
+ * \brief   Supplies the voltage on an ADC input channel at a given core cycle, expressed as
+ * 			a 16-bit fraction of VREFH (0 = VREFL, 65535 = VREFH)
+ */
+typedef uint16_t (*sim_analog_fn_t)(uint32_t channel, uint64_t cycles, void *ctx);
+
+/**
+ * \typedef	typedef struct sim_stats_s sim_stats_t
+ * \brief   Counters kept by the simulator, reported at exit
+ */
+typedef struct sim_stats_s sim_stats_t;
+
+/**
+ * \struct	struct sim_stats_s
+ * \brief   Counters kept by the simulator, reported at exit
+ */
+struct sim_stats_s{
+	uint64_t cycles;
+	uint64_t tpm_overflows[3];
+	uint64_t dma_transfers[4];
+	uint64_t dma_done[4];
+	uint64_t adc_conversions;
+	uint64_t dac_updates;
+	uint64_t uart_tx_bytes;
+	uint64_t uart_rx_bytes;
+	uint64_t irq_count[SIM_NUM_IRQS];
+	uint64_t systick_count;
+	uint64_t wfi_count;
+	uint64_t isr_wall_ns;
+	uint64_t adc_paced;
+	uint64_t adc_hold_ns;
+};
+
+/**
+ * \var		sim_stats
+ * \brief	Defined in sim_kl25z.c
+ */
+extern volatile sim_stats_t sim_stats;
+
+/**
+ * \fn		uint64_t sim_now_cycles
+ * \param	N/A
+ * \return	Core clock cycles simulated since reset
+ * \brief   Returns the simulated time base
+ */
+uint64_t sim_now_cycles(void);
+
+/**
+ * \fn		void sim_set_analog_source
+ * \param	uint32_t channel ADC0 input channel (0-31)
+ * \param	sim_analog_fn_t fn Function to sample, or NULL for the default
+ * \param	void *ctx Passed through to fn
+ * \return	N/A
+ * \brief   Overrides what an ADC input channel sees. By default channel 23 is the DAC0
+ * 			output and every other channel sits at mid-scale
+ */
+void sim_set_analog_source(uint32_t channel, sim_analog_fn_t fn, void *ctx);
+
+/**
+ * \fn		void sim_irq_disable
+ * \param	N/A
+ * \return	N/A
+ * \brief   __disable_irq() for the firmware thread: interrupts stay pending until
+ * 			sim_irq_enable or sim_wfi
+ */
+void sim_irq_disable(void);
+
+/**
+ * \fn		void sim_irq_enable
+ * \param	N/A
+ * \return	N/A
+ * \brief   __enable_irq() for the firmware thread
+ */
+void sim_irq_enable(void);
+
+/**
+ * \fn		bool sim_irq_masked
+ * \param	N/A
+ * \return	true if the firmware thread has interrupts masked, false otherwise
+ * \brief   __get_PRIMASK() for the firmware thread
+ */
+bool sim_irq_masked(void);
+
+/**
+ * \fn		void sim_wfi
+ * \param	N/A
+ * \return	N/A
+ * \brief   __WFI() for the firmware thread: returns once an interrupt is pending. Unlike
+ * 			the Cortex-M0+ with PRIMASK set, the handler has already run by then
+ */
+void sim_wfi(void);
+
+/**
+ * \fn		void sim_set_clocks
+ * \param	uint32_t core_hz Core clock, which SysTick counts
+ * \param	uint32_t periph_hz Clock of the TPMs and UART0, whichever source SOPT2 selects
+ * \param	bool vlpr Whether SMC reports VLPR or RUN
+ * \return	N/A
+ * \brief   Stands in for reprogramming MCG, SIM and SMC (see clocks.h). Simulated time
+ * 			still advances in cycles of SIM_CORE_CLOCK_HZ; the firmware itself runs no
+ * 			slower, only the peripherals' clocks change
+ */
+void sim_set_clocks(uint32_t core_hz, uint32_t periph_hz, bool vlpr);
+
+/**
+ * \fn		uint16_t sim_dac_output
+ * \param	N/A
+ * \return	DAC0 output as a 16-bit fraction of the reference voltage
+ * \brief   Returns the current DAC0 output, as seen by the loopback on channel 23
+ */
+uint16_t sim_dac_output(void);
+
+/**
+ * \fn		void sim_report
+ * \param	N/A
+ * \return	N/A
+ * \brief   Prints the simulator counters and firmware CPU time to stderr
+ */
+void sim_report(void);
+
+#endif /* SIM_KL25Z_H_ */
@@ -0,0 +1,177 @@
+/**
+ * \file    spsc_stress.c
+ * \author	Dayton Flores (dafl2542@colorado.edu)
+ * \date	10/19/2026
+ * \brief   Host stress test of the single-producer single-consumer queue
+ * \detail
+ * 		Runs source/spsc.c between two threads, which unlike an ISR and the main loop
+ * 		really do run at the same time, on different cores with their own caches.
+ * 		make spsc-stress builds and runs it.
+ *
+ * 		Lossless: the producer retries until each item is taken, and the consumer
+ * 		checks every sequence number and payload arrives once and in order.
+ *
+ * 		Lossy: the producer sends in bursts and drops what doesn't fit, as an ISR has
+ * 		to. The consumer checks what arrives is in order and uncorrupted, and that what
+ * 		arrived plus what was dropped adds up to what was sent.
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "spsc.h"
+
+/**
+ * \def		STRESS_ITEMS
+ * \brief	Items sent per run
+ */
+#define STRESS_ITEMS\
+	(1000000u)
+
+/**
+ * \def		STRESS_SLOTS
+ * \brief	Queue length, small so it is full and empty often
+ */
+#define STRESS_SLOTS\
+	(8)
+
+/**
+ * \typedef	typedef struct stress_item_s stress_item_t
+ * \brief   What goes through the queue: bigger than one store, so a torn copy shows
+ */
+typedef struct stress_item_s stress_item_t;
+
+struct stress_item_s{
+	uint32_t seq;
+	uint32_t check;		/* ~seq */
+	uint16_t signal;	/* seq truncated */
+	int16_t param;		/* -signal */
+};
+
+/**
+ * \var		stress_queue
+ * \brief	The queue under test and its storage
+ */
+static spsc_t stress_queue;
+static stress_item_t stress_slots[STRESS_SLOTS];
+
+/**
+ * \var		stress_lossy
+ * \brief	Set for the lossy run
+ */
+static bool stress_lossy;
+
+/**
+ * \var		stress_done
+ * \brief	Set by the producer once it has sent everything
+ */
+static volatile bool stress_done;
+
+static void *producer(void *arg)
+{
+	uint32_t seed = 1;
+
+	for(uint32_t seq = 0; seq < STRESS_ITEMS; seq++){
+		stress_item_t item = { seq, ~seq, (uint16_t)seq, (int16_t)-(int16_t)(uint16_t)seq };
+
+		if(stress_lossy){
+			spsc_put(&stress_queue, &item);
+
+			/**
+			 * Pause between bursts of up to 32 items
+			 */
+			seed = seed * 1103515245u + 12345u;
+			if(((seed >> 16) & 31) == 0){
+				sched_yield();
+			}
+		}
+		else{
+			while(!spsc_put(&stress_queue, &item)){
+				sched_yield();
+			}
+		}
+	}
+	stress_done = true;
+	return NULL;
+}
+
+/**
+ * \fn		int stress_run
+ * \param	bool lossy
+ * \return	The number of failures
+ */
+static int stress_run(bool lossy)
+{
+	pthread_t thread;
+	stress_item_t item;
+	uint32_t received = 0;
+	uint32_t next = 0;
+	uint32_t errors = 0;
+	bool done;
+
+	spsc_init(&stress_queue, stress_slots, sizeof(stress_item_t), STRESS_SLOTS);
+	stress_lossy = lossy;
+	stress_done = false;
+	pthread_create(&thread, NULL, producer, NULL);
+
+	do{
+		done = stress_done;
+		while(spsc_get(&stress_queue, &item)){
+			bool ok = (item.check == ~item.seq) &&
+					(item.signal == (uint16_t)item.seq) &&
+					(item.param == (int16_t)-(int16_t)(uint16_t)item.seq);
+
+			if(lossy){
+				ok = ok && (item.seq >= next);
+			}
+			else{
+				ok = ok && (item.seq == next);
+			}
+			if(!ok){
+				if(errors++ < 5){
+					printf("  bad item: seq = %u, expected %s%u\n",
+							item.seq, lossy ? ">= " : "", next);
+				}
+			}
+			next = item.seq + 1;
+			received++;
+		}
+
+		/**
+		 * Let the producer in on machines with a single core
+		 */
+		sched_yield();
+	} while(!done);
+	pthread_join(thread, NULL);
+
+	/**
+	 * drops counts every put that found the queue full, retries included
+	 */
+	if(lossy ? (received + stress_queue.drops != STRESS_ITEMS) : (received != STRESS_ITEMS)){
+		printf("  %u received, %u full, %u sent\n",
+				received, stress_queue.drops, STRESS_ITEMS);
+		errors++;
+	}
+	printf("%s: %u sent, %u received, %u puts found it full, most queued = %u of %u: %s\n",
+			lossy ? "lossy   " : "lossless",
+			STRESS_ITEMS,
+			received,
+			stress_queue.drops,
+			stress_queue.max,
+			STRESS_SLOTS,
+			errors ? "FAILED" : "passed");
+	return errors ? 1 : 0;
+}
+
+int main(void)
+{
+	int failures = 0;
+
+	failures += stress_run(false);
+	failures += stress_run(true);
+	return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
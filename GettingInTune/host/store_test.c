@@ -0,0 +1,267 @@
+/**
+ * \file    store_test.c
+ * \author	Dayton Flores (dafl2542@colorado.edu)
+ * \date	10/19/2026
+ * \brief   Host test of the persistent settings store
+ * \detail
+ * 		Runs source/store.c against the simulated flash in flash_host.c. make store-test
+ * 		builds and runs it.
+ *
+ * 		Each check starts from a fresh chip, and calls init_store() again wherever the
+ * 		firmware would be rebooted. Power is cut by limiting the words flash_host.c
+ * 		will still write, at every point of a compaction, and the store must come back
+ * 		with each key holding either its old or its new value.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "flash_host.h"
+#include "store.h"
+
+/**
+ * \def		TEST_SECTOR
+ * \brief	Index into flash_host_erases of the store's first sector
+ */
+#define TEST_SECTOR\
+	((STORE_BASE - FLASH_HOST_BASE) / STORE_SECTOR_SIZE)
+
+/**
+ * \def		TEST_RECORD
+ * \brief	Address of record i of store sector s: an 8-byte header, then 8-byte records
+ */
+#define TEST_RECORD(s, i)\
+	(STORE_BASE + (s) * STORE_SECTOR_SIZE + 8 + (i) * 8)
+
+/**
+ * \def		TEST_SLOTS
+ * \brief	Records a sector holds
+ */
+#define TEST_SLOTS\
+	((STORE_SECTOR_SIZE - 8) / 8)
+
+/**
+ * \def		TEST_WEAR_WRITES
+ * \brief	Writes in the wear check, enough to go round the ring many times
+ */
+#define TEST_WEAR_WRITES\
+	(20000u)
+
+/**
+ * \var		test_errors
+ * \brief	Failed checks so far
+ */
+static int test_errors = 0;
+
+/**
+ * critical.h masks the simulated interrupts, of which there are none here
+ */
+static bool test_masked = false;
+
+bool sim_irq_masked(void)
+{
+	return test_masked;
+}
+
+void sim_irq_disable(void)
+{
+	test_masked = true;
+}
+
+void sim_irq_enable(void)
+{
+	test_masked = false;
+}
+
+/**
+ * \fn		void check
+ * \param	bool ok
+ * \param	const char *what
+ * \return	N/A
+ */
+static void check(bool ok, const char *what)
+{
+	if(!ok){
+		printf("  failed: %s\n", what);
+		test_errors++;
+	}
+}
+
+/**
+ * \fn		void test_report
+ * \param	const char *name
+ * \param	int errors_before
+ * \return	N/A
+ */
+static void test_report(const char *name, int errors_before)
+{
+	printf("%-12s %s\n", name, (test_errors == errors_before) ? "passed" : "FAILED");
+}
+
+static void test_blank(void)
+{
+	int errors = test_errors;
+
+	flash_host_wipe();
+	check(init_store(), "init_store on blank flash");
+	for(uint32_t key = 0; key < STORE_KEYS; key++){
+		check(store_get((store_key_t)key, 1000 + key) == 1000 + key, "blank store returns the fallback");
+	}
+	check(!store_set(STORE_KEYS, 1), "store_set rejects an unknown key");
+	test_report("blank", errors);
+}
+
+static void test_persist(void)
+{
+	int errors = test_errors;
+	uint32_t programs;
+
+	flash_host_wipe();
+	init_store();
+	check(store_set(STORE_KEY_LAG_MIN, 12), "store_set");
+	check(store_set(STORE_KEY_LAG_MAX, 345), "store_set");
+	check(store_set(STORE_KEY_LAG_MIN, 13), "store_set over an earlier value");
+
+	check(init_store(), "init_store after writes");
+	check(store_get(STORE_KEY_LAG_MIN, 0) == 13, "last value for a key wins");
+	check(store_get(STORE_KEY_LAG_MAX, 0) == 345, "value survives init_store");
+	check(store_get(STORE_KEY_GATE_OPEN, 77) == 77, "unset key still returns the fallback");
+
+	programs = flash_host_programs;
+	check(store_set(STORE_KEY_LAG_MAX, 345), "store_set of an unchanged value");
+	check(flash_host_programs == programs, "unchanged value isn't written again");
+	test_report("persist", errors);
+}
+
+static void test_wear(void)
+{
+	int errors = test_errors;
+	uint32_t least = UINT32_MAX;
+	uint32_t most = 0;
+	uint32_t others = 0;
+
+	flash_host_wipe();
+	init_store();
+	for(uint32_t i = 0; i < TEST_WEAR_WRITES; i++){
+		if(!store_set((store_key_t)(i % STORE_KEYS), i)){
+			check(false, "store_set while wearing");
+			break;
+		}
+	}
+	for(uint32_t s = 0; s < FLASH_HOST_SIZE / STORE_SECTOR_SIZE; s++){
+		if((s >= TEST_SECTOR) && (s < TEST_SECTOR + STORE_SECTORS)){
+			least = (flash_host_erases[s] < least) ? flash_host_erases[s] : least;
+			most = (flash_host_erases[s] > most) ? flash_host_erases[s] : most;
+		}
+		else{
+			others += flash_host_erases[s];
+		}
+	}
+	check(most - least <= 1, "sectors wear evenly");
+	check(others == 0, "nothing outside the store is erased");
+
+	init_store();
+	for(uint32_t key = 0; key < STORE_KEYS; key++){
+		uint32_t last = TEST_WEAR_WRITES - 1 - ((TEST_WEAR_WRITES - 1 - key) % STORE_KEYS);
+
+		check(store_get((store_key_t)key, UINT32_MAX) == last, "values survive many compactions");
+	}
+	printf("%-12s %u writes, sectors erased %u to %u times: %s\n", "wear",
+			TEST_WEAR_WRITES, least, most, (test_errors == errors) ? "passed" : "FAILED");
+}
+
+static void test_torn(void)
+{
+	int errors = test_errors;
+
+	flash_host_wipe();
+	init_store();
+	store_set(STORE_KEY_ADC_PROFILE, 2);
+
+	/**
+	 * The value word goes in, the key and CRC don't
+	 */
+	flash_host_power = 1;
+	check(!store_set(STORE_KEY_ADC_PROFILE, 3), "store_set reports a torn write");
+	check(store_get(STORE_KEY_ADC_PROFILE, 0) == 2, "failed store_set keeps the old value in RAM");
+	flash_host_power = -1;
+
+	check(init_store(), "init_store after a torn record");
+	check(store_get(STORE_KEY_ADC_PROFILE, 0) == 2, "torn record is skipped");
+	check(store_set(STORE_KEY_ADC_PROFILE, 4), "store_set after a torn record");
+	init_store();
+	check(store_get(STORE_KEY_ADC_PROFILE, 0) == 4, "records after a torn one are read");
+	test_report("torn", errors);
+}
+
+static void test_corrupt(void)
+{
+	int errors = test_errors;
+
+	flash_host_wipe();
+	init_store();
+	store_set(STORE_KEY_LOG_LEVEL, 1);
+	store_set(STORE_KEY_LOG_LEVEL, 2);
+	flash_host_poke(TEST_RECORD(0, 1), 3);
+
+	init_store();
+	check(store_get(STORE_KEY_LOG_LEVEL, 0) == 1, "corrupt record fails its CRC");
+	test_report("corrupt", errors);
+}
+
+static void test_power_cut(void)
+{
+	int errors = test_errors;
+	uint32_t cuts = 0;
+	bool completed = false;
+
+	/**
+	 * Cut the power after 0, 1, 2... words of a store_set that has to compact, until
+	 * one completes
+	 */
+	for(int32_t power = 0; !completed && (power < 64); power++){
+		bool value_ok = true;
+
+		flash_host_wipe();
+		init_store();
+		for(uint32_t key = 0; key < STORE_KEYS; key++){
+			store_set((store_key_t)key, 100 + key);
+		}
+		for(uint32_t i = STORE_KEYS; i < TEST_SLOTS; i++){
+			store_set(STORE_KEY_LAG_MIN, i);
+		}
+
+		flash_host_power = power;
+		completed = store_set(STORE_KEY_LAG_MIN, 9999);
+		flash_host_power = -1;
+		cuts += completed ? 0 : 1;
+
+		check(init_store(), "init_store after a power cut");
+		value_ok = store_get(STORE_KEY_LAG_MIN, 0) == (completed ? 9999 : TEST_SLOTS - 1);
+		value_ok = value_ok || (!completed && (store_get(STORE_KEY_LAG_MIN, 0) == 9999));
+		check(value_ok, "compacted key holds its old or new value");
+		for(uint32_t key = STORE_KEY_LAG_MAX; key < STORE_KEYS; key++){
+			check(store_get((store_key_t)key, 0) == 100 + key, "other keys survive a power cut");
+		}
+
+		check(store_set(STORE_KEY_LAG_MAX, 4242), "store_set after a power cut");
+		init_store();
+		check(store_get(STORE_KEY_LAG_MAX, 0) == 4242, "store works after a power cut");
+	}
+	check(completed, "compaction completes with enough power");
+	printf("%-12s cut at %u points of a compaction: %s\n", "power cut",
+			cuts, (test_errors == errors) ? "passed" : "FAILED");
+}
+
+int main(void)
+{
+	test_blank();
+	test_persist();
+	test_wear();
+	test_torn();
+	test_corrupt();
+	test_power_cut();
+	return test_errors ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,467 @@
+/**
+ * \file    stream_rx.c
+ * \author	Dayton Flores (dafl2542@colorado.edu)
+ * \date	10/19/2026
+ * \brief   Host receiver for the firmware's binary sample stream (source/stream.h)
+ * \detail
+ * 		Reads the UART0 capture from a file or stdin, checks every frame's CRC and
+ * 		writes each source's samples to <prefix>_<source>.csv and .wav. Everything
+ * 		between frames is console output and goes to stdout untouched, so it can be
+ * 		piped on to dlog_decode.
+ *
+ * 			stream_rx [-o prefix] [-c] [-w] [capture]
+ *
+ * 		-o sets the output prefix (default "stream"), -c writes only CSV, -w only WAV.
+ * 		The CSV has one line per sample: the sample's index in its source, then its
+ * 		value. The WAV is 16-bit mono at the source's rate, samples scaled to full
+ * 		range; gaps in the sample index are filled with silence. A summary of frames,
+ * 		CRC failures, lost frames and gaps goes to stderr.
+ *
+ * 		With a board, capture at STREAM_BAUD_RATE from an adapter on PTA2, e.g.
+ * 			stty -F /dev/ttyUSB0 3000000 raw && stream_rx -o take1 < /dev/ttyUSB0
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/**
+ * User-defined libraries
+ */
+#include "stream.h"
+
+/**
+ * \def		PUSHBACK_SIZE
+ * \brief	Bytes that can be handed back to the input when a frame turns out to be text
+ */
+#define PUSHBACK_SIZE\
+	(STREAM_FRAME_SIZE)
+
+/**
+ * \def		WAV_HEADER_SIZE
+ * \brief	RIFF header of a PCM WAV file
+ */
+#define WAV_HEADER_SIZE\
+	(44)
+
+/**
+ * \def		WAV_MAX_GAP
+ * \brief	Longest gap filled with silence. Longer jumps start over where the samples are
+ */
+#define WAV_MAX_GAP\
+	(1u << 20)
+
+/**
+ * \typedef	typedef struct source_s source_t
+ * \brief   Output files and counters of one source
+ */
+typedef struct source_s source_t;
+
+/**
+ * \struct	struct source_s
+ * \brief   Output files and counters of one source
+ */
+struct source_s{
+	FILE *csv;
+	FILE *wav;
+	uint32_t rate_hz;
+	uint8_t bits;
+	bool started;
+	uint32_t next;
+	uint64_t samples;
+	uint64_t wav_samples;
+	uint64_t gaps;
+	uint64_t gap_samples;
+};
+
+/**
+ * Output options
+ */
+static const char *prefix = "stream";
+static bool write_csv = true;
+static bool write_wav = true;
+
+/**
+ * Sources and link counters
+ */
+static source_t sources[256];
+static uint64_t frames;
+static uint64_t crc_errors;
+static uint64_t frames_lost;
+static bool sequence_started;
+static uint16_t sequence_next;
+
+/**
+ * Input stream with a pushback stack
+ */
+static FILE *in;
+static uint8_t pushback[PUSHBACK_SIZE];
+static size_t pushback_count;
+
+/**
+ * \fn		int get_byte
+ * \param	N/A
+ * \return	Next input byte, or EOF
+ */
+static int get_byte(void)
+{
+	if(pushback_count){
+		return pushback[--pushback_count];
+	}
+	return fgetc(in);
+}
+
+/**
+ * \fn		void unget_bytes
+ * \param	const uint8_t *bytes
+ * \param	size_t n
+ * \return	N/A
+ * \brief   Returns bytes to the input so they are read again, in order
+ */
+static void unget_bytes(const uint8_t *bytes, size_t n)
+{
+	while(n--){
+		pushback[pushback_count++] = bytes[n];
+	}
+}
+
+/**
+ * \fn		uint16_t get16
+ * \param	const uint8_t *p
+ * \return	Little-endian half word at p
+ */
+static uint16_t get16(const uint8_t *p)
+{
+	return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+/**
+ * \fn		uint32_t get32
+ * \param	const uint8_t *p
+ * \return	Little-endian word at p
+ */
+static uint32_t get32(const uint8_t *p)
+{
+	return (uint32_t)get16(p) | ((uint32_t)get16(p + 2) << 16);
+}
+
+/**
+ * \fn		void put32
+ * \param	uint8_t *p
+ * \param	uint32_t v
+ * \return	N/A
+ */
+static void put32(uint8_t *p, uint32_t v)
+{
+	p[0] = (uint8_t)v;
+	p[1] = (uint8_t)(v >> 8);
+	p[2] = (uint8_t)(v >> 16);
+	p[3] = (uint8_t)(v >> 24);
+}
+
+/**
+ * \fn		uint16_t crc16
+ * \param	const uint8_t *data
+ * \param	size_t n
+ * \return	CRC-16/CCITT-FALSE of the data, bit by bit
+ */
+static uint16_t crc16(const uint8_t *data, size_t n)
+{
+	uint16_t crc = 0xFFFF;
+
+	while(n--){
+		crc ^= (uint16_t)(*data++ << 8);
+		for(int i = 0; i < 8; i++){
+			crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+		}
+	}
+	return crc;
+}
+
+/**
+ * \fn		void source_name
+ * \param	uint32_t id
+ * \param	char *name
+ * \param	size_t size
+ * \return	N/A
+ * \brief   File name suffix of a source: dac, adc0, adc1, ...
+ */
+static void source_name(uint32_t id, char *name, size_t size)
+{
+	if(id == STREAM_SOURCE_DAC){
+		snprintf(name, size, "dac");
+	}
+	else if(id >= STREAM_SOURCE_ADC){
+		snprintf(name, size, "adc%u", id - STREAM_SOURCE_ADC);
+	}
+	else{
+		snprintf(name, size, "src%u", id);
+	}
+}
+
+/**
+ * \fn		void wav_header
+ * \param	FILE *f
+ * \param	uint32_t rate_hz
+ * \param	uint64_t samples
+ * \return	N/A
+ * \brief   Writes (or rewrites) the header of a 16-bit mono PCM file
+ */
+static void wav_header(FILE *f, uint32_t rate_hz, uint64_t samples)
+{
+	uint8_t h[WAV_HEADER_SIZE];
+	uint32_t data = (samples > 0x7FFFFFF0u / 2) ? 0x7FFFFFF0u : (uint32_t)samples * 2;
+
+	memcpy(&h[0], "RIFF", 4);
+	put32(&h[4], 36 + data);
+	memcpy(&h[8], "WAVEfmt ", 8);
+	put32(&h[16], 16);
+	put32(&h[20], 1 | (1 << 16));
+	put32(&h[24], rate_hz);
+	put32(&h[28], rate_hz * 2);
+	put32(&h[32], 2 | (16 << 16));
+	memcpy(&h[36], "data", 4);
+	put32(&h[40], data);
+
+	fseek(f, 0, SEEK_SET);
+	fwrite(h, 1, sizeof(h), f);
+	fseek(f, 0, SEEK_END);
+}
+
+/**
+ * \fn		bool source_open
+ * \param	uint32_t id
+ * \param	source_t *s
+ * \return	true if the files could be created
+ */
+static bool source_open(uint32_t id, source_t *s)
+{
+	char name[16];
+	char path[512];
+
+	source_name(id, name, sizeof(name));
+	if(write_csv){
+		snprintf(path, sizeof(path), "%s_%s.csv", prefix, name);
+		if(!(s->csv = fopen(path, "w"))){
+			fprintf(stderr, "stream_rx: cannot create %s\n", path);
+			return false;
+		}
+		fprintf(s->csv, "index,sample\n");
+	}
+	if(write_wav){
+		snprintf(path, sizeof(path), "%s_%s.wav", prefix, name);
+		if(!(s->wav = fopen(path, "wb"))){
+			fprintf(stderr, "stream_rx: cannot create %s\n", path);
+			return false;
+		}
+		wav_header(s->wav, s->rate_hz, 0);
+	}
+	return true;
+}
+
+/**
+ * \fn		void wav_sample
+ * \param	source_t *s
+ * \param	int32_t sample Signed, full scale 16 bits
+ * \return	N/A
+ */
+static void wav_sample(source_t *s, int32_t sample)
+{
+	uint8_t b[2] = { (uint8_t)sample, (uint8_t)(sample >> 8) };
+
+	fwrite(b, 1, sizeof(b), s->wav);
+	s->wav_samples++;
+}
+
+/**
+ * \fn		bool frame_samples
+ * \param	const uint8_t *frame A frame that passed its CRC
+ * \return	false if the output could not be written
+ * \brief   Files the samples of a frame under their source
+ */
+static bool frame_samples(const uint8_t *frame)
+{
+	uint32_t id = frame[2];
+	uint8_t bits = frame[3];
+	uint32_t count = get16(&frame[6]);
+	uint32_t index = get32(&frame[8]);
+	source_t *s = &sources[id];
+
+	if(!s->started){
+		s->rate_hz = get32(&frame[12]);
+		s->bits = bits;
+		s->started = true;
+		s->next = index;
+		if(!source_open(id, s)){
+			return false;
+		}
+	}
+
+	/**
+	 * A jump forward is samples the firmware dropped: silence keeps the WAV in time.
+	 * Blocks that don't follow on (a new DAC buffer, say) are appended as they are
+	 */
+	if(index != s->next){
+		s->gaps++;
+		if(index - s->next < WAV_MAX_GAP){
+			s->gap_samples += index - s->next;
+			if(s->wav){
+				for(uint32_t i = s->next; i != index; i++){
+					wav_sample(s, 0);
+				}
+			}
+		}
+	}
+
+	for(uint32_t i = 0; i < count; i++){
+		uint16_t raw = get16(&frame[STREAM_HEADER_SIZE + 2 * i]);
+
+		if(s->csv){
+			fprintf(s->csv, "%u,%u\n", index + i, raw);
+		}
+		if(s->wav){
+			int32_t v = (s->bits && (s->bits < 16)) ? (raw << (16 - s->bits)) : raw;
+
+			wav_sample(s, v - 32768);
+		}
+	}
+	s->next = index + count;
+	s->samples += count;
+	return true;
+}
+
+/**
+ * \fn		void report
+ * \param	N/A
+ * \return	N/A
+ * \brief   Finishes the WAV headers and prints the summary
+ */
+static void report(void)
+{
+	fprintf(stderr, "stream_rx: %llu frames, %llu CRC errors, %llu frames lost\n",
+			(unsigned long long)frames,
+			(unsigned long long)crc_errors,
+			(unsigned long long)frames_lost);
+	for(uint32_t id = 0; id < 256; id++){
+		source_t *s = &sources[id];
+		char name[16];
+
+		if(!s->started){
+			continue;
+		}
+		source_name(id, name, sizeof(name));
+		fprintf(stderr, "stream_rx: %s: %llu samples, %u bits at %u Hz, %llu gaps (%llu samples)\n",
+				name,
+				(unsigned long long)s->samples,
+				s->bits,
+				s->rate_hz,
+				(unsigned long long)s->gaps,
+				(unsigned long long)s->gap_samples);
+		if(s->wav){
+			wav_header(s->wav, s->rate_hz, s->wav_samples);
+			fclose(s->wav);
+		}
+		if(s->csv){
+			fclose(s->csv);
+		}
+	}
+}
+
+int main(int argc, char **argv)
+{
+	uint8_t frame[STREAM_FRAME_SIZE];
+	int opt;
+	int c;
+
+	while((opt = getopt(argc, argv, "o:cw")) != -1){
+		switch(opt){
+		case 'o':
+			prefix = optarg;
+			break;
+		case 'c':
+			write_wav = false;
+			break;
+		case 'w':
+			write_csv = false;
+			break;
+		default:
+			fprintf(stderr, "usage: %s [-o prefix] [-c] [-w] [capture]\n", argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
+	if(!write_csv && !write_wav){
+		write_csv = true;
+		write_wav = true;
+	}
+	in = (optind < argc) ? fopen(argv[optind], "rb") : stdin;
+	if(!in){
+		fprintf(stderr, "%s: cannot open %s\n", argv[0], argv[optind]);
+		return EXIT_FAILURE;
+	}
+
+	while((c = get_byte()) != EOF){
+		size_t n = 1;
+		size_t size = STREAM_HEADER_SIZE + STREAM_CRC_SIZE;
+		uint16_t sequence;
+
+		if(c != STREAM_SYNC0){
+			putchar(c);
+			if(c == '\n'){
+				fflush(stdout);
+			}
+			continue;
+		}
+
+		/**
+		 * Collect a whole frame. Anything that doesn't check out was text after all:
+		 * print the first byte and read the rest again
+		 */
+		frame[0] = (uint8_t)c;
+		while(n < size){
+			if((c = get_byte()) == EOF){
+				break;
+			}
+			frame[n++] = (uint8_t)c;
+			if((n == 2) && (frame[1] != STREAM_SYNC1)){
+				break;
+			}
+			if(n == 8){
+				if(get16(&frame[6]) > STREAM_BLOCK_SAMPLES){
+					break;
+				}
+				size += 2 * get16(&frame[6]);
+			}
+		}
+		if((c == EOF) && (n >= 2) && (frame[1] == STREAM_SYNC1)){
+			fprintf(stderr, "stream_rx: capture ends inside a frame\n");
+			break;
+		}
+		if((n != size) || (get16(&frame[size - STREAM_CRC_SIZE]) != crc16(&frame[2], size - 2 - STREAM_CRC_SIZE))){
+			if(n == size){
+				crc_errors++;
+			}
+			putchar(frame[0]);
+			unget_bytes(&frame[1], n - 1);
+			continue;
+		}
+
+		sequence = get16(&frame[4]);
+		if(sequence_started && (sequence != sequence_next)){
+			frames_lost += (uint16_t)(sequence - sequence_next);
+		}
+		sequence_started = true;
+		sequence_next = sequence + 1;
+		frames++;
+
+		if(!frame_samples(frame)){
+			return EXIT_FAILURE;
+		}
+	}
+
+	fflush(stdout);
+	report();
+	return EXIT_SUCCESS;
+}
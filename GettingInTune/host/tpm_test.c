@@ -0,0 +1,149 @@
+/**
+ * \file    tpm_test.c
+ * \author	Dayton Flores (dafl2542@colorado.edu)
+ * \date	10/19/2026
+ * \brief   Host test of the TPM prescaler and MOD solver
+ * \detail
+ * 		Runs tpm_solve() from source/tpm.c. make tpm-test builds and runs it.
+ *
+ * 		Every rate the firmware programs a TPM for must come out exact from the 48 MHz
+ * 		TPM clock. Rates that can't be exact must be as near as any prescaler and MOD
+ * 		get, which is checked against a search of every one of them, and rates out of
+ * 		reach must be refused.
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "adc.h"
+#include "dac.h"
+#include "tpm.h"
+
+/**
+ * \var		test_errors
+ * \brief	Failed checks so far
+ */
+static int test_errors = 0;
+
+/**
+ * \fn		void check
+ * \param	bool ok
+ * \param	const char *what
+ * \param	uint32_t rate_hz
+ * \return	N/A
+ */
+static void check(bool ok, const char *what, uint32_t rate_hz)
+{
+	if(!ok){
+		printf("  failed: %s, %u Hz\n", what, rate_hz);
+		test_errors++;
+	}
+}
+
+/**
+ * \fn		double search_error
+ * \param	uint32_t clock_hz
+ * \param	uint32_t rate_hz
+ * \return	Smallest rate error, in Hz, of every prescaler and MOD
+ */
+static double search_error(uint32_t clock_hz, uint32_t rate_hz)
+{
+	double best = INFINITY;
+
+	for(uint32_t ps = 0; ps <= TPM_MAX_PS; ps++){
+		for(uint32_t n = 1; n <= TPM_MAX_COUNTS; n++){
+			double error = fabs((double)clock_hz / ((double)n * (1u << ps)) - rate_hz);
+
+			if(error < best){
+				best = error;
+			}
+		}
+	}
+	return best;
+}
+
+static void test_firmware_rates(void)
+{
+	static const struct{
+		const char *name;
+		uint32_t hz;
+	} rates[] = {
+		{ "DAC (TPM0)", SAMPLE_RATE_DAC_HZ },
+		{ "ADC (TPM1)", SAMPLE_RATE_ADC_HZ },
+		{ "PWM", PWM_FREQ_HZ },
+	};
+	int errors = test_errors;
+
+	for(uint32_t i = 0; i < sizeof(rates) / sizeof(rates[0]); i++){
+		tpm_rate_t rate;
+		bool ok = tpm_solve(TPM_CLOCK_HZ, rates[i].hz, &rate);
+
+		check(ok, "firmware rate in reach", rates[i].hz);
+		if(!ok){
+			continue;
+		}
+		check((uint64_t)rate.divisor * rates[i].hz == TPM_CLOCK_HZ, "firmware rate exact", rates[i].hz);
+		check(rate.divisor == ((rate.mod + 1) << rate.ps), "divisor matches MOD and PS", rates[i].hz);
+		check(rate.hz == (float)rates[i].hz, "achieved rate reported", rates[i].hz);
+		printf("%-12s %6u Hz: PS = %u, MOD = %5u, achieved %.3f Hz (truncated us periods gave %.3f Hz)\n",
+				rates[i].name,
+				(unsigned)rates[i].hz,
+				(unsigned)rate.ps,
+				(unsigned)rate.mod,
+				rate.hz,
+				(double)TPM_CLOCK_HZ / ((uint32_t)(1000000.0 / rates[i].hz) * 24 + 1) / 2);
+	}
+	printf("%-12s %s\n", "firmware", (test_errors == errors) ? "passed" : "FAILED");
+}
+
+static void test_nearest(void)
+{
+	static const uint32_t rates[] = {
+		6, 7, 100, 440, 999, 1001, 8000, 11025, 22050, 44100, 47999, 48001, 88200,
+		96001, 123457, 1000000, 3000000, 7777777, 23999999, 24000000, 48000000
+	};
+	int errors = test_errors;
+	double worst_ppm = 0.0;
+
+	for(uint32_t i = 0; i < sizeof(rates) / sizeof(rates[0]); i++){
+		tpm_rate_t rate;
+		double error;
+
+		if(!tpm_solve(TPM_CLOCK_HZ, rates[i], &rate)){
+			check(false, "rate in reach", rates[i]);
+			continue;
+		}
+		error = fabs((double)TPM_CLOCK_HZ / rate.divisor - rates[i]);
+		check(error <= search_error(TPM_CLOCK_HZ, rates[i]) * (1.0 + 1e-12), "nearest of every PS and MOD", rates[i]);
+		check((rate.mod < TPM_MAX_COUNTS) && (rate.ps <= TPM_MAX_PS), "settings fit the registers", rates[i]);
+		if((rates[i] < 1000000) && (error / rates[i] * 1e6 > worst_ppm)){
+			worst_ppm = error / rates[i] * 1e6;
+		}
+	}
+	printf("%-12s %u rates, worst error below 1 MHz = %.1f ppm: %s\n", "nearest",
+			(unsigned)(sizeof(rates) / sizeof(rates[0])),
+			worst_ppm,
+			(test_errors == errors) ? "passed" : "FAILED");
+}
+
+static void test_out_of_reach(void)
+{
+	tpm_rate_t rate;
+	int errors = test_errors;
+
+	check(!tpm_solve(TPM_CLOCK_HZ, 0, &rate), "0 Hz refused", 0);
+	check(!tpm_solve(TPM_CLOCK_HZ, 5, &rate), "slower than 128 * 65536 clocks refused", 5);
+	check(!tpm_solve(TPM_CLOCK_HZ, TPM_CLOCK_HZ + 1, &rate), "faster than the clock refused", TPM_CLOCK_HZ + 1);
+	printf("%-12s %s\n", "out of reach", (test_errors == errors) ? "passed" : "FAILED");
+}
+
+int main(void)
+{
+	test_firmware_rates();
+	test_nearest();
+	test_out_of_reach();
+	return test_errors ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -6,8 +6,16 @@
  */
 
 #include <stdbool.h>
+#include <stdio.h>
 #include "board.h"
+#include "fsl_debug_console.h"
 #include "adc.h"
+#include "arena.h"
+#include "critical.h"
+#include "instr.h"
+#include "irq.h"
+#include "task.h"
+#include "tpm.h"
 
 /**
  * \def		PCR_MUX_SEL_ADC
@@ -103,6 +111,18 @@
 #define CFG1_ADICLK\
 	(0)
 
+/**
+ * \def		SC3_AVGS_4
+ * \brief	SC3[1:0] which is Hardware Average Select
+ * \detail
+ * 		00: 4 samples averaged
+ * 		01: 8 samples averaged
+ * 		10: 16 samples averaged
+ * 		11: 32 samples averaged
+ */
+#define SC3_AVGS_4\
+	(0)
+
 /**
  * \def		SC2_REFSEL
  * \brief	SC2[1:0] which is Voltage Reference Select
@@ -120,6 +140,76 @@
 #define SC2_REFSEL\
 	(0)
 
+/**
+ * \def		ADC_BUS_CLOCK_HZ
+ * \brief	Bus clock feeding the ADC when CFG1[ADICLK] is 0
+ */
+#define ADC_BUS_CLOCK_HZ\
+	(24000000)
+
+/**
+ * \var		adc_profile
+ * \brief	Profile CFG1 and SC3 are configured for
+ */
+static adc_profile_t adc_profile = ADC_PROFILE_LOW_POWER;
+
+/**
+ * \var		adc_scan_channels
+ * \brief	SC1[ADCH] values the scan round-robins
+ */
+static uint8_t adc_scan_channels[ADC_SCAN_MAX_CHANNELS];
+
+/**
+ * \var		adc_scan_count
+ * \brief	Number of channels in the scan, 0 if scan mode is off
+ */
+uint32_t adc_scan_count = 0;
+
+/**
+ * \var		adc_scan_i
+ * \brief	Index of the channel being converted
+ */
+static volatile uint32_t adc_scan_i = 0;
+
+/**
+ * \var		adc_scan_ring_buffer
+ * \brief	Per-channel sample rings, written by ADC0_IRQHandler. Borrowed from the arena
+ * 			(arena.h) by init_onboard_adc_scan
+ */
+static int16_t *adc_scan_ring_buffer[ADC_SCAN_MAX_CHANNELS];
+
+/**
+ * \var		adc_scan_head
+ * \brief	Samples ever written per channel. Only ADC0_IRQHandler writes it
+ */
+static volatile uint32_t adc_scan_head[ADC_SCAN_MAX_CHANNELS];
+
+/**
+ * \var		adc_scan_tail
+ * \brief	Samples ever read per channel. Only the main loop writes it
+ */
+static volatile uint32_t adc_scan_tail[ADC_SCAN_MAX_CHANNELS];
+
+/**
+ * \var		adc_scan_overruns
+ * \brief	Samples dropped per channel because its ring was full
+ */
+volatile uint32_t adc_scan_overruns[ADC_SCAN_MAX_CHANNELS];
+
+/**
+ * \var		adc_scan_task
+ * \brief	Task ADC0_IRQHandler posts to as samples come in, NULL for none
+ */
+static task_t *adc_scan_task = NULL;
+static uint16_t adc_scan_signal = 0;
+static uint32_t adc_scan_every = 0;
+
+/**
+ * \var		adc_scan_countdown
+ * \brief	Samples per channel until its next post, so the ISR doesn't divide
+ */
+static uint32_t adc_scan_countdown[ADC_SCAN_MAX_CHANNELS];
+
 void init_onboard_adc(void)
 {
 	/**
@@ -143,12 +233,9 @@ void init_onboard_adc(void)
 	 * 	- Long sample time
 	 * 	- 16-bit single-ended conversion
 	 * 	- Bus clock
+	 * 	- No hardware averaging
 	 */
-    ADC0->CFG1 =
-    	ADC_CFG1_ADLPC(CFG1_ADLPC) |
-		ADC_CFG1_ADLSMP(CFG1_ADLSMP) |
-		ADC_CFG1_MODE(CFG1_MODE) |
-		ADC_CFG1_ADICLK(CFG1_ADICLK);
+    adc_set_profile(ADC_PROFILE_LOW_POWER);
 
 	/**
 	 * Configure ADC0:
@@ -174,3 +261,214 @@ void init_onboard_adc(void)
     //SIM->SOPT7 &= ~SIM_SOPT7_ADC0TRGSEL(0b1111);
     //SIM->SOPT7 |= SIM_SOPT7_ADC0TRGSEL(0b1001);
 }
+
+void adc_set_profile(adc_profile_t profile)
+{
+	bool low_power = (profile != ADC_PROFILE_FAST);
+
+	ADC0->CFG1 =
+		ADC_CFG1_ADLPC(low_power ? CFG1_ADLPC : 0) |
+		ADC_CFG1_ADLSMP(low_power ? CFG1_ADLSMP : 0) |
+		ADC_CFG1_MODE(CFG1_MODE) |
+		ADC_CFG1_ADICLK(CFG1_ADICLK);
+
+	if(profile == ADC_PROFILE_AVERAGE4){
+		ADC0->SC3 = (ADC0->SC3 & ~ADC_SC3_AVGS_MASK) | ADC_SC3_AVGE_MASK | ADC_SC3_AVGS(SC3_AVGS_4);
+	}
+	else{
+		ADC0->SC3 &= ~ADC_SC3_AVGE_MASK;
+	}
+	adc_profile = profile;
+}
+
+adc_profile_t adc_get_profile(void)
+{
+	return adc_profile;
+}
+
+void init_onboard_adc_scan(const uint8_t *channels, uint32_t count)
+{
+	if(count > ADC_SCAN_MAX_CHANNELS){
+		count = ADC_SCAN_MAX_CHANNELS;
+	}
+
+	/**
+	 * The scan keeps its rings from here on
+	 */
+	arena_return(ARENA_OWNER_SCAN);
+	for(uint32_t ch = 0; ch < count; ch++){
+		adc_scan_ring_buffer[ch] = arena_borrow(ARENA_OWNER_SCAN, ADC_SCAN_RING_SIZE);
+		adc_scan_channels[ch] = channels[ch];
+		adc_scan_head[ch] = 0;
+		adc_scan_tail[ch] = 0;
+		adc_scan_overruns[ch] = 0;
+	}
+	adc_scan_count = count;
+	adc_scan_i = 0;
+
+	/**
+	 * Configure ADC0:
+	 * 	- Hardware trigger from TPM1 overflow
+	 */
+	SIM->SOPT7 =
+		SIM_SOPT7_ADC0ALTTRGEN_MASK |
+		SIM_SOPT7_ADC0TRGSEL(ADC0TRGSEL_TPM1_OVERFLOW);
+	ADC0->SC2 |= ADC_SC2_ADTRG_MASK;
+
+	NVIC_SetPriority(ADC0_IRQn, IRQ_PRIORITY_ADC0);
+	NVIC_ClearPendingIRQ(ADC0_IRQn);
+	NVIC_EnableIRQ(ADC0_IRQn);
+
+	/**
+	 * Configure ADC0:
+	 * 	- First channel of the scan
+	 * 	- Interrupt on conversion complete
+	 */
+	ADC0->SC1[0] =
+		ADC_SC1_AIEN_MASK |
+		ADC_SC1_ADCH(adc_scan_channels[0]);
+}
+
+void ADC0_IRQHandler(void)
+{
+	/**
+	 * TPM1 has counted since the overflow that triggered the conversion
+	 */
+	uint32_t entry = INSTR_IRQ_STAMP(TPM1->CNT);
+	uint32_t start = INSTR_START();
+	uint32_t ch = adc_scan_i;
+	uint32_t head = adc_scan_head[ch];
+
+	/**
+	 * Reading R[0] clears COCO
+	 */
+	int16_t sample = (int16_t)ADC0->R[0];
+
+	/**
+	 * Select the next channel before the next trigger arrives. In hardware trigger
+	 * mode writing SC1 only selects the input, it does not start a conversion
+	 */
+	adc_scan_i = (ch + 1 < adc_scan_count) ? (ch + 1) : 0;
+	ADC0->SC1[0] =
+		ADC_SC1_AIEN_MASK |
+		ADC_SC1_ADCH(adc_scan_channels[adc_scan_i]);
+
+	if(head - adc_scan_tail[ch] >= ADC_SCAN_RING_SIZE){
+		adc_scan_overruns[ch]++;
+	}
+	else{
+		adc_scan_ring_buffer[ch][head & (ADC_SCAN_RING_SIZE - 1)] = sample;
+		adc_scan_head[ch] = head + 1;
+		if((adc_scan_task != NULL) && (--adc_scan_countdown[ch] == 0)){
+			adc_scan_countdown[ch] = adc_scan_every;
+			task_post_isr(adc_scan_task, adc_scan_signal, (int16_t)ch);
+		}
+	}
+	INSTR_STOP(INSTR_TIMER_ADC_ISR, start);
+	INSTR_IRQ(INSTR_IRQ_ADC0, tpm_cycles(TPM1, 0, entry), tpm_cycles(TPM1, entry, INSTR_IRQ_STAMP(TPM1->CNT)));
+}
+
+void adc_scan_notify(task_t *task, uint16_t signal, uint32_t samples)
+{
+	uint32_t primask = critical_enter();
+
+	for(uint32_t ch = 0; ch < ADC_SCAN_MAX_CHANNELS; ch++){
+		adc_scan_countdown[ch] = samples;
+	}
+	adc_scan_every = samples;
+	adc_scan_signal = signal;
+	adc_scan_task = (samples > 0) ? task : NULL;
+	critical_exit(primask);
+}
+
+bool adc_scan_read(uint32_t ch, int16_t *samples, uint32_t n)
+{
+	uint32_t tail = adc_scan_tail[ch];
+
+	if(adc_scan_head[ch] - tail < n){
+		return false;
+	}
+
+	for(uint32_t i = 0; i < n; i++){
+		samples[i] = adc_scan_ring_buffer[ch][(tail + i) & (ADC_SCAN_RING_SIZE - 1)];
+	}
+	adc_scan_tail[ch] = tail + n;
+	return true;
+}
+
+const int16_t *adc_scan_ring(uint32_t ch)
+{
+	return adc_scan_ring_buffer[ch];
+}
+
+uint32_t adc_scan_read_index(uint32_t ch)
+{
+	return adc_scan_tail[ch];
+}
+
+uint32_t adc_scan_available(uint32_t ch)
+{
+	return adc_scan_head[ch] - adc_scan_tail[ch];
+}
+
+void adc_scan_consume(uint32_t ch, uint32_t n)
+{
+	adc_scan_tail[ch] += n;
+}
+
+void adc_scan_flush(uint32_t ch)
+{
+	adc_scan_tail[ch] = adc_scan_head[ch];
+}
+
+void adc_scan_report(void)
+{
+	static const uint32_t bct_adck[4] = { 17, 20, 20, 25 };
+	static const uint32_t lst_adck[4] = { 20, 12, 6, 2 };
+	uint32_t cfg1 = ADC0->CFG1;
+	uint32_t adck_hz = ADC_BUS_CLOCK_HZ >> ((cfg1 & ADC_CFG1_ADIV_MASK) >> ADC_CFG1_ADIV_SHIFT);
+	uint32_t adck = bct_adck[(cfg1 & ADC_CFG1_MODE_MASK) >> ADC_CFG1_MODE_SHIFT];
+	uint32_t sc3 = ADC0->SC3;
+	uint32_t avg = 1;
+	uint32_t rate_hz = (uint32_t)tpm_overflow_rate_hz(TPM1);
+	uint32_t conversion_ns;
+	uint32_t limit_hz;
+
+	if(adc_scan_count == 0){
+		return;
+	}
+
+	/**
+	 * Conversion time from the KL25 reference manual: the first conversion adder
+	 * (3 ADCK + 5 bus clocks) plus base conversion time plus long sample adder,
+	 * the last two once per averaged conversion.
+	 * Only valid for the bus clock sources (CFG1[ADICLK] 0 or 1)
+	 */
+	if(cfg1 & ADC_CFG1_ADICLK_MASK){
+		adck_hz >>= 1;
+	}
+	if(cfg1 & ADC_CFG1_ADLSMP_MASK){
+		adck += lst_adck[(ADC0->CFG2 & ADC_CFG2_ADLSTS_MASK) >> ADC_CFG2_ADLSTS_SHIFT];
+	}
+	if(sc3 & ADC_SC3_AVGE_MASK){
+		avg = 4u << ((sc3 & ADC_SC3_AVGS_MASK) >> ADC_SC3_AVGS_SHIFT);
+	}
+	adck = 3 + avg * adck;
+	conversion_ns = (uint32_t)(((uint64_t)adck * 1000000000ULL) / adck_hz + (5ULL * 1000000000ULL) / ADC_BUS_CLOCK_HZ);
+	limit_hz = 1000000000UL / conversion_ns;
+
+	PRINTF("ADC scan: %u channels, %u Hz aggregate, %u Hz per channel\r\n",
+			(unsigned)adc_scan_count,
+			(unsigned)rate_hz,
+			(unsigned)(rate_hz / adc_scan_count));
+	PRINTF("ADC scan: conversion = %u ns, limit = %u Hz aggregate, %u Hz per channel, %u CPU cycles per sample\r\n",
+			(unsigned)conversion_ns,
+			(unsigned)limit_hz,
+			(unsigned)(limit_hz / adc_scan_count),
+			(unsigned)(SystemCoreClock / rate_hz));
+	for(uint32_t ch = 0; ch < adc_scan_count; ch++){
+		PRINTF("ADC scan: AD%u overruns = %u\r\n",
+				(unsigned)adc_scan_channels[ch],
+				(unsigned)adc_scan_overruns[ch]);
+	}
+}
@@ -8,6 +8,14 @@
 #ifndef ADC_H_
 #define ADC_H_
 
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * User-defined libraries
+ */
+#include "task.h"
+
 /**
  * \def		SAMPLE_RATE_ADC_HZ
  * \brief	The sampling rate for ADC in Hz
@@ -32,6 +40,70 @@
 #define SC1_ADCH\
 	(23)
 
+/**
+ * \def		ADC0TRGSEL_TPM1_OVERFLOW
+ * \brief	SOPT7[ADC0TRGSEL] value selecting TPM1 overflow as the ADC0 hardware trigger
+ */
+#define ADC0TRGSEL_TPM1_OVERFLOW\
+	(9)
+
+/**
+ * \def		ADC_SCAN_MAX_CHANNELS
+ * \brief	Most input channels a scan can round-robin
+ */
+#define ADC_SCAN_MAX_CHANNELS\
+	(2)
+
+/**
+ * \def		ADC_SCAN_RING_SIZE
+ * \brief	Samples held per scanned channel. Must be a power of 2
+ */
+#define ADC_SCAN_RING_SIZE\
+	(1024)
+
+/**
+ * \def		ADC_SCAN_BLOCK_SIZE
+ * \brief	Samples per channel handed to the pitch detector. Half a ring, so the ISR
+ * 			can keep writing while a block is read out
+ */
+#define ADC_SCAN_BLOCK_SIZE\
+	(ADC_SCAN_RING_SIZE / 2)
+
+/**
+ * \def		SC1_ADCH_PTE20
+ * \brief	SC1[4:0] value for AD0 (PTE20), the second input in the default scan
+ */
+#define SC1_ADCH_PTE20\
+	(0)
+
+/**
+ * \typedef	typedef enum adc_profile_e adc_profile_t
+ * \brief   Easily declare ADC conversion profiles
+ */
+typedef enum adc_profile_e adc_profile_t;
+
+/**
+ * \enum	enum adc_profile_e
+ * \brief   Trade-offs between conversion time, power and noise for the 16-bit conversions
+ */
+enum adc_profile_e{
+	ADC_PROFILE_LOW_POWER,	/* Low power, long sample time. The configuration init_onboard_adc sets */
+	ADC_PROFILE_FAST,		/* Normal power, short sample time */
+	ADC_PROFILE_AVERAGE4	/* Low power, long sample time, 4 conversions averaged per result */
+};
+
+/**
+ * \var		adc_scan_count
+ * \brief	Defined in adc.c
+ */
+extern uint32_t adc_scan_count;
+
+/**
+ * \var		adc_scan_overruns
+ * \brief	Defined in adc.c
+ */
+extern volatile uint32_t adc_scan_overruns[ADC_SCAN_MAX_CHANNELS];
+
 /**
  * \fn		void init_onboard_adc
  * \param	N/A
@@ -40,4 +112,112 @@
  */
 void init_onboard_adc(void);
 
+/**
+ * \fn		void adc_set_profile
+ * \param	adc_profile_t profile
+ * \return	N/A
+ * \brief   Reconfigures CFG1 and SC3 for a profile. Takes effect from the next conversion,
+ * 			so it is safe while a scan is running
+ */
+void adc_set_profile(adc_profile_t profile);
+
+/**
+ * \fn		adc_profile_t adc_get_profile
+ * \param	N/A
+ * \return	The profile last set
+ */
+adc_profile_t adc_get_profile(void);
+
+/**
+ * \fn		void init_onboard_adc_scan
+ * \param	const uint8_t *channels SC1[ADCH] values to round-robin
+ * \param	uint32_t count Number of channels, at most ADC_SCAN_MAX_CHANNELS
+ * \return	N/A
+ * \brief   Switches the ADC to scan mode: TPM1 overflow triggers each conversion and
+ * 			ADC0_IRQHandler files the result into that channel's ring before selecting
+ * 			the next channel. Call after init_onboard_adc and init_onboard_tpm
+ */
+void init_onboard_adc_scan(const uint8_t *channels, uint32_t count);
+
+/**
+ * \fn		void adc_scan_notify
+ * \param	task_t *task Posted to, NULL to stop
+ * \param	uint16_t signal Posted with the channel's index as its param
+ * \param	uint32_t samples How many samples a channel gets between posts
+ * \return	N/A
+ * \brief   Has ADC0_IRQHandler post to a task's inbox each time a channel's ring
+ * 			gains that many samples, so the reader can sleep until there is something
+ * 			to read
+ */
+void adc_scan_notify(task_t *task, uint16_t signal, uint32_t samples);
+
+/**
+ * \fn		bool adc_scan_read
+ * \param	uint32_t ch Index into the scan's channel list
+ * \param	int16_t *samples Destination for n samples
+ * \param	uint32_t n
+ * \return	true if n samples were available and copied out, false otherwise
+ * \brief   Takes the oldest n samples out of a channel's ring
+ */
+bool adc_scan_read(uint32_t ch, int16_t *samples, uint32_t n);
+
+/**
+ * \fn		const int16_t *adc_scan_ring
+ * \param	uint32_t ch Index into the scan's channel list
+ * \return	The channel's ring, ADC_SCAN_RING_SIZE samples
+ * \brief   For readers that work on the ring in place (see frame.c)
+ */
+const int16_t *adc_scan_ring(uint32_t ch);
+
+/**
+ * \fn		uint32_t adc_scan_read_index
+ * \param	uint32_t ch Index into the scan's channel list
+ * \return	Samples ever read from the channel. The oldest unread sample is at
+ * 			this index masked by ADC_SCAN_RING_SIZE - 1
+ */
+uint32_t adc_scan_read_index(uint32_t ch);
+
+/**
+ * \fn		uint32_t adc_scan_available
+ * \param	uint32_t ch Index into the scan's channel list
+ * \return	Samples written to the channel's ring and not read yet
+ */
+uint32_t adc_scan_available(uint32_t ch);
+
+/**
+ * \fn		void adc_scan_consume
+ * \param	uint32_t ch Index into the scan's channel list
+ * \param	uint32_t n Samples to mark as read, at most adc_scan_available(ch)
+ * \return	N/A
+ * \brief   Frees the oldest n samples for ADC0_IRQHandler to overwrite
+ */
+void adc_scan_consume(uint32_t ch, uint32_t n);
+
+/**
+ * \fn		void adc_scan_flush
+ * \param	uint32_t ch Index into the scan's channel list
+ * \return	N/A
+ * \brief   Discards everything currently in a channel's ring
+ */
+void adc_scan_flush(uint32_t ch);
+
+/**
+ * \fn		void adc_scan_report
+ * \param	N/A
+ * \return	N/A
+ * \brief   Prints the scan's aggregate and per-channel rates against the limits set by
+ * 			the conversion time, and the overrun counters
+ */
+void adc_scan_report(void);
+
+/**
+ * \fn		void ADC0_IRQHandler
+ * \param	N/A
+ * \return	N/A
+ * \brief   The ISR for ADC0 conversion complete, used in scan mode
+ * \detail	FUNCTION NAME IS CASE SENSITIVE. Since it is weakly defined in
+ * 			startup\startup_mkl25z4.c this definition will override
+ */
+void ADC0_IRQHandler(void);
+
 #endif /* ADC_H_ */
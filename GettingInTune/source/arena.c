@@ -0,0 +1,124 @@
+/**
+ * \file    arena.c
+ * \author	Dayton Flores (dafl2542@colorado.edu)
+ * \date	10/19/2026
+ * \brief   Function definitions for the sample arena
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "fsl_debug_console.h"
+
+/**
+ * User-defined libraries
+ */
+#include "arena.h"
+#include "section.h"
+
+_Static_assert(ARENA_BLOCKS <= UINT8_MAX, "per-owner block counts are 8 bits");
+
+/**
+ * \var		arena
+ * \brief	The arena. Word aligned, for DMA and the detectors. Every owner writes its
+ * 			blocks before reading them, so startup doesn't spend time zeroing it
+ */
+static int16_t arena[ARENA_SAMPLES] NOINIT __attribute__((aligned(4)));
+
+/**
+ * \var		arena_owners
+ * \brief	Owner of each block
+ */
+static uint8_t arena_owners[ARENA_BLOCKS];
+
+/**
+ * \var		arena_blocks_used
+ * \brief	Blocks borrowed right now, and the most ever
+ */
+static uint32_t arena_blocks_used = 0;
+static uint32_t arena_blocks_peak = 0;
+
+/**
+ * \var		arena_owner_blocks
+ * \brief	Blocks each owner holds right now, and the most it ever has
+ */
+static uint8_t arena_owner_blocks[ARENA_OWNERS];
+static uint8_t arena_owner_peak[ARENA_OWNERS];
+
+/**
+ * \var		arena_owner_names
+ * \brief	What arena_report calls each owner, in enum order
+ */
+static const char * const arena_owner_names[ARENA_OWNERS] = {
+	"free", "dac", "capture", "scan", "window", "bench"
+};
+
+int16_t *arena_borrow(arena_owner_t owner, uint32_t samples)
+{
+	uint32_t blocks = ARENA_ROUND(samples) / ARENA_BLOCK_SAMPLES;
+	uint32_t run = 0;
+
+	/**
+	 * First fit
+	 */
+	for(uint32_t b = 0; (b < ARENA_BLOCKS) && (blocks > 0); b++){
+		run = (arena_owners[b] == ARENA_FREE) ? (run + 1) : 0;
+		if(run == blocks){
+			uint32_t first = b + 1 - blocks;
+
+			for(uint32_t i = first; i <= b; i++){
+				arena_owners[i] = (uint8_t)owner;
+			}
+			arena_blocks_used += blocks;
+			if(arena_blocks_used > arena_blocks_peak){
+				arena_blocks_peak = arena_blocks_used;
+			}
+			arena_owner_blocks[owner] += blocks;
+			if(arena_owner_blocks[owner] > arena_owner_peak[owner]){
+				arena_owner_peak[owner] = arena_owner_blocks[owner];
+			}
+			return &arena[first * ARENA_BLOCK_SAMPLES];
+		}
+	}
+
+	PRINTF("arena: no room for %u samples, %u of %u in use\r\n",
+			(unsigned)samples,
+			(unsigned)arena_used(),
+			(unsigned)ARENA_SAMPLES);
+	return NULL;
+}
+
+void arena_return(arena_owner_t owner)
+{
+	for(uint32_t b = 0; b < ARENA_BLOCKS; b++){
+		if(arena_owners[b] == owner){
+			arena_owners[b] = ARENA_FREE;
+			arena_blocks_used--;
+		}
+	}
+	arena_owner_blocks[owner] = 0;
+}
+
+uint32_t arena_used(void)
+{
+	return arena_blocks_used * ARENA_BLOCK_SAMPLES;
+}
+
+uint32_t arena_peak(void)
+{
+	return arena_blocks_peak * ARENA_BLOCK_SAMPLES;
+}
+
+void arena_report(void)
+{
+	PRINTF("arena: %u of %u samples, peak = %u\r\n",
+			(unsigned)arena_used(),
+			(unsigned)ARENA_SAMPLES,
+			(unsigned)arena_peak());
+	for(uint32_t owner = ARENA_FREE + 1; owner < ARENA_OWNERS; owner++){
+		PRINTF("arena: %-8s %5u samples, peak = %u\r\n",
+				arena_owner_names[owner],
+				(unsigned)(arena_owner_blocks[owner] * ARENA_BLOCK_SAMPLES),
+				(unsigned)(arena_owner_peak[owner] * ARENA_BLOCK_SAMPLES));
+	}
+}
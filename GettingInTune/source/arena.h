@@ -0,0 +1,189 @@
+/**
+ * \file    arena.h
+ * \author	Dayton Flores (dafl2542@colorado.edu)
+ * \date	10/19/2026
+ * \brief   Macros and function headers for the sample arena
+ * \detail
+ * 		Every large sample buffer lives in one statically sized arena instead of its
+ * 		own static array: the DAC buffer (playback), adc_buffer or the scan rings
+ * 		(capture) and the frame window (analysis). Builds only ever use some of them,
+ * 		and the arena is sized to the most the build borrows at once, so RAM is spent
+ * 		on what the build runs rather than on everything it could.
+ *
+ * 		Owners borrow blocks with arena_borrow() for as long as they need them and
+ * 		give them back with arena_return(). The size is each build's worst case, so
+ * 		borrows at startup can't fail. The arena, the rest of .data and .bss, and the
+ * 		heap and stack have to fit in SRAM together, which ARENA_SRAM_BYTES checks at
+ * 		compile time (the generated linker script can't hold the check, the IDE
+ * 		rewrites it).
+ */
+
+#ifndef ARENA_H_
+#define ARENA_H_
+
+#include <stdint.h>
+
+/**
+ * User-defined libraries
+ */
+#include "adc.h"
+#include "bench.h"
+#include "frame.h"
+#include "stream.h"
+#include "tone.h"
+
+/**
+ * \def		ARENA_BLOCK_SAMPLES
+ * \brief	Samples per block, the unit the arena hands out
+ */
+#define ARENA_BLOCK_SAMPLES\
+	(256)
+
+/**
+ * \def		ARENA_ROUND
+ * \brief	Samples n takes up in the arena, rounded up to whole blocks
+ */
+#define ARENA_ROUND(n)\
+	((((n) + ARENA_BLOCK_SAMPLES - 1) / ARENA_BLOCK_SAMPLES) * ARENA_BLOCK_SAMPLES)
+
+/**
+ * \def		ARENA_BUDGET_CAPTURE
+ * \brief	Samples capture and analysis borrow at once
+ */
+#ifdef ADC_SCAN
+#define ARENA_BUDGET_CAPTURE\
+	(ADC_SCAN_MAX_CHANNELS * ARENA_ROUND(ADC_SCAN_RING_SIZE) + ARENA_ROUND(FRAME_MAX_LENGTH))
+#else
+#define ARENA_BUDGET_CAPTURE\
+	(ARENA_ROUND(ADC_BUF_SIZE))
+#endif
+
+/**
+ * \def		ARENA_BUDGET_BENCH
+ * \brief	Samples the benchmark borrows next to capture. Polled builds lend it the
+ * 			capture's blocks
+ */
+#if defined(BENCH_LOOPBACK) && defined(ADC_SCAN)
+#define ARENA_BUDGET_BENCH\
+	(ARENA_ROUND(BENCH_BLOCK_SIZE))
+#else
+#define ARENA_BUDGET_BENCH\
+	(0)
+#endif
+
+/**
+ * \def		ARENA_SAMPLES
+ * \brief	Size of the arena in 16-bit samples: the most the build borrows at once,
+ * 			playback and then capture and analysis. 6 KB polled, 7 KB with ADC_SCAN,
+ * 			8 KB with ADC_SCAN and BENCH_LOOPBACK
+ */
+#define ARENA_SAMPLES\
+	(ARENA_ROUND(DAC_BUF_SIZE) + ARENA_BUDGET_CAPTURE + ARENA_BUDGET_BENCH)
+
+/**
+ * \def		ARENA_BLOCKS
+ * \brief	Blocks in the arena
+ */
+#define ARENA_BLOCKS\
+	(ARENA_SAMPLES / ARENA_BLOCK_SAMPLES)
+
+/**
+ * \def		ARENA_SRAM_BYTES
+ * \brief	SRAM on the MKL25Z128 (MKL25Z4_Project_Debug_memory.ld)
+ */
+#define ARENA_SRAM_BYTES\
+	(16 * 1024)
+
+/**
+ * \def		ARENA_HEAP_STACK_BYTES
+ * \brief	_HeapSize and _StackSize, the MCU settings' defaults in .cproject
+ */
+#define ARENA_HEAP_STACK_BYTES\
+	(0x400 + 0x400)
+
+/**
+ * \def		ARENA_STATIC_BYTES
+ * \brief	.data, .bss and .ramfunc outside the arena, ~4.75 KB. The host map (make
+ * 			map-report) puts the firmware's .data and .bss at 4.9 KB with CONSOLE=1, of
+ * 			which ~0.9 KB is const pointer tables (flash on the target) and 64-bit
+ * 			pointers; .ramfunc adds ~0.7 KB back. The benchmark's results and the
+ * 			stream's frames (stream.c) come on top
+ */
+#if defined(BENCH_LOOPBACK) && defined(STREAM_EXPORT)
+#define ARENA_STATIC_BYTES\
+	(4864 + 1024 + STREAM_FRAMES * (STREAM_FRAME_SIZE + sizeof(uint32_t)))
+#elif defined(BENCH_LOOPBACK)
+#define ARENA_STATIC_BYTES\
+	(4864 + 1024)
+#elif defined(STREAM_EXPORT)
+#define ARENA_STATIC_BYTES\
+	(4864 + STREAM_FRAMES * (STREAM_FRAME_SIZE + sizeof(uint32_t)))
+#else
+#define ARENA_STATIC_BYTES\
+	(4864)
+#endif
+
+_Static_assert(ARENA_SAMPLES * sizeof(int16_t) + ARENA_STATIC_BYTES + ARENA_HEAP_STACK_BYTES <= ARENA_SRAM_BYTES,
+		"arena: the arena, the other statics, the heap and the stack don't fit in SRAM");
+
+/**
+ * \typedef	typedef enum arena_owner_e arena_owner_t
+ * \brief   Easily declare arena owners
+ */
+typedef enum arena_owner_e arena_owner_t;
+
+/**
+ * \enum	enum arena_owner_e
+ * \brief   Who holds a block
+ */
+enum arena_owner_e{
+	ARENA_FREE,
+	ARENA_OWNER_DAC,		/* dac_buffer, for good */
+	ARENA_OWNER_CAPTURE,	/* adc_buffer in polled builds, from pipeline_start on */
+	ARENA_OWNER_SCAN,		/* The scan rings, from init_onboard_adc_scan on */
+	ARENA_OWNER_WINDOW,		/* The frame window, from init_frames to the next one */
+	ARENA_OWNER_BENCH,		/* adc_buffer during bench_loopback_run */
+	ARENA_OWNERS
+};
+
+/**
+ * \fn		int16_t *arena_borrow
+ * \param	arena_owner_t owner
+ * \param	uint32_t samples
+ * \return	The first of samples contiguous samples, or NULL if they don't fit
+ * \brief   Hands out enough whole blocks for samples. Call from the main loop
+ */
+int16_t *arena_borrow(arena_owner_t owner, uint32_t samples);
+
+/**
+ * \fn		void arena_return
+ * \param	arena_owner_t owner
+ * \return	N/A
+ * \brief   Frees every block owner holds
+ */
+void arena_return(arena_owner_t owner);
+
+/**
+ * \fn		uint32_t arena_used
+ * \param	N/A
+ * \return	Samples borrowed right now
+ */
+uint32_t arena_used(void);
+
+/**
+ * \fn		uint32_t arena_peak
+ * \param	N/A
+ * \return	Most samples ever borrowed at once
+ */
+uint32_t arena_peak(void);
+
+/**
+ * \fn		void arena_report
+ * \param	N/A
+ * \return	N/A
+ * \brief   Prints what the arena holds as a whole and per owner, now and at most. An
+ * 			owner's peak is what its buffers could be trimmed to
+ */
+void arena_report(void);
+
+#endif /* ARENA_H_ */
@@ -15,12 +15,54 @@
 #include <assert.h>
 
 #include "autocorrelate.h"
+#include "section.h"
+
+
+// Lags the detectors may return, see autocorrelate_set_lag_bounds
+static uint32_t lag_min = 0;
+static uint32_t lag_max = UINT32_MAX;
+
+
+/*
+ * Number of lags to compute for a buffer of nsamp samples: a peak is
+ * only recognized one lag past it, so stop one past lag_max
+ */
+static uint32_t
+lag_end(uint32_t nsamp)
+{
+  if (nsamp > 0 && lag_max < nsamp - 1)
+    return lag_max + 2;
+  return nsamp;
+}
 
 
 /*
  * See documentation in .h file
  */
-int
+void
+autocorrelate_set_lag_bounds(uint32_t min_lag, uint32_t max_lag)
+{
+  lag_min = min_lag;
+  lag_max = max_lag;
+}
+
+
+/*
+ * See documentation in .h file
+ */
+void
+autocorrelate_get_lag_bounds(uint32_t *min_lag, uint32_t *max_lag)
+{
+  *min_lag = lag_min;
+  *max_lag = lag_max;
+}
+
+
+/*
+ * See documentation in .h file. The O(N^2) inner loop is the hottest
+ * code in the tuner, so it runs from SRAM
+ */
+RAMFUNC int
 autocorrelate_detect_period(void *samples, uint32_t nsamp,
     autocorrelate_sample_format_t format)
 {
@@ -31,9 +73,19 @@ autocorrelate_detect_period(void *samples, uint32_t nsamp,
 
   int32_t s1 = 0;
   int32_t s2 = 0;
+  uint32_t end = lag_end(nsamp);
+  bool skipped = false;
   
   sum = 0;
-  for (int i=0; i < nsamp; i++) {
+  for (int i=0; i < end; i++) {
+    if (i == 1 && lag_min > 1) {
+      // Lags below lag_min can't be reported; the one just below it is
+      // still needed for the slope at lag_min
+      i = lag_min - 1;
+      skipped = true;
+      if (i >= end)
+        break;
+    }
     prev_sum = sum;
     sum = 0;
 
@@ -65,6 +117,9 @@ autocorrelate_detect_period(void *samples, uint32_t nsamp,
     if (i == 0) {
       thresh = sum / 2;
 
+    } else if (skipped) {
+      skipped = false;
+
     } else if ((sum > thresh) && (sum - prev_sum > 0)) {
       // slope is positive, so now enter mode where we're looking for
       // negative slope
@@ -82,6 +137,86 @@ autocorrelate_detect_period(void *samples, uint32_t nsamp,
 }
 
 
+/*
+ * See documentation in .h file. From SRAM too, see above
+ */
+RAMFUNC int
+autocorrelate_detect_period_ring(const void *ring, uint32_t mask,
+    uint32_t start, uint32_t nsamp, const int16_t *window,
+    autocorrelate_sample_format_t format)
+{
+  int32_t sum = 0;
+  int prev_sum = 0;
+  int32_t thresh = 0;
+  bool slope_positive = false;
+
+  int32_t s1 = 0;
+  int32_t s2 = 0;
+  uint32_t end = lag_end(nsamp);
+  bool skipped = false;
+
+  for (int i=0; i < end; i++) {
+    if (i == 1 && lag_min > 1) {
+      i = lag_min - 1;
+      skipped = true;
+      if (i >= end)
+        break;
+    }
+    prev_sum = sum;
+    sum = 0;
+
+    for (int k=0; k < nsamp - i; k++) {
+      uint32_t j1 = (start + k) & mask;
+      uint32_t j2 = (start + k + i) & mask;
+
+      switch (format) {
+
+      case kAC_12bps_unsigned:
+        s1 = (int32_t)*((uint16_t*)ring + j1) - (1 << 11);
+        s2 = (int32_t)*((uint16_t*)ring + j2) - (1 << 11);
+        break;
+
+      case kAC_16bps_unsigned:
+        s1 = (int32_t)*((uint16_t*)ring + j1) - (1 << 15);
+        s2 = (int32_t)*((uint16_t*)ring + j2) - (1 << 15);
+        break;
+
+      case kAC_12bps_signed:
+      case kAC_16bps_signed:
+        s1 = *((int16_t*)ring + j1);
+        s2 = *((int16_t*)ring + j2);
+        break;
+      }
+
+      // Weights are Q15, and samples are centered on 0 by now
+      if (window) {
+        s1 = (s1 * window[k]) >> 15;
+        s2 = (s2 * window[k+i]) >> 15;
+      }
+
+      sum += (s1 * s2) >>
+          ((format == kAC_12bps_signed || format == kAC_12bps_unsigned) ? 12 : 16);
+    }
+
+    if (i == 0) {
+      thresh = sum / 2;
+
+    } else if (skipped) {
+      skipped = false;
+
+    } else if ((sum > thresh) && (sum - prev_sum > 0)) {
+      slope_positive = true;
+
+    } else if (slope_positive && (sum - prev_sum) <= 0) {
+      return i-1;
+    }
+  }
+
+  // no correlation found
+  return -1;
+}
+
+
 //#define TESTING
 
 #ifdef TESTING
@@ -120,6 +255,32 @@ int main()
     assert(period-res2 <= slop && res2-period <= slop);
     assert(period-res3 <= slop && res3-period <= slop);
     assert(period-res4 <= slop && res4-period <= slop);
+
+    // The same data as a frame that wraps around the end of a ring
+    uint16_t ring[BUF_SIZE];
+    const uint32_t start = BUF_SIZE - 100;
+
+    for (int i=0; i < BUF_SIZE; i++) {
+      ring[(start + i) & (BUF_SIZE - 1)] = unsigned_16bps_test[i];
+    }
+
+    int res5 = autocorrelate_detect_period_ring(ring, BUF_SIZE - 1, start,
+        BUF_SIZE, NULL, kAC_16bps_unsigned);
+    assert(period-res5 <= slop && res5-period <= slop);
+
+    // Bounds above the period find the next peak, at twice the period
+    // (and twice the slop); bounds below it find nothing
+    if (2 * period < BUF_SIZE / 2) {
+      autocorrelate_set_lag_bounds(period + period / 2, 3 * period);
+      int res6 = autocorrelate_detect_period(signed_16bps_test, BUF_SIZE, kAC_16bps_signed);
+      int res7 = autocorrelate_detect_period_ring(ring, BUF_SIZE - 1, start,
+          BUF_SIZE, NULL, kAC_16bps_unsigned);
+      assert(2*period-res6 <= 2*slop && res6-2*period <= 2*slop);
+      assert(2*period-res7 <= 2*slop && res7-2*period <= 2*slop);
+    }
+    autocorrelate_set_lag_bounds(0, period / 2);
+    assert(autocorrelate_detect_period(signed_16bps_test, BUF_SIZE, kAC_16bps_signed) == -1);
+    autocorrelate_set_lag_bounds(0, UINT32_MAX);
   }
 }
 
@@ -35,4 +35,44 @@ int autocorrelate_detect_period(void *samples, uint32_t nsamp,
     autocorrelate_sample_format_t format);
 
 
+/*
+ * Same as autocorrelate_detect_period, but for a frame that sits in a
+ * ring buffer, optionally weighted by a window. Nothing is copied:
+ * sample k of the frame is read from ring[(start + k) & mask]
+ *
+ * Parameters:
+ *   ring      Ring buffer of samples; its size must be a power of 2
+ *   mask      Ring size - 1
+ *   start     Ring index of the first sample of the frame
+ *   nsamp     Number of samples in the frame
+ *   window    nsamp Q15 weights applied to the frame, or NULL for none
+ *   format    The format for the samples (see above)
+ *
+ * Returns:
+ *   The recovered fundamental period of the waveform, expressed in
+ *   number of samples, or -1 if no correlation was found
+ */
+int autocorrelate_detect_period_ring(const void *ring, uint32_t mask,
+    uint32_t start, uint32_t nsamp, const int16_t *window,
+    autocorrelate_sample_format_t format);
+
+
+/*
+ * Restrict the lags both detectors will return. A peak outside the
+ * bounds is passed over; the search ends after max_lag. Bounds hold
+ * until changed; (0, UINT32_MAX) lifts them
+ *
+ * Parameters:
+ *   min_lag   Shortest period to report, in samples
+ *   max_lag   Longest period to report, in samples
+ */
+void autocorrelate_set_lag_bounds(uint32_t min_lag, uint32_t max_lag);
+
+
+/*
+ * Read back the bounds set by autocorrelate_set_lag_bounds
+ */
+void autocorrelate_get_lag_bounds(uint32_t *min_lag, uint32_t *max_lag);
+
+
 #endif  //  _AUTOCORRELATE_H_
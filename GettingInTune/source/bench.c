@@ -0,0 +1,417 @@
+/**
+ * \file    bench.c
+ * \author	Dayton Flores (dafl2542@colorado.edu)
+ * \date	10/19/2026
+ * \brief   Function definitions for the DAC-to-detector loopback benchmark
+ */
+
+#include <stdio.h>
+#include "board.h"
+#include "fsl_debug_console.h"
+
+/**
+ * User-defined libraries
+ */
+#include "adc.h"
+#include "arena.h"
+#include "autocorrelate.h"
+#include "bench.h"
+#include "cents.h"
+#include "dma.h"
+#include "event.h"
+#include "instr.h"
+#include "section.h"
+#include "systick.h"
+#include "tone.h"
+#include "tpm.h"
+
+/**
+ * \def		ADC_DMA_CHANNEL
+ * \brief	DMA channel that moves ADC results (channel 0 feeds the DAC, channel 2 the
+ * 			stream export)
+ */
+#define ADC_DMA_CHANNEL\
+	(1)
+
+/**
+ * \def		ADC_DMA_SOURCE
+ * \brief	DMAMUX source for ADC0 conversion complete
+ */
+#define ADC_DMA_SOURCE\
+	(40)
+
+/**
+ * \def		NUM_TONES
+ * \brief	Number of values in tone_t
+ */
+#define NUM_TONES\
+	(4)
+
+/**
+ * \def		BENCH_SETTLE_TICKS
+ * \brief	Idle time between iterations. The iteration number is added on top so
+ * 			note changes land at different phases of the DAC and ADC timers
+ */
+#define BENCH_SETTLE_TICKS\
+	(2667)
+
+/**
+ * \def		BENCH_KERNELS_IN
+ * \brief	Where the DSP kernels run from in this build, see section.h
+ */
+#if RAMFUNC_ENABLE
+#define BENCH_KERNELS_IN\
+	"SRAM"
+#else
+#define BENCH_KERNELS_IN\
+	"flash"
+#endif
+
+/**
+ * \enum	enum bench_stage_e
+ * \brief   Points after the note change that get timestamped
+ */
+enum bench_stage_e{
+	FIRST_SAMPLE,
+	BLOCK_DONE,
+	RESULT,
+	NUM_STAGES
+};
+
+/**
+ * \var		bench_latency
+ * \brief	Ticks from the note change to each stage, per tone and iteration
+ */
+static benchtime_t bench_latency[NUM_STAGES][NUM_TONES][BENCH_ITERATIONS];
+
+/**
+ * \var		bench_period
+ * \brief	Period each iteration detected, in samples, 0 if none
+ */
+static int16_t bench_period[NUM_TONES][BENCH_ITERATIONS];
+
+#ifndef ADC_SCAN
+_Static_assert(ARENA_ROUND(BENCH_BLOCK_SIZE) <= ARENA_BUDGET_CAPTURE,
+		"polled builds budget no arena for the benchmark, its block has to fit in the capture's");
+#endif
+_Static_assert((BENCH_BLOCK_SIZE << 1) <= DMA_DSR_BCR_BCR_MASK, "the block is one DMA transfer");
+_Static_assert(sizeof(bench_latency) + sizeof(bench_period) <= 1024,
+		"the benchmark's results are budgeted at 1 KB of SRAM (ARENA_STATIC_BYTES)");
+
+benchtime_t bench_now(void)
+{
+	return (benchtime_t)now_us();
+}
+
+/**
+ * \fn		void capture_adc_block
+ * \param	benchtime_t *first Timestamp of the first conversion
+ * \param	benchtime_t *last Timestamp of the last conversion
+ * \return	N/A
+ * \brief   Fills adc_buffer with one conversion per TPM1 overflow (SAMPLE_RATE_ADC_HZ)
+ * \detail
+ * 		TPM1 overflow triggers the conversions in hardware and DMA channel 1 moves each
+ * 		result into adc_buffer, so the sample rate doesn't depend on how fast this loop
+ * 		polls. The ADC is handed back in software trigger mode for the main loop
+ */
+static void capture_adc_block(benchtime_t *first, benchtime_t *last)
+{
+	/**
+	 * Route ADC0 complete to DMA channel 1: 16-bit R[0] into adc_buffer, one per request
+	 */
+	DMAMUX0->CHCFG[ADC_DMA_CHANNEL] = 0;
+	DMA0->DMA[ADC_DMA_CHANNEL].DSR_BCR = DMA_DSR_BCR_DONE_MASK;
+	DMA0->DMA[ADC_DMA_CHANNEL].SAR = DMA_SAR_SAR((uint32_t)(&(ADC0->R[0])));
+	DMA0->DMA[ADC_DMA_CHANNEL].DAR = DMA_DAR_DAR((uint32_t)(adc_buffer));
+	DMA0->DMA[ADC_DMA_CHANNEL].DSR_BCR = DMA_DSR_BCR_BCR(BENCH_BLOCK_SIZE << 1);
+	DMA0->DMA[ADC_DMA_CHANNEL].DCR =
+		DMA_DCR_ERQ_MASK |
+		DMA_DCR_CS_MASK |
+		DMA_DCR_SSIZE(2) |
+		DMA_DCR_DINC_MASK |
+		DMA_DCR_DSIZE(2) |
+		DMA_DCR_D_REQ_MASK;
+	DMAMUX0->CHCFG[ADC_DMA_CHANNEL] =
+		DMAMUX_CHCFG_ENBL_MASK |
+		DMAMUX_CHCFG_SOURCE(ADC_DMA_SOURCE);
+
+	/**
+	 * Hardware trigger from TPM1 overflow, DMA request on conversion complete
+	 */
+	SIM->SOPT7 =
+		SIM_SOPT7_ADC0ALTTRGEN_MASK |
+		SIM_SOPT7_ADC0TRGSEL(ADC0TRGSEL_TPM1_OVERFLOW);
+	ADC0->SC2 |=
+		ADC_SC2_ADTRG_MASK |
+		ADC_SC2_DMAEN_MASK;
+	ADC0->SC1[0] = ADC_SC1_ADCH(SC1_ADCH);
+
+	while((DMA0->DMA[ADC_DMA_CHANNEL].DSR_BCR & DMA_DSR_BCR_BCR_MASK) == (BENCH_BLOCK_SIZE << 1));
+	*first = bench_now();
+	while(!(DMA0->DMA[ADC_DMA_CHANNEL].DSR_BCR & DMA_DSR_BCR_DONE_MASK));
+	*last = bench_now();
+
+	/**
+	 * Back to software trigger
+	 */
+	ADC0->SC2 &= ~(ADC_SC2_ADTRG_MASK | ADC_SC2_DMAEN_MASK);
+	SIM->SOPT7 = 0;
+	DMAMUX0->CHCFG[ADC_DMA_CHANNEL] = 0;
+	DMA0->DMA[ADC_DMA_CHANNEL].DSR_BCR = DMA_DSR_BCR_DONE_MASK;
+}
+
+/**
+ * \fn		void bench_cycles
+ * \param	instr_timer_t *timer
+ * \param	uint32_t start systick_timestamp() at the start of the interval
+ * \return	N/A
+ * \brief   Adds the interval since start to timer, in core cycles
+ */
+static void bench_cycles(instr_timer_t *timer, uint32_t start)
+{
+	uint32_t cycles = instr_cycles(systick_timestamp() - start);
+
+	if((timer->count == 0) || (cycles < timer->min)){
+		timer->min = cycles;
+	}
+	if(cycles > timer->max){
+		timer->max = cycles;
+	}
+	timer->total += cycles;
+	timer->count++;
+}
+
+/**
+ * \fn		void sort_ticks
+ * \param	benchtime_t *ticks
+ * \param	int n
+ * \return	N/A
+ * \brief   Insertion sort, n is at most BENCH_ITERATIONS
+ */
+static void sort_ticks(benchtime_t *ticks, int n)
+{
+	for(int i = 1; i < n; i++){
+		benchtime_t t = ticks[i];
+		int j = i - 1;
+
+		while((j >= 0) && (ticks[j] > t)){
+			ticks[j + 1] = ticks[j];
+			j--;
+		}
+		ticks[j + 1] = t;
+	}
+}
+
+/**
+ * \fn		benchtime_t percentile
+ * \param	const benchtime_t *sorted
+ * \param	int n
+ * \param	int p Percentile, 0 to 100
+ * \return	Nearest-rank percentile of sorted
+ */
+static benchtime_t percentile(const benchtime_t *sorted, int n, int p)
+{
+	int rank = (p * n + 99) / 100;
+
+	return sorted[(rank > 0) ? (rank - 1) : 0];
+}
+
+void bench_loopback_run(tone_t resume_tone)
+{
+	static const char * const tone_names[NUM_TONES] = { "A4", "D5", "E5", "A5" };
+	static const char * const stage_names[NUM_STAGES] = { "first sample", "block done", "result" };
+	int32_t tone_hz[NUM_TONES] = { 0 };
+	instr_timer_t fill_cycles[NUM_TONES] = { 0 };
+	instr_timer_t detect_cycles[NUM_TONES] = { 0 };
+	instr_timer_t cents_cycles[NUM_TONES] = { 0 };
+	int32_t tenths;
+	uint32_t start;
+	benchtime_t t_note;
+	benchtime_t t_first;
+	benchtime_t t_last;
+	benchtime_t t_result;
+	int period;
+	float rate_hz;
+
+	/**
+	 * adc_buffer is only borrowed for the benchmark
+	 */
+	adc_buffer = arena_borrow(ARENA_OWNER_BENCH, BENCH_BLOCK_SIZE);
+	if(adc_buffer == NULL){
+		return;
+	}
+
+	/**
+	 * Use the sample rate TPM1 achieves, not the nominal one
+	 */
+	rate_hz = tpm_overflow_rate_hz(TPM1);
+
+	PRINTF("Loopback benchmark: %d iterations per tone, timestamps at %d Hz\r\n",
+			BENCH_ITERATIONS, BENCH_TICK_HZ);
+#if defined(HOST_SIM)
+	PRINTF("Kernel cycles not measured: host code takes no simulated time\r\n");
+#endif
+
+	for(int i = 0; i < BENCH_ITERATIONS; i++){
+		for(int tone = 0; tone < NUM_TONES; tone++){
+
+			/**
+			 * Let the previous tone play on for a varying amount of time
+			 */
+			t_note = bench_now();
+			while(bench_now() - t_note < BENCH_SETTLE_TICKS + (benchtime_t)(i * NUM_TONES + tone));
+
+			/**
+			 * Change note
+			 */
+			start = systick_timestamp();
+			fill_dac_buffer((tone_t)tone);
+			bench_cycles(&fill_cycles[tone], start);
+			start_onboard_dma((uint16_t*)dac_buffer, dac_buffer_samples << 1);
+			t_note = bench_now();
+			tone_hz[tone] = dac_buffer_hz;
+
+			/**
+			 * Capture a block off the loopback and detect its period
+			 */
+			capture_adc_block(&t_first, &t_last);
+			start = systick_timestamp();
+			period = autocorrelate_detect_period(adc_buffer, BENCH_BLOCK_SIZE, kAC_16bps_unsigned);
+			bench_cycles(&detect_cycles[tone], start);
+			t_result = bench_now();
+
+			bench_latency[FIRST_SAMPLE][tone][i] = t_first - t_note;
+			bench_latency[BLOCK_DONE][tone][i] = t_last - t_note;
+			bench_latency[RESULT][tone][i] = t_result - t_note;
+			bench_period[tone][i] = (int16_t)((period > 0) ? period : 0);
+
+			if(period > 0){
+				start = systick_timestamp();
+				cents_note((uint32_t)(rate_hz * 65536.0f / period), &tenths);
+				bench_cycles(&cents_cycles[tone], start);
+			}
+		}
+	}
+
+	/**
+	 * Latency percentiles per tone and stage, in us
+	 */
+	for(int tone = 0; tone < NUM_TONES; tone++){
+		int detected = 0;
+		int period_min = 0;
+		int period_max = 0;
+		float hz_sum = 0;
+		float error_sum = 0;
+		float error_max = 0;
+
+		for(int stage = 0; stage < NUM_STAGES; stage++){
+			benchtime_t *ticks = bench_latency[stage][tone];
+
+			sort_ticks(ticks, BENCH_ITERATIONS);
+			PRINTF("%s %-12s us: min = %u, p50 = %u, p90 = %u, p99 = %u, max = %u\r\n",
+					tone_names[tone],
+					stage_names[stage],
+					(unsigned)ticks[0],
+					(unsigned)percentile(ticks, BENCH_ITERATIONS, 50),
+					(unsigned)percentile(ticks, BENCH_ITERATIONS, 90),
+					(unsigned)percentile(ticks, BENCH_ITERATIONS, 99),
+					(unsigned)ticks[BENCH_ITERATIONS - 1]);
+		}
+
+#if !defined(HOST_SIM)
+
+		/**
+		 * Time in the DAC refill and the detector, to compare kernels in flash and SRAM
+		 */
+		PRINTF("%s kernels in %s, cycles: fill min = %u, avg = %u, max = %u; detect min = %u, avg = %u, max = %u\r\n",
+				tone_names[tone],
+				BENCH_KERNELS_IN,
+				(unsigned)fill_cycles[tone].min,
+				(unsigned)(fill_cycles[tone].total / BENCH_ITERATIONS),
+				(unsigned)fill_cycles[tone].max,
+				(unsigned)detect_cycles[tone].min,
+				(unsigned)(detect_cycles[tone].total / BENCH_ITERATIONS),
+				(unsigned)detect_cycles[tone].max);
+#endif
+
+		/**
+		 * Frequency error of each iteration against the nominal tone. The detector
+		 * resolves whole samples of lag, so every iteration can read the same
+		 */
+		for(int i = 0; i < BENCH_ITERATIONS; i++){
+			int p = bench_period[tone][i];
+			float error;
+
+			if(p == 0){
+				continue;
+			}
+			if((detected == 0) || (p < period_min)){
+				period_min = p;
+			}
+			if(p > period_max){
+				period_max = p;
+			}
+			hz_sum += rate_hz / p;
+			error = rate_hz / p - tone_hz[tone];
+			if(error < 0){
+				error = -error;
+			}
+			error_sum += error;
+			if(error > error_max){
+				error_max = error;
+			}
+			detected++;
+		}
+
+		if(detected){
+			float mean = hz_sum / detected;
+			const note_t *note = cents_note((uint32_t)(mean * 65536.0f), &tenths);
+
+			/**
+			 * The fixed-point cents conversion of the mean detected frequency
+			 */
+#if defined(HOST_SIM)
+			PRINTF("%s cents: mean reads %s %+.1f cents\r\n",
+					tone_names[tone],
+					note ? note->name : "-",
+					tenths / 10.0f);
+#else
+			PRINTF("%s cents: mean reads %s %+.1f cents, cycles min = %u, avg = %u, max = %u\r\n",
+					tone_names[tone],
+					note ? note->name : "-",
+					tenths / 10.0f,
+					(unsigned)cents_cycles[tone].min,
+					(unsigned)(cents_cycles[tone].total / detected),
+					(unsigned)cents_cycles[tone].max);
+#endif
+			PRINTF("%s frequency: expected = %d Hz, detected min = %.2f, mean = %.2f, max = %.2f Hz, |error| mean = %.2f, max = %.2f Hz, missed = %d\r\n",
+					tone_names[tone],
+					tone_hz[tone],
+					rate_hz / period_max,
+					mean,
+					rate_hz / period_min,
+					error_sum / detected,
+					error_max,
+					BENCH_ITERATIONS - detected);
+			PRINTF("%s period: %d to %d samples, one sample of lag = %.2f Hz\r\n\n",
+					tone_names[tone],
+					period_min,
+					period_max,
+					rate_hz / period_min - rate_hz / (period_min + 1));
+		}
+		else{
+			PRINTF("%s frequency: expected = %d Hz, no period detected\r\n\n",
+					tone_names[tone],
+					tone_hz[tone]);
+		}
+	}
+
+	/**
+	 * Hand the DAC back to the main loop
+	 */
+	fill_dac_buffer(resume_tone);
+	start_onboard_dma((uint16_t*)dac_buffer, dac_buffer_samples << 1);
+
+	arena_return(ARENA_OWNER_BENCH);
+	adc_buffer = NULL;
+}
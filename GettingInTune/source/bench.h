@@ -0,0 +1,77 @@
+/**
+ * \file    bench.h
+ * \author	Dayton Flores (dafl2542@colorado.edu)
+ * \date	10/19/2026
+ * \brief   Macros and function headers for the DAC-to-detector loopback benchmark
+ * \detail
+ * 		Build with BENCH_LOOPBACK defined to run the benchmark once before the main loop.
+ * 		Each iteration changes the note on the DAC, captures one ADC block at the TPM1 rate
+ * 		and runs the period detector, timestamping every stage with now_us(). Latency
+ * 		percentiles and the frequency error for each tone_t are printed at the end.
+ *
+ * 		The DAC refill and the detector are also timed in core cycles. Build once more
+ * 		with RAMFUNC_ENABLE set to 0 to compare them running from flash instead of
+ * 		SRAM (section.h). The cents conversion (cents.h) of each detected frequency is
+ * 		timed the same way, which the host's cents-bench can't do.
+ */
+
+#ifndef BENCH_H_
+#define BENCH_H_
+
+#include <stdint.h>
+#include "adc.h"
+#include "tone.h"
+
+/**
+ * \def		BENCH_ITERATIONS
+ * \brief	Note changes measured per tone_t
+ */
+#ifndef BENCH_ITERATIONS
+#define BENCH_ITERATIONS\
+	(16)
+#endif
+
+/**
+ * \def		BENCH_BLOCK_SIZE
+ * \brief	Samples captured per note change. Polled builds lend the benchmark the
+ * 			capture's blocks, so it gets the block the pipeline analyzes. With ADC_SCAN
+ * 			the rings hold theirs and it takes a scan block's worth more (arena.h)
+ */
+#ifdef ADC_SCAN
+#define BENCH_BLOCK_SIZE\
+	(ADC_SCAN_BLOCK_SIZE)
+#else
+#define BENCH_BLOCK_SIZE\
+	(ADC_BUF_SIZE)
+#endif
+
+/**
+ * \def		BENCH_TICK_HZ
+ * \brief	Rate of the timestamps, now_us() from the event scheduler
+ */
+#define BENCH_TICK_HZ\
+	(1000000)
+
+/**
+ * \typedef	typedef uint32_t benchtime_t
+ * \brief   Timestamp in us (1 / BENCH_TICK_HZ), the low 32 bits of now_us()
+ */
+typedef uint32_t benchtime_t;
+
+/**
+ * \fn		benchtime_t bench_now
+ * \param	N/A
+ * \return	The current timestamp
+ * \brief   Needs init_event_scheduler to have run
+ */
+benchtime_t bench_now(void);
+
+/**
+ * \fn		void bench_loopback_run
+ * \param	tone_t resume_tone Tone to put back on the DAC when done
+ * \return	N/A
+ * \brief   Runs BENCH_ITERATIONS note changes per tone_t and prints the results
+ */
+void bench_loopback_run(tone_t resume_tone);
+
+#endif /* BENCH_H_ */
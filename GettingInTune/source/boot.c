@@ -0,0 +1,82 @@
+/**
+ * \file    boot.c
+ * \author	Dayton Flores (dafl2542@colorado.edu)
+ * \date	10/19/2026
+ * \brief   Function definitions for boot time measurement
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "board.h"
+
+/**
+ * User-defined libraries
+ */
+#include "boot.h"
+#include "dlog.h"
+#include "systick.h"
+
+/**
+ * \def		BOOT_EARLY_HZ
+ * \brief	SysTick rate before BOOT_MARK_CLOCKS: the reset clock over 16, see boot.h
+ */
+#ifdef HOST_SIM
+#define BOOT_EARLY_HZ\
+	(SYSTICK_TIMESTAMP_HZ)
+#else
+#define BOOT_EARLY_HZ\
+	(DEFAULT_SYSTEM_CLOCK / 16)
+#endif
+
+/**
+ * \var		boot_stamps
+ * \brief	systick_timestamp() at each milestone
+ */
+static uint32_t boot_stamps[BOOT_MARKS];
+
+/**
+ * \var		boot_marked
+ * \brief	Bit n is set once milestone n has been stamped
+ */
+static uint32_t boot_marked = 0;
+
+bool boot_mark(boot_mark_t mark)
+{
+	if(boot_marked & (1u << mark)){
+		return false;
+	}
+	boot_stamps[mark] = systick_timestamp();
+	boot_marked |= (1u << mark);
+	return true;
+}
+
+/**
+ * \fn		uint32_t boot_us
+ * \param	boot_mark_t mark
+ * \return	Microseconds from reset to mark, 0 if it hasn't been reached
+ */
+static uint32_t boot_us(boot_mark_t mark)
+{
+	uint32_t stamp = boot_stamps[mark];
+	uint32_t early = stamp;
+
+	if(!(boot_marked & (1u << mark))){
+		return 0;
+	}
+	if((boot_marked & (1u << BOOT_MARK_CLOCKS)) && (stamp > boot_stamps[BOOT_MARK_CLOCKS])){
+		early = boot_stamps[BOOT_MARK_CLOCKS];
+	}
+	return (uint32_t)(((uint64_t)early * 1000000u) / BOOT_EARLY_HZ +
+			((uint64_t)(stamp - early) * 1000000u) / SYSTICK_TIMESTAMP_HZ);
+}
+
+void boot_report(void)
+{
+	DLOG_AT(DLOG_LEVEL_OFF, "boot: main = %u us, clocks = %u us, init = %u us, dac = %u us, adc = %u us, result = %u us\r\n",
+			(unsigned)boot_us(BOOT_MARK_MAIN),
+			(unsigned)boot_us(BOOT_MARK_CLOCKS),
+			(unsigned)boot_us(BOOT_MARK_INIT),
+			(unsigned)boot_us(BOOT_MARK_DAC),
+			(unsigned)boot_us(BOOT_MARK_ADC),
+			(unsigned)boot_us(BOOT_MARK_RESULT));
+}
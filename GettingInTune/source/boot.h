@@ -0,0 +1,62 @@
+/**
+ * \file    boot.h
+ * \author	Dayton Flores (dafl2542@colorado.edu)
+ * \date	10/19/2026
+ * \brief   Macros and function headers for boot time measurement
+ * \detail
+ * 		ResetISR starts SysTick before it copies .data and zeroes .bss, so
+ * 		systick_timestamp() counts from (nearly) reset. boot_mark() stamps each
+ * 		milestone the first time it is reached, and boot_report() prints them all in us
+ * 		since reset once the first pitch is out.
+ *
+ * 		Until BOARD_InitBootClocks runs, SysTick counts the reset clock (the FLL at
+ * 		DEFAULT_SYSTEM_CLOCK) divided by 16 rather than SYSTICK_TIMESTAMP_HZ, so stamps
+ * 		from before BOOT_MARK_CLOCKS are scaled by that rate instead.
+ *
+ * 		On the host there is no ResetISR: SysTick starts at the top of main() and runs
+ * 		at the same rate throughout.
+ */
+
+#ifndef BOOT_H_
+#define BOOT_H_
+
+#include <stdbool.h>
+
+/**
+ * \typedef	typedef enum boot_mark_e boot_mark_t
+ * \brief   Easily declare boot milestones
+ */
+typedef enum boot_mark_e boot_mark_t;
+
+/**
+ * \enum	enum boot_mark_e
+ * \brief   Boot milestones, in the order they are reached
+ */
+enum boot_mark_e{
+	BOOT_MARK_MAIN,		/* main() entered: .data copied and .bss zeroed */
+	BOOT_MARK_CLOCKS,	/* BOARD_InitBootClocks done, core at 48 MHz */
+	BOOT_MARK_INIT,		/* Tables, buffers and peripherals ready */
+	BOOT_MARK_DAC,		/* DMA into the DAC started, first sample out */
+	BOOT_MARK_ADC,		/* First block (polled) or frame (ADC_SCAN) in */
+	BOOT_MARK_RESULT,	/* First pitch reported */
+	BOOT_MARKS
+};
+
+/**
+ * \fn		bool boot_mark
+ * \param	boot_mark_t mark
+ * \return	true the first time mark is reached, false after that
+ * \brief   Stamps mark with systick_timestamp(), once. Call from the main loop
+ */
+bool boot_mark(boot_mark_t mark);
+
+/**
+ * \fn		void boot_report
+ * \param	N/A
+ * \return	N/A
+ * \brief   Sends every milestone reached so far, in us since reset, as one DLOG record.
+ * 			Sent whatever dlog_level is
+ */
+void boot_report(void);
+
+#endif /* BOOT_H_ */
@@ -0,0 +1,108 @@
+/**
+ * \file    cents.c
+ * \author	Dayton Flores (dafl2542@colorado.edu)
+ * \date	10/19/2026
+ * \brief   Function definitions for the fixed-point log2 and cents conversion
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * User-defined libraries
+ */
+#include "cents.h"
+#include "note.h"
+
+/**
+ * \var		cents_log2_table
+ * \brief	log2(1 + i / 128), Q16: round(65536 * log2(1 + i / 128)) for i = 0 to 128
+ */
+static const uint32_t cents_log2_table[(1 << CENTS_LOG2_BITS) + 1] = {
+	    0,   736,  1466,  2190,  2909,  3623,  4331,  5034,
+	 5732,  6425,  7112,  7795,  8473,  9146,  9814, 10477,
+	11136, 11791, 12440, 13086, 13727, 14363, 14996, 15624,
+	16248, 16868, 17484, 18096, 18704, 19308, 19909, 20505,
+	21098, 21687, 22272, 22854, 23433, 24007, 24579, 25146,
+	25711, 26272, 26830, 27384, 27936, 28484, 29029, 29571,
+	30109, 30645, 31178, 31707, 32234, 32758, 33279, 33797,
+	34312, 34825, 35334, 35841, 36346, 36847, 37346, 37842,
+	38336, 38827, 39316, 39802, 40286, 40767, 41246, 41722,
+	42196, 42667, 43137, 43603, 44068, 44530, 44990, 45448,
+	45904, 46357, 46809, 47258, 47705, 48150, 48593, 49034,
+	49472, 49909, 50344, 50776, 51207, 51636, 52063, 52488,
+	52911, 53332, 53751, 54169, 54584, 54998, 55410, 55820,
+	56229, 56635, 57040, 57443, 57845, 58245, 58643, 59039,
+	59434, 59827, 60219, 60609, 60997, 61384, 61769, 62152,
+	62534, 62915, 63294, 63671, 64047, 64421, 64794, 65166,
+	65536
+};
+
+int32_t cents_log2(uint32_t x)
+{
+	int32_t exponent = 31;
+	uint32_t i;
+	uint32_t weight;
+
+	if(x == 0){
+		return 0;
+	}
+
+	/**
+	 * Shift the top bit up to bit 31. The M0+ has no CLZ instruction
+	 */
+	if(!(x & 0xFFFF0000UL)){
+		x <<= 16;
+		exponent -= 16;
+	}
+	if(!(x & 0xFF000000UL)){
+		x <<= 8;
+		exponent -= 8;
+	}
+	if(!(x & 0xF0000000UL)){
+		x <<= 4;
+		exponent -= 4;
+	}
+	if(!(x & 0xC0000000UL)){
+		x <<= 2;
+		exponent -= 2;
+	}
+	if(!(x & 0x80000000UL)){
+		x <<= 1;
+		exponent -= 1;
+	}
+
+	/**
+	 * The bits below the top one are the mantissa's fraction: its top CENTS_LOG2_BITS
+	 * pick the entry, the next 16 weigh the step to the one after
+	 */
+	x <<= 1;
+	i = x >> (32 - CENTS_LOG2_BITS);
+	weight = (x >> (16 - CENTS_LOG2_BITS)) & 0xFFFF;
+
+	return (exponent << 16) + (int32_t)cents_log2_table[i] +
+			(int32_t)(((cents_log2_table[i + 1] - cents_log2_table[i]) * weight) >> 16);
+}
+
+const note_t *cents_note(uint32_t hz_q16, int32_t *tenths)
+{
+	int32_t semitones;
+	int32_t offset;
+	int32_t midi;
+
+	if(hz_q16 == 0){
+		return NULL;
+	}
+
+	/**
+	 * Semitones from A4, Q16. 12 semitones to the octave, and log2 is in octaves
+	 */
+	semitones = 12 * (cents_log2(hz_q16) - cents_log2(NOTE_Q16(NOTE_A4_HZ)));
+	midi = NOTE_MIDI_A4 + ((semitones + 0x8000) >> 16);
+	offset = semitones - (midi - NOTE_MIDI_A4) * 65536;
+
+	if(tenths != NULL){
+		*tenths = (offset * 1000 + 0x8000) >> 16;
+	}
+	return note_from_midi((uint32_t)midi);
+}
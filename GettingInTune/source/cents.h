@@ -0,0 +1,58 @@
+/**
+ * \file    cents.h
+ * \author	Dayton Flores (dafl2542@colorado.edu)
+ * \date	10/19/2026
+ * \brief   Macros and function headers for the fixed-point log2 and cents conversion
+ * \detail
+ * 		Turns a detected frequency into "note name and cents off", for the tuner's
+ * 		readout, without floats: the M0+ has no FPU, and soft-float log2 is thousands
+ * 		of cycles.
+ *
+ * 		cents_log2() normalizes its argument to [1, 2) and looks the mantissa up in a
+ * 		129-entry table of log2(1 + i / 128), interpolating linearly between entries.
+ * 		That is good to about 0.03 cents, against the tenths cents_note() reports.
+ * 		host/cents_bench.c checks it against double precision and times it (make
+ * 		cents-bench); the loopback benchmark (bench.h) counts its cycles on the target.
+ */
+
+#ifndef CENTS_H_
+#define CENTS_H_
+
+#include <stdint.h>
+
+/**
+ * User-defined libraries
+ */
+#include "note.h"
+
+/**
+ * \def		CENTS_LOG2_BITS
+ * \brief	Mantissa bits that index the log2 table, which has 2^CENTS_LOG2_BITS + 1 entries
+ */
+#define CENTS_LOG2_BITS\
+	(7)
+
+/**
+ * \def		CENTS_ROUND
+ * \brief	Rounds tenths of a cent to whole cents, half away from zero
+ */
+#define CENTS_ROUND(tenths)\
+	(((tenths) < 0) ? -((5 - (tenths)) / 10) : (((tenths) + 5) / 10))
+
+/**
+ * \fn		int32_t cents_log2
+ * \param	uint32_t x Above 0
+ * \return	log2(x), Q16. 0 for x = 0
+ */
+int32_t cents_log2(uint32_t x);
+
+/**
+ * \fn		const note_t *cents_note
+ * \param	uint32_t hz_q16 Frequency, Q16 Hz
+ * \param	int32_t *tenths Where to put how far hz_q16 is from the note, in tenths of a
+ * 			cent: -500 to 500, positive when sharp. May be NULL
+ * \return	The nearest note, or NULL if it would be off either end of the piano
+ */
+const note_t *cents_note(uint32_t hz_q16, int32_t *tenths);
+
+#endif /* CENTS_H_ */
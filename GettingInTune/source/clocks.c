@@ -0,0 +1,287 @@
+/**
+ * \file    clocks.c
+ * \author	Dayton Flores (dafl2542@colorado.edu)
+ * \date	10/19/2026
+ * \brief   Function definitions for switching clock profiles at run time
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "board.h"
+#include "clock_config.h"
+#include "fsl_debug_console.h"
+#include "fsl_smc.h"
+#ifdef HOST_SIM
+#include "sim_kl25z.h"
+#endif
+#if !defined(HOST_SIM) || defined(HOST_UART_CONSOLE)
+#include "fsl_lpsci.h"
+#endif
+
+/**
+ * User-defined libraries
+ */
+#include "clocks.h"
+#include "critical.h"
+#include "event.h"
+#include "instr.h"
+#include "systick.h"
+#include "tpm.h"
+
+/**
+ * \def		CLOCKS_SRC_PLLFLL
+ * \brief	SOPT2[TPMSRC] and SOPT2[UART0SRC] value for MCGFLLCLK or MCGPLLCLK / 2
+ */
+#define CLOCKS_SRC_PLLFLL\
+	(1)
+
+/**
+ * \def		CLOCKS_SRC_MCGIRCLK
+ * \brief	SOPT2[TPMSRC] and SOPT2[UART0SRC] value for MCGIRCLK
+ */
+#define CLOCKS_SRC_MCGIRCLK\
+	(3)
+
+/**
+ * \typedef	typedef struct clocks_info_s clocks_info_t
+ * \brief   Easily declare what a profile runs at
+ */
+typedef struct clocks_info_s clocks_info_t;
+
+/**
+ * \struct	struct clocks_info_s
+ * \brief   One profile's clocks, per board/clock_config.c
+ */
+struct clocks_info_s{
+	const char *name;
+	uint32_t core_hz;
+	uint32_t bus_hz;
+	uint32_t periph_hz;		/* TPMs and UART0 */
+	uint32_t periph_src;	/* For SOPT2[TPMSRC] and SOPT2[UART0SRC] */
+};
+
+/**
+ * \var		clocks_table
+ * \brief	Every profile, in enum order
+ */
+static const clocks_info_t clocks_table[CLOCKS_PROFILES] = {
+	{ "RUN",  BOARD_BOOTCLOCKRUN_CORE_CLOCK,  24000000, TPM_CLOCK_HZ, CLOCKS_SRC_PLLFLL },
+	{ "VLPR", BOARD_BOOTCLOCKVLPR_CORE_CLOCK, 800000,   4000000,      CLOCKS_SRC_MCGIRCLK },
+};
+
+/**
+ * \var		clocks_current
+ * \brief	Profile the clocks are in. BOARD_InitBootClocks starts in RUN
+ */
+static clocks_profile_t clocks_current = CLOCKS_RUN;
+
+/**
+ * \var		clocks_auto
+ * \brief	Whether clocks_policy picks the profile
+ */
+#ifdef STREAM_EXPORT
+static bool clocks_auto = false;
+#else
+static bool clocks_auto = true;
+#endif
+
+/**
+ * \var		clocks_signal_us
+ * \brief	now_us() when clocks_policy last saw the gate open, or was turned on
+ */
+static uint64_t clocks_signal_us = 0;
+
+/**
+ * \fn		void clocks_enter
+ * \param	clocks_profile_t profile
+ * \return	N/A
+ * \brief   Reprograms MCG, SIM and SMC from the other profile into profile. VLPR has to
+ * 			be left before the PLL comes back, and entered after it is gone
+ */
+static void clocks_enter(clocks_profile_t profile)
+{
+#ifdef HOST_SIM
+	sim_set_clocks(clocks_table[profile].core_hz, clocks_table[profile].periph_hz, profile == CLOCKS_VLPR);
+#else
+	if(profile == CLOCKS_VLPR){
+		CLOCK_SetSimSafeDivs();
+		CLOCK_SetMcgConfig(&mcgConfig_BOARD_BootClockVLPR);
+		CLOCK_SetSimConfig(&simConfig_BOARD_BootClockVLPR);
+		CLOCK_DeinitOsc0();
+#if (defined(FSL_FEATURE_SMC_HAS_LPWUI) && FSL_FEATURE_SMC_HAS_LPWUI)
+		SMC_SetPowerModeVlpr(SMC, false);
+#else
+		SMC_SetPowerModeVlpr(SMC);
+#endif
+		while(SMC_GetPowerModeState(SMC) != kSMC_PowerStateVlpr){
+		}
+	}
+	else{
+		SMC_SetPowerModeRun(SMC);
+		while(SMC_GetPowerModeState(SMC) != kSMC_PowerStateRun){
+		}
+		CLOCK_SetSimSafeDivs();
+		CLOCK_InitOsc0(&oscConfig_BOARD_BootClockRUN);
+		CLOCK_SetXtal0Freq(oscConfig_BOARD_BootClockRUN.freq);
+		CLOCK_SetMcgConfig(&mcgConfig_BOARD_BootClockRUN);
+		CLOCK_SetSimConfig(&simConfig_BOARD_BootClockRUN);
+	}
+#endif
+	SystemCoreClock = clocks_table[profile].core_hz;
+}
+
+void init_clocks(void)
+{
+	SMC_SetPowerModeProtection(SMC, kSMC_AllowPowerModeAll);
+}
+
+clocks_profile_t clocks_profile(void)
+{
+	return clocks_current;
+}
+
+/**
+ * \fn		bool clocks_apply
+ * \param	clocks_profile_t profile
+ * \param	bool *timers Set false if the timers can't keep time in profile
+ * \return	true if UART0 makes the console's baud rate from profile's clock
+ * \brief   Moves the clocks and everything timed from them into profile. Call with
+ * 			interrupts masked
+ */
+static bool clocks_apply(clocks_profile_t profile, bool *timers)
+{
+	const clocks_info_t *to = &clocks_table[profile];
+	bool baud = true;
+
+	clocks_enter(profile);
+	SIM->SOPT2 = (SIM->SOPT2 & ~(SIM_SOPT2_TPMSRC_MASK | SIM_SOPT2_UART0SRC_MASK)) |
+			SIM_SOPT2_TPMSRC(to->periph_src) |
+			SIM_SOPT2_UART0SRC(to->periph_src);
+	tpm_retime(to->periph_hz);
+	*timers = event_retime(to->periph_hz);
+	*timers = systick_retime(to->core_hz) && *timers;
+	instr_retime(to->core_hz);
+#if !defined(HOST_SIM) || defined(HOST_UART_CONSOLE)
+	/**
+	 * The baud rate is left as it was if it is out of reach
+	 */
+	baud = (LPSCI_SetBaudRate(UART0, BOARD_DEBUG_UART_BAUDRATE, to->periph_hz) == kStatus_Success);
+#endif
+	return baud;
+}
+
+bool clocks_switch(clocks_profile_t profile)
+{
+	const clocks_info_t *to = &clocks_table[profile];
+	uint32_t primask;
+	bool timers;
+	bool baud;
+
+	if(profile == clocks_current){
+		clocks_report();
+		return true;
+	}
+
+#ifdef STREAM_EXPORT
+	/**
+	 * The stream's baud rate is more than 4 MHz can make
+	 */
+	if(profile != CLOCKS_RUN){
+		PRINTF("clock: stream export needs the RUN UART0 clock\r\n");
+		return false;
+	}
+#endif
+
+#if !defined(HOST_SIM) || defined(HOST_UART_CONSOLE)
+	/**
+	 * Nothing queued may go out at the old baud rate
+	 */
+	DbgConsole_Flush();
+#endif
+
+	primask = critical_enter();
+	baud = clocks_apply(profile, &timers);
+	if(!baud){
+		clocks_apply(clocks_current, &timers);
+	}
+	else{
+		clocks_current = profile;
+	}
+	critical_exit(primask);
+
+	if(!baud){
+		PRINTF("clock: UART0 can't make %u baud from %u Hz, staying in %s\r\n",
+				(unsigned)BOARD_DEBUG_UART_BAUDRATE,
+				(unsigned)to->periph_hz,
+				clocks_table[clocks_current].name);
+		return false;
+	}
+	if(!timers){
+		PRINTF("clock: the timers can't keep time in %s\r\n", to->name);
+	}
+	clocks_report();
+	return true;
+}
+
+bool clocks_set_auto(bool on)
+{
+#ifdef STREAM_EXPORT
+	if(on){
+		PRINTF("clock: stream export needs the RUN UART0 clock, no automatic switching\r\n");
+		return false;
+	}
+#endif
+	clocks_auto = on;
+	clocks_signal_us = now_us();
+	return true;
+}
+
+bool clocks_policy(bool signal)
+{
+	uint64_t now;
+	clocks_profile_t profile;
+
+	if(!clocks_auto){
+		return false;
+	}
+
+	now = now_us();
+	if(signal){
+		clocks_signal_us = now;
+		profile = CLOCKS_RUN;
+	}
+	else if((now - clocks_signal_us) >= CLOCKS_IDLE_US){
+		profile = CLOCKS_VLPR;
+	}
+	else{
+		return false;
+	}
+	if(profile == clocks_current){
+		return false;
+	}
+
+	PRINTF("clock: %s, switching to %s\r\n", signal ? "signal" : "no signal", clocks_table[profile].name);
+	if(!clocks_switch(profile)){
+		/**
+		 * Don't try again on every block
+		 */
+		PRINTF("clock: automatic switching off\r\n");
+		clocks_auto = false;
+		return false;
+	}
+	return true;
+}
+
+void clocks_report(void)
+{
+	const clocks_info_t *info = &clocks_table[clocks_current];
+
+	PRINTF("clock: %s (%s), core = %u Hz, bus = %u Hz, TPMs and UART0 = %u Hz\r\n",
+			info->name,
+			clocks_auto ? "auto" : "manual",
+			(unsigned)info->core_hz,
+			(unsigned)info->bus_hz,
+			(unsigned)info->periph_hz);
+	tpm_report();
+}
@@ -0,0 +1,124 @@
+/**
+ * \file    clocks.h
+ * \author	Dayton Flores (dafl2542@colorado.edu)
+ * \date	10/19/2026
+ * \brief   Macros and function headers for switching clock profiles at run time
+ * \detail
+ * 		Two profiles, the ones board/clock_config.c describes:
+ * 			- RUN: 48 MHz core from the PLL, 24 MHz bus. The TPMs and UART0 count on
+ * 			  MCGPLLCLK / 2, 48 MHz. Playback, capture and analysis run here
+ * 			- VLPR: 4 MHz core from the fast internal reference, 800 kHz bus. The TPMs
+ * 			  and UART0 count on MCGIRCLK, 4 MHz. idle_wait() enters VLPW instead of WAIT
+ *
+ * 		clocks_switch() moves between them and retimes everything clocked from them:
+ * 		TPM0 and TPM1 (tpm_retime), the event scheduler's TPM2 (event_retime), SysTick
+ * 		(systick_retime) and the console's baud rate. Timestamps and deadlines keep their
+ * 		units and carry on across a switch.
+ *
+ * 		A TPM keeps running across a switch at the nearest rate the new clock gives
+ * 		(tpm_retime). 4 MHz has no factor of 3, so in VLPR TPM0 plays at 48193 Hz
+ * 		(+0.4%, tones ~7 cents sharp) and TPM1 triggers capture at 95238 Hz (-0.8%),
+ * 		which clocks_report prints. Reports take frequencies from what TPM1 actually
+ * 		runs at (tpm_overflow_rate_hz).
+ *
+ * 		In VLPR only the gate (gate.h) looks at captured blocks. ADC0 converts on the
+ * 		800 kHz bus, more slowly than TPM1 triggers, so the blocks aren't at a rate the
+ * 		detector could use, but their energy and zero crossings still find a tone.
+ *
+ * 		The policy, clocks_policy(), runs on every block or frame the gate looks at.
+ * 		RUN drops to VLPR once the gate has stayed closed for CLOCKS_IDLE_US, and VLPR
+ * 		comes back to RUN as soon as it opens; the block that opened it is dropped.
+ * 		The console's clock command picks a profile by hand, which turns the policy
+ * 		off until "clock auto".
+ *
+ * 		A switch the console's baud rate can't follow is undone, so it never goes
+ * 		silent. Stream export needs RUN's UART0 clock and keeps the policy off.
+ *
+ * 		Flash can't be programmed in VLPR, so the console's save refuses there.
+ */
+
+#ifndef CLOCKS_H_
+#define CLOCKS_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * \def		CLOCKS_IDLE_US
+ * \brief	How long the gate has to stay closed before the policy drops to VLPR
+ */
+#define CLOCKS_IDLE_US\
+	(5000000)
+
+/**
+ * \typedef	typedef enum clocks_profile_e clocks_profile_t
+ * \brief   Easily declare clock profiles
+ */
+typedef enum clocks_profile_e clocks_profile_t;
+
+/**
+ * \enum	enum clocks_profile_e
+ * \brief   The clock profiles, see the file comment
+ */
+enum clocks_profile_e{
+	CLOCKS_RUN,
+	CLOCKS_VLPR,
+	CLOCKS_PROFILES
+};
+
+/**
+ * \fn		void init_clocks
+ * \param	N/A
+ * \return	N/A
+ * \brief   Allows the very low power modes, VLPR and VLPW. PMPROT takes one write per
+ * 			reset, so call once, after BOARD_InitBootClocks
+ */
+void init_clocks(void);
+
+/**
+ * \fn		clocks_profile_t clocks_profile
+ * \param	N/A
+ * \return	The profile the clocks are in
+ */
+clocks_profile_t clocks_profile(void);
+
+/**
+ * \fn		bool clocks_switch
+ * \param	clocks_profile_t profile
+ * \return	true if the clocks are in profile now, false if this build can't use it or
+ * 			the console's baud rate can't be made from it (the clocks are left as
+ * 			they were)
+ * \brief   Reprograms MCG, SIM and SMC for profile, retimes the peripherals and prints
+ * 			the outcome. Waits for queued console output first, and masks interrupts
+ * 			while the clocks change. Call from the main loop
+ */
+bool clocks_switch(clocks_profile_t profile);
+
+/**
+ * \fn		bool clocks_set_auto
+ * \param	bool on
+ * \return	true if the policy is as asked, false if this build can't run it
+ * \brief   Turns the automatic policy on or off. On by default, except with stream export
+ */
+bool clocks_set_auto(bool on);
+
+/**
+ * \fn		bool clocks_policy
+ * \param	bool signal Whether any gate is open, signal_present
+ * \return	true if the clocks switched, so the block just gated was taken at the old
+ * 			profile's rate
+ * \brief   The automatic policy, see the file comment. Does nothing while it is off.
+ * 			Call from the main loop after each gate update
+ */
+bool clocks_policy(bool signal);
+
+/**
+ * \fn		void clocks_report
+ * \param	N/A
+ * \return	N/A
+ * \brief   Prints the profile, its clocks, whether the policy picks it and what the
+ * 			TPMs run at
+ */
+void clocks_report(void);
+
+#endif /* CLOCKS_H_ */
@@ -0,0 +1,494 @@
+/**
+ * \file    command.c
+ * \author	Dayton Flores (dafl2542@colorado.edu)
+ * \date	10/19/2026
+ * \brief   Function definitions for the console command line
+ */
+
+#include <ctype.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "board.h"
+#include "fsl_debug_console.h"
+
+/**
+ * User-defined libraries
+ */
+#include "adc.h"
+#include "arena.h"
+#include "autocorrelate.h"
+#include "boot.h"
+#include "clocks.h"
+#include "command.h"
+#include "dlog.h"
+#include "gate.h"
+#include "instr.h"
+#include "note.h"
+#include "pipeline.h"
+#include "ram.h"
+#include "store.h"
+#include "task.h"
+#include "tone.h"
+
+/**
+ * \typedef	typedef struct command_s command_t
+ * \brief   A command and the function that runs it
+ */
+typedef struct command_s command_t;
+
+/**
+ * \struct	struct command_s
+ * \brief   A command and the function that runs it
+ */
+struct command_s{
+	const char *name;
+	const char *usage;
+	bool (*run)(int argc, char **argv);
+};
+
+/**
+ * \var		command_line
+ * \brief	Characters of the line being typed
+ */
+static char command_line[COMMAND_LINE_LEN];
+static uint32_t command_line_len = 0;
+
+/**
+ * \var		command_overflow
+ * \brief	Set once the line being typed no longer fits, so it is discarded at its end
+ */
+static bool command_overflow = false;
+
+/**
+ * \var		command_cr
+ * \brief	Set after a CR, so the LF of a CR LF pair doesn't end a second, empty line
+ */
+static bool command_cr = false;
+
+/**
+ * Names for the fixed tones, the profiles, the log levels and the clock profiles, in
+ * enum order. "auto" comes after the clock profiles, at CLOCKS_PROFILES
+ */
+static const char * const tone_names[] = { "A4", "D5", "E5", "A5" };
+static const char * const profile_names[] = { "lowpower", "fast", "avg4" };
+static const char * const level_names[] = { "off", "info", "debug" };
+static const char * const clock_names[] = { "run", "vlpr", "auto" };
+
+/**
+ * \fn		int command_lookup
+ * \param	const char *word
+ * \param	const char * const *names
+ * \param	int count
+ * \return	Index of word in names, ignoring case, or -1 if it isn't there
+ */
+static int command_lookup(const char *word, const char * const *names, int count)
+{
+	for(int i = 0; i < count; i++){
+		const char *a = word;
+		const char *b = names[i];
+
+		while(*a && (tolower((unsigned char)*a) == tolower((unsigned char)*b))){
+			a++;
+			b++;
+		}
+		if(!*a && !*b){
+			return i;
+		}
+	}
+	return -1;
+}
+
+/**
+ * \fn		bool command_number
+ * \param	const char *word
+ * \param	uint32_t *value
+ * \return	true if word is a whole decimal number, false otherwise
+ */
+static bool command_number(const char *word, uint32_t *value)
+{
+	char *end;
+
+	if(!isdigit((unsigned char)*word)){
+		return false;
+	}
+	*value = (uint32_t)strtoul(word, &end, 10);
+	return (*end == '\0');
+}
+
+static bool command_help(int argc, char **argv);
+
+static bool command_status(int argc, char **argv)
+{
+	uint32_t min_lag;
+	uint32_t max_lag;
+	uint32_t gate_open;
+	uint32_t gate_close;
+
+	autocorrelate_get_lag_bounds(&min_lag, &max_lag);
+	gate_get_energy(&gate_open, &gate_close);
+	PRINTF("tone = %d Hz (%s), hold = %s\r\n",
+			(int)dac_buffer_hz,
+			tone_names[current_tone],
+			tone_hold ? "on" : "off");
+	if(max_lag == UINT32_MAX){
+		PRINTF("lag = %u to any samples\r\n", (unsigned)min_lag);
+	}
+	else{
+		PRINTF("lag = %u to %u samples\r\n", (unsigned)min_lag, (unsigned)max_lag);
+	}
+	PRINTF("adc = %s, log = %s\r\n",
+			profile_names[adc_get_profile()],
+			level_names[dlog_level]);
+	PRINTF("gate = open above %u, close below %u\r\n",
+			(unsigned)gate_open,
+			(unsigned)gate_close);
+	PRINTF("arena = %u of %u samples, peak = %u\r\n",
+			(unsigned)arena_used(),
+			(unsigned)ARENA_SAMPLES,
+			(unsigned)arena_peak());
+	clocks_report();
+	store_report();
+	return true;
+}
+
+static bool command_tone(int argc, char **argv)
+{
+	int tone = command_lookup(argv[1], tone_names, sizeof(tone_names) / sizeof(tone_names[0]));
+
+	if((argc != 2) || (tone < 0)){
+		return false;
+	}
+	current_tone = (tone_t)tone;
+	fill_dac_buffer(current_tone);
+	pipeline_play();
+	return true;
+}
+
+static bool command_freq(int argc, char **argv)
+{
+	uint32_t hz;
+
+	if((argc != 2) || !command_number(argv[1], &hz)){
+		return false;
+	}
+	if(!fill_dac_buffer_hz(hz)){
+		PRINTF("%u Hz is out of range\r\n", (unsigned)hz);
+		return true;
+	}
+	tone_hold = true;
+	pipeline_play();
+	return true;
+}
+
+static bool command_note(int argc, char **argv)
+{
+	const note_t *note = note_from_name(argv[1]);
+	uint32_t midi;
+
+	if((note == NULL) && command_number(argv[1], &midi)){
+		note = note_from_midi(midi);
+	}
+	if((argc != 2) || (note == NULL)){
+		return false;
+	}
+	if(!fill_dac_buffer_note(note->midi)){
+		PRINTF("%s is out of range\r\n", note->name);
+		return true;
+	}
+	tone_hold = true;
+	pipeline_play();
+	return true;
+}
+
+static bool command_hold(int argc, char **argv)
+{
+	static const char * const states[] = { "off", "on" };
+	int state = command_lookup(argv[1], states, 2);
+
+	if((argc != 2) || (state < 0)){
+		return false;
+	}
+	tone_hold = (state == 1);
+	return true;
+}
+
+static bool command_lag(int argc, char **argv)
+{
+	uint32_t min_lag;
+	uint32_t max_lag;
+
+	if((argc != 3) || !command_number(argv[1], &min_lag) || !command_number(argv[2], &max_lag) ||
+	   (min_lag > max_lag)){
+		return false;
+	}
+	autocorrelate_set_lag_bounds(min_lag, max_lag);
+	return true;
+}
+
+static bool command_adc(int argc, char **argv)
+{
+	int profile = command_lookup(argv[1], profile_names, sizeof(profile_names) / sizeof(profile_names[0]));
+
+	if((argc != 2) || (profile < 0)){
+		return false;
+	}
+	adc_set_profile((adc_profile_t)profile);
+	return true;
+}
+
+static bool command_instr(int argc, char **argv)
+{
+	if((argc == 2) && (strcmp(argv[1], "reset") == 0)){
+		instr_reset();
+		return true;
+	}
+	if(argc != 1){
+		return false;
+	}
+	instr_report();
+	return true;
+}
+
+static bool command_tasks(int argc, char **argv)
+{
+	if((argc == 2) && (strcmp(argv[1], "reset") == 0)){
+		task_reset();
+		return true;
+	}
+	if(argc != 1){
+		return false;
+	}
+	task_report();
+	return true;
+}
+
+static bool command_boot(int argc, char **argv)
+{
+	if(argc != 1){
+		return false;
+	}
+	boot_report();
+	return true;
+}
+
+static bool command_mem(int argc, char **argv)
+{
+	if(argc != 1){
+		return false;
+	}
+	ram_report();
+	return true;
+}
+
+static bool command_log(int argc, char **argv)
+{
+	int level = command_lookup(argv[1], level_names, sizeof(level_names) / sizeof(level_names[0]));
+
+	if((argc != 2) || (level < 0)){
+		return false;
+	}
+	dlog_level = (uint32_t)level;
+	return true;
+}
+
+static bool command_gate(int argc, char **argv)
+{
+	uint32_t open;
+	uint32_t close;
+
+	if((argc != 3) || !command_number(argv[1], &open) || !command_number(argv[2], &close)){
+		return false;
+	}
+	return gate_set_energy(open, close);
+}
+
+static bool command_save(int argc, char **argv)
+{
+	uint32_t min_lag;
+	uint32_t max_lag;
+	uint32_t gate_open;
+	uint32_t gate_close;
+	bool ok;
+
+	if(argc != 1){
+		return false;
+	}
+	if(clocks_profile() != CLOCKS_RUN){
+		PRINTF("save: flash can't be programmed in VLPR, switch to run first (clock run)\r\n");
+		return true;
+	}
+	autocorrelate_get_lag_bounds(&min_lag, &max_lag);
+	gate_get_energy(&gate_open, &gate_close);
+
+	/**
+	 * Only what changed is written, but with interrupts masked: playback and capture
+	 * can glitch while it is written
+	 */
+	ok = store_set(STORE_KEY_LAG_MIN, min_lag);
+	ok = ok && store_set(STORE_KEY_LAG_MAX, max_lag);
+	ok = ok && store_set(STORE_KEY_ADC_PROFILE, (uint32_t)adc_get_profile());
+	ok = ok && store_set(STORE_KEY_LOG_LEVEL, dlog_level);
+	ok = ok && store_set(STORE_KEY_GATE_OPEN, gate_open);
+	ok = ok && store_set(STORE_KEY_GATE_CLOSE, gate_close);
+	if(!ok){
+		PRINTF("save failed\r\n");
+	}
+	store_report();
+	return true;
+}
+
+static bool command_clock(int argc, char **argv)
+{
+	int profile;
+
+	if(argc == 1){
+		clocks_report();
+		return true;
+	}
+	profile = command_lookup(argv[1], clock_names, sizeof(clock_names) / sizeof(clock_names[0]));
+	if((argc != 2) || (profile < 0)){
+		return false;
+	}
+	if(profile == CLOCKS_PROFILES){
+		clocks_set_auto(true);
+		clocks_report();
+		return true;
+	}
+
+	/**
+	 * A profile picked by hand stays until the next clock command
+	 */
+	clocks_set_auto(false);
+	clocks_switch((clocks_profile_t)profile);
+	return true;
+}
+
+/**
+ * \var		commands
+ * \brief	Every command, as listed by help
+ */
+static const command_t commands[] = {
+	{ "help",   "help",                   command_help },
+	{ "status", "status",                 command_status },
+	{ "tone",   "tone A4|D5|E5|A5",       command_tone },
+	{ "freq",   "freq <hz>",              command_freq },
+	{ "note",   "note <name>|<midi>",     command_note },
+	{ "hold",   "hold on|off",            command_hold },
+	{ "lag",    "lag <min> <max>",        command_lag },
+	{ "adc",    "adc lowpower|fast|avg4", command_adc },
+	{ "log",    "log off|info|debug",     command_log },
+	{ "instr",  "instr [reset]",          command_instr },
+	{ "tasks",  "tasks [reset]",          command_tasks },
+	{ "boot",   "boot",                   command_boot },
+	{ "mem",    "mem",                    command_mem },
+	{ "gate",   "gate <open> <close>",    command_gate },
+	{ "save",   "save",                   command_save },
+	{ "clock",  "clock [run|vlpr|auto]",  command_clock },
+};
+
+static bool command_help(int argc, char **argv)
+{
+	for(uint32_t i = 0; i < sizeof(commands) / sizeof(commands[0]); i++){
+		PRINTF("  %s\r\n", commands[i].usage);
+	}
+	return true;
+}
+
+/**
+ * \fn		void command_run
+ * \param	char *line NUL-terminated, split in place
+ * \return	N/A
+ * \brief   Splits a line into words and runs the command it names
+ */
+static void command_run(char *line)
+{
+	char *argv[COMMAND_MAX_ARGS + 1] = { NULL };
+	int argc = 0;
+
+	while(*line){
+		while(*line == ' '){
+			*line++ = '\0';
+		}
+		if(!*line){
+			break;
+		}
+		if(argc == COMMAND_MAX_ARGS){
+			PRINTF("too many words\r\n");
+			return;
+		}
+		argv[argc++] = line;
+		while(*line && (*line != ' ')){
+			line++;
+		}
+	}
+	if(argc == 0){
+		return;
+	}
+
+	/**
+	 * Handlers read argv[1] before checking argc, so it has to be a string
+	 */
+	if(argc == 1){
+		argv[1] = "";
+	}
+	for(uint32_t i = 0; i < sizeof(commands) / sizeof(commands[0]); i++){
+		if(strcmp(argv[0], commands[i].name) == 0){
+			INSTR_COUNT(INSTR_COUNT_COMMANDS);
+			if(!commands[i].run(argc, argv)){
+				PRINTF("usage: %s\r\n", commands[i].usage);
+			}
+			return;
+		}
+	}
+	PRINTF("unknown command '%s', try help\r\n", argv[0]);
+}
+
+void command_poll(void)
+{
+	char c;
+	bool echoed = false;
+
+	while(DbgConsole_TryGetchar(&c) == kStatus_Success){
+		bool cr = command_cr;
+
+		echoed = true;
+		command_cr = (c == '\r');
+		if((c == '\n') && cr){
+			continue;
+		}
+
+		if((c == '\r') || (c == '\n')){
+			PRINTF("\r\n");
+			if(command_overflow){
+				PRINTF("line too long\r\n");
+			}
+			else{
+				command_line[command_line_len] = '\0';
+				command_run(command_line);
+			}
+			command_line_len = 0;
+			command_overflow = false;
+		}
+		else if((c == '\b') || (c == 0x7F)){
+			if(command_line_len > 0){
+				command_line_len--;
+				PRINTF("\b \b");
+			}
+		}
+		else if(isprint((unsigned char)c)){
+			if(command_line_len < COMMAND_LINE_LEN - 1){
+				command_line[command_line_len++] = c;
+			}
+			else{
+				command_overflow = true;
+			}
+			PUTCHAR(c);
+		}
+	}
+	if(echoed){
+		fflush(stdout);
+	}
+}
@@ -0,0 +1,57 @@
+/**
+ * \file    command.h
+ * \author	Dayton Flores (dafl2542@colorado.edu)
+ * \date	10/19/2026
+ * \brief   Macros and function headers for the console command line
+ * \detail
+ * 		Reconfigures the tuner while it runs. command_poll() takes whatever characters
+ * 		the debug console has received, echoes them and runs a line once it ends in CR
+ * 		or LF. It never waits for input, so it is called once per pass of the main loop.
+ *
+ * 		Commands:
+ * 			help                      List the commands
+ * 			status                    Print the current settings
+ * 			tone A4|D5|E5|A5          Switch to a note; the sequence carries on from it
+ * 			freq <hz>                 Play any frequency and hold it
+ * 			note <name>|<midi>        Play a piano key, like C#4 or 61, and hold it
+ * 			hold on|off               Stop or resume stepping through the notes
+ * 			lag <min> <max>           Bound the periods the detector reports, in samples
+ * 			adc lowpower|fast|avg4    Select an ADC conversion profile
+ * 			log off|info|debug        Select how much DLOG sends
+ * 			instr [reset]             Dump or zero the instrumentation (instr.h)
+ * 			tasks [reset]             Dump or zero the tasks' statistics (task.h)
+ * 			boot                      Print how long startup took (boot.h)
+ * 			mem                       Print SRAM use and the stack's high-water mark (ram.h)
+ * 			gate <open> <close>       Set the noise gate's energy thresholds (gate.h)
+ * 			save                      Keep the settings above over a power cycle (store.h)
+ * 			clock [run|vlpr|auto]     Print or pick the clock profile, or leave it to the
+ * 			                          policy (clocks.h)
+ */
+
+#ifndef COMMAND_H_
+#define COMMAND_H_
+
+/**
+ * \def		COMMAND_LINE_LEN
+ * \brief	Longest command line, terminator included. Longer lines are discarded
+ */
+#define COMMAND_LINE_LEN\
+	(48)
+
+/**
+ * \def		COMMAND_MAX_ARGS
+ * \brief	Most words in a command line, the command included
+ */
+#define COMMAND_MAX_ARGS\
+	(4)
+
+/**
+ * \fn		void command_poll
+ * \param	N/A
+ * \return	N/A
+ * \brief   Reads the characters received so far and runs any command they complete.
+ * 			Call from the main loop
+ */
+void command_poll(void);
+
+#endif /* COMMAND_H_ */
@@ -0,0 +1,60 @@
+/**
+ * \file    critical.h
+ * \author	Dayton Flores (dafl2542@colorado.edu)
+ * \date	10/19/2026
+ * \brief   Critical sections that nest
+ * \detail
+ * 		uint32_t primask = critical_enter(); ... critical_exit(primask);
+ *
+ * 		Interrupts are only unmasked again if they were unmasked on entry, so a critical
+ * 		section can be entered from an ISR or from inside another one. Masking is
+ * 		simulated by sim_kl25z.c on the host.
+ */
+
+#ifndef CRITICAL_H_
+#define CRITICAL_H_
+
+#include <stdint.h>
+#include "board.h"
+#ifdef HOST_SIM
+#include "sim_kl25z.h"
+#endif
+
+/**
+ * \fn		uint32_t critical_enter
+ * \param	N/A
+ * \return	The mask state to hand back to critical_exit
+ * \brief   Masks interrupts
+ */
+static inline uint32_t critical_enter(void)
+{
+#ifdef HOST_SIM
+	uint32_t primask = sim_irq_masked() ? 1 : 0;
+
+	sim_irq_disable();
+#else
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+#endif
+	return primask;
+}
+
+/**
+ * \fn		void critical_exit
+ * \param	uint32_t primask From the matching critical_enter
+ * \return	N/A
+ * \brief   Unmasks interrupts, unless they were masked before critical_enter
+ */
+static inline void critical_exit(uint32_t primask)
+{
+#ifdef HOST_SIM
+	if(!primask){
+		sim_irq_enable();
+	}
+#else
+	__set_PRIMASK(primask);
+#endif
+}
+
+#endif /* CRITICAL_H_ */
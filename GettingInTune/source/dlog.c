@@ -0,0 +1,70 @@
+/**
+ * \file    dlog.c
+ * \author	Dayton Flores (dafl2542@colorado.edu)
+ * \date	10/19/2026
+ * \brief   Function definitions for deferred binary logging
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/**
+ * User-defined libraries
+ */
+#include "dlog.h"
+#include "systick.h"
+
+/**
+ * \var		dlog_level
+ * \brief	Most detailed DLOG level that is sent, DLOG_LEVEL_OFF to DLOG_LEVEL_DEBUG
+ */
+volatile uint32_t dlog_level = DLOG_LEVEL_DEBUG;
+
+/**
+ * \fn		uint8_t *dlog_put32
+ * \param	uint8_t *p
+ * \param	uint32_t v
+ * \return	p advanced past v
+ * \brief   Stores v little-endian
+ */
+static uint8_t *dlog_put32(uint8_t *p, uint32_t v)
+{
+	p[0] = (uint8_t)v;
+	p[1] = (uint8_t)(v >> 8);
+	p[2] = (uint8_t)(v >> 16);
+	p[3] = (uint8_t)(v >> 24);
+	return p + 4;
+}
+
+void dlog_write(const char *fmt, const uint32_t *args, uint32_t nargs)
+{
+	uint8_t record[DLOG_MAX_RECORD_SIZE];
+	uint8_t *p = record;
+	uint8_t sum = 0;
+
+	if(nargs > DLOG_MAX_ARGS){
+		nargs = DLOG_MAX_ARGS;
+	}
+
+	*p++ = DLOG_MARKER;
+	*p++ = (uint8_t)nargs;
+	p = dlog_put32(p, (uint32_t)(uintptr_t)fmt);
+	p = dlog_put32(p, systick_timestamp());
+	for(uint32_t i = 0; i < nargs; i++){
+		p = dlog_put32(p, args[i]);
+	}
+
+	for(uint8_t *q = &record[1]; q < p; q++){
+		sum += *q;
+	}
+	*p++ = (uint8_t)(0 - sum);
+
+	fwrite(record, 1, (size_t)(p - record), stdout);
+
+	/**
+	 * A record has no newline, so a line-buffered stdout would hold it until some
+	 * later record happened to contain a 0x0A byte
+	 */
+	fflush(stdout);
+}
@@ -0,0 +1,187 @@
+/**
+ * \file    dlog.h
+ * \author	Dayton Flores (dafl2542@colorado.edu)
+ * \date	10/19/2026
+ * \brief   Macros and function headers for deferred binary logging
+ * \detail
+ * 		DLOG(fmt, ...) takes printf arguments but does no formatting on the target. It
+ * 		sends a record holding the address of fmt (which doubles as its ID), a SysTick
+ * 		timestamp and the raw 32-bit arguments. host/dlog_decode.c looks the format
+ * 		string up at that address in the ELF (GettingInTune.axf, or the host build) and
+ * 		prints the line; anything between records passes through as plain text, so
+ * 		DLOG and PRINTF can share the console.
+ *
+ * 		Record, little-endian:
+ * 			0xA5, argument count, format address (4), timestamp (4), arguments (4 each),
+ * 			checksum (the bytes after 0xA5 sum to 0 mod 256)
+ *
+ * 		Arguments are converted to uint32_t. Wrap floats in DLOG_FLOAT so their bits go
+ * 		out rather than their truncated value, and %s arguments in DLOG_STRING. Those
+ * 		must be string literals or other constants the decoder can find in the ELF. As
+ * 		with printf, only one context may log at a time.
+ *
+ * 		DLOG logs at DLOG_LEVEL_INFO; DLOG_AT picks the level. Lines above dlog_level
+ * 		are skipped before their arguments are evaluated.
+ */
+
+#ifndef DLOG_H_
+#define DLOG_H_
+
+#include <stdint.h>
+#include <stdio.h>
+
+/**
+ * \def		DLOG_DEFERRED
+ * \brief	1 to send binary records, 0 to make DLOG a plain printf
+ */
+#ifndef DLOG_DEFERRED
+#define DLOG_DEFERRED\
+	(1)
+#endif
+
+/**
+ * \def		DLOG_MARKER
+ * \brief	First byte of every record. Never appears in the ASCII the firmware prints
+ */
+#define DLOG_MARKER\
+	(0xA5)
+
+/**
+ * \def		DLOG_MAX_ARGS
+ * \brief	Most arguments one record can carry
+ */
+#define DLOG_MAX_ARGS\
+	(8)
+
+/**
+ * \def		DLOG_HEADER_SIZE
+ * \brief	Marker, argument count, format address and timestamp
+ */
+#define DLOG_HEADER_SIZE\
+	(10)
+
+/**
+ * \def		DLOG_MAX_RECORD_SIZE
+ * \brief	Size of a record with DLOG_MAX_ARGS arguments, checksum included
+ */
+#define DLOG_MAX_RECORD_SIZE\
+	(DLOG_HEADER_SIZE + 4 * DLOG_MAX_ARGS + 1)
+
+/**
+ * \def		DLOG_LEVEL_OFF
+ * \brief	dlog_level that silences every DLOG
+ */
+#define DLOG_LEVEL_OFF\
+	(0)
+
+/**
+ * \def		DLOG_LEVEL_INFO
+ * \brief	Measurements and reports
+ */
+#define DLOG_LEVEL_INFO\
+	(1)
+
+/**
+ * \def		DLOG_LEVEL_DEBUG
+ * \brief	Everything, including each note change
+ */
+#define DLOG_LEVEL_DEBUG\
+	(2)
+
+/**
+ * \var		dlog_level
+ * \brief	Defined in dlog.c
+ */
+extern volatile uint32_t dlog_level;
+
+/**
+ * \def		DLOG
+ * \brief	Logs a printf-style line at DLOG_LEVEL_INFO
+ */
+#define DLOG(fmt, ...)\
+	DLOG_AT(DLOG_LEVEL_INFO, fmt, ##__VA_ARGS__)
+
+#if DLOG_DEFERRED
+
+/**
+ * \def		DLOG_SECTION
+ * \brief	Format strings stay in flash (.rodata.* is placed in .text) so their addresses
+ * 			are fixed at link time
+ */
+#define DLOG_SECTION\
+	".rodata.dlog"
+
+/**
+ * \def		DLOG_AT
+ * \brief	Logs a printf-style line as a binary record if level is enabled, see the file comment
+ */
+#define DLOG_AT(level, fmt, ...)\
+	do{\
+		static const char dlog_fmt[] __attribute__((section(DLOG_SECTION))) = fmt;\
+		if(dlog_level >= (level)){\
+			const uint32_t dlog_args[] = { 0, ##__VA_ARGS__ };\
+			_Static_assert(sizeof(dlog_args) / sizeof(dlog_args[0]) <= DLOG_MAX_ARGS + 1,\
+					"too many DLOG arguments");\
+			dlog_write(dlog_fmt, &dlog_args[1], (sizeof(dlog_args) / sizeof(dlog_args[0])) - 1);\
+		}\
+	}while(0)
+
+/**
+ * \def		DLOG_FLOAT
+ * \brief	Passes a float argument to DLOG by its IEEE 754 bits
+ */
+#define DLOG_FLOAT(x)\
+	(dlog_float_bits(x))
+
+/**
+ * \def		DLOG_STRING
+ * \brief	Passes a constant string argument to DLOG by its address
+ */
+#define DLOG_STRING(s)\
+	((uint32_t)(uintptr_t)(s))
+
+#else
+
+#include "fsl_debug_console.h"
+
+#define DLOG_AT(level, fmt, ...)\
+	do{\
+		if(dlog_level >= (level)){\
+			PRINTF(fmt, ##__VA_ARGS__);\
+		}\
+	}while(0)
+
+#define DLOG_FLOAT(x)\
+	((double)(x))
+
+#define DLOG_STRING(s)\
+	(s)
+
+#endif /* DLOG_DEFERRED */
+
+/**
+ * \fn		uint32_t dlog_float_bits
+ * \param	float x
+ * \return	The bits of x
+ */
+static inline uint32_t dlog_float_bits(float x)
+{
+	union{
+		float f;
+		uint32_t u;
+	} bits = { .f = x };
+
+	return bits.u;
+}
+
+/**
+ * \fn		void dlog_write
+ * \param	const char *fmt Format string, in DLOG_SECTION
+ * \param	const uint32_t *args
+ * \param	uint32_t nargs At most DLOG_MAX_ARGS
+ * \return	N/A
+ * \brief   Builds a record and hands it to stdout in one write. Use DLOG instead
+ */
+void dlog_write(const char *fmt, const uint32_t *args, uint32_t nargs);
+
+#endif /* DLOG_H_ */
@@ -6,8 +6,13 @@
  */
 
 #include "board.h"
+#include "critical.h"
 #include "dma.h"
+#include "instr.h"
+#include "irq.h"
+#include "task.h"
 #include "tone.h"
+#include "tpm.h"
 
 /**
  * \def		DCR_EINT
@@ -141,6 +146,13 @@ uint16_t *dma_source;
  */
 uint32_t dma_count;
 
+/**
+ * \var		dma_task
+ * \brief	Task DMA0_IRQHandler posts to after each pass through dac_buffer, NULL for none
+ */
+static task_t *dma_task = NULL;
+static uint16_t dma_signal = 0;
+
 void init_onboard_dma(void)
 {
 	/**
@@ -173,11 +185,11 @@ void init_onboard_dma(void)
 
 	/**
      * Configure DMA0 IRQ
-     * 	- Set the interrupt priority (range 0 to 3, with 0 being highest priority)
+     * 	- Set the interrupt priority from the plan in irq.h
      * 	- Clear pending IRQ
      * 	- Enable IRQ
      */
-	NVIC_SetPriority(DMA0_IRQn, 2);
+	NVIC_SetPriority(DMA0_IRQn, IRQ_PRIORITY_DMA0);
 	NVIC_ClearPendingIRQ(DMA0_IRQn);
 	NVIC_EnableIRQ(DMA0_IRQn);
 
@@ -212,8 +224,26 @@ void start_onboard_dma(uint16_t *source, uint32_t count)
 	DMAMUX0->CHCFG[0] |= DMAMUX_CHCFG_ENBL(CHCFG_ENBL);
 }
 
+void dma_notify(task_t *task, uint16_t signal)
+{
+	uint32_t primask = critical_enter();
+
+	dma_signal = signal;
+	dma_task = task;
+	critical_exit(primask);
+}
+
 void DMA0_IRQHandler(void)
 {
+	/**
+	 * TPM0 has counted since the overflow that moved the last sample, unless it has
+	 * overflowed again: then TOF is still set, nothing took the request, and the DAC
+	 * is holding a sample too long
+	 */
+	uint32_t entry = INSTR_IRQ_STAMP(TPM0->CNT);
+	bool late = INSTR_IRQ_STAMP(TPM0->SC & TPM_SC_TOF_MASK) != 0;
+	uint32_t start = INSTR_START();
+
 	/**
 	 * Set the Done flag
 	 */
@@ -223,4 +253,16 @@ void DMA0_IRQHandler(void)
      * Begin DMA transfer
      */
     start_onboard_dma(dac_buffer, dac_buffer_samples << 1);
+
+    if(dma_task != NULL){
+    	task_post_isr(dma_task, dma_signal, 0);
+    }
+
+    INSTR_STOP(INSTR_TIMER_DMA_ISR, start);
+    if(late){
+    	INSTR_IRQ_LATE(INSTR_IRQ_DMA0);
+    }
+    else{
+    	INSTR_IRQ(INSTR_IRQ_DMA0, tpm_cycles(TPM0, 0, entry), tpm_cycles(TPM0, entry, INSTR_IRQ_STAMP(TPM0->CNT)));
+    }
 }
@@ -8,6 +8,13 @@
 #ifndef DMA_H_
 #define DMA_H_
 
+#include <stdint.h>
+
+/**
+ * User-defined libraries
+ */
+#include "task.h"
+
 /**
  * \fn		void init_onboard_dma
  * \param	N/A
@@ -25,6 +32,16 @@ void init_onboard_dma(void);
  */
 void start_onboard_dma(uint16_t *source, uint32_t count);
 
+/**
+ * \fn		void dma_notify
+ * \param	task_t *task Posted to, NULL to stop
+ * \param	uint16_t signal
+ * \return	N/A
+ * \brief   Has DMA0_IRQHandler post to a task's inbox each time the DAC has played the
+ * 			whole buffer. Call after init_onboard_dma
+ */
+void dma_notify(task_t *task, uint16_t signal);
+
 /**
  * \fn		void DMA0_IRQHandler
  * \param	N/A
@@ -0,0 +1,365 @@
+/**
+ * \file    event.c
+ * \author	Dayton Flores (dafl2542@colorado.edu)
+ * \date	10/19/2026
+ * \brief   Function definitions for the tickless event scheduler
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "board.h"
+
+/**
+ * User-defined libraries
+ */
+#include "critical.h"
+#include "event.h"
+#include "instr.h"
+#include "irq.h"
+#include "tpm.h"
+
+/**
+ * \def		TPM2_SC_PS
+ * \brief	Prescale Factor Selection (divide by 16, see EVENT_COUNT_HZ)
+ */
+#define TPM2_SC_PS\
+	(4)
+
+/**
+ * \def		TPM2_DBGMODE
+ * \brief	LPTPM counter continues to increment in debug mode
+ */
+#define TPM2_DBGMODE\
+	(3)
+
+/**
+ * \def		EVENT_CHANNEL
+ * \brief	TPM2 channel that compares against the earliest deadline
+ */
+#define EVENT_CHANNEL\
+	(0)
+
+/**
+ * \def		EVENT_CnSC
+ * \brief	Software compare: the channel only sets CHF on a match, the pin is untouched
+ */
+#define EVENT_CnSC\
+	(TPM_CnSC_MSA_MASK)
+
+/**
+ * \var		event_overflows
+ * \brief	Upper bits of the TPM2 count, counted by TPM2_IRQHandler. 64 bits, so
+ * 			event_now() doesn't wrap; the Cortex-M0+ reads it in two halves, so only
+ * 			with interrupts masked
+ */
+static volatile uint64_t event_overflows = 0;
+
+/**
+ * \var		event_base
+ * \brief	event_now() when TPM2 was last (re)started, see event_retime
+ */
+static uint64_t event_base = 0;
+
+/**
+ * \var		event_scale
+ * \brief	EVENT_COUNT_HZ counts per TPM2 count: 1 at TPM_CLOCK_HZ, more on a slower
+ * 			TPM clock
+ */
+static uint32_t event_scale = 1;
+
+/**
+ * \var		event_queue
+ * \brief	Queued events, earliest deadline first. Only touched from the main loop
+ */
+static event_t *event_queue = NULL;
+
+/**
+ * \fn		uint64_t event_raw
+ * \param	N/A
+ * \return	TPM2 counts since it was last (re)started, extended to 64 bits by its overflows
+ */
+static uint64_t event_raw(void)
+{
+	uint32_t primask = critical_enter();
+	uint64_t hi = event_overflows;
+	uint32_t lo = TPM2->CNT;
+
+	/**
+	 * The counter wrapped but TPM2_IRQHandler hasn't counted it yet
+	 */
+	if((TPM2->SC & TPM_SC_TOF_MASK) && (lo < 0x8000)){
+		hi++;
+	}
+	critical_exit(primask);
+
+	return (hi << 16) | lo;
+}
+
+uint64_t event_now(void)
+{
+	return event_base + event_raw() * event_scale;
+}
+
+/**
+ * \fn		void event_arm
+ * \param	N/A
+ * \return	N/A
+ * \brief   Points the TPM2 compare at the earliest deadline, if it comes up before TPM2
+ * 			next overflows. Later ones are left to the overflow interrupt, which wakes
+ * 			the main loop to look again
+ */
+static void event_arm(void)
+{
+	uint64_t raw;
+	uint64_t ahead;
+	uint32_t lo;
+	uint32_t match;
+
+	/**
+	 * Stop interrupting and clear CHF (write 1 to clear)
+	 */
+	TPM2->CONTROLS[EVENT_CHANNEL].CnSC = TPM_CnSC_CHF_MASK | EVENT_CnSC;
+	if(event_queue == NULL){
+		return;
+	}
+
+	raw = event_raw();
+	lo = (uint32_t)(raw & 0xFFFF);
+	if(event_queue->deadline <= event_base + raw * event_scale){
+		return;
+	}
+
+	/**
+	 * The first TPM2 count at or past the deadline, if it comes before the overflow
+	 */
+	ahead = event_queue->deadline - (event_base + raw * event_scale);
+	if(ahead > (uint64_t)(0xFFFF - lo) * event_scale){
+		return;
+	}
+	match = lo + ((uint32_t)ahead + event_scale - 1) / event_scale;
+
+	/**
+	 * If CNT gets past CnV before the write lands the match is lost, but task_sleep
+	 * checks event_due before it waits
+	 */
+	TPM2->CONTROLS[EVENT_CHANNEL].CnV = TPM_CnV_VAL(match);
+	TPM2->CONTROLS[EVENT_CHANNEL].CnSC = TPM_CnSC_CHIE_MASK | EVENT_CnSC;
+}
+
+/**
+ * \fn		void event_insert
+ * \param	event_t *event Not queued
+ * \return	N/A
+ * \brief   Queues event behind those with the same or an earlier deadline
+ */
+static void event_insert(event_t *event)
+{
+	event_t **link = &event_queue;
+
+	while((*link != NULL) && ((*link)->deadline <= event->deadline)){
+		link = &(*link)->next;
+	}
+	event->next = *link;
+	*link = event;
+	event->queued = true;
+}
+
+/**
+ * \fn		void event_remove
+ * \param	event_t *event
+ * \return	N/A
+ * \brief   Unlinks event if it is queued
+ */
+static void event_remove(event_t *event)
+{
+	event_t **link = &event_queue;
+
+	if(!event->queued){
+		return;
+	}
+	while(*link != event){
+		link = &(*link)->next;
+	}
+	*link = event->next;
+	event->queued = false;
+}
+
+/**
+ * \fn		void event_start
+ * \param	event_t *event
+ * \param	uint32_t interval_us
+ * \param	bool periodic
+ * \param	event_fn_t fn
+ * \param	void *arg
+ * \return	N/A
+ * \brief   (Re)queues event one interval from now
+ */
+static void event_start(event_t *event, uint32_t interval_us, bool periodic, event_fn_t fn, void *arg)
+{
+	event_remove(event);
+	event->interval = interval_us * EVENT_COUNTS_PER_US;
+	event->periodic = periodic;
+	event->fn = fn;
+	event->arg = arg;
+	event->deadline = event_now() + event->interval;
+	event_insert(event);
+	event_arm();
+}
+
+void init_event_scheduler(void)
+{
+	/**
+	 * Enable clock to TPM2. SOPT2[TPMSRC] is configured by init_onboard_tpm
+	 */
+	SIM->SCGC6 |= SIM_SCGC6_TPM2_MASK;
+
+	/**
+	 * Disable TPM2 for configuration and count the full 16 bits
+	 */
+	TPM2->SC = 0;
+	TPM2->CNT = 0;
+	TPM2->MOD = TPM_MOD_MOD(0xFFFF);
+	TPM2->CONTROLS[EVENT_CHANNEL].CnSC = EVENT_CnSC;
+
+	/**
+     * Configure the TPM SC register:
+     * 	- Count up with divide by 16 prescaler
+     * 	- Interrupt on overflow
+     */
+	TPM2->SC =
+		TPM_SC_TOIE_MASK |
+		TPM_SC_PS(TPM2_SC_PS);
+	TPM2->CONF |= TPM_CONF_DBGMODE(TPM2_DBGMODE);
+
+	NVIC_SetPriority(TPM2_IRQn, IRQ_PRIORITY_TPM2);
+	NVIC_ClearPendingIRQ(TPM2_IRQn);
+	NVIC_EnableIRQ(TPM2_IRQn);
+
+	/**
+	 * Start TPM2
+	 */
+	TPM2->SC |= TPM_SC_CMOD(1);
+}
+
+bool event_retime(uint32_t clock_hz)
+{
+	uint32_t ps = 0;
+
+	/**
+	 * The smallest prescaler that counts at EVENT_COUNT_HZ or a whole fraction of it
+	 */
+	while((ps <= TPM_SC_PS_MASK) && (clock_hz >> ps) &&
+		  (((clock_hz >> ps) > EVENT_COUNT_HZ) || (EVENT_COUNT_HZ % (clock_hz >> ps)) ||
+		   (clock_hz & ((1u << ps) - 1)))){
+		ps++;
+	}
+	if((ps > TPM_SC_PS_MASK) || !(clock_hz >> ps)){
+		return false;
+	}
+
+	/**
+	 * Carry on from where the old rate got to. SC[PS] only takes a write with the
+	 * counter stopped
+	 */
+	event_base = event_now();
+	TPM2->SC &= ~(TPM_SC_CMOD_MASK | TPM_SC_PS_MASK);
+	TPM2->SC |= TPM_SC_TOF_MASK;
+	TPM2->CNT = 0;
+	event_overflows = 0;
+	event_scale = EVENT_COUNT_HZ / (clock_hz >> ps);
+	TPM2->SC |= TPM_SC_PS(ps) | TPM_SC_CMOD(1);
+	event_arm();
+	return true;
+}
+
+uint64_t now_us(void)
+{
+	return event_now() / EVENT_COUNTS_PER_US;
+}
+
+void event_after(event_t *event, uint32_t delay_us, event_fn_t fn, void *arg)
+{
+	event_start(event, delay_us, false, fn, arg);
+}
+
+void event_every(event_t *event, uint32_t period_us, event_fn_t fn, void *arg)
+{
+	event_start(event, period_us, true, fn, arg);
+}
+
+void event_restart(event_t *event)
+{
+	event_remove(event);
+	event->deadline = event_now() + event->interval;
+	event_insert(event);
+	event_arm();
+}
+
+void event_cancel(event_t *event)
+{
+	event_remove(event);
+	event_arm();
+}
+
+void event_run(void)
+{
+	event_t *event;
+
+	while((event_queue != NULL) && (event_queue->deadline <= event_now())){
+		event = event_queue;
+		event_remove(event);
+
+		/**
+		 * Requeue before the callback, so the callback can still cancel or restart it
+		 */
+		if(event->periodic){
+			event->deadline += event->interval;
+			event_insert(event);
+		}
+		event->fn(event->arg);
+	}
+	event_arm();
+}
+
+bool event_due(void)
+{
+	return (event_queue != NULL) && (event_queue->deadline <= event_now());
+}
+
+void TPM2_IRQHandler(void)
+{
+	uint32_t entry = INSTR_IRQ_STAMP(TPM2->CNT);
+	uint32_t from = 0;
+	uint32_t primask;
+
+	/**
+	 * Latency from the compare match if an armed one came up, the overflow if not.
+	 * CHF also sets on matches nobody armed, long after they happened
+	 */
+	if((TPM2->CONTROLS[EVENT_CHANNEL].CnSC & (TPM_CnSC_CHF_MASK | TPM_CnSC_CHIE_MASK)) ==
+			(TPM_CnSC_CHF_MASK | TPM_CnSC_CHIE_MASK)){
+		from = INSTR_IRQ_STAMP(TPM2->CONTROLS[EVENT_CHANNEL].CnV);
+	}
+
+	if(TPM2->SC & TPM_SC_TOF_MASK){
+
+		/**
+		 * DMA0 and ADC0 preempt this handler. Clearing TOF (write 1 to clear) and
+		 * counting the overflow happen together, or event_raw() in one of them could
+		 * find TOF clear and the old count, or the count between its halves
+		 */
+		primask = critical_enter();
+		TPM2->SC |= TPM_SC_TOF_MASK;
+		event_overflows++;
+		critical_exit(primask);
+	}
+
+	/**
+	 * A deadline came up: clear CHF and stop interrupting, event_run takes it from here
+	 */
+	if(TPM2->CONTROLS[EVENT_CHANNEL].CnSC & TPM_CnSC_CHF_MASK){
+		TPM2->CONTROLS[EVENT_CHANNEL].CnSC = TPM_CnSC_CHF_MASK | EVENT_CnSC;
+	}
+	INSTR_IRQ(INSTR_IRQ_TPM2, tpm_cycles(TPM2, from, entry), tpm_cycles(TPM2, entry, INSTR_IRQ_STAMP(TPM2->CNT)));
+}
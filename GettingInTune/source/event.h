@@ -0,0 +1,171 @@
+/**
+ * \file    event.h
+ * \author	Dayton Flores (dafl2542@colorado.edu)
+ * \date	10/19/2026
+ * \brief   Macros and function headers for the tickless event scheduler
+ * \detail
+ * 		TPM2 counts freely at EVENT_COUNT_HZ and its overflows extend it to 64 bits, which
+ * 		gives now_us(). Events are one-shot or periodic callbacks kept in a queue sorted
+ * 		by deadline. Channel 0 of TPM2 compares against the earliest deadline, so the CPU
+ * 		is only woken when something is due (or TPM2 overflows, every ~22 ms at
+ * 		TPM_CLOCK_HZ) rather than
+ * 		by a fixed tick.
+ *
+ * 		Callbacks run from event_run() in the main loop, never from the ISR, so they may
+ * 		use anything the main loop uses. They may start, restart or cancel any event,
+ * 		their own included. event_t structs belong to the caller and must stay valid
+ * 		while the event is queued.
+ */
+
+#ifndef EVENT_H_
+#define EVENT_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * \def		EVENT_COUNT_HZ
+ * \brief	Rate TPM2 counts at: the 48 MHz TPM clock divided by 16. On a slower clock
+ * 			(see event_retime) each count stands for several of these, and deadlines and
+ * 			now_us() keep their units
+ */
+#define EVENT_COUNT_HZ\
+	(3000000UL)
+
+/**
+ * \def		EVENT_COUNTS_PER_US
+ * \brief	TPM2 counts per us
+ */
+#define EVENT_COUNTS_PER_US\
+	(EVENT_COUNT_HZ / 1000000UL)
+
+/**
+ * \typedef	typedef void (*event_fn_t)(void *arg)
+ * \brief   An event's callback
+ */
+typedef void (*event_fn_t)(void *arg);
+
+/**
+ * \typedef	typedef struct event_s event_t
+ * \brief   Easily declare events
+ */
+typedef struct event_s event_t;
+
+/**
+ * \struct	struct event_s
+ * \brief   One callback and when to run it. Only touched through the functions below
+ */
+struct event_s{
+	event_t *next;
+	uint64_t deadline;	/* In counts at EVENT_COUNT_HZ */
+	uint32_t interval;	/* Delay or period, in counts at EVENT_COUNT_HZ */
+	event_fn_t fn;
+	void *arg;
+	bool periodic;
+	bool queued;
+};
+
+/**
+ * \fn		void init_event_scheduler
+ * \param	N/A
+ * \return	N/A
+ * \brief   Starts TPM2 free-running. Call after init_onboard_tpm, which selects the TPM
+ * 			clock
+ */
+void init_event_scheduler(void);
+
+/**
+ * \fn		uint64_t event_now
+ * \param	N/A
+ * \return	Counts at EVENT_COUNT_HZ since init_event_scheduler
+ * \brief   now_us() without the division, for timing short intervals
+ */
+uint64_t event_now(void);
+
+/**
+ * \fn		bool event_retime
+ * \param	uint32_t clock_hz The TPM clock from now on
+ * \return	true if TPM2 can count at EVENT_COUNT_HZ or a whole fraction of it from
+ * 			clock_hz, false (and nothing changed) if not
+ * \brief   Reprograms TPM2's prescaler for a new TPM clock (see clocks.h). event_now()
+ * 			carries on from where it was, so queued deadlines stay put; only the time
+ * 			the clock took to switch is lost. Call with interrupts masked
+ */
+bool event_retime(uint32_t clock_hz);
+
+/**
+ * \fn		uint64_t now_us
+ * \param	N/A
+ * \return	us since init_event_scheduler
+ * \brief   Monotonic time, usable from any context
+ */
+uint64_t now_us(void);
+
+/**
+ * \fn		void event_after
+ * \param	event_t *event
+ * \param	uint32_t delay_us
+ * \param	event_fn_t fn
+ * \param	void *arg Passed to fn
+ * \return	N/A
+ * \brief   Runs fn once, delay_us from now. Requeues event if it was already queued
+ */
+void event_after(event_t *event, uint32_t delay_us, event_fn_t fn, void *arg);
+
+/**
+ * \fn		void event_every
+ * \param	event_t *event
+ * \param	uint32_t period_us
+ * \param	event_fn_t fn
+ * \param	void *arg Passed to fn
+ * \return	N/A
+ * \brief   Runs fn every period_us, the first time period_us from now. Deadlines advance
+ * 			by exactly period_us, so a late callback doesn't make the next one late too
+ */
+void event_every(event_t *event, uint32_t period_us, event_fn_t fn, void *arg);
+
+/**
+ * \fn		void event_restart
+ * \param	event_t *event Started before with event_after or event_every
+ * \return	N/A
+ * \brief   Pushes the next deadline back to a full delay or period from now
+ */
+void event_restart(event_t *event);
+
+/**
+ * \fn		void event_cancel
+ * \param	event_t *event
+ * \return	N/A
+ * \brief   Removes event from the queue, if it is there
+ */
+void event_cancel(event_t *event);
+
+/**
+ * \fn		void event_run
+ * \param	N/A
+ * \return	N/A
+ * \brief   Runs the callbacks that are due and sets the TPM2 compare for the next one.
+ * 			Call from the main loop
+ */
+void event_run(void);
+
+/**
+ * \fn		bool event_due
+ * \param	N/A
+ * \return	true if an event's deadline has passed and event_run hasn't run it yet
+ * \brief   Checked before idling, since a deadline the TPM2 compare missed won't wake
+ * 			the core
+ */
+bool event_due(void);
+
+/**
+ * \fn		void TPM2_IRQHandler
+ * \param	N/A
+ * \return	N/A
+ * \brief   The ISR for the TPM2 timer: counts overflows and notes that a deadline came up
+ * \detail	FUNCTION NAME IS CASE SENSITIVE. Since it is weakly defined in
+ * 			startup\startup_mkl25z4.c this definition will override
+ */
+void TPM2_IRQHandler(void);
+
+#endif /* EVENT_H_ */
@@ -0,0 +1,119 @@
+/**
+ * \file    frame.c
+ * \author	Dayton Flores (dafl2542@colorado.edu)
+ * \date	10/19/2026
+ * \brief   Function definitions for overlapping analysis frames over the ADC scan rings
+ */
+
+#include "board.h"
+
+/**
+ * User-defined libraries
+ */
+#include "adc.h"
+#include "arena.h"
+#include "autocorrelate.h"
+#include "fp_trig.h"
+#include "frame.h"
+
+/**
+ * \def		Q15_ONE
+ * \brief	1.0 in Q15, rounded down to fit an int16_t
+ */
+#define Q15_ONE\
+	(32767)
+
+/**
+ * \var		frame_length
+ * \brief	Samples per frame
+ */
+static uint32_t frame_length = FRAME_LENGTH;
+
+/**
+ * \var		frame_hop
+ * \brief	Samples consumed per frame_release
+ */
+static uint32_t frame_hop = FRAME_HOP;
+
+/**
+ * \var		frame_window
+ * \brief	Q15 weights for each sample of a frame, NULL when not windowing
+ */
+static const int16_t *frame_window = NULL;
+
+/**
+ * \var		frame_window_table
+ * \brief	Storage for frame_window, borrowed from the arena (arena.h) until the next
+ * 			init_frames
+ */
+static int16_t *frame_window_table = NULL;
+
+void init_frames(uint32_t length, uint32_t hop, frame_window_t window)
+{
+	int32_t c;
+
+	if((length == 0) || (length > FRAME_MAX_LENGTH)){
+		length = FRAME_MAX_LENGTH;
+	}
+	if((hop == 0) || (hop > length)){
+		hop = length;
+	}
+	frame_length = length;
+	frame_hop = hop;
+
+	frame_window = NULL;
+	arena_return(ARENA_OWNER_WINDOW);
+	if(window == FRAME_WINDOW_NONE){
+		return;
+	}
+	frame_window_table = arena_borrow(ARENA_OWNER_WINDOW, length);
+	if(frame_window_table == NULL){
+		return;
+	}
+
+	/**
+	 * Symmetric windows over the frame, from fp_cos:
+	 * 	Hann:    0.5 - 0.5 cos(2 pi k / (length - 1))
+	 * 	Hamming: 0.54 - 0.46 cos(2 pi k / (length - 1))
+	 */
+	for(uint32_t k = 0; k < length; k++){
+		c = (length > 1) ? fp_cos((int32_t)((TWO_PI * k) / (length - 1))) : -TRIG_SCALE_FACTOR;
+
+		if(window == FRAME_WINDOW_HANN){
+			frame_window_table[k] = (int16_t)(((TRIG_SCALE_FACTOR - c) * Q15_ONE) / (2 * TRIG_SCALE_FACTOR));
+		}
+		else{
+			frame_window_table[k] = (int16_t)(((27 * TRIG_SCALE_FACTOR - 23 * c) * Q15_ONE) / (50 * TRIG_SCALE_FACTOR));
+		}
+	}
+	frame_window = frame_window_table;
+}
+
+bool frame_next(uint32_t ch, frame_t *frame)
+{
+	if(adc_scan_available(ch) < frame_length){
+		return false;
+	}
+
+	frame->ring = adc_scan_ring(ch);
+	frame->mask = ADC_SCAN_RING_SIZE - 1;
+	frame->start = adc_scan_read_index(ch) & frame->mask;
+	frame->length = frame_length;
+	frame->window = frame_window;
+	return true;
+}
+
+void frame_release(uint32_t ch)
+{
+	adc_scan_consume(ch, frame_hop);
+}
+
+int frame_detect_period(const frame_t *frame)
+{
+	return autocorrelate_detect_period_ring(frame->ring,
+			frame->mask,
+			frame->start,
+			frame->length,
+			frame->window,
+			kAC_16bps_unsigned);
+}
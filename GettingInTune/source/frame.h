@@ -0,0 +1,110 @@
+/**
+ * \file    frame.h
+ * \author	Dayton Flores (dafl2542@colorado.edu)
+ * \date	10/19/2026
+ * \brief   Macros and function headers for overlapping analysis frames over the ADC scan rings
+ * \detail
+ * 		A frame is a view of frame_length samples in a channel's ring, starting at the
+ * 		ring's read index. Releasing a frame consumes only hop samples, so with a hop
+ * 		shorter than the frame successive frames overlap and the detector runs more
+ * 		often on the same data rate. Samples are never copied out of the ring.
+ */
+
+#ifndef FRAME_H_
+#define FRAME_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "adc.h"
+
+/**
+ * \def		FRAME_MAX_LENGTH
+ * \brief	Longest frame, leaving half of each ring for ADC0_IRQHandler to fill
+ */
+#define FRAME_MAX_LENGTH\
+	(ADC_SCAN_BLOCK_SIZE)
+
+/**
+ * \def		FRAME_LENGTH
+ * \brief	Default frame length in samples
+ */
+#define FRAME_LENGTH\
+	(FRAME_MAX_LENGTH)
+
+/**
+ * \def		FRAME_HOP
+ * \brief	Default hop between frames in samples (50% overlap)
+ */
+#define FRAME_HOP\
+	(FRAME_LENGTH / 2)
+
+/**
+ * \typedef	typedef enum frame_window_e frame_window_t
+ * \brief   Window functions a frame can be weighted with
+ */
+typedef enum frame_window_e frame_window_t;
+
+/**
+ * \enum	enum frame_window_e
+ * \brief   Window functions a frame can be weighted with
+ */
+enum frame_window_e{
+	FRAME_WINDOW_NONE,
+	FRAME_WINDOW_HANN,
+	FRAME_WINDOW_HAMMING
+};
+
+/**
+ * \typedef	typedef struct frame_s frame_t
+ * \brief   A frame of samples in place in a ring
+ */
+typedef struct frame_s frame_t;
+
+/**
+ * \struct	struct frame_s
+ * \brief   A frame of samples in place in a ring
+ */
+struct frame_s{
+	const int16_t *ring;
+	uint32_t mask;
+	uint32_t start;
+	uint32_t length;
+	const int16_t *window;
+};
+
+/**
+ * \fn		void init_frames
+ * \param	uint32_t length Samples per frame, at most FRAME_MAX_LENGTH
+ * \param	uint32_t hop Samples between the starts of successive frames, 1 to length
+ * \param	frame_window_t window
+ * \return	N/A
+ * \brief   Configures framing for every scanned channel and computes the Q15 window
+ */
+void init_frames(uint32_t length, uint32_t hop, frame_window_t window);
+
+/**
+ * \fn		bool frame_next
+ * \param	uint32_t ch Index into the scan's channel list
+ * \param	frame_t *frame Filled in with the channel's next frame
+ * \return	true if a whole frame is available, false otherwise
+ * \brief   Views the channel's next frame. It stays valid until frame_release
+ */
+bool frame_next(uint32_t ch, frame_t *frame);
+
+/**
+ * \fn		void frame_release
+ * \param	uint32_t ch Index into the scan's channel list
+ * \return	N/A
+ * \brief   Done with the channel's current frame: consume one hop from its ring
+ */
+void frame_release(uint32_t ch);
+
+/**
+ * \fn		int frame_detect_period
+ * \param	const frame_t *frame
+ * \return	Period of the fundamental in samples, or -1 if none was found
+ * \brief   Runs the autocorrelation pitch detector over a frame in place
+ */
+int frame_detect_period(const frame_t *frame);
+
+#endif /* FRAME_H_ */
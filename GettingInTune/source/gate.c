@@ -0,0 +1,133 @@
+/**
+ * \file    gate.c
+ * \author	Dayton Flores (dafl2542@colorado.edu)
+ * \date	10/19/2026
+ * \brief   Function definitions for the noise gate in front of the pitch detector
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * User-defined libraries
+ */
+#include "gate.h"
+
+/**
+ * \var		gates
+ * \brief	One gate per input
+ */
+static gate_t gates[GATE_MAX_INPUTS];
+
+/**
+ * \var		gates_open
+ * \brief	Bit n is set while gate n is open
+ */
+static uint32_t gates_open = 0;
+
+/**
+ * \var		gate_open_energy
+ * \brief	Energy thresholds in use, see gate_set_energy
+ */
+static uint32_t gate_open_energy = GATE_OPEN_ENERGY;
+static uint32_t gate_close_energy = GATE_CLOSE_ENERGY;
+
+/**
+ * \var		signal_present
+ * \brief	True while any input carries a tone, so the CPU can sleep otherwise
+ */
+volatile bool signal_present = false;
+
+bool gate_update(uint32_t input, const int16_t *ring, uint32_t mask, uint32_t start, uint32_t n)
+{
+	gate_t *gate = &gates[input];
+	uint32_t sum = 0;
+	uint64_t energy = 0;
+	uint32_t crossings = 0;
+	int32_t mean;
+	int32_t d;
+	int32_t state = 0;
+
+	if(n == 0){
+		return gate->open;
+	}
+
+	/**
+	 * Mean first, so DC on the input counts as neither energy nor crossings
+	 */
+	for(uint32_t k = 0; k < n; k++){
+		sum += (uint16_t)ring[(start + k) & mask] >> GATE_SAMPLE_SHIFT;
+	}
+	mean = (int32_t)(sum / n);
+
+	for(uint32_t k = 0; k < n; k++){
+		d = (int32_t)((uint16_t)ring[(start + k) & mask] >> GATE_SAMPLE_SHIFT) - mean;
+		energy += (uint32_t)(d * d);
+
+		/**
+		 * Schmitt trigger: only a swing from below -GATE_ZCR_BAND to above +GATE_ZCR_BAND
+		 * (or back) counts, so noise riding on a slow part of the waveform doesn't
+		 */
+		if(d > GATE_ZCR_BAND){
+			if(state < 0){
+				crossings++;
+			}
+			state = 1;
+		}
+		else if(d < -GATE_ZCR_BAND){
+			if(state > 0){
+				crossings++;
+			}
+			state = -1;
+		}
+	}
+	gate->energy = (uint32_t)(energy / n);
+	gate->zcr = (crossings << 10) / n;
+	gate->blocks++;
+
+	/**
+	 * Hysteresis: harder to open than to stay open
+	 */
+	if(gate->open){
+		if((gate->energy < gate_close_energy) || (gate->zcr > GATE_CLOSE_ZCR)){
+			gate->open = false;
+		}
+	}
+	else{
+		if((gate->energy > gate_open_energy) && (gate->zcr < GATE_OPEN_ZCR)){
+			gate->open = true;
+		}
+	}
+
+	if(gate->open){
+		gates_open |= (1u << input);
+	}
+	else{
+		gates_open &= ~(1u << input);
+		gate->skipped++;
+	}
+	signal_present = (gates_open != 0);
+
+	return gate->open;
+}
+
+const gate_t *gate_state(uint32_t input)
+{
+	return &gates[input];
+}
+
+bool gate_set_energy(uint32_t open, uint32_t close)
+{
+	if(close >= open){
+		return false;
+	}
+	gate_open_energy = open;
+	gate_close_energy = close;
+	return true;
+}
+
+void gate_get_energy(uint32_t *open, uint32_t *close)
+{
+	*open = gate_open_energy;
+	*close = gate_close_energy;
+}
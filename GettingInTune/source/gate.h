@@ -0,0 +1,136 @@
+/**
+ * \file    gate.h
+ * \author	Dayton Flores (dafl2542@colorado.edu)
+ * \date	10/19/2026
+ * \brief   Macros and function headers for the noise gate in front of the pitch detector
+ * \detail
+ * 		The autocorrelation detector is O(N^2) and runs to the end of its loop when there
+ * 		is nothing to find. The gate looks at a block first, in one O(N) pass: its AC
+ * 		energy and its zero-crossing rate. A tone has energy and crosses its mean twice
+ * 		per period; silence has no energy, broadband noise crosses far too often.
+ * 		Both tests use separate open and close thresholds so the gate doesn't chatter.
+ */
+
+#ifndef GATE_H_
+#define GATE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * \def		GATE_MAX_INPUTS
+ * \brief	Independent gates, one per scanned ADC channel
+ */
+#define GATE_MAX_INPUTS\
+	(2)
+
+/**
+ * \def		GATE_SAMPLE_SHIFT
+ * \brief	Samples are 16-bit unsigned and analyzed at 10 bits, so their sum fits 32 bits.
+ * 			Energy is summed in 64: a full-scale square wave over ADC_BUF_SIZE samples
+ * 			(2048) only just fits 32, and would not over twice that
+ */
+#define GATE_SAMPLE_SHIFT\
+	(6)
+
+/**
+ * \def		GATE_OPEN_ENERGY
+ * \brief	Default mean square (10-bit LSB^2) above which the gate may open. About 1% of
+ * 			full scale in amplitude. gate_set_energy() changes it
+ */
+#define GATE_OPEN_ENERGY\
+	(64)
+
+/**
+ * \def		GATE_CLOSE_ENERGY
+ * \brief	Default mean square (10-bit LSB^2) below which an open gate closes
+ */
+#define GATE_CLOSE_ENERGY\
+	(32)
+
+/**
+ * \def		GATE_ZCR_BAND
+ * \brief	Half-width (10-bit LSB) of the band around the mean a crossing has to traverse
+ */
+#define GATE_ZCR_BAND\
+	(8)
+
+/**
+ * \def		GATE_OPEN_ZCR
+ * \brief	Zero crossings per 1024 samples below which the gate may open. A tone at f Hz
+ * 			sampled at fs crosses 2 * f / fs times per sample: C8 at 48 kHz is ~180
+ */
+#define GATE_OPEN_ZCR\
+	(256)
+
+/**
+ * \def		GATE_CLOSE_ZCR
+ * \brief	Zero crossings per 1024 samples above which an open gate closes. White noise
+ * 			sits around 512
+ */
+#define GATE_CLOSE_ZCR\
+	(320)
+
+/**
+ * \typedef	typedef struct gate_s gate_t
+ * \brief   State and last measurements of one gate
+ */
+typedef struct gate_s gate_t;
+
+/**
+ * \struct	struct gate_s
+ * \brief   State and last measurements of one gate
+ */
+struct gate_s{
+	bool open;
+	uint32_t energy;
+	uint32_t zcr;
+	uint32_t blocks;
+	uint32_t skipped;
+};
+
+/**
+ * \var		signal_present
+ * \brief	Defined in gate.c
+ */
+extern volatile bool signal_present;
+
+/**
+ * \fn		bool gate_update
+ * \param	uint32_t input Gate to update, below GATE_MAX_INPUTS
+ * \param	const int16_t *ring Block of 16-bit unsigned samples, in place in a ring
+ * \param	uint32_t mask Ring size - 1, or 0xFFFFFFFF for a linear buffer
+ * \param	uint32_t start Index of the first sample
+ * \param	uint32_t n Samples in the block
+ * \return	true if the block should go to the pitch detector, false to skip it
+ * \brief   Measures a block and moves the gate through its hysteresis. Also updates
+ * 			signal_present, which is true while any gate is open
+ */
+bool gate_update(uint32_t input, const int16_t *ring, uint32_t mask, uint32_t start, uint32_t n);
+
+/**
+ * \fn		const gate_t *gate_state
+ * \param	uint32_t input
+ * \return	The gate's state and last measurements
+ */
+const gate_t *gate_state(uint32_t input);
+
+/**
+ * \fn		bool gate_set_energy
+ * \param	uint32_t open Mean square above which a gate may open
+ * \param	uint32_t close Mean square below which an open gate closes
+ * \return	true if set, false if close isn't below open
+ * \brief   Changes every gate's energy thresholds, to suit the input's noise floor
+ */
+bool gate_set_energy(uint32_t open, uint32_t close);
+
+/**
+ * \fn		void gate_get_energy
+ * \param	uint32_t *open
+ * \param	uint32_t *close
+ * \return	N/A
+ * \brief   Reads the energy thresholds in use
+ */
+void gate_get_energy(uint32_t *open, uint32_t *close);
+
+#endif /* GATE_H_ */
@@ -0,0 +1,55 @@
+/**
+ * \file    idle.c
+ * \author	Dayton Flores (dafl2542@colorado.edu)
+ * \date	10/19/2026
+ * \brief   Function definitions for the low-power idle policy
+ */
+
+#include <stdint.h>
+#include "board.h"
+#include "fsl_smc.h"
+#ifdef HOST_SIM
+#include "sim_kl25z.h"
+#endif
+
+/**
+ * User-defined libraries
+ */
+#include "event.h"
+#include "idle.h"
+#include "instr.h"
+
+void idle_wait(void)
+{
+#if INSTR_ENABLE
+	uint64_t start = event_now();
+#endif
+
+	/**
+	 * WFI enters VLPW instead of WAIT on its own in VLPR; the SMC calls only differ in
+	 * name, but which one ran is what gets counted
+	 */
+	if(SMC_GetPowerModeState(SMC) == kSMC_PowerStateVlpr){
+		INSTR_COUNT(INSTR_COUNT_VLPW);
+#ifdef HOST_SIM
+		sim_wfi();
+#else
+		SMC_SetPowerModeVlpw(SMC);
+#endif
+	}
+	else{
+		INSTR_COUNT(INSTR_COUNT_WAIT);
+#ifdef HOST_SIM
+		sim_wfi();
+#else
+		SMC_SetPowerModeWait(SMC);
+#endif
+	}
+
+#if INSTR_ENABLE
+	uint64_t slept = event_now() - start;
+
+	instr_asleep += slept;
+	INSTR_ADD(INSTR_TIMER_SLEEP, instr_cycles((uint32_t)slept));
+#endif
+}
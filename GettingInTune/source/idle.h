@@ -0,0 +1,35 @@
+/**
+ * \file    idle.h
+ * \author	Dayton Flores (dafl2542@colorado.edu)
+ * \date	10/19/2026
+ * \brief   Macros and function headers for the low-power idle policy
+ * \detail
+ * 		Playback (TPM0 and DMA into the DAC) and capture (TPM1 triggering the ADC) run
+ * 		without the CPU. Whenever the main loop has nothing left to do, task_sleep()
+ * 		calls idle_wait(), which stops the core until the next interrupt: DMA, ADC, TPM
+ * 		(including the event scheduler's TPM2), UART or SysTick.
+ *
+ * 		The core enters WAIT from RUN and VLPW from VLPR (see clocks.h). Both keep the
+ * 		bus clock, DMA, TPMs, ADC and UART0 running, so nothing the main loop started is
+ * 		disturbed.
+ *
+ * 		Time spent idle is measured on TPM2, which keeps counting in both modes, and goes
+ * 		to the instrumentation (instr.h) as the sleep timer and the WAIT and VLPW
+ * 		counters. The fraction of time asleep is the current-draw proxy instr_report
+ * 		prints.
+ */
+
+#ifndef IDLE_H_
+#define IDLE_H_
+
+/**
+ * \fn		void idle_wait
+ * \param	N/A
+ * \return	N/A
+ * \brief   Enters WAIT or VLPW, whichever matches the current run mode, and returns once
+ * 			an interrupt is pending. Call with interrupts masked, after checking there is
+ * 			nothing to do, so an interrupt in between can't be slept through
+ */
+void idle_wait(void);
+
+#endif /* IDLE_H_ */
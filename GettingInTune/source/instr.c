@@ -0,0 +1,253 @@
+/**
+ * \file    instr.c
+ * \author	Dayton Flores (dafl2542@colorado.edu)
+ * \date	10/19/2026
+ * \brief   Function definitions for runtime instrumentation
+ */
+
+#include <stdint.h>
+
+/**
+ * User-defined libraries
+ */
+#include "dlog.h"
+#include "event.h"
+#include "instr.h"
+#include "systick.h"
+
+/**
+ * \var		instr_timers
+ * \brief	Cycle timers, indexed by instr_timer_id_t
+ */
+volatile instr_timer_t instr_timers[INSTR_TIMERS];
+
+/**
+ * \var		instr_counters
+ * \brief	Event counters, indexed by instr_counter_id_t
+ */
+volatile uint32_t instr_counters[INSTR_COUNTERS];
+
+/**
+ * \var		instr_irqs
+ * \brief	Handler histograms, indexed by instr_irq_id_t
+ */
+volatile instr_irq_t instr_irqs[INSTR_IRQS];
+
+/**
+ * \var		instr_cycle_scale
+ * \brief	Core cycles per SYSTICK_TIMESTAMP_HZ count, with INSTR_SCALE_SHIFT fraction
+ * 			bits. 16 in RUN; 4/3 in VLPR, which has no exact value and reads 4 ppm low
+ */
+volatile uint32_t instr_cycle_scale =
+		(uint32_t)(((uint64_t)INSTR_CORE_CLOCK_HZ << INSTR_SCALE_SHIFT) / SYSTICK_TIMESTAMP_HZ);
+
+/**
+ * \var		instr_asleep
+ * \brief	TPM2 counts spent in idle_wait since instr_reset. Kept in counts rather
+ * 			than cycles, so the share of time asleep holds across clock switches
+ */
+uint64_t instr_asleep = 0;
+
+_Static_assert(SYSTICK_TIMESTAMP_HZ == EVENT_COUNT_HZ,
+		"instr_cycles() takes SysTick and TPM2 counts alike");
+
+/**
+ * \var		instr_timer_names
+ * \brief	Names for the report, in instr_timer_id_t order
+ */
+static const char * const instr_timer_names[] = {
+	"capture",
+	"gate",
+	"detect",
+	"fill_dac",
+	"report",
+	"adc_isr",
+	"dma_isr",
+	"sleep"
+};
+
+_Static_assert(sizeof(instr_timer_names) / sizeof(instr_timer_names[0]) == INSTR_TIMERS,
+		"a timer has no name");
+
+/**
+ * \var		instr_irq_names
+ * \brief	Names for the report, in instr_irq_id_t order
+ */
+static const char * const instr_irq_names[] = {
+	"dma0",
+	"adc0",
+	"tpm2",
+	"systick"
+};
+
+_Static_assert(sizeof(instr_irq_names) / sizeof(instr_irq_names[0]) == INSTR_IRQS,
+		"a profiled handler has no name");
+_Static_assert((INSTR_IRQ_BUCKETS == 7) && (INSTR_IRQ_BUCKET_CYCLES == 32),
+		"instr_report's header is for 7 buckets from 32 cycles");
+
+/**
+ * \var		instr_build
+ * \brief	Identifies the firmware the report came from
+ */
+static const char instr_build[] = __DATE__ " " __TIME__;
+
+/**
+ * \var		instr_since
+ * \brief	event_now() at the last instr_reset
+ */
+static uint64_t instr_since = 0;
+
+void instr_reset(void)
+{
+	for(uint32_t i = 0; i < INSTR_TIMERS; i++){
+		instr_timers[i].count = 0;
+		instr_timers[i].min = 0;
+		instr_timers[i].max = 0;
+		instr_timers[i].total = 0;
+	}
+	for(uint32_t i = 0; i < INSTR_COUNTERS; i++){
+		instr_counters[i] = 0;
+	}
+	for(uint32_t i = 0; i < INSTR_IRQS; i++){
+		volatile instr_irq_t *h = &instr_irqs[i];
+
+		h->count = 0;
+		h->late = 0;
+		h->latency_max = 0;
+		h->duration_max = 0;
+		for(uint32_t b = 0; b < INSTR_IRQ_BUCKETS; b++){
+			h->latency[b] = 0;
+			h->duration[b] = 0;
+		}
+	}
+	instr_asleep = 0;
+	instr_since = event_now();
+}
+
+void instr_retime(uint32_t core_hz)
+{
+	instr_cycle_scale = (uint32_t)(((uint64_t)core_hz << INSTR_SCALE_SHIFT) / SYSTICK_TIMESTAMP_HZ);
+}
+
+void instr_snapshot(instr_snapshot_t *snapshot)
+{
+	snapshot->timestamp = systick_timestamp();
+	snapshot->elapsed = event_now() - instr_since;
+	snapshot->asleep = instr_asleep;
+
+	/**
+	 * Timers updated by an ISR may change in the middle of the copy. count changes
+	 * last in instr_stop, so copy again until it stays put
+	 */
+	for(uint32_t i = 0; i < INSTR_TIMERS; i++){
+		volatile instr_timer_t *t = &instr_timers[i];
+		uint32_t count;
+
+		do{
+			count = t->count;
+			snapshot->timers[i].min = t->min;
+			snapshot->timers[i].max = t->max;
+			snapshot->timers[i].total = t->total;
+		}while(count != t->count);
+		snapshot->timers[i].count = count;
+	}
+	for(uint32_t i = 0; i < INSTR_COUNTERS; i++){
+		snapshot->counters[i] = instr_counters[i];
+	}
+	for(uint32_t i = 0; i < INSTR_IRQS; i++){
+		volatile instr_irq_t *h = &instr_irqs[i];
+		instr_irq_t *copy = &snapshot->irqs[i];
+		uint32_t count;
+
+		do{
+			count = h->count;
+			copy->late = h->late;
+			copy->latency_max = h->latency_max;
+			copy->duration_max = h->duration_max;
+			for(uint32_t b = 0; b < INSTR_IRQ_BUCKETS; b++){
+				copy->latency[b] = h->latency[b];
+				copy->duration[b] = h->duration[b];
+			}
+		}while(count != h->count);
+		copy->count = count;
+	}
+}
+
+void instr_report(void)
+{
+	static instr_snapshot_t snapshot;
+	uint32_t asleep;
+
+	instr_snapshot(&snapshot);
+
+	/**
+	 * DLOG_LEVEL_OFF: the report was asked for, so it goes out even with logging off
+	 */
+	DLOG_AT(DLOG_LEVEL_OFF, "instr: build %s, %u timestamp counts\r\n",
+			DLOG_STRING(instr_build),
+			(unsigned)snapshot.timestamp);
+	for(uint32_t i = 0; i < INSTR_TIMERS; i++){
+		const instr_timer_t *t = &snapshot.timers[i];
+
+		if(t->count == 0){
+			continue;
+		}
+		DLOG_AT(DLOG_LEVEL_OFF, "instr: %-8s n = %u, min = %u, avg = %u, max = %u cycles\r\n",
+				DLOG_STRING(instr_timer_names[i]),
+				(unsigned)t->count,
+				(unsigned)t->min,
+				(unsigned)(t->total / t->count),
+				(unsigned)t->max);
+	}
+	DLOG_AT(DLOG_LEVEL_OFF, "instr: loops = %u, notes = %u, frames = %u, gated = %u, commands = %u\r\n",
+			(unsigned)snapshot.counters[INSTR_COUNT_LOOPS],
+			(unsigned)snapshot.counters[INSTR_COUNT_NOTES],
+			(unsigned)snapshot.counters[INSTR_COUNT_FRAMES],
+			(unsigned)snapshot.counters[INSTR_COUNT_GATED],
+			(unsigned)snapshot.counters[INSTR_COUNT_COMMANDS]);
+
+	/**
+	 * Asleep in hundredths of a percent of the time since the reset
+	 */
+	asleep = snapshot.elapsed ? (uint32_t)(snapshot.asleep * 10000 / snapshot.elapsed) : 0;
+	DLOG_AT(DLOG_LEVEL_OFF, "instr: asleep %u.%02u%% of %u ms, %u WAIT, %u VLPW\r\n",
+			(unsigned)(asleep / 100),
+			(unsigned)(asleep % 100),
+			(unsigned)(snapshot.elapsed / (EVENT_COUNT_HZ / 1000)),
+			(unsigned)snapshot.counters[INSTR_COUNT_WAIT],
+			(unsigned)snapshot.counters[INSTR_COUNT_VLPW]);
+
+	/**
+	 * One header, then per handler: runs, maxima and the two histograms
+	 */
+	DLOG_AT(DLOG_LEVEL_OFF, "instr: irq cycles      <32    <64   <128   <256   <512    <1k   more\r\n");
+	for(uint32_t i = 0; i < INSTR_IRQS; i++){
+		const instr_irq_t *h = &snapshot.irqs[i];
+
+		if((h->count == 0) && (h->late == 0)){
+			continue;
+		}
+		DLOG_AT(DLOG_LEVEL_OFF, "instr: %-7s n = %u, late = %u, max latency = %u, max duration = %u cycles\r\n",
+				DLOG_STRING(instr_irq_names[i]),
+				(unsigned)h->count,
+				(unsigned)h->late,
+				(unsigned)h->latency_max,
+				(unsigned)h->duration_max);
+		DLOG_AT(DLOG_LEVEL_OFF, "instr:   latency  %6u %6u %6u %6u %6u %6u %6u\r\n",
+				(unsigned)h->latency[0],
+				(unsigned)h->latency[1],
+				(unsigned)h->latency[2],
+				(unsigned)h->latency[3],
+				(unsigned)h->latency[4],
+				(unsigned)h->latency[5],
+				(unsigned)h->latency[6]);
+		DLOG_AT(DLOG_LEVEL_OFF, "instr:   duration %6u %6u %6u %6u %6u %6u %6u\r\n",
+				(unsigned)h->duration[0],
+				(unsigned)h->duration[1],
+				(unsigned)h->duration[2],
+				(unsigned)h->duration[3],
+				(unsigned)h->duration[4],
+				(unsigned)h->duration[5],
+				(unsigned)h->duration[6]);
+	}
+}
@@ -0,0 +1,429 @@
+/**
+ * \file    instr.h
+ * \author	Dayton Flores (dafl2542@colorado.edu)
+ * \date	10/19/2026
+ * \brief   Macros and function headers for runtime instrumentation
+ * \detail
+ * 		Event counters and cycle timers around the hot paths, kept in RAM and read back
+ * 		at runtime (the console's instr command) to see where the time goes and to
+ * 		compare firmware versions.
+ *
+ * 		The Cortex-M0+ has no DWT cycle counter, so timers read systick_timestamp(),
+ * 		which counts at SYSTICK_TIMESTAMP_HZ in either clock profile: instr_cycles()
+ * 		turns counts into cycles of the core clock in effect (16 per count in RUN, 4/3
+ * 		in VLPR), which is also the resolution of every timer. A timer keeps the number
+ * 		of intervals and their minimum, maximum and total length in cycles.
+ *
+ * 		Each timer and counter must only be updated from one context (the main loop or
+ * 		one ISR). Build with INSTR_ENABLE set to 0 to compile every probe out.
+ *
+ * 		The handlers with deadlines also keep histograms of their latency, from the
+ * 		hardware event to the handler's first instruction, and of their duration. Both
+ * 		are read off the timer behind the event, which counts on the core clock in
+ * 		either clock profile, so they are exact to its prescaler rather than to a
+ * 		SYSTICK_TIMESTAMP_HZ count. Bucket 0 holds everything under
+ * 		INSTR_IRQ_BUCKET_CYCLES, each one after it twice as much, and the last one the
+ * 		rest. The priorities they result from are planned in irq.h.
+ */
+
+#ifndef INSTR_H_
+#define INSTR_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * User-defined libraries
+ */
+#include "systick.h"
+
+/**
+ * \def		INSTR_ENABLE
+ * \brief	1 to keep the probes in the build, 0 to compile them out
+ */
+#ifndef INSTR_ENABLE
+#define INSTR_ENABLE\
+	(1)
+#endif
+
+/**
+ * \def		INSTR_CORE_CLOCK_HZ
+ * \brief	Core clock out of reset (RUN), until instr_retime is told otherwise
+ */
+#define INSTR_CORE_CLOCK_HZ\
+	(48000000UL)
+
+/**
+ * \def		INSTR_SCALE_SHIFT
+ * \brief	Fraction bits of instr_cycle_scale
+ */
+#define INSTR_SCALE_SHIFT\
+	(16)
+
+/**
+ * \typedef	typedef enum instr_timer_id_e instr_timer_id_t
+ * \brief   Easily declare timers
+ */
+typedef enum instr_timer_id_e instr_timer_id_t;
+
+/**
+ * \enum	enum instr_timer_id_e
+ * \brief   What the timers measure
+ */
+enum instr_timer_id_e{
+	INSTR_TIMER_CAPTURE,	/* One polled ADC conversion */
+	INSTR_TIMER_GATE,		/* gate_update on one block or frame */
+	INSTR_TIMER_DETECT,		/* The autocorrelation detector on one block or frame */
+	INSTR_TIMER_FILL_DAC,	/* Refilling dac_buffer for a note change */
+	INSTR_TIMER_REPORT,		/* Formatting and queueing a report */
+	INSTR_TIMER_ADC_ISR,	/* ADC0_IRQHandler */
+	INSTR_TIMER_DMA_ISR,	/* DMA0_IRQHandler */
+	INSTR_TIMER_SLEEP,		/* One idle_wait, measured on TPM2 */
+	INSTR_TIMERS
+};
+
+/**
+ * \typedef	typedef enum instr_counter_id_e instr_counter_id_t
+ * \brief   Easily declare counters
+ */
+typedef enum instr_counter_id_e instr_counter_id_t;
+
+/**
+ * \enum	enum instr_counter_id_e
+ * \brief   What the counters count
+ */
+enum instr_counter_id_e{
+	INSTR_COUNT_LOOPS,		/* Passes of the main loop */
+	INSTR_COUNT_NOTES,		/* Note changes */
+	INSTR_COUNT_FRAMES,		/* Blocks or frames the gate looked at */
+	INSTR_COUNT_GATED,		/* Of those, the ones the detector skipped */
+	INSTR_COUNT_COMMANDS,	/* Console commands run */
+	INSTR_COUNT_WAIT,		/* Entries into WAIT */
+	INSTR_COUNT_VLPW,		/* Entries into VLPW */
+	INSTR_COUNTERS
+};
+
+/**
+ * \def		INSTR_IRQ_BUCKETS
+ * \brief	Buckets in each latency and duration histogram
+ */
+#define INSTR_IRQ_BUCKETS\
+	(7)
+
+/**
+ * \def		INSTR_IRQ_BUCKET_CYCLES
+ * \brief	Upper bound of the first bucket, in core cycles. The Cortex-M0+ takes 16 to
+ * 			enter a handler with no wait states
+ */
+#define INSTR_IRQ_BUCKET_CYCLES\
+	(32)
+
+/**
+ * \typedef	typedef enum instr_irq_id_e instr_irq_id_t
+ * \brief   Easily declare profiled handlers
+ */
+typedef enum instr_irq_id_e instr_irq_id_t;
+
+/**
+ * \enum	enum instr_irq_id_e
+ * \brief   The profiled handlers, and what their latency counts from
+ */
+enum instr_irq_id_e{
+	INSTR_IRQ_DMA0,		/* The TPM0 overflow that moved the last sample to the DAC */
+	INSTR_IRQ_ADC0,		/* The TPM1 overflow that triggered the conversion, which takes most of it */
+	INSTR_IRQ_TPM2,		/* The compare match, or the overflow if there was none */
+	INSTR_IRQ_SYSTICK,	/* SysTick's reload */
+	INSTR_IRQS
+};
+
+/**
+ * \typedef	typedef struct instr_timer_s instr_timer_t
+ * \brief   Statistics of one timer
+ */
+typedef struct instr_timer_s instr_timer_t;
+
+/**
+ * \struct	struct instr_timer_s
+ * \brief   Statistics of one timer, in core cycles
+ */
+struct instr_timer_s{
+	uint32_t count;
+	uint32_t min;
+	uint32_t max;
+	uint64_t total;
+};
+
+/**
+ * \typedef	typedef struct instr_irq_s instr_irq_t
+ * \brief   Histograms of one handler
+ */
+typedef struct instr_irq_s instr_irq_t;
+
+/**
+ * \struct	struct instr_irq_s
+ * \brief   Histograms of one handler, in core cycles
+ */
+struct instr_irq_s{
+	uint32_t count;
+	uint32_t late;		/* Entered too late to measure: DMA0 after TPM0's next overflow */
+	uint32_t latency_max;
+	uint32_t duration_max;
+	uint32_t latency[INSTR_IRQ_BUCKETS];
+	uint32_t duration[INSTR_IRQ_BUCKETS];
+};
+
+/**
+ * \typedef	typedef struct instr_snapshot_s instr_snapshot_t
+ * \brief   Every timer and counter at one point in time
+ */
+typedef struct instr_snapshot_s instr_snapshot_t;
+
+/**
+ * \struct	struct instr_snapshot_s
+ * \brief   Every timer and counter at one point in time
+ */
+struct instr_snapshot_s{
+	uint32_t timestamp;
+	uint64_t elapsed;	/* TPM2 counts since instr_reset, or since boot */
+	uint64_t asleep;	/* TPM2 counts of that in idle_wait */
+	instr_timer_t timers[INSTR_TIMERS];
+	uint32_t counters[INSTR_COUNTERS];
+	instr_irq_t irqs[INSTR_IRQS];
+};
+
+/**
+ * \var		instr_timers
+ * \brief	Defined in instr.c
+ */
+extern volatile instr_timer_t instr_timers[INSTR_TIMERS];
+
+/**
+ * \var		instr_counters
+ * \brief	Defined in instr.c
+ */
+extern volatile uint32_t instr_counters[INSTR_COUNTERS];
+
+/**
+ * \var		instr_irqs
+ * \brief	Defined in instr.c
+ */
+extern volatile instr_irq_t instr_irqs[INSTR_IRQS];
+
+/**
+ * \var		instr_cycle_scale
+ * \brief	Defined in instr.c
+ */
+extern volatile uint32_t instr_cycle_scale;
+
+/**
+ * \var		instr_asleep
+ * \brief	Defined in instr.c
+ */
+extern uint64_t instr_asleep;
+
+#if INSTR_ENABLE
+
+/**
+ * \def		INSTR_START
+ * \brief	Starts an interval: uint32_t t = INSTR_START(); ... INSTR_STOP(timer, t);
+ */
+#define INSTR_START()\
+	(systick_timestamp())
+
+/**
+ * \def		INSTR_STOP
+ * \brief	Ends an interval begun by INSTR_START and adds it to a timer
+ */
+#define INSTR_STOP(timer, start)\
+	(instr_stop((timer), (start)))
+
+/**
+ * \def		INSTR_ADD
+ * \brief	Adds an interval measured some other way, in core cycles, to a timer
+ */
+#define INSTR_ADD(timer, cycles)\
+	(instr_add((timer), (cycles)))
+
+/**
+ * \def		INSTR_COUNT
+ * \brief	Counts one event
+ */
+#define INSTR_COUNT(counter)\
+	(instr_counters[(counter)]++)
+
+/**
+ * \def		INSTR_IRQ_STAMP
+ * \brief	Reads the counter a handler's latency and duration come from. First thing in
+ * 			the handler for the latency, last thing for the duration
+ */
+#define INSTR_IRQ_STAMP(counter)\
+	(counter)
+
+/**
+ * \def		INSTR_IRQ
+ * \brief	Adds one run of a handler, latency and duration in core cycles
+ */
+#define INSTR_IRQ(irq, latency, duration)\
+	(instr_irq((irq), (latency), (duration)))
+
+/**
+ * \def		INSTR_IRQ_LATE
+ * \brief	Counts a run of a handler whose latency can't be told
+ */
+#define INSTR_IRQ_LATE(irq)\
+	(instr_irqs[(irq)].late++)
+
+#else
+
+#define INSTR_START()\
+	(0)
+
+#define INSTR_STOP(timer, start)\
+	((void)(start))
+
+#define INSTR_ADD(timer, cycles)\
+	((void)0)
+
+#define INSTR_COUNT(counter)\
+	((void)0)
+
+#define INSTR_IRQ_STAMP(counter)\
+	(0)
+
+#define INSTR_IRQ(irq, latency, duration)\
+	((void)sizeof((latency) + (duration)))
+
+#define INSTR_IRQ_LATE(irq)\
+	((void)0)
+
+#endif /* INSTR_ENABLE */
+
+/**
+ * \fn		uint32_t instr_cycles
+ * \param	uint32_t counts At SYSTICK_TIMESTAMP_HZ, or EVENT_COUNT_HZ which is the same
+ * \return	counts in cycles of the core clock in effect. An interval a clock switch fell
+ * 			in is taken at the new clock
+ */
+static inline uint32_t instr_cycles(uint32_t counts)
+{
+	return (uint32_t)(((uint64_t)counts * instr_cycle_scale) >> INSTR_SCALE_SHIFT);
+}
+
+/**
+ * \fn		void instr_add
+ * \param	instr_timer_id_t timer
+ * \param	uint32_t cycles
+ * \return	N/A
+ * \brief   Adds an interval to a timer. Use INSTR_ADD instead
+ */
+static inline void instr_add(instr_timer_id_t timer, uint32_t cycles)
+{
+	volatile instr_timer_t *t = &instr_timers[timer];
+
+	if((t->count == 0) || (cycles < t->min)){
+		t->min = cycles;
+	}
+	if(cycles > t->max){
+		t->max = cycles;
+	}
+	t->total += cycles;
+
+	/**
+	 * Last, so instr_snapshot can tell the timer changed while it was copied
+	 */
+	t->count++;
+}
+
+/**
+ * \fn		void instr_stop
+ * \param	instr_timer_id_t timer
+ * \param	uint32_t start From INSTR_START
+ * \return	N/A
+ * \brief   Adds the interval since start to a timer. Use INSTR_STOP instead
+ */
+static inline void instr_stop(instr_timer_id_t timer, uint32_t start)
+{
+	instr_add(timer, instr_cycles(systick_timestamp() - start));
+}
+
+/**
+ * \fn		uint32_t instr_irq_bucket
+ * \param	uint32_t cycles
+ * \return	The histogram bucket cycles falls in. Loops once per doubling above
+ * 			INSTR_IRQ_BUCKET_CYCLES, so not at all for most handler runs
+ */
+static inline uint32_t instr_irq_bucket(uint32_t cycles)
+{
+	uint32_t bucket = 0;
+
+	for(cycles /= INSTR_IRQ_BUCKET_CYCLES; (cycles != 0) && (bucket < INSTR_IRQ_BUCKETS - 1); cycles >>= 1){
+		bucket++;
+	}
+	return bucket;
+}
+
+/**
+ * \fn		void instr_irq
+ * \param	instr_irq_id_t irq
+ * \param	uint32_t latency
+ * \param	uint32_t duration
+ * \return	N/A
+ * \brief   Adds one run of a handler to its histograms. Use INSTR_IRQ instead
+ */
+static inline void instr_irq(instr_irq_id_t irq, uint32_t latency, uint32_t duration)
+{
+	volatile instr_irq_t *h = &instr_irqs[irq];
+
+	h->latency[instr_irq_bucket(latency)]++;
+	h->duration[instr_irq_bucket(duration)]++;
+	if(latency > h->latency_max){
+		h->latency_max = latency;
+	}
+	if(duration > h->duration_max){
+		h->duration_max = duration;
+	}
+
+	/**
+	 * Last, so instr_snapshot can tell the histograms changed while they were copied
+	 */
+	h->count++;
+}
+
+/**
+ * \fn		void instr_reset
+ * \param	N/A
+ * \return	N/A
+ * \brief   Zeroes every timer and counter, and restarts the time the sleep timer is
+ * 			reported against
+ */
+void instr_reset(void);
+
+/**
+ * \fn		void instr_retime
+ * \param	uint32_t core_hz The core clock from now on
+ * \return	N/A
+ * \brief   Makes instr_cycles() count cycles of core_hz. Called by clocks_switch
+ */
+void instr_retime(uint32_t core_hz);
+
+/**
+ * \fn		void instr_snapshot
+ * \param	instr_snapshot_t *snapshot
+ * \return	N/A
+ * \brief   Copies every timer and counter. Each timer is copied whole, even if an ISR
+ * 			updates it meanwhile
+ */
+void instr_snapshot(instr_snapshot_t *snapshot);
+
+/**
+ * \fn		void instr_report
+ * \param	N/A
+ * \return	N/A
+ * \brief   Takes a snapshot and sends it as DLOG records (text with DLOG_DEFERRED set to
+ * 			0): one per timer that ran, with count, min, average and max cycles, one with
+ * 			the counters, one with the share of the time spent asleep and three per
+ * 			profiled handler that ran, with its histograms. Sent whatever dlog_level is
+ */
+void instr_report(void);
+
+#endif /* INSTR_H_ */
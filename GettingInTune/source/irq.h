@@ -0,0 +1,102 @@
+/**
+ * \file    irq.h
+ * \author	Dayton Flores (dafl2542@colorado.edu)
+ * \date	10/19/2026
+ * \brief   The interrupt priority plan
+ * \detail
+ * 		Every NVIC_SetPriority in the firmware takes its level from here, so the
+ * 		priorities can be weighed against each other in one place. The Cortex-M0+ has
+ * 		IRQ_PRIORITY_LEVELS levels, 0 the most urgent; NVIC_SetPriority keeps only the
+ * 		low bits of what it is given, so 128 or 192 (what the levels look like in the
+ * 		IPR registers) silently become 0. A handler preempts only handlers of a less
+ * 		urgent level, so a handler's worst latency is the longest one above it or at its
+ * 		own level, plus the longest critical section.
+ *
+ * 		The plan follows the deadlines, shortest first:
+ * 			- 0: DMA0 (the DAC buffer restart, before TPM0's next request, 1 /
+ * 			  SAMPLE_RATE_DAC_HZ away) and ADC0 (a scan conversion, filed before the
+ * 			  next trigger, 1 / SAMPLE_RATE_ADC_HZ away). Both handlers are short
+ * 			- 1: TPM2, whose overflows have to be counted before the next one, ~22 ms
+ * 			  later at TPM_CLOCK_HZ
+ * 			- 2: DMA2, the stream export's frames. Above the console, so a frame hands
+ * 			  the transmitter back promptly
+ * 			- 3: SysTick, which systick_timestamp() copes with being late for, TPM1,
+ * 			  whose overflow interrupt is unused (it triggers the ADC), and UART0, which
+ * 			  the debug console sets to DEBUG_CONSOLE_IRQ_PRIORITY
+ *
+ * 		Each level can be overridden with -D to try another plan; the console's instr
+ * 		command shows the latencies that result (instr.h).
+ */
+
+#ifndef IRQ_H_
+#define IRQ_H_
+
+/**
+ * \def		IRQ_PRIORITY_LEVELS
+ * \brief	Priority levels on the Cortex-M0+: 2 bits, __NVIC_PRIO_BITS
+ */
+#define IRQ_PRIORITY_LEVELS\
+	(4)
+
+/**
+ * \def		IRQ_PRIORITY_DMA0
+ * \brief	DMA0_IRQHandler restarts the DAC buffer, see dma.c
+ */
+#ifndef IRQ_PRIORITY_DMA0
+#define IRQ_PRIORITY_DMA0\
+	(0)
+#endif
+
+/**
+ * \def		IRQ_PRIORITY_ADC0
+ * \brief	ADC0_IRQHandler files a scan conversion, see adc.c
+ */
+#ifndef IRQ_PRIORITY_ADC0
+#define IRQ_PRIORITY_ADC0\
+	(0)
+#endif
+
+/**
+ * \def		IRQ_PRIORITY_TPM2
+ * \brief	TPM2_IRQHandler counts the event scheduler's overflows, see event.c
+ */
+#ifndef IRQ_PRIORITY_TPM2
+#define IRQ_PRIORITY_TPM2\
+	(1)
+#endif
+
+/**
+ * \def		IRQ_PRIORITY_DMA2
+ * \brief	DMA2_IRQHandler ends a stream frame, see stream.c
+ */
+#ifndef IRQ_PRIORITY_DMA2
+#define IRQ_PRIORITY_DMA2\
+	(2)
+#endif
+
+/**
+ * \def		IRQ_PRIORITY_TPM1
+ * \brief	TPM1_IRQHandler, see tpm.c
+ */
+#ifndef IRQ_PRIORITY_TPM1
+#define IRQ_PRIORITY_TPM1\
+	(3)
+#endif
+
+/**
+ * \def		IRQ_PRIORITY_SYSTICK
+ * \brief	SysTick_Handler counts SysTick's wraps, see systick.c
+ */
+#ifndef IRQ_PRIORITY_SYSTICK
+#define IRQ_PRIORITY_SYSTICK\
+	(3)
+#endif
+
+_Static_assert(IRQ_PRIORITY_DMA0 < IRQ_PRIORITY_LEVELS, "IRQ_PRIORITY_DMA0 is out of range");
+_Static_assert(IRQ_PRIORITY_ADC0 < IRQ_PRIORITY_LEVELS, "IRQ_PRIORITY_ADC0 is out of range");
+_Static_assert(IRQ_PRIORITY_TPM2 < IRQ_PRIORITY_LEVELS, "IRQ_PRIORITY_TPM2 is out of range");
+_Static_assert(IRQ_PRIORITY_DMA2 < IRQ_PRIORITY_LEVELS, "IRQ_PRIORITY_DMA2 is out of range");
+_Static_assert(IRQ_PRIORITY_TPM1 < IRQ_PRIORITY_LEVELS, "IRQ_PRIORITY_TPM1 is out of range");
+_Static_assert(IRQ_PRIORITY_SYSTICK < IRQ_PRIORITY_LEVELS, "IRQ_PRIORITY_SYSTICK is out of range");
+
+#endif /* IRQ_H_ */
@@ -41,11 +41,25 @@
 #include "fsl_debug_console.h"
 /* TODO: insert other include files here. */
 #include "adc.h"
+#include "arena.h"
 #include "autocorrelate.h"
+#include "bench.h"
+#include "boot.h"
+#include "clocks.h"
+#include "command.h"
 #include "dac.h"
+#include "dlog.h"
 #include "dma.h"
+#include "event.h"
 #include "fp_trig.h"
+#include "gate.h"
+#include "instr.h"
+#include "pipeline.h"
+#include "ram.h"
+#include "store.h"
+#include "stream.h"
 #include "systick.h"
+#include "task.h"
 #include "test_sine.h"
 #include "tone.h"
 #include "tpm.h"
@@ -64,9 +78,22 @@ tone_t current_tone = A4;
  */
 int main(void) {
 
+    /**
+     * Start SysTick, unless ResetISR already has, and note how long startup took
+     */
+    init_onboard_systick();
+    boot_mark(BOOT_MARK_MAIN);
+
+    /**
+     * Paint the stack, unless ResetISR already has, so the console's mem command can
+     * tell how deep it has been
+     */
+    ram_paint_stack();
+
     /* Init board hardware. */
     BOARD_InitBootPins();
     BOARD_InitBootClocks();
+    boot_mark(BOOT_MARK_CLOCKS);
     BOARD_InitBootPeripherals();
 #ifndef BOARD_INIT_DEBUG_CONSOLE_PERIPHERAL
     /* Init FSL debug console. */
@@ -74,10 +101,18 @@ int main(void) {
 #endif
 
     /**
-     * Test sin function generated from given fp_trig.o
+     * Allow VLPR, for the clock policy and the console's clock command
+     */
+    init_clocks();
+
+#ifdef TEST_SIN
+    /**
+     * Test sin function generated from given fp_trig.o. Takes a while against libm's
+     * sin, so only in builds that ask for it
      */
     test_sin();
-    printf("\n");
+    PRINTF("\n");
+#endif
 
     /**
      * Pre-compute samples for all tones
@@ -85,8 +120,10 @@ int main(void) {
     tone_to_samples();
 
     /**
-     * Stuff DAC buffer with initial tone's samples until DAC buffer is full
+     * Borrow the DAC buffer from the sample arena for good, then stuff it with initial
+     * tone's samples until DAC buffer is full
      */
+    dac_buffer = arena_borrow(ARENA_OWNER_DAC, DAC_BUF_SIZE);
     fill_dac_buffer(current_tone);
 
     /**
@@ -99,6 +136,35 @@ int main(void) {
      */
     init_onboard_adc();
 
+    /**
+     * Restore the settings the console's save command kept. Anything never saved, or
+     * out of range, keeps its default
+     */
+    if(init_store()){
+    	uint32_t min_lag;
+    	uint32_t max_lag;
+    	uint32_t gate_open;
+    	uint32_t gate_close;
+    	uint32_t profile = store_get(STORE_KEY_ADC_PROFILE, ADC_PROFILE_LOW_POWER);
+    	uint32_t level = store_get(STORE_KEY_LOG_LEVEL, dlog_level);
+
+    	autocorrelate_get_lag_bounds(&min_lag, &max_lag);
+    	min_lag = store_get(STORE_KEY_LAG_MIN, min_lag);
+    	max_lag = store_get(STORE_KEY_LAG_MAX, max_lag);
+    	if(min_lag <= max_lag){
+    		autocorrelate_set_lag_bounds(min_lag, max_lag);
+    	}
+    	if(profile <= ADC_PROFILE_AVERAGE4){
+    		adc_set_profile((adc_profile_t)profile);
+    	}
+    	if(level <= DLOG_LEVEL_DEBUG){
+    		dlog_level = level;
+    	}
+    	gate_get_energy(&gate_open, &gate_close);
+    	gate_set_energy(store_get(STORE_KEY_GATE_OPEN, gate_open),
+    			store_get(STORE_KEY_GATE_CLOSE, gate_close));
+    }
+
     /**
      * Initialize on-board DMA
      */
@@ -107,21 +173,28 @@ int main(void) {
     /**
      * Initialize on-board TPM for use with DMA
      */
-    init_onboard_tpm(SAMPLE_PERIOD_DAC_US, SAMPLE_PERIOD_ADC_US);
+    init_onboard_tpm(SAMPLE_RATE_DAC_HZ, SAMPLE_RATE_ADC_HZ);
 
     /**
-     * Initialize SysTick on-board timer
+     * Start the free-running TPM2 the event scheduler keeps time with
      */
-    init_onboard_systick();
+    init_event_scheduler();
+
+    /**
+     * Add the tasks the tuner's stages run in
+     */
+    init_pipeline();
 
     /**
      * Print info about current tone
      */
-    printf("Generated %d samples at %d Hz. Computed period = %d samples\r\n",
+    PRINTF("Generated %d samples at %d Hz. Computed period = %d samples\r\n",
     		dac_buffer_full_periods * dac_buffer_samples_per_period,
 			dac_buffer_hz,
 			dac_buffer_samples_per_period);
 
+    boot_mark(BOOT_MARK_INIT);
+
     /**
      * Begin TPM counter
      */
@@ -131,135 +204,46 @@ int main(void) {
      * Begin DMA transfer
      */
     start_onboard_dma((uint16_t*)dac_buffer, dac_buffer_samples << 1);
+    boot_mark(BOOT_MARK_DAC);
 
+#ifdef BENCH_LOOPBACK
     /**
-     * Begin reading samples from ADC
+     * Measure note change to detected pitch over the DAC to ADC loopback
      */
-    int32_t adc_min = 0;
-    int32_t adc_max = 0;
-    int32_t adc_avg = 0;
+    bench_loopback_run(current_tone);
+#endif
+
+    /**
+     * Measure the first note and step through the notes from here on
+     */
+    pipeline_start();
 
     /**
      * Main infinite loop
      */
     while(1) {
 
+    	INSTR_COUNT(INSTR_COUNT_LOOPS);
+
     	/**
-    	 * If we still have samples to read
+    	 * Run whatever commands have come in on the console, whatever events are due,
+    	 * then one event of the highest-priority task that has one
     	 */
-    	if(!adc_done){
-
-        	/**
-        	 * Reset ADC buffer index and print since 1024 samples were taken
-        	 */
-        	if(adc_buffer_i >= ADC_BUF_SIZE){
-        		adc_done = true;
-        		adc_buffer_i = 0;
-        	    printf("min = %d, max = %d, avg = %d, period = %d samples, frequency = %d Hz\r\n\n",
-        	    		adc_min,
-						adc_max,
-						(adc_avg >> 10),
-						((autocorrelate_detect_period(adc_buffer, ADC_BUF_SIZE, kAC_16bps_unsigned)) >> 1),
-						(SAMPLE_RATE_ADC_HZ / autocorrelate_detect_period(adc_buffer, ADC_BUF_SIZE, kAC_16bps_unsigned)) << 1);
-        	    adc_min = 0;
-        	    adc_max = 0;
-        	    adc_avg = 0;
-        	}
-
-            /**
-             * Begin reading a sample from ADC
-             */
-            ADC0->SC1[0] = ADC_SC1_ADCH(SC1_ADCH);
-        	while(!(ADC0->SC1[0] & ADC_SC1_COCO(1)));
-        	adc_buffer[adc_buffer_i] = ((int16_t)(ADC0->R[0]));
-        	adc_avg += adc_buffer[adc_buffer_i];
-        	if(adc_buffer[adc_buffer_i] < adc_min){
-        		adc_min = adc_buffer[adc_buffer_i];
-        	}
-        	if(adc_buffer[adc_buffer_i] > adc_max){
-        		adc_max = adc_buffer[adc_buffer_i];
-        	}
-        	adc_buffer_i++;
-    	}
-
-        /**
-         * Set by SysTick_Handler every TICK_SEC
-         */
-        if(tick){
-
-            /**
-             * Reset flag that was set by SysTick ISR
-             */
-        	tick = false;
-
-            /**
-             * Increment for timestamp purposes
-             */
-        	ticks_since_startup++;
-        	//printf("Sec since startup = %f\r\n", ticks_since_startup * TICK_SEC);
-
-            /**
-             * Increment for note timing purposes
-             */
-        	ticks_since_last_note++;
-    		//printf("Sec since last note = %f\r\n", ticks_since_last_note * TICK_SEC);
-
-        	/**
-        	 * Check if a full second has passed since current note started
-        	 */
-        	if(!(ticks_since_last_note & (TICK_HZ - 1))){
-
-                /**
-                 * Reset for note timing purposes
-                 */
-        		ticks_since_last_note = 0;
-
-        		/**
-        		 * Change note
-        		 */
-        		switch(current_tone){
-        		case A4:
-        			current_tone = D5;
-        			break;
-        		case D5:
-        			current_tone = E5;
-        			break;
-        		case E5:
-        			current_tone = A5;
-        			break;
-        		case A5:
-        			current_tone = A4;
-        			break;
-        		default:
-        			break;
-        		}
-
-        	    /**
-        	     * Stuff DAC buffer with tone's samples until DAC buffer is full
-        	     */
-        	    fill_dac_buffer(current_tone);
-
-        	    /**
-        	     * Print info about current tone
-        	     */
-        	    printf("Generated %d samples at %d Hz. Computed period = %d samples\r\n",
-        	    		dac_buffer_samples,
-						dac_buffer_hz,
-						dac_buffer_samples_per_period);
-
-        	    /**
-        	     * Begin DMA transfer
-        	     */
-        	    start_onboard_dma((uint16_t*)dac_buffer, dac_buffer_samples << 1);
-
-        	    /**
-        	     * Begin ADC sampling for the new current tone
-        	     */
-        		adc_done = false;
-        	}
-        }
+    	command_poll();
+    	event_run();
+    	task_run();
 
+#ifdef STREAM_EXPORT
+    	/**
+    	 * Frames held back for console output go out once it has
+    	 */
+    	stream_service();
+#endif
 
+    	/**
+    	 * Conversions, console input and events all come in by interrupt
+    	 */
+    	task_sleep();
     }
     return 0 ;
 }
@@ -0,0 +1,66 @@
+/**
+ * \file    note.c
+ * \author	Dayton Flores (dafl2542@colorado.edu)
+ * \date	10/19/2026
+ * \brief   Function definitions for the note table
+ */
+
+#include <ctype.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * User-defined libraries
+ */
+#include "note.h"
+
+const note_t *note_from_midi(uint32_t midi)
+{
+	if((midi < NOTE_MIDI_FIRST) || (midi > NOTE_MIDI_LAST)){
+		return NULL;
+	}
+	return &note_table[midi - NOTE_MIDI_FIRST];
+}
+
+const note_t *note_from_name(const char *name)
+{
+	for(uint32_t i = 0; i < NOTE_COUNT; i++){
+		const char *a = name;
+		const char *b = note_table[i].name;
+
+		while(*a && (toupper((unsigned char)*a) == *b)){
+			a++;
+			b++;
+		}
+		if(!*a && !*b){
+			return &note_table[i];
+		}
+	}
+	return NULL;
+}
+
+const note_t *note_nearest(uint32_t hz_q16)
+{
+	uint32_t lo = 0;
+	uint32_t hi = NOTE_COUNT - 1;
+
+	if((hz_q16 < note_table[0].low_q16) || (hz_q16 >= note_table[NOTE_COUNT - 1].high_q16)){
+		return NULL;
+	}
+
+	/**
+	 * The bands are contiguous and in order, so find the last one starting at or
+	 * below hz_q16
+	 */
+	while(lo < hi){
+		uint32_t mid = (lo + hi + 1) / 2;
+
+		if(note_table[mid].low_q16 <= hz_q16){
+			lo = mid;
+		}
+		else{
+			hi = mid - 1;
+		}
+	}
+	return &note_table[lo];
+}
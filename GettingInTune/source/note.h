@@ -0,0 +1,121 @@
+/**
+ * \file    note.h
+ * \author	Dayton Flores (dafl2542@colorado.edu)
+ * \date	10/19/2026
+ * \brief   Macros and function headers for the note table
+ * \detail
+ * 		Every key of an 88-key piano, A0 (MIDI 21) to C8 (MIDI 108), in equal temperament
+ * 		from A4 = NOTE_A4_HZ. The table is const, so it stays in flash, and is generated:
+ * 		host/note_gen.c writes note_table.c from this header, SAMPLE_RATE_DAC_HZ and
+ * 		SAMPLE_RATE_ADC_HZ, and the host build regenerates it whenever one of them
+ * 		changes. Don't edit note_table.c by hand.
+ *
+ * 		Each note has, precomputed:
+ * 			- Its frequency, Q16 Hz
+ * 			- The phase step per DAC sample of a 32-bit phase accumulator (DDS), which
+ * 			  wraps once per period of the note
+ * 			- Its period at SAMPLE_RATE_ADC_HZ, Q8 samples, which is what the detector
+ * 			  should find. In ADC_SCAN builds each channel is sampled at
+ * 			  SAMPLE_RATE_ADC_HZ / adc_scan_count, so divide by the channel count
+ * 			- The band of frequencies nearer to it than to its neighbours, halfway
+ * 			  between them in pitch
+ */
+
+#ifndef NOTE_H_
+#define NOTE_H_
+
+#include <stdint.h>
+
+/**
+ * \def		NOTE_MIDI_FIRST
+ * \brief	MIDI number of the lowest note in the table, A0
+ */
+#define NOTE_MIDI_FIRST\
+	(21)
+
+/**
+ * \def		NOTE_MIDI_LAST
+ * \brief	MIDI number of the highest note in the table, C8
+ */
+#define NOTE_MIDI_LAST\
+	(108)
+
+/**
+ * \def		NOTE_COUNT
+ * \brief	Notes in the table
+ */
+#define NOTE_COUNT\
+	(NOTE_MIDI_LAST - NOTE_MIDI_FIRST + 1)
+
+/**
+ * \def		NOTE_MIDI_A4
+ * \brief	MIDI number of the reference pitch
+ */
+#define NOTE_MIDI_A4\
+	(69)
+
+/**
+ * \def		NOTE_A4_HZ
+ * \brief	Frequency of the reference pitch in Hz
+ */
+#define NOTE_A4_HZ\
+	(440)
+
+/**
+ * \def		NOTE_Q16
+ * \brief	Converts whole Hz to the table's Q16 Hz
+ */
+#define NOTE_Q16(hz)\
+	((uint32_t)(hz) << 16)
+
+/**
+ * \typedef	typedef struct note_s note_t
+ * \brief   Easily declare notes
+ */
+typedef struct note_s note_t;
+
+/**
+ * \struct	struct note_s
+ * \brief   One key, see the file comment
+ */
+struct note_s{
+	uint32_t hz_q16;			/* Frequency, Q16 Hz */
+	uint32_t low_q16;			/* Nearest to this note from here... */
+	uint32_t high_q16;			/* ...up to, not including, here */
+	uint32_t dac_step;			/* Phase step per DAC sample, 2^32 per period */
+	uint32_t adc_period_q8;		/* Period at SAMPLE_RATE_ADC_HZ, Q8 samples */
+	uint8_t midi;
+	char name[4];				/* "A0", "C#4"... */
+};
+
+/**
+ * \var		note_table
+ * \brief	Defined in note_table.c, in MIDI order
+ */
+extern const note_t note_table[NOTE_COUNT];
+
+/**
+ * \fn		const note_t *note_from_midi
+ * \param	uint32_t midi
+ * \return	The note, or NULL if midi isn't a piano key
+ */
+const note_t *note_from_midi(uint32_t midi);
+
+/**
+ * \fn		const note_t *note_from_name
+ * \param	const char *name Like "A4" or "C#3", either case
+ * \return	The note, or NULL if there is none by that name
+ * \brief   For the console. Goes through the table, so keep it out of loops
+ */
+const note_t *note_from_name(const char *name);
+
+/**
+ * \fn		const note_t *note_nearest
+ * \param	uint32_t hz_q16
+ * \return	The note nearest hz_q16 in pitch, or NULL if it is more than half a semitone
+ * 			beyond either end of the piano
+ * \brief   A binary search of the notes' bands, so at most 7 steps
+ */
+const note_t *note_nearest(uint32_t hz_q16);
+
+#endif /* NOTE_H_ */
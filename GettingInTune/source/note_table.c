@@ -0,0 +1,106 @@
+/**
+ * \file    note_table.c
+ * \author	Dayton Flores (dafl2542@colorado.edu)
+ * \date	10/19/2026
+ * \brief   The note table, see note.h. Generated by host/note_gen.c for
+ * 			A4 = 440 Hz, a 48000 Hz DAC and a 96000 Hz ADC: don't edit
+ */
+
+#include <stdint.h>
+
+/**
+ * User-defined libraries
+ */
+#include "note.h"
+
+const note_t note_table[NOTE_COUNT] = {
+	/*     hz_q16      low_q16     high_q16     dac_step   adc_per_q8  midi  name   */
+	{    1802240u,    1750934u,    1855050u,    2460658u,     893673u,   21, "A0"   },
+	{    1909407u,    1855050u,    1965357u,    2606977u,     843515u,   22, "A#0"  },
+	{    2022946u,    1965357u,    2082223u,    2761996u,     796172u,   23, "B0"   },
+	{    2143237u,    2082223u,    2206038u,    2926232u,     751486u,   24, "C1"   },
+	{    2270680u,    2206038u,    2337216u,    3100235u,     709309u,   25, "C#1"  },
+	{    2405702u,    2337216u,    2476194u,    3284585u,     669498u,   26, "D1"   },
+	{    2548752u,    2476194u,    2623436u,    3479896u,     631922u,   27, "D#1"  },
+	{    2700309u,    2623436u,    2779434u,    3686822u,     596455u,   28, "E1"   },
+	{    2860878u,    2779434u,    2944708u,    3906052u,     562979u,   29, "F1"   },
+	{    3030994u,    2944708u,    3119809u,    4138318u,     531381u,   30, "F#1"  },
+	{    3211227u,    3119809u,    3305323u,    4384395u,     501557u,   31, "G1"   },
+	{    3402176u,    3305323u,    3501867u,    4645104u,     473407u,   32, "G#1"  },
+	{    3604480u,    3501867u,    3710099u,    4921317u,     446836u,   33, "A1"   },
+	{    3818814u,    3710099u,    3930713u,    5213953u,     421757u,   34, "A#1"  },
+	{    4045892u,    3930713u,    4164446u,    5523991u,     398086u,   35, "B1"   },
+	{    4286473u,    4164446u,    4412077u,    5852465u,     375743u,   36, "C2"   },
+	{    4541360u,    4412077u,    4674432u,    6200470u,     354654u,   37, "C#2"  },
+	{    4811404u,    4674432u,    4952388u,    6569170u,     334749u,   38, "D2"   },
+	{    5097505u,    4952388u,    5246873u,    6959793u,     315961u,   39, "D#2"  },
+	{    5400618u,    5246873u,    5558868u,    7373644u,     298227u,   40, "E2"   },
+	{    5721755u,    5558868u,    5889416u,    7812103u,     281489u,   41, "F2"   },
+	{    6061989u,    5889416u,    6239618u,    8276635u,     265690u,   42, "F#2"  },
+	{    6422453u,    6239618u,    6610645u,    8768789u,     250778u,   43, "G2"   },
+	{    6804352u,    6610645u,    7003735u,    9290209u,     236703u,   44, "G#2"  },
+	{    7208960u,    7003735u,    7420199u,    9842633u,     223418u,   45, "A2"   },
+	{    7637627u,    7420199u,    7861427u,   10427907u,     210879u,   46, "A#2"  },
+	{    8091784u,    7861427u,    8328891u,   11047982u,     199043u,   47, "B2"   },
+	{    8572947u,    8328891u,    8824153u,   11704930u,     187872u,   48, "C3"   },
+	{    9082720u,    8824153u,    9348864u,   12400941u,     177327u,   49, "C#3"  },
+	{    9622807u,    9348864u,    9904777u,   13138339u,     167375u,   50, "D3"   },
+	{   10195009u,    9904777u,   10493746u,   13919586u,     157981u,   51, "D#3"  },
+	{   10801236u,   10493746u,   11117736u,   14747287u,     149114u,   52, "E3"   },
+	{   11443511u,   11117736u,   11778831u,   15624207u,     140745u,   53, "F3"   },
+	{   12123977u,   11778831u,   12479237u,   16553270u,     132845u,   54, "F#3"  },
+	{   12844906u,   12479237u,   13221291u,   17537579u,     125389u,   55, "G3"   },
+	{   13608704u,   13221291u,   14007470u,   18580418u,     118352u,   56, "G#3"  },
+	{   14417920u,   14007470u,   14840397u,   19685267u,     111709u,   57, "A3"   },
+	{   15275254u,   14840397u,   15722853u,   20855814u,     105439u,   58, "A#3"  },
+	{   16183568u,   15722853u,   16657783u,   22095965u,      99521u,   59, "B3"   },
+	{   17145893u,   16657783u,   17648306u,   23409859u,      93936u,   60, "C4"   },
+	{   18165441u,   17648306u,   18697729u,   24801882u,      88664u,   61, "C#4"  },
+	{   19245614u,   18697729u,   19809554u,   26276679u,      83687u,   62, "D4"   },
+	{   20390018u,   19809554u,   20987491u,   27839171u,      78990u,   63, "D#4"  },
+	{   21602472u,   20987491u,   22235472u,   29494575u,      74557u,   64, "E4"   },
+	{   22887021u,   22235472u,   23557662u,   31248413u,      70372u,   65, "F4"   },
+	{   24247954u,   23557662u,   24958474u,   33106541u,      66423u,   66, "F#4"  },
+	{   25689813u,   24958474u,   26442582u,   35075158u,      62695u,   67, "G4"   },
+	{   27217409u,   26442582u,   28014940u,   37160835u,      59176u,   68, "G#4"  },
+	{   28835840u,   28014940u,   29680795u,   39370534u,      55855u,   69, "A4"   },
+	{   30550508u,   29680795u,   31445706u,   41711627u,      52720u,   70, "A#4"  },
+	{   32367136u,   31445706u,   33315566u,   44191930u,      49761u,   71, "B4"   },
+	{   34291786u,   33315566u,   35296612u,   46819719u,      46968u,   72, "C5"   },
+	{   36330882u,   35296612u,   37395458u,   49603764u,      44332u,   73, "C#5"  },
+	{   38491228u,   37395458u,   39619108u,   52553357u,      41844u,   74, "D5"   },
+	{   40780036u,   39619108u,   41974982u,   55678342u,      39495u,   75, "D#5"  },
+	{   43204943u,   41974982u,   44470945u,   58989149u,      37278u,   76, "E5"   },
+	{   45774043u,   44470945u,   47115325u,   62496826u,      35186u,   77, "F5"   },
+	{   48495909u,   47115325u,   49916948u,   66213081u,      33211u,   78, "F#5"  },
+	{   51379626u,   49916948u,   52885164u,   70150316u,      31347u,   79, "G5"   },
+	{   54434817u,   52885164u,   56029879u,   74321671u,      29588u,   80, "G#5"  },
+	{   57671680u,   56029879u,   59361589u,   78741067u,      27927u,   81, "A5"   },
+	{   61101017u,   59361589u,   62891413u,   83423255u,      26360u,   82, "A#5"  },
+	{   64734272u,   62891413u,   66631131u,   88383859u,      24880u,   83, "B5"   },
+	{   68583572u,   66631131u,   70593224u,   93639437u,      23484u,   84, "C6"   },
+	{   72661764u,   70593224u,   74790916u,   99207528u,      22166u,   85, "C#6"  },
+	{   76982457u,   74790916u,   79238215u,  105106715u,      20922u,   86, "D6"   },
+	{   81560072u,   79238215u,   83949965u,  111356685u,      19748u,   87, "D#6"  },
+	{   86409886u,   83949965u,   88941889u,  117978298u,      18639u,   88, "E6"   },
+	{   91548086u,   88941889u,   94230649u,  124993653u,      17593u,   89, "F6"   },
+	{   96991818u,   94230649u,   99833895u,  132426162u,      16606u,   90, "F#6"  },
+	{  102759252u,   99833895u,  105770327u,  140300631u,      15674u,   91, "G6"   },
+	{  108869635u,  105770327u,  112059758u,  148643341u,      14794u,   92, "G#6"  },
+	{  115343360u,  112059758u,  118723178u,  157482134u,      13964u,   93, "A6"   },
+	{  122202033u,  118723178u,  125782826u,  166846509u,      13180u,   94, "A#6"  },
+	{  129468544u,  125782826u,  133262262u,  176767719u,      12440u,   95, "B6"   },
+	{  137167144u,  133262262u,  141186449u,  187278874u,      11742u,   96, "C7"   },
+	{  145323527u,  141186449u,  149581832u,  198415056u,      11083u,   97, "C#7"  },
+	{  153964914u,  149581832u,  158476430u,  210213429u,      10461u,   98, "D7"   },
+	{  163120144u,  158476430u,  167899929u,  222713370u,       9874u,   99, "D#7"  },
+	{  172819773u,  167899929u,  177883778u,  235956596u,       9320u,  100, "E7"   },
+	{  183096171u,  177883778u,  188461298u,  249987305u,       8797u,  101, "F7"   },
+	{  193983636u,  188461298u,  199667790u,  264852324u,       8303u,  102, "F#7"  },
+	{  205518503u,  199667790u,  211540655u,  280601263u,       7837u,  103, "G7"   },
+	{  217739269u,  211540655u,  224119517u,  297286682u,       7397u,  104, "G#7"  },
+	{  230686720u,  224119517u,  237446357u,  314964268u,       6982u,  105, "A7"   },
+	{  244404066u,  237446357u,  251565652u,  333693018u,       6590u,  106, "A#7"  },
+	{  258937088u,  251565652u,  266524524u,  353535438u,       6220u,  107, "B7"   },
+	{  274334289u,  266524524u,  282372897u,  374557749u,       5871u,  108, "C8"   },
+};
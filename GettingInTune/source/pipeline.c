@@ -0,0 +1,605 @@
+/**
+ * \file    pipeline.c
+ * \author	Dayton Flores (dafl2542@colorado.edu)
+ * \date	10/19/2026
+ * \brief   Function definitions for the tuner's tasks
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "board.h"
+#include "fsl_debug_console.h"
+
+/**
+ * User-defined libraries
+ */
+#include "adc.h"
+#include "arena.h"
+#include "autocorrelate.h"
+#include "boot.h"
+#include "cents.h"
+#include "clocks.h"
+#include "dlog.h"
+#include "dma.h"
+#include "event.h"
+#include "frame.h"
+#include "gate.h"
+#include "instr.h"
+#include "pipeline.h"
+#include "stream.h"
+#include "task.h"
+#include "tone.h"
+#include "tpm.h"
+
+/**
+ * \def		PRIORITY_REFILL
+ * \brief	Task priorities, 0 is the highest. A note change is a few ms of work once a
+ * 			second and shouldn't wait behind the detector
+ */
+#define PRIORITY_REFILL\
+	(0)
+#define PRIORITY_SEQUENCER\
+	(1)
+#define PRIORITY_DETECT\
+	(2)
+#define PRIORITY_REPORT\
+	(3)
+#define PRIORITY_CAPTURE\
+	(4)
+
+/**
+ * \typedef	typedef enum pipeline_signal_e pipeline_signal_t
+ * \brief   Easily declare the signals the tasks exchange
+ */
+typedef enum pipeline_signal_e pipeline_signal_t;
+
+/**
+ * \enum	enum pipeline_signal_e
+ * \brief   The signals the tasks exchange
+ */
+enum pipeline_signal_e{
+	PIPELINE_TICK,		/* sequencer: note_event came up */
+	PIPELINE_TONE,		/* refill: fill dac_buffer with current_tone, then play it */
+	PIPELINE_PLAY,		/* refill: play dac_buffer as it is */
+	PIPELINE_PLAYED,	/* refill: DMA0_IRQHandler, the DAC played dac_buffer through */
+	PIPELINE_CONTINUE,	/* capture: convert the next chunk of the block */
+	PIPELINE_BLOCK,		/* detect: adc_buffer holds a full block */
+	PIPELINE_FRAME,		/* detect: channel param has samples for more frames */
+	PIPELINE_RESULT		/* report: the period found (polled), or the channel done (ADC_SCAN) */
+};
+
+/**
+ * \var		note_event
+ * \brief	Ticks the sequencer every NOTE_PERIOD_US
+ */
+static event_t note_event;
+
+/**
+ * \var		refill_settling
+ * \brief	Set from a new note until the DAC has played all of dac_buffer once
+ */
+static bool refill_settling = false;
+
+/**
+ * \var		refill_task
+ * \brief	The tasks, see pipeline.h
+ */
+static task_t refill_task;
+static task_t sequencer_task;
+static task_t detect_task;
+static task_t report_task;
+#ifndef ADC_SCAN
+static task_t capture_task;
+#endif
+
+#ifdef ADC_SCAN
+/**
+ * \def		FRAMES_PER_NOTE
+ * \brief	Overlapping frames averaged into each channel's pitch estimate per note
+ */
+#define FRAMES_PER_NOTE\
+	(8)
+
+/**
+ * \var		adc_scan_list
+ * \brief	Inputs monitored in scan mode: the DAC loopback and PTE20
+ */
+static const uint8_t adc_scan_list[] = { SC1_ADCH, SC1_ADCH_PTE20 };
+
+/**
+ * \var		adc_scan_done
+ * \brief	Channels detect has finished with for this note
+ */
+static uint32_t adc_scan_done = 0;
+
+/**
+ * \var		adc_scan_reported
+ * \brief	Of those, the channels report has printed
+ */
+static uint32_t adc_scan_reported = 0;
+
+/**
+ * Per-channel results for the note, from detect to report
+ */
+static uint32_t frames[ADC_SCAN_MAX_CHANNELS] = { 0 };
+static uint32_t periods[ADC_SCAN_MAX_CHANNELS] = { 0 };
+static int32_t period_sum[ADC_SCAN_MAX_CHANNELS] = { 0 };
+static uint32_t gated[ADC_SCAN_MAX_CHANNELS] = { 0 };
+#else
+/**
+ * \def		CAPTURE_CHUNK
+ * \brief	Polled conversions per capture event, about 0.7 ms at SAMPLE_RATE_ADC_HZ
+ */
+#define CAPTURE_CHUNK\
+	(64)
+
+/**
+ * \var		capture_busy
+ * \brief	Set while a PIPELINE_CONTINUE is queued for capture
+ */
+static bool capture_busy = false;
+
+/**
+ * Statistics of the block being captured, from capture to report
+ */
+static int32_t adc_min = 0;
+static int32_t adc_max = 0;
+static int32_t adc_avg = 0;
+#endif
+
+#ifdef STREAM_EXPORT
+/**
+ * \def		DAC_BITS
+ * \brief	Significant bits of the DAC samples
+ */
+#define DAC_BITS\
+	(12)
+
+/**
+ * \def		ADC_BITS
+ * \brief	Significant bits of the ADC samples
+ */
+#define ADC_BITS\
+	(16)
+
+/**
+ * \var		dac_stream_index
+ * \brief	Index of the next DAC sample to stream
+ */
+static uint32_t dac_stream_index = 0;
+
+#ifndef ADC_SCAN
+/**
+ * \var		adc_stream_index
+ * \brief	Index of the next ADC sample to stream
+ */
+static uint32_t adc_stream_index = 0;
+#endif
+#endif
+
+/**
+ * \fn		void pipeline_measure
+ * \param	N/A
+ * \return	N/A
+ * \brief   Measures the note playing now. A measurement already under way carries on
+ */
+static void pipeline_measure(void)
+{
+	adc_done = false;
+#ifndef ADC_SCAN
+	if(!capture_busy){
+		capture_busy = task_post(&capture_task, PIPELINE_CONTINUE, 0);
+	}
+#endif
+}
+
+/**
+ * \fn		void pipeline_tick
+ * \param	void *arg Unused
+ * \return	N/A
+ * \brief   note_event callback
+ */
+static void pipeline_tick(void *arg)
+{
+	task_post(&sequencer_task, PIPELINE_TICK, 0);
+}
+
+/**
+ * \fn		void pipeline_refill
+ * \param	task_event_t event PIPELINE_TONE, PIPELINE_PLAY or PIPELINE_PLAYED
+ * \return	N/A
+ * \brief   The refill task. A new note is only measured once the DAC has played it
+ * 			through, so the capture doesn't start on the step from the old one
+ */
+static void pipeline_refill(task_event_t event)
+{
+	uint32_t start;
+
+	if(event.signal == PIPELINE_PLAYED){
+		if(refill_settling){
+			refill_settling = false;
+			pipeline_measure();
+		}
+		return;
+	}
+
+	if(event.signal == PIPELINE_TONE){
+
+	    /**
+	     * Stuff DAC buffer with tone's samples until DAC buffer is full
+	     */
+	    INSTR_COUNT(INSTR_COUNT_NOTES);
+	    start = INSTR_START();
+	    fill_dac_buffer(current_tone);
+	    INSTR_STOP(INSTR_TIMER_FILL_DAC, start);
+	}
+
+    /**
+     * Print info about current tone
+     */
+    DLOG_AT(DLOG_LEVEL_DEBUG, "Generated %d samples at %d Hz. Computed period = %d samples\r\n",
+    		dac_buffer_samples,
+			dac_buffer_hz,
+			dac_buffer_samples_per_period);
+
+    /**
+     * Begin DMA transfer
+     */
+    start_onboard_dma((uint16_t*)dac_buffer, dac_buffer_samples << 1);
+
+#ifdef STREAM_EXPORT
+    stream_block(STREAM_SOURCE_DAC, dac_buffer, 0xFFFFFFFF, 0, dac_buffer_samples, dac_stream_index);
+    dac_stream_index += dac_buffer_samples;
+#endif
+
+    /**
+     * Begin ADC sampling for the new current tone once it has played through
+     */
+    refill_settling = true;
+}
+
+/**
+ * \fn		void pipeline_sequencer
+ * \param	task_event_t event PIPELINE_TICK
+ * \return	N/A
+ * \brief   The sequencer task
+ */
+static void pipeline_sequencer(task_event_t event)
+{
+	/**
+	 * Measure the same note again if the console holds it
+	 */
+	if(tone_hold){
+		pipeline_measure();
+		return;
+	}
+
+	switch(current_tone){
+	case A4:
+		current_tone = D5;
+		break;
+	case D5:
+		current_tone = E5;
+		break;
+	case E5:
+		current_tone = A5;
+		break;
+	case A5:
+		current_tone = A4;
+		break;
+	default:
+		break;
+	}
+	task_post(&refill_task, PIPELINE_TONE, 0);
+}
+
+#ifdef ADC_SCAN
+/**
+ * \fn		void pipeline_detect
+ * \param	task_event_t event PIPELINE_FRAME
+ * \return	N/A
+ * \brief   The detect task. Estimates pitch once per note on each scanned channel by
+ * 			averaging the periods found in FRAMES_PER_NOTE overlapping frames of its ring.
+ * 			Channels that are done keep their ring empty so it doesn't overrun
+ */
+static void pipeline_detect(task_event_t event)
+{
+	uint32_t ch = (uint32_t)event.param;
+	frame_t frame;
+	int period;
+	uint32_t start;
+	bool open;
+
+	if(adc_done || (adc_scan_done & (1u << ch))){
+		adc_scan_flush(ch);
+		return;
+	}
+
+	while(frame_next(ch, &frame)){
+		boot_mark(BOOT_MARK_ADC);
+
+		/**
+		 * Frames without a tone skip the O(N^2) detector
+		 */
+		INSTR_COUNT(INSTR_COUNT_FRAMES);
+		start = INSTR_START();
+		open = gate_update(ch, frame.ring, frame.mask, frame.start, frame.length);
+		INSTR_STOP(INSTR_TIMER_GATE, start);
+
+		/**
+		 * Only RUN captures at TPM1's rate (clocks.h). A frame from before a switch
+		 * was taken at the other profile's
+		 */
+		if(clocks_policy(signal_present) || (clocks_profile() != CLOCKS_RUN)){
+			period = -1;
+		}
+		else if(open){
+			start = INSTR_START();
+			period = frame_detect_period(&frame);
+			INSTR_STOP(INSTR_TIMER_DETECT, start);
+		}
+		else{
+			INSTR_COUNT(INSTR_COUNT_GATED);
+			period = -1;
+			gated[ch]++;
+		}
+#ifdef STREAM_EXPORT
+		/**
+		 * Frames overlap, so the samples each one releases cover the signal once
+		 */
+		stream_block(STREAM_SOURCE_ADC + ch, frame.ring, frame.mask, frame.start, FRAME_HOP, adc_scan_read_index(ch));
+#endif
+		frame_release(ch);
+		if(period > 0){
+			period_sum[ch] += period;
+			periods[ch]++;
+		}
+
+		if(++frames[ch] >= FRAMES_PER_NOTE){
+			adc_scan_done |= (1u << ch);
+			task_post(&report_task, PIPELINE_RESULT, (int16_t)ch);
+			break;
+		}
+	}
+}
+
+/**
+ * \fn		void pipeline_report
+ * \param	task_event_t event PIPELINE_RESULT
+ * \return	N/A
+ * \brief   The report task. Prints a channel's estimate, and the scan's statistics once
+ * 			every channel has one
+ */
+static void pipeline_report(task_event_t event)
+{
+	uint32_t ch = (uint32_t)event.param;
+	uint32_t start = INSTR_START();
+	float hz = periods[ch] ? (tpm_overflow_rate_hz(TPM1) * periods[ch] / adc_scan_count / period_sum[ch]) : 0.0f;
+	int32_t tenths = 0;
+	const note_t *note = cents_note((uint32_t)(hz * 65536.0f), &tenths);
+
+	DLOG("AD%u: %u of %u frames (%u gated), period = %.1f samples, frequency = %.1f Hz, note = %s %+d cents\r\n",
+			adc_scan_list[ch],
+			(unsigned)periods[ch],
+			(unsigned)frames[ch],
+			(unsigned)gated[ch],
+			DLOG_FLOAT(periods[ch] ? ((float)period_sum[ch] / periods[ch]) : -1.0f),
+			DLOG_FLOAT(hz),
+			DLOG_STRING(note ? note->name : "-"),
+			(int)CENTS_ROUND(tenths));
+	frames[ch] = 0;
+	gated[ch] = 0;
+	periods[ch] = 0;
+	period_sum[ch] = 0;
+	adc_scan_reported |= (1u << ch);
+
+	if(adc_scan_reported == ((1u << adc_scan_count) - 1)){
+		adc_done = true;
+		adc_scan_done = 0;
+		adc_scan_reported = 0;
+		adc_scan_report();
+#ifdef STREAM_EXPORT
+		stream_report();
+#endif
+		if(boot_mark(BOOT_MARK_RESULT)){
+			boot_report();
+		}
+		PRINTF("\n");
+	}
+	INSTR_STOP(INSTR_TIMER_REPORT, start);
+}
+#else
+/**
+ * \fn		void pipeline_capture
+ * \param	task_event_t event PIPELINE_CONTINUE
+ * \return	N/A
+ * \brief   The capture task. Converts up to CAPTURE_CHUNK samples into adc_buffer and
+ * 			queues itself again until the block is full
+ */
+static void pipeline_capture(task_event_t event)
+{
+	uint32_t start;
+
+	capture_busy = false;
+	if(adc_done){
+		return;
+	}
+	if(adc_buffer_i == 0){
+		adc_min = 0;
+		adc_max = 0;
+		adc_avg = 0;
+	}
+
+	for(uint32_t n = 0; (n < CAPTURE_CHUNK) && (adc_buffer_i < ADC_BUF_SIZE); n++){
+
+        /**
+         * One conversion per TPM1 overflow (tpm_overflow_rate_hz), which the report
+         * divides by. TPM1 is stopped while it is paused, and then nothing paces the loop
+         */
+        while((TPM1->SC & TPM_SC_CMOD_MASK) && !(TPM1->SC & TPM_SC_TOF_MASK));
+        TPM1->SC |= TPM_SC_TOF_MASK;
+
+        /**
+         * Begin reading a sample from ADC
+         */
+        start = INSTR_START();
+        ADC0->SC1[0] = ADC_SC1_ADCH(SC1_ADCH);
+    	while(!(ADC0->SC1[0] & ADC_SC1_COCO(1)));
+    	adc_buffer[adc_buffer_i] = ((int16_t)(ADC0->R[0]));
+    	INSTR_STOP(INSTR_TIMER_CAPTURE, start);
+    	adc_avg += adc_buffer[adc_buffer_i];
+    	if(adc_buffer[adc_buffer_i] < adc_min){
+    		adc_min = adc_buffer[adc_buffer_i];
+    	}
+    	if(adc_buffer[adc_buffer_i] > adc_max){
+    		adc_max = adc_buffer[adc_buffer_i];
+    	}
+    	adc_buffer_i++;
+	}
+
+	if(adc_buffer_i < ADC_BUF_SIZE){
+		capture_busy = task_post(&capture_task, PIPELINE_CONTINUE, 0);
+		return;
+	}
+
+	/**
+	 * The block is in. detect and report run before capture does again, so
+	 * adc_buffer is safe until they are done with it
+	 */
+	adc_done = true;
+	adc_buffer_i = 0;
+	task_post(&detect_task, PIPELINE_BLOCK, 0);
+}
+
+/**
+ * \fn		void pipeline_detect
+ * \param	task_event_t event PIPELINE_BLOCK
+ * \return	N/A
+ * \brief   The detect task. Only runs the detector when the gate finds a tone in the
+ * 			block
+ */
+static void pipeline_detect(task_event_t event)
+{
+	int period;
+	uint32_t start;
+	bool open;
+
+	boot_mark(BOOT_MARK_ADC);
+	INSTR_COUNT(INSTR_COUNT_FRAMES);
+	start = INSTR_START();
+	open = gate_update(0, adc_buffer, 0xFFFFFFFF, 0, ADC_BUF_SIZE);
+	INSTR_STOP(INSTR_TIMER_GATE, start);
+
+	/**
+	 * Only RUN captures at TPM1's rate (clocks.h). A block from before a switch
+	 * was taken at the other profile's
+	 */
+	if(clocks_policy(signal_present) || (clocks_profile() != CLOCKS_RUN)){
+		period = -1;
+	}
+	else if(open){
+		start = INSTR_START();
+		period = autocorrelate_detect_period(adc_buffer, ADC_BUF_SIZE, kAC_16bps_unsigned);
+		INSTR_STOP(INSTR_TIMER_DETECT, start);
+	}
+	else{
+		INSTR_COUNT(INSTR_COUNT_GATED);
+		period = -1;
+	}
+	task_post(&report_task, PIPELINE_RESULT, (int16_t)period);
+}
+
+/**
+ * \fn		void pipeline_report
+ * \param	task_event_t event PIPELINE_RESULT, with the period found
+ * \return	N/A
+ * \brief   The report task
+ */
+static void pipeline_report(task_event_t event)
+{
+	int period = event.param;
+	uint32_t start = INSTR_START();
+	float hz = (period > 0) ? (tpm_overflow_rate_hz(TPM1) / period) : 0.0f;
+	int32_t tenths = 0;
+	const note_t *note = (period > 0) ? cents_note((uint32_t)(hz * 65536.0f), &tenths) : NULL;
+
+    DLOG("min = %d, max = %d, avg = %d, period = %d samples, frequency = %d Hz, note = %s %+d cents, signal = %s\r\n\n",
+    		adc_min,
+			adc_max,
+			(adc_avg / ADC_BUF_SIZE),
+			period,
+			(int)hz,
+			DLOG_STRING(note ? note->name : "-"),
+			(int)CENTS_ROUND(tenths),
+			DLOG_STRING(signal_present ? "yes" : "no"));
+    INSTR_STOP(INSTR_TIMER_REPORT, start);
+    if(boot_mark(BOOT_MARK_RESULT)){
+    	boot_report();
+    }
+#ifdef STREAM_EXPORT
+    stream_block(STREAM_SOURCE_ADC, adc_buffer, 0xFFFFFFFF, 0, ADC_BUF_SIZE, adc_stream_index);
+    adc_stream_index += ADC_BUF_SIZE;
+    stream_report();
+#endif
+}
+#endif
+
+void init_pipeline(void)
+{
+	task_init(&refill_task, "refill", PRIORITY_REFILL, pipeline_refill);
+	task_init(&sequencer_task, "sequencer", PRIORITY_SEQUENCER, pipeline_sequencer);
+	task_init(&detect_task, "detect", PRIORITY_DETECT, pipeline_detect);
+	task_init(&report_task, "report", PRIORITY_REPORT, pipeline_report);
+	dma_notify(&refill_task, PIPELINE_PLAYED);
+#ifdef ADC_SCAN
+	/**
+	 * Let TPM1 trigger the ADC round-robin over adc_scan_list, waking detect each
+	 * time a channel has another frame's worth of new samples
+	 */
+	init_onboard_adc_scan(adc_scan_list, sizeof(adc_scan_list) / sizeof(adc_scan_list[0]));
+	adc_scan_notify(&detect_task, PIPELINE_FRAME, FRAME_HOP);
+
+	/**
+	 * Analyze each channel in Hann-windowed frames with 50% overlap
+	 */
+	init_frames(FRAME_LENGTH, FRAME_HOP, FRAME_WINDOW_HANN);
+#else
+	task_init(&capture_task, "capture", PRIORITY_CAPTURE, pipeline_capture);
+#endif
+
+#ifdef STREAM_EXPORT
+    /**
+     * Switch UART0 to the streaming rate and describe what goes out on it
+     */
+    init_stream(STREAM_BAUD_RATE);
+    stream_source(STREAM_SOURCE_DAC, DAC_BITS, (uint32_t)tpm_overflow_rate_hz(TPM0));
+#ifdef ADC_SCAN
+    for(uint32_t ch = 0; ch < adc_scan_count; ch++){
+    	stream_source(STREAM_SOURCE_ADC + ch, ADC_BITS, (uint32_t)tpm_overflow_rate_hz(TPM1) / adc_scan_count);
+    }
+#else
+    stream_source(STREAM_SOURCE_ADC, ADC_BITS, SAMPLE_RATE_ADC_HZ);
+#endif
+    stream_block(STREAM_SOURCE_DAC, dac_buffer, 0xFFFFFFFF, 0, dac_buffer_samples, dac_stream_index);
+    dac_stream_index += dac_buffer_samples;
+#endif
+}
+
+void pipeline_start(void)
+{
+#ifndef ADC_SCAN
+	/**
+	 * Capture borrows its block from here on
+	 */
+	adc_buffer = arena_borrow(ARENA_OWNER_CAPTURE, ADC_BUF_SIZE);
+#endif
+	event_every(&note_event, NOTE_PERIOD_US, pipeline_tick, NULL);
+	pipeline_measure();
+}
+
+void pipeline_play(void)
+{
+	event_restart(&note_event);
+	task_post(&refill_task, PIPELINE_PLAY, 0);
+}
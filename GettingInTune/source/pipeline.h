@@ -0,0 +1,63 @@
+/**
+ * \file    pipeline.h
+ * \author	Dayton Flores (dafl2542@colorado.edu)
+ * \date	10/19/2026
+ * \brief   Macros and function headers for the tuner's tasks
+ * \detail
+ * 		The tuner's stages run as tasks (task.h), highest priority first:
+ *
+ * 			refill     Refills dac_buffer for a new note, restarts the DMA into the DAC
+ * 			           and starts measuring the note once DMA0_IRQHandler reports it
+ * 			           played through
+ * 			sequencer  Steps to the next note on each tick of note_event, unless the
+ * 			           console holds the current one
+ * 			detect     Gates a block (polled) or the frames ADC0_IRQHandler announces
+ * 			           (ADC_SCAN), and runs the pitch detector on those with a tone
+ * 			report     Prints and streams what detect found
+ * 			capture    Polls the ADC into adc_buffer, CAPTURE_CHUNK samples per event.
+ * 			           Polled builds only
+ *
+ * 		So the note chain is tick -> sequencer -> refill (<- DMA ISR), and the
+ * 		measurement chain is capture (or the ADC ISR) -> detect -> report. ISRs post
+ * 		to the tasks' inboxes, see task.h. A measurement ends once a block
+ * 		(polled) or FRAMES_PER_NOTE frames per channel (ADC_SCAN) have been reported,
+ * 		and adc_done stays set until the next note.
+ */
+
+#ifndef PIPELINE_H_
+#define PIPELINE_H_
+
+/**
+ * \def		NOTE_PERIOD_US
+ * \brief	How long each note plays before the next one, in us
+ */
+#define NOTE_PERIOD_US\
+	(1000000)
+
+/**
+ * \fn		void init_pipeline
+ * \param	N/A
+ * \return	N/A
+ * \brief   Adds the tasks and, depending on the build, starts the ADC scan and describes
+ * 			the streams. Call after the peripherals and the event scheduler are
+ * 			initialized
+ */
+void init_pipeline(void);
+
+/**
+ * \fn		void pipeline_start
+ * \param	N/A
+ * \return	N/A
+ * \brief   Measures the note playing now and steps through the notes from here on
+ */
+void pipeline_start(void);
+
+/**
+ * \fn		void pipeline_play
+ * \param	N/A
+ * \return	N/A
+ * \brief   Plays the new contents of dac_buffer and measures them for a full note
+ */
+void pipeline_play(void);
+
+#endif /* PIPELINE_H_ */
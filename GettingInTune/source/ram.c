@@ -0,0 +1,140 @@
+/**
+ * \file    ram.c
+ * \author	Dayton Flores (dafl2542@colorado.edu)
+ * \date	10/19/2026
+ * \brief   Function definitions for SRAM usage and the stack's high-water mark
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "board.h"
+#include "fsl_debug_console.h"
+
+/**
+ * User-defined libraries
+ */
+#include "arena.h"
+#include "ram.h"
+
+#ifdef HOST_SIM
+/**
+ * Bounds of the host image's .data and .bss, from the default linker script
+ */
+extern uint8_t __data_start[];
+extern uint8_t _edata[];
+extern uint8_t __bss_start[];
+extern uint8_t _end[];
+#else
+/**
+ * Bounds of the SRAM sections, from MKL25Z4_Project_Debug.ld and _memory.ld
+ */
+extern uint8_t __base_SRAM[];
+extern uint8_t __top_SRAM[];
+extern uint8_t _data[];
+extern uint8_t _edata[];
+extern uint8_t _bss[];
+extern uint8_t _ebss[];
+extern uint8_t _noinit[];
+extern uint8_t _end_noinit[];
+extern uint8_t _pvHeapStart[];
+extern uint8_t _pvHeapLimit[];
+extern uint8_t _vStackTop[];
+#endif
+
+/**
+ * \var		ram_stack_limit
+ * \brief	Lowest word of the painted stack: the end of the heap
+ */
+static uint32_t *ram_stack_limit = NULL;
+
+/**
+ * \var		ram_stack_top
+ * \brief	Word above the highest one the stack can use: the top of SRAM
+ */
+static uint32_t *ram_stack_top = NULL;
+
+/**
+ * \var		ram_painted
+ * \brief	Set once the stack is painted, so main() doesn't paint over what ResetISR used
+ */
+static bool ram_painted = false;
+
+void ram_paint_stack(void)
+{
+	uintptr_t sp;
+	uint32_t *end;
+
+	if(ram_painted){
+		return;
+	}
+#ifdef HOST_SIM
+	sp = (uintptr_t)__builtin_frame_address(0);
+	ram_stack_top = (uint32_t *)(sp & ~(uintptr_t)3);
+	ram_stack_limit = (uint32_t *)((sp - RAM_HOST_STACK_BYTES) & ~(uintptr_t)3);
+#else
+	sp = __get_MSP();
+	ram_stack_top = (uint32_t *)_vStackTop;
+	ram_stack_limit = (uint32_t *)_pvHeapLimit;
+#endif
+
+	/**
+	 * Stops short of this frame, which is in use
+	 */
+	end = (uint32_t *)((sp - RAM_PAINT_GUARD) & ~(uintptr_t)3);
+	for(uint32_t *word = ram_stack_limit; word < end; word++){
+		*word = RAM_STACK_PAINT;
+	}
+	ram_painted = true;
+}
+
+uint32_t ram_stack_peak(void)
+{
+	uint32_t *word = ram_stack_limit;
+
+	if(!ram_painted){
+		return 0;
+	}
+	while((word < ram_stack_top) && (*word == RAM_STACK_PAINT)){
+		word++;
+	}
+	return (uint32_t)((uintptr_t)ram_stack_top - (uintptr_t)word);
+}
+
+uint32_t ram_stack_free(void)
+{
+	if(!ram_painted){
+		return 0;
+	}
+	return (uint32_t)((uintptr_t)ram_stack_top - (uintptr_t)ram_stack_limit) - ram_stack_peak();
+}
+
+void ram_report(void)
+{
+	uint32_t peak = ram_stack_peak();
+	uint32_t room = (uint32_t)((uintptr_t)ram_stack_top - (uintptr_t)ram_stack_limit);
+
+#ifdef HOST_SIM
+	PRINTF("ram: host image, .data = %u bytes, .bss = %u bytes\r\n",
+			(unsigned)(_edata - __data_start),
+			(unsigned)(_end - __bss_start));
+#else
+	PRINTF("ram: %u bytes of SRAM, reserved = %u, .data = %u, .bss = %u, .noinit = %u, heap = %u, stack = %u\r\n",
+			(unsigned)(__top_SRAM - __base_SRAM),
+			(unsigned)(_data - __base_SRAM),
+			(unsigned)(_edata - _data),
+			(unsigned)(_ebss - _bss),
+			(unsigned)(_end_noinit - _noinit),
+			(unsigned)(_pvHeapLimit - _pvHeapStart),
+			(unsigned)(__top_SRAM - _pvHeapLimit));
+#endif
+	PRINTF("ram: stack peak = %u bytes, %u of %u never reached\r\n",
+			(unsigned)peak,
+			(unsigned)(room - peak),
+			(unsigned)room);
+	if(ram_painted && (peak == room)){
+		PRINTF("ram: the stack has run into the heap\r\n");
+	}
+	arena_report();
+}
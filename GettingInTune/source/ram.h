@@ -0,0 +1,85 @@
+/**
+ * \file    ram.h
+ * \author	Dayton Flores (dafl2542@colorado.edu)
+ * \date	10/19/2026
+ * \brief   Macros and function headers for SRAM usage and the stack's high-water mark
+ * \detail
+ * 		MKL25Z4_Project_Debug.ld lays the 16 KB of SRAM out bottom up as the reserved
+ * 		sections (MTB and USB buffers), .data, .bss, .noinit (the sample arena), the heap
+ * 		and whatever is left over, with the stack coming down from the top. Nothing
+ * 		stops the stack growing through the heap and into .noinit and .bss, so ResetISR
+ * 		paints everything between the end of the heap and its own frame with
+ * 		RAM_STACK_PAINT before main() runs. The lowest word no longer holding it is as
+ * 		deep as the stack (ISRs included) has ever been.
+ *
+ * 		ram_report() prints the layout, the high-water mark and what the arena's owners
+ * 		hold (arena_report). host/map_report.c breaks the same sections down by module
+ * 		from the linker map.
+ *
+ * 		On the host there is no ResetISR or linker script: main() paints
+ * 		RAM_HOST_STACK_BYTES below its own frame, and the sizes are the host image's.
+ */
+
+#ifndef RAM_H_
+#define RAM_H_
+
+#include <stdint.h>
+
+/**
+ * \def		RAM_STACK_PAINT
+ * \brief	What unused stack is painted with
+ */
+#define RAM_STACK_PAINT\
+	(0xc5c5c5c5UL)
+
+/**
+ * \def		RAM_PAINT_GUARD
+ * \brief	Bytes left unpainted below the painting function's own frame
+ */
+#define RAM_PAINT_GUARD\
+	(256)
+
+/**
+ * \def		RAM_HOST_STACK_BYTES
+ * \brief	Bytes of stack painted on the host. Host frames are bigger than Cortex-M0+
+ * 			ones, so host high-water marks only rank code paths
+ */
+#define RAM_HOST_STACK_BYTES\
+	(65536)
+
+/**
+ * \fn		void ram_paint_stack
+ * \param	N/A
+ * \return	N/A
+ * \brief   Paints the free stack with RAM_STACK_PAINT. ResetISR calls it once .bss is
+ * 			zeroed, later calls do nothing
+ */
+void ram_paint_stack(void);
+
+/**
+ * \fn		uint32_t ram_stack_peak
+ * \param	N/A
+ * \return	Most bytes of stack ever in use, from the top of SRAM down
+ * \brief   Scans up from the end of the heap for the first word that isn't paint. Takes
+ * 			tens of us, so call from the main loop
+ */
+uint32_t ram_stack_peak(void);
+
+/**
+ * \fn		uint32_t ram_stack_free
+ * \param	N/A
+ * \return	Bytes between the end of the heap and ram_stack_peak() that the stack has
+ * 			never reached. 0 means it has run into the heap, and maybe beyond
+ */
+uint32_t ram_stack_free(void);
+
+/**
+ * \fn		void ram_report
+ * \param	N/A
+ * \return	N/A
+ * \brief   Prints the size of each SRAM section, the stack's high-water mark and what the
+ * 			arena's owners hold
+ */
+void ram_report(void);
+
+#endif /* RAM_H_ */
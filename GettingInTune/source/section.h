@@ -0,0 +1,52 @@
+/**
+ * \file    section.h
+ * \author	Dayton Flores (dafl2542@colorado.edu)
+ * \date	10/19/2026
+ * \brief   Macros that place code and data in particular linker sections
+ * \detail
+ * 		The sections are the ones MKL25Z4_Project_Debug.ld already lays out. The host
+ * 		build has no such script, so the macros expand to nothing there.
+ */
+
+#ifndef SECTION_H_
+#define SECTION_H_
+
+/**
+ * \def		RAMFUNC_ENABLE
+ * \brief	1 to run RAMFUNC functions from SRAM, 0 to leave them in flash (to compare
+ * 			the two with the loopback benchmark, see bench.h)
+ */
+#ifndef RAMFUNC_ENABLE
+#define RAMFUNC_ENABLE\
+	(1)
+#endif
+
+/**
+ * \def		NOINIT
+ * \brief	Places a variable in .noinit, which ResetISR neither copies nor zeroes. For
+ * 			large buffers that are always written before they are read: they start out
+ * 			holding whatever was in SRAM
+ */
+#ifdef HOST_SIM
+#define NOINIT
+#else
+#define NOINIT\
+	__attribute__((section(".noinit")))
+#endif
+
+/**
+ * \def		RAMFUNC
+ * \brief	Runs a function from SRAM rather than flash, which needs wait states at 48 MHz.
+ * 			.ramfunc is part of .data, so ResetISR copies it over with the rest of
+ * 			.data. Calls between flash and SRAM are out of range of a bl, so they go
+ * 			through veneers the linker adds. Only for the hot loops: every byte of code
+ * 			comes out of the same 16 KB as the buffers
+ */
+#if RAMFUNC_ENABLE && !defined(HOST_SIM)
+#define RAMFUNC\
+	__attribute__((section(".ramfunc"), noinline))
+#else
+#define RAMFUNC
+#endif
+
+#endif /* SECTION_H_ */
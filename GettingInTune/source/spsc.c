@@ -0,0 +1,66 @@
+/**
+ * \file    spsc.c
+ * \author	Dayton Flores (dafl2542@colorado.edu)
+ * \date	10/19/2026
+ * \brief   Function definitions for single-producer single-consumer queues
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * User-defined libraries
+ */
+#include "spsc.h"
+
+void spsc_init(spsc_t *q, void *slots, uint32_t item_size, uint32_t count)
+{
+	q->slots = (uint8_t *)slots;
+	q->item_size = item_size;
+	q->mask = count - 1;
+	q->head = 0;
+	q->tail = 0;
+	q->max = 0;
+	q->drops = 0;
+}
+
+bool spsc_put(spsc_t *q, const void *item)
+{
+	uint32_t head = q->head;
+	uint32_t used = head - q->tail;
+
+	if(used > q->mask){
+		q->drops++;
+		return false;
+	}
+	memcpy(&q->slots[(head & q->mask) * q->item_size], item, q->item_size);
+
+	/**
+	 * The item has to be in its slot before the consumer can see the new head
+	 */
+	SPSC_BARRIER();
+	q->head = head + 1;
+	if(used + 1 > q->max){
+		q->max = used + 1;
+	}
+	return true;
+}
+
+bool spsc_get(spsc_t *q, void *item)
+{
+	uint32_t tail = q->tail;
+
+	if(q->head == tail){
+		return false;
+	}
+
+	/**
+	 * Read the slot only after seeing head, and free it only once it has been read
+	 */
+	SPSC_BARRIER();
+	memcpy(item, &q->slots[(tail & q->mask) * q->item_size], q->item_size);
+	SPSC_BARRIER();
+	q->tail = tail + 1;
+	return true;
+}
@@ -0,0 +1,92 @@
+/**
+ * \file    spsc.h
+ * \author	Dayton Flores (dafl2542@colorado.edu)
+ * \date	10/19/2026
+ * \brief   Macros and function headers for single-producer single-consumer queues
+ * \detail
+ * 		A ring of fixed-size items with one writer (the producer) and one reader (the
+ * 		consumer), typically an ISR and the main loop. head is only written by the
+ * 		producer and tail only by the consumer, and aligned 32-bit loads and stores are
+ * 		single-copy atomic, so neither side needs to mask interrupts or use exclusive
+ * 		accesses (which the Cortex-M0+ doesn't have). A barrier orders each item's
+ * 		copy against the index that publishes it, which also makes the queue safe
+ * 		between two host threads (see host/spsc_stress.c).
+ *
+ * 		head and tail count items ever put and got, so all slots are usable and the
+ * 		fill level is head - tail even after they wrap.
+ */
+
+#ifndef SPSC_H_
+#define SPSC_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * \def		SPSC_BARRIER
+ * \brief	Full memory barrier: DMB on the Cortex-M0+, and one the compiler can't move
+ * 			accesses across
+ */
+#define SPSC_BARRIER()\
+	(__sync_synchronize())
+
+/**
+ * \typedef	typedef struct spsc_s spsc_t
+ * \brief   Easily declare queues
+ */
+typedef struct spsc_s spsc_t;
+
+/**
+ * \struct	struct spsc_s
+ * \brief   One queue. Only touched through the functions below
+ */
+struct spsc_s{
+	uint8_t *slots;
+	uint32_t item_size;		/* In bytes */
+	uint32_t mask;			/* Slots - 1 */
+	volatile uint32_t head;	/* Items ever put. Producer only */
+	volatile uint32_t tail;	/* Items ever got. Consumer only */
+	volatile uint32_t max;	/* Most items queued at once. Producer only */
+	volatile uint32_t drops;	/* Items put while the queue was full. Producer only */
+};
+
+/**
+ * \fn		void spsc_init
+ * \param	spsc_t *q
+ * \param	void *slots Storage for count items
+ * \param	uint32_t item_size In bytes
+ * \param	uint32_t count Must be a power of 2
+ * \return	N/A
+ * \brief   Empties q. Call before either side uses it
+ */
+void spsc_init(spsc_t *q, void *slots, uint32_t item_size, uint32_t count);
+
+/**
+ * \fn		bool spsc_put
+ * \param	spsc_t *q
+ * \param	const void *item item_size bytes
+ * \return	true if item was queued, false if q was full and it was dropped
+ * \brief   Producer side
+ */
+bool spsc_put(spsc_t *q, const void *item);
+
+/**
+ * \fn		bool spsc_get
+ * \param	spsc_t *q
+ * \param	void *item Destination for item_size bytes
+ * \return	true if an item was taken out, false if q was empty
+ * \brief   Consumer side
+ */
+bool spsc_get(spsc_t *q, void *item);
+
+/**
+ * \fn		uint32_t spsc_count
+ * \param	const spsc_t *q
+ * \return	Items queued. Exact on the consumer side, a lower bound on the producer side
+ */
+static inline uint32_t spsc_count(const spsc_t *q)
+{
+	return q->head - q->tail;
+}
+
+#endif /* SPSC_H_ */
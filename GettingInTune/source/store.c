@@ -0,0 +1,384 @@
+/**
+ * \file    store.c
+ * \author	Dayton Flores (dafl2542@colorado.edu)
+ * \date	10/19/2026
+ * \brief   Function definitions for the persistent settings store
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "fsl_debug_console.h"
+#include "fsl_flash.h"
+
+/**
+ * User-defined libraries
+ */
+#include "critical.h"
+#include "store.h"
+
+/**
+ * \def		STORE_MAGIC
+ * \brief	Marks a sector header as written, and the layout it was written with
+ */
+#define STORE_MAGIC\
+	(0x3153564BUL)
+
+/**
+ * \def		STORE_ERASED
+ * \brief	What an erased word of flash reads
+ */
+#define STORE_ERASED\
+	(0xFFFFFFFFUL)
+
+/**
+ * \typedef	typedef struct store_header_s store_header_t
+ * \brief   Easily declare sector headers
+ */
+typedef struct store_header_s store_header_t;
+
+/**
+ * \struct	struct store_header_s
+ * \brief   First words of a sector. sequence is programmed before magic, so a sector
+ * 			only counts once both are in
+ */
+struct store_header_s{
+	uint32_t magic;
+	uint32_t sequence;
+};
+
+/**
+ * \typedef	typedef struct store_record_s store_record_t
+ * \brief   Easily declare records
+ */
+typedef struct store_record_s store_record_t;
+
+/**
+ * \struct	struct store_record_s
+ * \brief   One value in the log. Two words, both erased for a free slot
+ */
+struct store_record_s{
+	uint32_t value;
+	uint16_t key;
+	uint16_t crc;
+};
+
+/**
+ * \def		STORE_RECORDS
+ * \brief	Records per sector, after the header
+ */
+#define STORE_RECORDS\
+	((STORE_SECTOR_SIZE - sizeof(store_header_t)) / sizeof(store_record_t))
+
+_Static_assert(STORE_KEYS < STORE_RECORDS, "a compacted sector must have room for every key plus one");
+_Static_assert(sizeof(store_record_t) == 8, "records must be whole flash words");
+
+/**
+ * \var		store_flash
+ * \brief	State fsl_flash keeps between calls
+ */
+static flash_config_t store_flash;
+
+/**
+ * \var		store_ready
+ * \brief	Set once init_store() has found or started a store in flash
+ */
+static bool store_ready = false;
+
+/**
+ * \var		store_active
+ * \brief	The active sector, its sequence number and the next free record in it
+ */
+static uint32_t store_active = 0;
+static uint32_t store_sequence = 0;
+static uint32_t store_next = 0;
+
+/**
+ * \var		store_values
+ * \brief	RAM copy of every key's value, which store_get() reads
+ */
+static uint32_t store_values[STORE_KEYS];
+
+/**
+ * \var		store_valid
+ * \brief	Bit n is set once key n has a value
+ */
+static uint32_t store_valid = 0;
+
+#ifndef HOST_SIM
+/**
+ * \var		_image_end
+ * \brief	End of the program image in flash, from the linker script
+ */
+extern const uint8_t _image_end[];
+#endif
+
+/**
+ * \fn		const store_header_t *store_header
+ * \param	uint32_t sector
+ * \return	The sector's header, read straight from flash
+ */
+static const store_header_t *store_header(uint32_t sector)
+{
+	return (const store_header_t *)(STORE_BASE + sector * STORE_SECTOR_SIZE);
+}
+
+/**
+ * \fn		const store_record_t *store_record
+ * \param	uint32_t sector
+ * \param	uint32_t i
+ * \return	Record i of the sector, read straight from flash
+ */
+static const store_record_t *store_record(uint32_t sector, uint32_t i)
+{
+	return (const store_record_t *)(STORE_BASE + sector * STORE_SECTOR_SIZE +
+			sizeof(store_header_t) + i * sizeof(store_record_t));
+}
+
+/**
+ * \fn		uint16_t store_crc
+ * \param	uint16_t key
+ * \param	uint32_t value
+ * \return	CRC-16/CCITT of the value's and the key's bytes, little-endian
+ */
+static uint16_t store_crc(uint16_t key, uint32_t value)
+{
+	uint8_t bytes[6] = {
+		(uint8_t)value, (uint8_t)(value >> 8), (uint8_t)(value >> 16), (uint8_t)(value >> 24),
+		(uint8_t)key, (uint8_t)(key >> 8)
+	};
+	uint16_t crc = 0xFFFF;
+
+	for(uint32_t i = 0; i < sizeof(bytes); i++){
+		crc ^= (uint16_t)(bytes[i] << 8);
+		for(int bit = 0; bit < 8; bit++){
+			crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+		}
+	}
+	return crc;
+}
+
+/**
+ * \fn		bool store_erase
+ * \param	uint32_t sector
+ * \return	true if the sector now reads erased
+ */
+static bool store_erase(uint32_t sector)
+{
+	uint32_t addr = STORE_BASE + sector * STORE_SECTOR_SIZE;
+	const uint32_t *word = (const uint32_t *)addr;
+	uint32_t primask;
+	status_t status;
+
+	primask = critical_enter();
+	status = FLASH_Erase(&store_flash, addr, STORE_SECTOR_SIZE, kFLASH_ApiEraseKey);
+	critical_exit(primask);
+
+	if(status != kStatus_FLASH_Success){
+		return false;
+	}
+	for(uint32_t i = 0; i < STORE_SECTOR_SIZE / sizeof(uint32_t); i++){
+		if(word[i] != STORE_ERASED){
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * \fn		bool store_program
+ * \param	uint32_t addr Word aligned
+ * \param	const void *src
+ * \param	uint32_t bytes A multiple of 4
+ * \return	true if flash now reads back src
+ */
+static bool store_program(uint32_t addr, const void *src, uint32_t bytes)
+{
+	const uint32_t *from = (const uint32_t *)src;
+	const uint32_t *to = (const uint32_t *)addr;
+	uint32_t primask;
+	status_t status;
+
+	primask = critical_enter();
+	status = FLASH_Program(&store_flash, addr, (uint32_t *)src, bytes);
+	critical_exit(primask);
+
+	if(status != kStatus_FLASH_Success){
+		return false;
+	}
+	for(uint32_t i = 0; i < bytes / sizeof(uint32_t); i++){
+		if(to[i] != from[i]){
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * \fn		bool store_append
+ * \param	store_key_t key
+ * \param	uint32_t value
+ * \return	true if the record is in the active sector
+ * \brief   Writes a record to the next free slot. A slot that fails is left behind
+ */
+static bool store_append(store_key_t key, uint32_t value)
+{
+	store_record_t record = { value, (uint16_t)key, store_crc((uint16_t)key, value) };
+
+	if(store_next >= STORE_RECORDS){
+		return false;
+	}
+	return store_program((uint32_t)store_record(store_active, store_next++), &record, sizeof(record));
+}
+
+/**
+ * \fn		bool store_start
+ * \param	uint32_t sector
+ * \param	uint32_t sequence
+ * \return	true if the sector is erased, holds every value in RAM and has its header
+ * \brief   Makes sector the active one. Only once its header is in does it outrank the
+ * 			sector it replaces, which stays active if anything fails
+ */
+static bool store_start(uint32_t sector, uint32_t sequence)
+{
+	uint32_t previous = store_active;
+	uint32_t previous_next = store_next;
+	uint32_t magic = STORE_MAGIC;
+	bool ok;
+
+	ok = store_erase(sector);
+	store_active = sector;
+	store_next = 0;
+	for(uint32_t key = 0; ok && (key < STORE_KEYS); key++){
+		if(store_valid & (1u << key)){
+			ok = store_append((store_key_t)key, store_values[key]);
+		}
+	}
+	ok = ok && store_program((uint32_t)&store_header(sector)->sequence, &sequence, sizeof(sequence));
+	ok = ok && store_program((uint32_t)&store_header(sector)->magic, &magic, sizeof(magic));
+
+	if(!ok){
+		store_active = previous;
+		store_next = previous_next;
+		return false;
+	}
+	store_sequence = sequence;
+	return true;
+}
+
+bool init_store(void)
+{
+	bool found = false;
+
+	store_ready = false;
+	store_valid = 0;
+	store_next = 0;
+
+#ifndef HOST_SIM
+	if((uint32_t)_image_end > STORE_BASE){
+		PRINTF("store: the program runs into the store at 0x%05x, settings won't be saved\r\n",
+				(unsigned)STORE_BASE);
+		return false;
+	}
+#endif
+	if(FLASH_Init(&store_flash) != kStatus_FLASH_Success){
+		PRINTF("store: flash driver failed to start, settings won't be saved\r\n");
+		return false;
+	}
+
+	/**
+	 * The active sector is the one with the highest sequence number
+	 */
+	for(uint32_t sector = 0; sector < STORE_SECTORS; sector++){
+		const store_header_t *header = store_header(sector);
+
+		if((header->magic == STORE_MAGIC) && (!found || (header->sequence > store_sequence))){
+			store_active = sector;
+			store_sequence = header->sequence;
+			found = true;
+		}
+	}
+	if(!found){
+		store_ready = store_start(0, 1);
+		if(!store_ready){
+			PRINTF("store: can't start a store in flash, settings won't be saved\r\n");
+		}
+		return store_ready;
+	}
+
+	/**
+	 * Replay the log up to the first free slot. Torn or corrupt records are skipped,
+	 * and their slots stay used
+	 */
+	for(store_next = 0; store_next < STORE_RECORDS; store_next++){
+		const store_record_t *record = store_record(store_active, store_next);
+		const uint32_t *words = (const uint32_t *)record;
+
+		if((words[0] == STORE_ERASED) && (words[1] == STORE_ERASED)){
+			break;
+		}
+		if((record->key < STORE_KEYS) && (record->crc == store_crc(record->key, record->value))){
+			store_values[record->key] = record->value;
+			store_valid |= (1u << record->key);
+		}
+	}
+	store_ready = true;
+	return true;
+}
+
+uint32_t store_get(store_key_t key, uint32_t fallback)
+{
+	return (store_valid & (1u << key)) ? store_values[key] : fallback;
+}
+
+bool store_set(store_key_t key, uint32_t value)
+{
+	uint32_t old_value;
+	uint32_t old_valid;
+
+	if(!store_ready || (key >= STORE_KEYS)){
+		return false;
+	}
+	if((store_valid & (1u << key)) && (store_values[key] == value)){
+		return true;
+	}
+	old_value = store_values[key];
+	old_valid = store_valid;
+	store_values[key] = value;
+	store_valid |= (1u << key);
+
+	/**
+	 * Append, and if the sector is full (or the slot is bad), compact into the next
+	 * sector with the new value already in place
+	 */
+	if(store_append(key, value)){
+		return true;
+	}
+	if(store_start((store_active + 1) % STORE_SECTORS, store_sequence + 1)){
+		return true;
+	}
+
+	/**
+	 * Still on the old sector, which doesn't hold the new value
+	 */
+	store_values[key] = old_value;
+	store_valid = old_valid;
+	return false;
+}
+
+void store_report(void)
+{
+	if(!store_ready){
+		PRINTF("store: not in use\r\n");
+		return;
+	}
+	PRINTF("store: sector %u of %u at 0x%05x, %u of %u records used, %u compactions, each sector erased ~%u times\r\n",
+			(unsigned)store_active,
+			(unsigned)STORE_SECTORS,
+			(unsigned)(STORE_BASE + store_active * STORE_SECTOR_SIZE),
+			(unsigned)store_next,
+			(unsigned)STORE_RECORDS,
+			(unsigned)(store_sequence - 1),
+			(unsigned)((store_sequence + STORE_SECTORS - 1) / STORE_SECTORS));
+}
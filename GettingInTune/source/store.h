@@ -0,0 +1,119 @@
+/**
+ * \file    store.h
+ * \author	Dayton Flores (dafl2542@colorado.edu)
+ * \date	10/19/2026
+ * \brief   Macros and function headers for the persistent settings store
+ * \detail
+ * 		A small key/value store in the last STORE_SECTORS sectors of flash, so settings
+ * 		changed from the console survive a power cycle and a reflash that doesn't erase
+ * 		the whole chip.
+ *
+ * 		The store is a log. Each sector starts with a header holding a sequence number,
+ * 		and the sector with the highest one is active. Setting a value appends a record
+ * 		(value, key, CRC-16) to the active sector; the last good record for a key wins.
+ * 		Once the active sector is full, the live values are compacted into the next
+ * 		sector round the ring and it becomes active. Sectors are erased in turn, so
+ * 		they wear evenly.
+ *
+ * 		Power can fail at any point:
+ * 			- A torn record fails its CRC and is skipped, the key keeps its old value
+ * 			- A sector's header is written last, after the records compacted into it,
+ * 			  so a half-compacted sector is never active and is erased before reuse
+ *
+ * 		init_store() reads every value into RAM. store_get() only reads that copy and
+ * 		never touches flash, so it is safe on any path. store_set() programs flash with
+ * 		interrupts masked (code in flash can't run while it is being programmed), which
+ * 		holds off ISRs for up to a sector erase: only call it when a gap in playback and
+ * 		capture is acceptable, like the console's save command.
+ *
+ * 		On the host, host/flash_host.c simulates the flash behind fsl_flash.h.
+ */
+
+#ifndef STORE_H_
+#define STORE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "fsl_device_registers.h"
+
+/**
+ * \def		STORE_SECTOR_SIZE
+ * \brief	Size of a flash sector, the unit of erase, in bytes
+ */
+#define STORE_SECTOR_SIZE\
+	(FSL_FEATURE_FLASH_PFLASH_BLOCK_SECTOR_SIZE)
+
+/**
+ * \def		STORE_SECTORS
+ * \brief	Sectors in the ring. Each one is erased once per STORE_SECTORS compactions
+ */
+#define STORE_SECTORS\
+	(4)
+
+/**
+ * \def		STORE_BASE
+ * \brief	Address of the first sector: the end of flash, less STORE_SECTORS sectors.
+ * 			The program image must end below it, init_store() checks
+ */
+#define STORE_BASE\
+	(FSL_FEATURE_FLASH_PFLASH_BLOCK_COUNT * FSL_FEATURE_FLASH_PFLASH_BLOCK_SIZE - STORE_SECTORS * STORE_SECTOR_SIZE)
+
+/**
+ * \typedef	typedef enum store_key_e store_key_t
+ * \brief   Easily declare keys
+ */
+typedef enum store_key_e store_key_t;
+
+/**
+ * \enum	enum store_key_e
+ * \brief   What the store holds. Only ever add keys at the end: a key's number is what
+ * 			goes to flash
+ */
+enum store_key_e{
+	STORE_KEY_LAG_MIN,		/* autocorrelate_set_lag_bounds */
+	STORE_KEY_LAG_MAX,
+	STORE_KEY_ADC_PROFILE,	/* adc_set_profile */
+	STORE_KEY_LOG_LEVEL,	/* dlog_level */
+	STORE_KEY_GATE_OPEN,	/* gate_set_energy */
+	STORE_KEY_GATE_CLOSE,
+	STORE_KEYS
+};
+
+/**
+ * \fn		bool init_store
+ * \param	N/A
+ * \return	true if the store is usable, false if store_set() will fail
+ * \brief   Finds the active sector and reads every key's value into RAM. Starts an empty
+ * 			store if flash holds none. Call again to re-read flash
+ */
+bool init_store(void);
+
+/**
+ * \fn		uint32_t store_get
+ * \param	store_key_t key
+ * \param	uint32_t fallback
+ * \return	The key's value, or fallback if it has never been set
+ * \brief   Reads the RAM copy, never flash
+ */
+uint32_t store_get(store_key_t key, uint32_t fallback);
+
+/**
+ * \fn		bool store_set
+ * \param	store_key_t key
+ * \param	uint32_t value
+ * \return	true once value is in flash, false if it couldn't be written
+ * \brief   Appends value for key to the log, compacting first if the active sector is
+ * 			full. Does nothing if key already holds value. Masks interrupts while flash
+ * 			is programmed, see the file comment
+ */
+bool store_set(store_key_t key, uint32_t value);
+
+/**
+ * \fn		void store_report
+ * \param	N/A
+ * \return	N/A
+ * \brief   Prints the active sector, how full it is and how worn the sectors are
+ */
+void store_report(void);
+
+#endif /* STORE_H_ */
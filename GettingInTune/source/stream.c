@@ -0,0 +1,406 @@
+/**
+ * \file    stream.c
+ * \author	Dayton Flores (dafl2542@colorado.edu)
+ * \date	10/19/2026
+ * \brief   Function definitions for binary sample streaming over UART0
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "board.h"
+#include "fsl_debug_console.h"
+
+/**
+ * User-defined libraries
+ */
+#include "irq.h"
+#include "stream.h"
+
+/**
+ * Only built into STREAM_EXPORT builds: DMA2_IRQHandler would otherwise keep the
+ * frames in SRAM
+ */
+#ifdef STREAM_EXPORT
+
+/**
+ * \def		STREAM_DMA_CHANNEL
+ * \brief	DMA channel feeding UART0. Channel 0 feeds the DAC and bench.c borrows
+ * 			channel 1 for the ADC
+ */
+#define STREAM_DMA_CHANNEL\
+	(2)
+
+/**
+ * \def		CHCFG_SOURCE_UART0_TX
+ * \brief	DMAMUX request source for UART0 transmit (TDRE with C5[TDMAE] set)
+ */
+#define CHCFG_SOURCE_UART0_TX\
+	(3)
+
+/**
+ * \def		DCR_SIZE_8BIT
+ * \brief	DCR[SSIZE]/DCR[DSIZE] value for 8-bit bus cycles
+ */
+#define DCR_SIZE_8BIT\
+	(1)
+
+/**
+ * \def		STREAM_UART_CLOCK_HZ
+ * \brief	UART0 clock, MCGPLLCLK/2 in BOARD_BootClockRUN
+ */
+#define STREAM_UART_CLOCK_HZ\
+	(48000000)
+
+/**
+ * \def		STREAM_UART_OSR
+ * \brief	Receiver oversampling ratio, C4[OSR] + 1
+ */
+#define STREAM_UART_OSR\
+	(16)
+
+/**
+ * \def		PCR_MUX_SEL_UART0
+ * \brief	PCR[MUX] value routing UART0_TX to PTA2
+ */
+#define PCR_MUX_SEL_UART0\
+	(2)
+
+/**
+ * \def		PORTA_UART0_TX_POS
+ * \brief	UART0_TX is located at PTA2
+ */
+#define PORTA_UART0_TX_POS\
+	(2)
+
+/**
+ * \var		stream_crc_table
+ * \brief	CRC-16/CCITT-FALSE (polynomial 0x1021) of every byte value, one table lookup
+ * 			per byte instead of eight shifts
+ */
+static const uint16_t stream_crc_table[256] = {
+	0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+	0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+	0x1231, 0x0210, 0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6,
+	0x9339, 0x8318, 0xB37B, 0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE,
+	0x2462, 0x3443, 0x0420, 0x1401, 0x64E6, 0x74C7, 0x44A4, 0x5485,
+	0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE, 0xF5CF, 0xC5AC, 0xD58D,
+	0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6, 0x5695, 0x46B4,
+	0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D, 0xC7BC,
+	0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
+	0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B,
+	0x5AF5, 0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12,
+	0xDBFD, 0xCBDC, 0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A,
+	0x6CA6, 0x7C87, 0x4CE4, 0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41,
+	0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD, 0xAD2A, 0xBD0B, 0x8D68, 0x9D49,
+	0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13, 0x2E32, 0x1E51, 0x0E70,
+	0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A, 0x9F59, 0x8F78,
+	0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E, 0xE16F,
+	0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
+	0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E,
+	0x02B1, 0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256,
+	0xB5EA, 0xA5CB, 0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D,
+	0x34E2, 0x24C3, 0x14A0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+	0xA7DB, 0xB7FA, 0x8799, 0x97B8, 0xE75F, 0xF77E, 0xC71D, 0xD73C,
+	0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657, 0x7676, 0x4615, 0x5634,
+	0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9, 0xB98A, 0xA9AB,
+	0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882, 0x28A3,
+	0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
+	0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92,
+	0xFD2E, 0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9,
+	0x7C26, 0x6C07, 0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1,
+	0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
+	0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0,
+};
+
+/**
+ * \typedef	typedef struct stream_frame_s stream_frame_t
+ * \brief   A frame and the number of bytes in use
+ */
+typedef struct stream_frame_s stream_frame_t;
+
+/**
+ * \struct	struct stream_frame_s
+ * \brief   A frame and the number of bytes in use
+ */
+struct stream_frame_s{
+	uint8_t data[STREAM_FRAME_SIZE];
+	uint32_t size;
+};
+
+/**
+ * \var		stream_frames
+ * \brief	Frames waiting for or in the DMA
+ */
+static stream_frame_t stream_frames[STREAM_FRAMES];
+
+/**
+ * \var		stream_head
+ * \brief	Frames ever queued. Only the main loop writes it
+ */
+static volatile uint32_t stream_head = 0;
+
+/**
+ * \var		stream_tail
+ * \brief	Frames ever sent. Only DMA2_IRQHandler writes it
+ */
+static volatile uint32_t stream_tail = 0;
+
+/**
+ * \var		stream_busy
+ * \brief	True while a frame is in the DMA and the stream holds the transmitter
+ */
+static volatile bool stream_busy = false;
+
+/**
+ * \var		stream_sequence
+ * \brief	Sequence number of the next frame
+ */
+static uint16_t stream_sequence = 0;
+
+/**
+ * \var		stream_bits
+ * \brief	Significant bits per sample of each source
+ */
+static uint8_t stream_bits[STREAM_MAX_SOURCES];
+
+/**
+ * \var		stream_rate_hz
+ * \brief	Sample rate of each source
+ */
+static uint32_t stream_rate_hz[STREAM_MAX_SOURCES];
+
+/**
+ * \var		stream_samples_sent
+ * \brief	Samples queued since init_stream
+ */
+static uint32_t stream_samples_sent = 0;
+
+/**
+ * \var		stream_samples_dropped
+ * \brief	Samples dropped since init_stream because every frame was in use
+ */
+static uint32_t stream_samples_dropped = 0;
+
+uint16_t stream_crc16(uint16_t crc, const uint8_t *data, uint32_t n)
+{
+	while(n--){
+		crc = (uint16_t)(crc << 8) ^ stream_crc_table[(uint8_t)(crc >> 8) ^ *data++];
+	}
+	return crc;
+}
+
+/**
+ * \fn		void put16
+ * \param	uint8_t *p
+ * \param	uint32_t v
+ * \return	N/A
+ * \brief   Stores the low half of v little-endian
+ */
+static void put16(uint8_t *p, uint32_t v)
+{
+	p[0] = (uint8_t)v;
+	p[1] = (uint8_t)(v >> 8);
+}
+
+/**
+ * \fn		void put32
+ * \param	uint8_t *p
+ * \param	uint32_t v
+ * \return	N/A
+ * \brief   Stores v little-endian
+ */
+static void put32(uint8_t *p, uint32_t v)
+{
+	put16(p, v);
+	put16(p + 2, v >> 16);
+}
+
+/**
+ * \fn		void stream_start
+ * \param	N/A
+ * \return	N/A
+ * \brief   Points DMA channel 2 at the oldest queued frame and lets UART0 pull it
+ */
+static void stream_start(void)
+{
+	stream_frame_t *frame = &stream_frames[stream_tail & (STREAM_FRAMES - 1)];
+
+	DMA0->DMA[STREAM_DMA_CHANNEL].SAR = DMA_SAR_SAR((uint32_t)(frame->data));
+	DMA0->DMA[STREAM_DMA_CHANNEL].DAR = DMA_DAR_DAR((uint32_t)(&(UART0->D)));
+	DMA0->DMA[STREAM_DMA_CHANNEL].DSR_BCR = DMA_DSR_BCR_BCR(frame->size);
+
+	/**
+	 * Configure DMA2:
+	 * 	- Interrupt when the frame is done
+	 * 	- One byte per UART0 request, from an incrementing source
+	 * 	- Stop taking requests at the end of the frame
+	 */
+	DMA0->DMA[STREAM_DMA_CHANNEL].DCR =
+		DMA_DCR_EINT_MASK |
+		DMA_DCR_ERQ_MASK |
+		DMA_DCR_CS_MASK |
+		DMA_DCR_SINC_MASK |
+		DMA_DCR_SSIZE(DCR_SIZE_8BIT) |
+		DMA_DCR_DSIZE(DCR_SIZE_8BIT) |
+		DMA_DCR_D_REQ_MASK;
+
+	UART0->C5 |= UART0_C5_TDMAE_MASK;
+}
+
+/**
+ * \fn		void stream_kick
+ * \param	N/A
+ * \return	N/A
+ * \brief   Starts the oldest queued frame if the link is idle and the console has nothing
+ * 			queued. DMA2_IRQHandler only runs while stream_busy, so the main loop needs no
+ * 			critical section here
+ */
+static void stream_kick(void)
+{
+	if(!stream_busy && (stream_tail != stream_head) && DbgConsole_TxAcquire()){
+		stream_busy = true;
+		stream_start();
+	}
+}
+
+void init_stream(uint32_t baud)
+{
+	uint32_t sbr = (STREAM_UART_CLOCK_HZ + (STREAM_UART_OSR * baud) / 2) / (STREAM_UART_OSR * baud);
+
+	/**
+	 * Nothing queued may go out at the old rate once the rate has changed
+	 */
+	DbgConsole_Flush();
+
+	/**
+	 * Enable clock to DMA, DMA MUX, UART0 and Port A
+	 * UART0 runs from MCGFLLCLK/MCGPLLCLK/2 like the debug console
+	 */
+	SIM->SCGC7 |= SIM_SCGC7_DMA_MASK;
+	SIM->SCGC6 |= SIM_SCGC6_DMAMUX_MASK;
+	SIM->SCGC4 |= SIM_SCGC4_UART0_MASK;
+	SIM->SCGC5 |= SIM_SCGC5_PORTA_MASK;
+	SIM->SOPT2 = (SIM->SOPT2 & ~SIM_SOPT2_UART0SRC_MASK) | SIM_SOPT2_UART0SRC(1);
+	PORTA->PCR[PORTA_UART0_TX_POS] = (PORTA->PCR[PORTA_UART0_TX_POS] & ~PORT_PCR_MUX_MASK) |
+			PORT_PCR_MUX(PCR_MUX_SEL_UART0);
+
+	/**
+	 * The baud rate may only change with the transmitter off
+	 */
+	if(sbr == 0){
+		sbr = 1;
+	}
+	UART0->C2 &= ~UART0_C2_TE_MASK;
+	UART0->C4 = (UART0->C4 & ~UART0_C4_OSR_MASK) | UART0_C4_OSR(STREAM_UART_OSR - 1);
+	UART0->BDH = (UART0->BDH & ~UART0_BDH_SBR_MASK) | UART0_BDH_SBR(sbr >> 8);
+	UART0->BDL = UART0_BDL_SBR(sbr);
+	UART0->C2 |= UART0_C2_TE_MASK;
+
+	stream_head = 0;
+	stream_tail = 0;
+	stream_busy = false;
+	stream_sequence = 0;
+	stream_samples_sent = 0;
+	stream_samples_dropped = 0;
+
+	/**
+	 * Disable DMA2 to allow for configuration, then route UART0 transmit to it
+	 */
+	DMAMUX0->CHCFG[STREAM_DMA_CHANNEL] = 0;
+	DMA0->DMA[STREAM_DMA_CHANNEL].DSR_BCR = DMA_DSR_BCR_DONE_MASK;
+
+	NVIC_SetPriority(DMA2_IRQn, IRQ_PRIORITY_DMA2);
+	NVIC_ClearPendingIRQ(DMA2_IRQn);
+	NVIC_EnableIRQ(DMA2_IRQn);
+
+	DMAMUX0->CHCFG[STREAM_DMA_CHANNEL] =
+		DMAMUX_CHCFG_ENBL_MASK |
+		DMAMUX_CHCFG_SOURCE(CHCFG_SOURCE_UART0_TX);
+}
+
+void stream_source(uint32_t source, uint8_t bits, uint32_t rate_hz)
+{
+	stream_bits[source] = bits;
+	stream_rate_hz[source] = rate_hz;
+}
+
+uint32_t stream_block(uint32_t source, const int16_t *ring, uint32_t mask, uint32_t start, uint32_t n, uint32_t index)
+{
+	uint32_t queued = 0;
+
+	while(queued < n){
+		uint32_t head = stream_head;
+		uint32_t count = n - queued;
+		stream_frame_t *frame;
+		uint8_t *p;
+
+		if(head - stream_tail >= STREAM_FRAMES){
+			stream_samples_dropped += n - queued;
+			break;
+		}
+		if(count > STREAM_BLOCK_SAMPLES){
+			count = STREAM_BLOCK_SAMPLES;
+		}
+
+		frame = &stream_frames[head & (STREAM_FRAMES - 1)];
+		p = frame->data;
+		p[0] = STREAM_SYNC0;
+		p[1] = STREAM_SYNC1;
+		p[2] = (uint8_t)source;
+		p[3] = stream_bits[source];
+		put16(&p[4], stream_sequence++);
+		put16(&p[6], count);
+		put32(&p[8], index + queued);
+		put32(&p[12], stream_rate_hz[source]);
+		p += STREAM_HEADER_SIZE;
+		for(uint32_t i = 0; i < count; i++){
+			put16(p, (uint16_t)ring[(start + queued + i) & mask]);
+			p += 2;
+		}
+		put16(p, stream_crc16(0xFFFF, &frame->data[2], (uint32_t)(p - &frame->data[2])));
+		frame->size = (uint32_t)(p - frame->data) + STREAM_CRC_SIZE;
+
+		stream_head = head + 1;
+		queued += count;
+	}
+	stream_samples_sent += queued;
+
+	stream_kick();
+	return queued;
+}
+
+void stream_service(void)
+{
+	stream_kick();
+}
+
+void stream_report(void)
+{
+	PRINTF("Stream: %u frames, %u samples sent, %u samples dropped\r\n",
+			(unsigned)stream_sequence,
+			(unsigned)stream_samples_sent,
+			(unsigned)stream_samples_dropped);
+}
+
+void DMA2_IRQHandler(void)
+{
+	/**
+	 * Clear the Done flag and stop UART0 requesting more
+	 */
+	DMA0->DMA[STREAM_DMA_CHANNEL].DSR_BCR = DMA_DSR_BCR_DONE_MASK;
+	UART0->C5 &= ~UART0_C5_TDMAE_MASK;
+	stream_tail = stream_tail + 1;
+
+	/**
+	 * Keep the transmitter for the next frame unless the console is waiting for it
+	 */
+	if((stream_tail != stream_head) && !DbgConsole_TxPending()){
+		stream_start();
+		return;
+	}
+	stream_busy = false;
+	DbgConsole_TxRelease();
+}
+
+#endif /* STREAM_EXPORT */
@@ -0,0 +1,177 @@
+/**
+ * \file    stream.h
+ * \author	Dayton Flores (dafl2542@colorado.edu)
+ * \date	10/19/2026
+ * \brief   Macros and function headers for binary sample streaming over UART0
+ * \detail
+ * 		Build with STREAM_EXPORT to send the DAC blocks and the samples the detector
+ * 		analyzes to a host (host/stream_rx.c writes them to CSV and WAV). Blocks are
+ * 		copied into frames from the main loop and DMA channel 2 feeds the frames to
+ * 		UART0, so sampling never waits on the link: when every frame is in use, the
+ * 		block is dropped and counted. Console text still goes out between frames.
+ *
+ * 		Frame, little-endian:
+ * 			0xAA, 0x55, source, bits per sample, sequence (2), sample count (2),
+ * 			index of the first sample in its source (4), sample rate in Hz (4),
+ * 			samples (2 each), CRC-16/CCITT-FALSE of everything after the sync bytes (2)
+ *
+ * 		Sequence numbers count every frame sent, so lost frames show up as a jump;
+ * 		the sample index shows where the samples sit in their source.
+ *
+ * 		OpenSDA's virtual COM port can't keep up with STREAM_BAUD_RATE. Capture with a
+ * 		3.3 V USB serial adapter on PTA2 (UART0_TX) instead.
+ */
+
+#ifndef STREAM_H_
+#define STREAM_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * \def		STREAM_BAUD_RATE
+ * \brief	UART0 baud rate while streaming: 48 MHz / (16 * 1), or 300 kB/s of frames
+ */
+#ifndef STREAM_BAUD_RATE
+#define STREAM_BAUD_RATE\
+	(3000000)
+#endif
+
+/**
+ * \def		STREAM_SYNC0
+ * \brief	First byte of every frame
+ */
+#define STREAM_SYNC0\
+	(0xAA)
+
+/**
+ * \def		STREAM_SYNC1
+ * \brief	Second byte of every frame
+ */
+#define STREAM_SYNC1\
+	(0x55)
+
+/**
+ * \def		STREAM_HEADER_SIZE
+ * \brief	Sync, source, bits, sequence, sample count, index and rate
+ */
+#define STREAM_HEADER_SIZE\
+	(16)
+
+/**
+ * \def		STREAM_CRC_SIZE
+ * \brief	Bytes of CRC at the end of a frame
+ */
+#define STREAM_CRC_SIZE\
+	(2)
+
+/**
+ * \def		STREAM_BLOCK_SAMPLES
+ * \brief	Most samples per frame. Longer blocks are split over several frames
+ */
+#define STREAM_BLOCK_SAMPLES\
+	(128)
+
+/**
+ * \def		STREAM_FRAME_SIZE
+ * \brief	Bytes in a full frame
+ */
+#define STREAM_FRAME_SIZE\
+	(STREAM_HEADER_SIZE + 2 * STREAM_BLOCK_SAMPLES + STREAM_CRC_SIZE)
+
+/**
+ * \def		STREAM_FRAMES
+ * \brief	Frames that can be queued for the DMA. Must be a power of 2
+ */
+#define STREAM_FRAMES\
+	(8)
+
+/**
+ * \def		STREAM_MAX_SOURCES
+ * \brief	Number of sources a stream can carry
+ */
+#define STREAM_MAX_SOURCES\
+	(4)
+
+/**
+ * \def		STREAM_SOURCE_DAC
+ * \brief	Source of the DAC blocks
+ */
+#define STREAM_SOURCE_DAC\
+	(0)
+
+/**
+ * \def		STREAM_SOURCE_ADC
+ * \brief	Source of the first ADC input. The other scanned inputs follow
+ */
+#define STREAM_SOURCE_ADC\
+	(1)
+
+/**
+ * \fn		uint16_t stream_crc16
+ * \param	uint16_t crc 0xFFFF to start
+ * \param	const uint8_t *data
+ * \param	uint32_t n
+ * \return	The CRC-16/CCITT-FALSE of the data so far
+ */
+uint16_t stream_crc16(uint16_t crc, const uint8_t *data, uint32_t n);
+
+/**
+ * \fn		void init_stream
+ * \param	uint32_t baud UART0 baud rate, see STREAM_BAUD_RATE
+ * \return	N/A
+ * \brief   Lets queued console output out, switches UART0 to the streaming baud rate and
+ * 			sets up DMA channel 2 to feed it
+ */
+void init_stream(uint32_t baud);
+
+/**
+ * \fn		void stream_source
+ * \param	uint32_t source Below STREAM_MAX_SOURCES
+ * \param	uint8_t bits Significant bits per sample
+ * \param	uint32_t rate_hz Sample rate, for the receiver
+ * \return	N/A
+ * \brief   Describes a source before its first block
+ */
+void stream_source(uint32_t source, uint8_t bits, uint32_t rate_hz);
+
+/**
+ * \fn		uint32_t stream_block
+ * \param	uint32_t source
+ * \param	const int16_t *ring Samples, in place in a ring
+ * \param	uint32_t mask Ring size - 1, or 0xFFFFFFFF for a linear buffer
+ * \param	uint32_t start Index of the first sample in the ring
+ * \param	uint32_t n Samples in the block
+ * \param	uint32_t index Position of the first sample in the source, for the receiver
+ * \return	Samples queued. The rest were dropped for want of a free frame
+ * \brief   Copies a block into frames and starts sending them. Never waits
+ */
+uint32_t stream_block(uint32_t source, const int16_t *ring, uint32_t mask, uint32_t start, uint32_t n, uint32_t index);
+
+/**
+ * \fn		void stream_service
+ * \param	N/A
+ * \return	N/A
+ * \brief   Starts queued frames that had to wait for console output. Call from the main loop
+ */
+void stream_service(void);
+
+/**
+ * \fn		void stream_report
+ * \param	N/A
+ * \return	N/A
+ * \brief   Prints frames and samples sent and dropped
+ */
+void stream_report(void);
+
+/**
+ * \fn		void DMA2_IRQHandler
+ * \param	N/A
+ * \return	N/A
+ * \brief   The ISR for DMA channel 2, which runs each time a frame has gone to UART0
+ * \detail	FUNCTION NAME IS CASE SENSITIVE. Since it is weakly defined in
+ * 			startup\startup_mkl25z4.c this definition will override
+ */
+void DMA2_IRQHandler(void);
+
+#endif /* STREAM_H_ */
@@ -16,15 +16,10 @@
  * User-defined libraries
  */
 #include "bitops.h"
+#include "instr.h"
+#include "irq.h"
 #include "systick.h"
 
-/**
- * \def		MSEC_PER_SEC
- * \brief	Used for unit conversions
- */
-#define MSEC_PER_SEC\
-	(1000)
-
 /**
  * \def		PRIM_CLOCK_HZ
  * \brief	Frequency of primary processor clock source in Hz. For KL25Z, this is 48 MHz
@@ -39,6 +34,21 @@
 #define ALT_CLOCK_HZ\
 	(3000000UL)
 
+/**
+ * \def		SYSTICK_EXT_CLOCK_DIV
+ * \brief	The external reference clock is the core clock divided by 16
+ */
+#define SYSTICK_EXT_CLOCK_DIV\
+	(16)
+
+/**
+ * \def		SYSTICK_RELOAD
+ * \brief	Largest 24-bit reload: a wrap every 2^24 / ALT_CLOCK_HZ, ~5.6 s. A power of two,
+ * 			so systick_timestamp() stays continuous when its 32 bits wrap
+ */
+#define SYSTICK_RELOAD\
+	(SysTick_LOAD_RELOAD_Msk)
+
 /**
  * \def		SysTick_CTRL_CLKSOURCE_EXT_Msk
  * \brief	The CLKSOURCE field selects the clock source, which can be either the processor
@@ -50,35 +60,62 @@
 	(0UL << SysTick_CTRL_CLKSOURCE_Pos)
 
 /**
- * \var		ticktime_t ticks_since_startup
- * \brief	Ticks since boot
+ * \var		systick_wraps
+ * \brief	SysTick reloads since init_onboard_systick, counted in SysTick_Handler so that
+ * 			none are lost while the main loop is busy
+ */
+static volatile uint32_t systick_wraps = 0;
+
+/**
+ * \var		systick_base
+ * \brief	systick_timestamp() when SysTick was last retimed
  */
-volatile ticktime_t ticks_since_startup = 0;
+static uint32_t systick_base = 0;
 
 /**
- * \var		ticktime_t ticks_since_last_note
- * \brief	Ticks since the last note was played
+ * \var		systick_scale
+ * \brief	SYSTICK_TIMESTAMP_HZ counts per SysTick count: 1 on the 48 MHz core clock, more
+ * 			on a slower one
  */
-volatile ticktime_t ticks_since_last_note = 0;
+static uint32_t systick_scale = 1;
 
 /**
- * \var		volatile bool tick
- * \brief	Flag controlled by SysTick timer
+ * \fn		uint32_t systick_since_wrap
+ * \param	N/A
+ * \return	Core clock cycles since SysTick last reached 0, to within SYSTICK_EXT_CLOCK_DIV
+ * \brief   VAL sits at 0 for one count before the reload, so the interrupt can find it
+ * 			there or counting down from LOAD
  */
-volatile bool tick = false;
+static inline uint32_t systick_since_wrap(void)
+{
+	uint32_t val = SysTick->VAL;
+
+	if(val == 0){
+		return 0;
+	}
+	return ((SysTick->LOAD & SysTick_LOAD_RELOAD_Msk) + 1 - val) * SYSTICK_EXT_CLOCK_DIV;
+}
 
 void init_onboard_systick(void)
 {
+	/**
+	 * Already counting since ResetISR: leave it be, so systick_timestamp() carries on
+	 * from reset
+	 */
+	if(SysTick->CTRL & SysTick_CTRL_ENABLE_Msk){
+		return;
+	}
+
     /**
      * Configure the SysTick LOAD register:
-     * 	- To generate interrupt every TICK_SEC
+     * 	- To count as long as it can between interrupts
      */
-	SysTick->LOAD = ((ALT_CLOCK_HZ - 1) * TICK_SEC);
+	SysTick->LOAD = SYSTICK_RELOAD;
 
 	/**
-     * Set the SysTick interrupt priority (range 0 to 3, with 0 being highest priority)
+     * Set the SysTick interrupt priority from the plan in irq.h
      */
-	NVIC_SetPriority(SysTick_IRQn, 3);
+	NVIC_SetPriority(SysTick_IRQn, IRQ_PRIORITY_SYSTICK);
 
 	/**
      * Configure SysTick VAL register:
@@ -103,16 +140,68 @@ void init_onboard_systick(void)
 
 void SysTick_Handler(void)
 {
+	uint32_t entry = INSTR_IRQ_STAMP(systick_since_wrap());
+
     /**
-     * Raise flag that TICK_SEC time has passed
+     * Count the wrap for systick_timestamp()
      */
-	tick = true;
+	systick_wraps++;
+
+	INSTR_IRQ(INSTR_IRQ_SYSTICK, entry, INSTR_IRQ_STAMP(systick_since_wrap()) - entry);
 }
 
-volatile uint32_t now(void)
+uint32_t systick_timestamp(void)
 {
-    /**
-     * Convert ticks to sec, and then sec to ms
-     */
-	return((ticks_since_startup * TICK_SEC * MSEC_PER_SEC));
+	uint32_t wraps;
+	uint32_t val;
+	uint32_t load = SysTick->LOAD;
+	bool pending;
+
+	/**
+	 * Retry if SysTick_Handler ran in between, so wraps and VAL belong together
+	 */
+	do{
+		wraps = systick_wraps;
+		val = SysTick->VAL;
+
+		/**
+		 * Reloaded but SysTick_Handler hasn't run yet (interrupts masked, or called from
+		 * a handler SysTick can't preempt): count the wrap here, against a VAL read after it
+		 */
+		pending = (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) != 0;
+		if(pending){
+			val = SysTick->VAL;
+		}
+	}while(wraps != systick_wraps);
+
+	if(pending){
+		wraps++;
+	}
+
+	/**
+	 * SysTick pends on reaching 0 and reloads on the next count, so a VAL of 0 is the
+	 * first count of the new period rather than the last of the old one. It is also
+	 * what VAL reads before the first reload
+	 */
+	return systick_base + (wraps * (load + 1) + ((val != 0) ? (load + 1 - val) : 0)) * systick_scale;
+}
+
+bool systick_retime(uint32_t core_hz)
+{
+	uint32_t ext_hz = core_hz / SYSTICK_EXT_CLOCK_DIV;
+
+	if((ext_hz == 0) || (ext_hz > SYSTICK_TIMESTAMP_HZ) || (SYSTICK_TIMESTAMP_HZ % ext_hz)){
+		return false;
+	}
+
+	/**
+	 * Carry on from where the old rate got to. Writing VAL clears it and starts a new
+	 * period, which mustn't count as a wrap
+	 */
+	systick_base = systick_timestamp();
+	SysTick->VAL = 0;
+	SCB->ICSR = SCB_ICSR_PENDSTCLR_Msk;
+	systick_wraps = 0;
+	systick_scale = SYSTICK_TIMESTAMP_HZ / ext_hz;
+	return true;
 }
@@ -8,50 +8,25 @@
 #ifndef SYSTICK_H_
 #define SYSTICK_H_
 
-/**
- * \def		TICK_HZ
- * \brief	The frequency at which SysTick interrupts should be raised in Hz
- */
-#define TICK_HZ\
-	(16)
-
-/**
- * \def		TICK_SEC
- * \brief	The period between SysTick interrupts in sec
- */
-#define TICK_SEC\
-	(1.0/TICK_HZ)
-
-/**
- * \typedef	typedef unsigned int ticktime_t
- * \brief   Time since boot, where each tick is 1 / ALT_CLOCK_HZ or 1 / PRIM_CLOCK_HZ, depending
- * 			on what's configured
- */
-typedef unsigned int ticktime_t;
-
-/**
- * \var		ticktime_t ticks_since_startup
- * \brief	Defined in systick.c
- */
-extern volatile ticktime_t ticks_since_startup;
+#include <stdbool.h>
+#include <stdint.h>
 
 /**
- * \var		ticktime_t ticks_since_last_note
- * \brief	Defined in systick.c
+ * \def		SYSTICK_TIMESTAMP_HZ
+ * \brief	Rate of systick_timestamp(): SysTick counts on the external reference clock,
+ * 			the 48 MHz core clock over 16. On a slower core clock (see systick_retime)
+ * 			each count stands for several of these
  */
-extern volatile ticktime_t ticks_since_last_note;
-
-/**
- * \var		extern volatile bool tick
- * \brief	Defined in systick.c
- */
-extern volatile bool tick;
+#define SYSTICK_TIMESTAMP_HZ\
+	(3000000UL)
 
 /**
  * \fn		void init_onboard_systick
  * \param	N/A
  * \return	N/A
- * \brief   Initialize the timing system
+ * \brief   Initialize the timing system. SysTick runs its full 24 bits, so it only
+ * 			interrupts every ~5.6 s to count a wrap; timed work goes through event.h.
+ * 			ResetISR calls it first thing, later calls leave SysTick running
  */
 void init_onboard_systick(void);
 
@@ -66,28 +41,22 @@ void init_onboard_systick(void);
 void SysTick_Handler(void);
 
 /**
- * \fn		uint32_t now
- * \param	N/A
- * \return	Time since startup in ms
- * \brief   Returns time since startup, in ms
- */
-volatile uint32_t now(void);
-
-/**
- * \fn		void reset_timer
+ * \fn		uint32_t systick_timestamp
  * \param	N/A
- * \return	N/A
- * \brief   Resets timer to 0; doesn't affect now() values
+ * \return	SysTick counts since init_onboard_systick, at SYSTICK_TIMESTAMP_HZ once the
+ * 			core clock is set up (see boot.h). Wraps after about 23 minutes
+ * \brief   Fine-grained time since startup, usable from any context
  */
-void reset_timer(void);
+uint32_t systick_timestamp(void);
 
 /**
- * \fn		ticktime_t get_timer
- * \param	N/A
- * \return	Ticks since the last call to reset_timer()
- * \brief   Returns ticks since the last call to reset_timer()
+ * \fn		bool systick_retime
+ * \param	uint32_t core_hz The core clock from now on
+ * \return	true if core_hz / 16 divides SYSTICK_TIMESTAMP_HZ, false (and nothing
+ * 			changed) if not
+ * \brief   Keeps systick_timestamp() counting at SYSTICK_TIMESTAMP_HZ on a new core clock
+ * 			(see clocks.h), carrying on from where it was. Call with interrupts masked
  */
-ticktime_t get_timer(void);
-
+bool systick_retime(uint32_t core_hz);
 
 #endif /* SYSTICK_H_ */
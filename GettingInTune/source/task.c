@@ -0,0 +1,140 @@
+/**
+ * \file    task.c
+ * \author	Dayton Flores (dafl2542@colorado.edu)
+ * \date	10/19/2026
+ * \brief   Function definitions for the cooperative task framework
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * User-defined libraries
+ */
+#include "critical.h"
+#include "dlog.h"
+#include "event.h"
+#include "idle.h"
+#include "instr.h"
+#include "task.h"
+
+_Static_assert((TASK_QUEUE_LEN & (TASK_QUEUE_LEN - 1)) == 0, "TASK_QUEUE_LEN must be a power of 2");
+
+/**
+ * \var		task_list
+ * \brief	Every task, highest priority first
+ */
+static task_t *task_list = NULL;
+
+void task_init(task_t *task, const char *name, uint32_t priority, task_fn_t fn)
+{
+	task_t **link = &task_list;
+
+	task->name = name;
+	task->priority = priority;
+	task->fn = fn;
+	spsc_init(&task->queue, task->queue_slots, sizeof(task_event_t), TASK_QUEUE_LEN);
+	spsc_init(&task->inbox, task->inbox_slots, sizeof(task_event_t), TASK_QUEUE_LEN);
+	task->runs = 0;
+	task->wcet = 0;
+
+	while((*link != NULL) && ((*link)->priority <= priority)){
+		link = &(*link)->next;
+	}
+	task->next = *link;
+	*link = task;
+}
+
+bool task_post(task_t *task, uint16_t signal, int16_t param)
+{
+	task_event_t event = { signal, param };
+
+	return spsc_put(&task->queue, &event);
+}
+
+bool task_post_isr(task_t *task, uint16_t signal, int16_t param)
+{
+	task_event_t event = { signal, param };
+
+	return spsc_put(&task->inbox, &event);
+}
+
+bool task_run(void)
+{
+	task_t *task = task_list;
+	task_event_t event;
+	uint64_t start;
+	uint32_t cycles;
+
+	while((task != NULL) && !spsc_get(&task->inbox, &event) && !spsc_get(&task->queue, &event)){
+		task = task->next;
+	}
+	if(task == NULL){
+		return false;
+	}
+
+	/**
+	 * Includes whatever interrupts come in during the run, which is what the other
+	 * tasks wait for
+	 */
+	start = event_now();
+	task->fn(event);
+	cycles = instr_cycles((uint32_t)(event_now() - start));
+
+	task->runs++;
+	if(cycles > task->wcet){
+		task->wcet = cycles;
+	}
+	return true;
+}
+
+bool task_ready(void)
+{
+	for(task_t *task = task_list; task != NULL; task = task->next){
+		if(spsc_count(&task->inbox) || spsc_count(&task->queue)){
+			return true;
+		}
+	}
+	return false;
+}
+
+void task_sleep(void)
+{
+	/**
+	 * With interrupts masked one that comes in after the checks still ends the idle,
+	 * and is taken once they are unmasked
+	 */
+	uint32_t primask = critical_enter();
+
+	if(!task_ready() && !event_due()){
+		idle_wait();
+	}
+	critical_exit(primask);
+}
+
+void task_reset(void)
+{
+	for(task_t *task = task_list; task != NULL; task = task->next){
+		task->queue.max = spsc_count(&task->queue);
+		task->queue.drops = 0;
+		task->inbox.max = spsc_count(&task->inbox);
+		task->inbox.drops = 0;
+		task->runs = 0;
+		task->wcet = 0;
+	}
+}
+
+void task_report(void)
+{
+	for(task_t *task = task_list; task != NULL; task = task->next){
+		DLOG_AT(DLOG_LEVEL_OFF, "task: %-9s priority %u, runs = %u, wcet = %u cycles, queue max = %u, inbox max = %u, drops = %u\r\n",
+				DLOG_STRING(task->name),
+				(unsigned)task->priority,
+				(unsigned)task->runs,
+				(unsigned)task->wcet,
+				(unsigned)task->queue.max,
+				(unsigned)task->inbox.max,
+				(unsigned)(task->queue.drops + task->inbox.drops));
+	}
+}
@@ -0,0 +1,162 @@
+/**
+ * \file    task.h
+ * \author	Dayton Flores (dafl2542@colorado.edu)
+ * \date	10/19/2026
+ * \brief   Macros and function headers for the cooperative task framework
+ * \detail
+ * 		A task is a function that handles one event at a time and returns, plus two
+ * 		bounded queues of events waiting for it (spsc.h): one for task_post() from the
+ * 		main loop, event callbacks (event.h) and other tasks, and an inbox for
+ * 		task_post_isr() from one ISR. Neither needs interrupts masked. task_run() runs
+ * 		the oldest event of the highest-priority task that has any, inbox first, so a
+ * 		long stage only ever delays the others by one event, and work is split into as
+ * 		many events as it needs to be.
+ *
+ * 		A full queue drops the new event and counts it. A burst from an ISR is queued
+ * 		up to TASK_QUEUE_LEN deep, so nothing is lost unless the task falls that far
+ * 		behind.
+ *
+ * 		Each task's worst-case execution time per event, queue high-water marks and
+ * 		drops are kept for task_report().
+ */
+
+#ifndef TASK_H_
+#define TASK_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * User-defined libraries
+ */
+#include "spsc.h"
+
+/**
+ * \def		TASK_QUEUE_LEN
+ * \brief	Events each task can have waiting. Must be a power of 2
+ */
+#define TASK_QUEUE_LEN\
+	(8)
+
+/**
+ * \typedef	typedef struct task_event_s task_event_t
+ * \brief   Easily declare task events
+ */
+typedef struct task_event_s task_event_t;
+
+/**
+ * \struct	struct task_event_s
+ * \brief   What happened, and one value to go with it
+ */
+struct task_event_s{
+	uint16_t signal;	/* Meaning is up to the task */
+	int16_t param;
+};
+
+/**
+ * \typedef	typedef void (*task_fn_t)(task_event_t event)
+ * \brief   Handles one event and returns
+ */
+typedef void (*task_fn_t)(task_event_t event);
+
+/**
+ * \typedef	typedef struct task_s task_t
+ * \brief   Easily declare tasks
+ */
+typedef struct task_s task_t;
+
+/**
+ * \struct	struct task_s
+ * \brief   One task. Only touched through the functions below
+ */
+struct task_s{
+	task_t *next;
+	const char *name;
+	task_fn_t fn;
+	uint32_t priority;					/* 0 is the highest */
+	spsc_t queue;						/* From the main loop */
+	spsc_t inbox;						/* From one ISR */
+	task_event_t queue_slots[TASK_QUEUE_LEN];
+	task_event_t inbox_slots[TASK_QUEUE_LEN];
+	uint32_t runs;
+	uint32_t wcet;						/* Longest run, in core cycles */
+};
+
+/**
+ * \fn		void task_init
+ * \param	task_t *task Must stay valid for as long as the firmware runs
+ * \param	const char *name For task_report
+ * \param	uint32_t priority 0 is the highest. Tasks with equal priority run in the order
+ * 			they were added
+ * \param	task_fn_t fn
+ * \return	N/A
+ * \brief   Adds a task with an empty queue. Call from the main loop, before anything
+ * 			posts to it
+ */
+void task_init(task_t *task, const char *name, uint32_t priority, task_fn_t fn);
+
+/**
+ * \fn		bool task_post
+ * \param	task_t *task
+ * \param	uint16_t signal
+ * \param	int16_t param
+ * \return	true if the event was queued, false if the queue was full
+ * \brief   Queues an event for task. Only from the main loop, including event callbacks
+ * 			and tasks
+ */
+bool task_post(task_t *task, uint16_t signal, int16_t param);
+
+/**
+ * \fn		bool task_post_isr
+ * \param	task_t *task
+ * \param	uint16_t signal
+ * \param	int16_t param
+ * \return	true if the event was queued, false if the inbox was full
+ * \brief   Queues an event in task's inbox. Only from one ISR per task, the inbox's
+ * 			producer
+ */
+bool task_post_isr(task_t *task, uint16_t signal, int16_t param);
+
+/**
+ * \fn		bool task_run
+ * \param	N/A
+ * \return	true if an event was run, false if no task had one
+ * \brief   Runs one event of the highest-priority task that has one. Call from the
+ * 			main loop
+ */
+bool task_run(void);
+
+/**
+ * \fn		bool task_ready
+ * \param	N/A
+ * \return	true if any task has an event waiting
+ */
+bool task_ready(void);
+
+/**
+ * \fn		void task_sleep
+ * \param	N/A
+ * \return	N/A
+ * \brief   Idles (idle.h) until an interrupt, unless a task has an event waiting or a
+ * 			scheduler event is due. Call at the end of each pass of the main loop
+ */
+void task_sleep(void);
+
+/**
+ * \fn		void task_reset
+ * \param	N/A
+ * \return	N/A
+ * \brief   Zeroes every task's statistics. An ISR posting meanwhile can leave its
+ * 			inbox's high-water mark or drops stale by one event
+ */
+void task_reset(void);
+
+/**
+ * \fn		void task_report
+ * \param	N/A
+ * \return	N/A
+ * \brief   Sends every task's statistics through DLOG, whatever the log level
+ */
+void task_report(void);
+
+#endif /* TASK_H_ */
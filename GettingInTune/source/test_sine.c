@@ -6,6 +6,7 @@
  */
 #include <stdio.h>
 #include <math.h>
+#include "fsl_debug_console.h"
 
 #include "fp_trig.h"
 #include "test_sine.h"
@@ -41,10 +42,10 @@ void test_sin()
     sum_sq += err*err;
   }
 
-  printf("max_err=%f  sum_sq=%f\n\r", max_err, sum_sq);
+  PRINTF("max_err=%f  sum_sq=%f\n\r", max_err, sum_sq);
 
   if (max_err > 2.0 || sum_sq > 12000)
   {
-	  printf("Error: Do not proceed. Your sine function needs work\n\r");
+	  PRINTF("Error: Do not proceed. Your sine function needs work\n\r");
   }
 }
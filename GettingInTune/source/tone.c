@@ -7,7 +7,10 @@
 
 #include <stdio.h>
 #include "board.h"
+#include "dac.h"
 #include "fp_trig.h"
+#include "note.h"
+#include "section.h"
 #include "tone.h"
 
 /**
@@ -102,34 +105,40 @@
 
 /**
  * \var		samples_a4
- * \brief	Buffer to hold audio out samples for 1 period of tone A4
+ * \brief	Buffer to hold audio out samples for 1 period of tone A4. fp_sin stays within
+ * 			+/-TRIG_SCALE_FACTOR, so 16 bits hold every table
  */
-int32_t samples_a4[SAMPLES_PER_PERIOD_A4];
+int16_t samples_a4[SAMPLES_PER_PERIOD_A4];
 
 /**
  * \var		samples_d5
  * \brief	Buffer to hold audio out data for tone D5
  */
-int32_t samples_d5[SAMPLES_PER_PERIOD_D5];
+int16_t samples_d5[SAMPLES_PER_PERIOD_D5];
 
 /**
  * \var		samples_e5
  * \brief	Buffer to hold audio out data for tone E5
  */
-int32_t samples_e5[SAMPLES_PER_PERIOD_E5];
+int16_t samples_e5[SAMPLES_PER_PERIOD_E5];
 
 /**
  * \var		samples_a5
  * \brief	Buffer to hold audio out data for tone A5
  */
-int32_t samples_a5[SAMPLES_PER_PERIOD_A5];
+int16_t samples_a5[SAMPLES_PER_PERIOD_A5];
+
+/**
+ * \var		tone_hold
+ * \brief	Keeps the tone in dac_buffer instead of stepping to the next note every second
+ */
+bool tone_hold = false;
 
 /**
  * \var		dac_buffer
  * \brief	Buffer to hold samples for DMA's source
  */
-int16_t dac_buffer[DAC_BUF_SIZE];
-int16_t dac_buffer_test[DAC_BUF_SIZE];
+int16_t *dac_buffer = NULL;
 
 /**
  * \var		dac_buffer_samples_per_period
@@ -159,7 +168,7 @@ int32_t dac_buffer_samples;
  * \var		adc_buffer
  * \brief	Buffer to hold samples from ADC reading
  */
-int16_t adc_buffer[ADC_BUF_SIZE];
+int16_t *adc_buffer = NULL;
 
 /**
  * \var		adc_buffer_i
@@ -196,7 +205,7 @@ void tone_to_samples(void)
 		 * the rest of the buffer
 		 */
 		if(i < SAMPLES_PER_PERIOD_A4){
-			samples_a4[i] = fp_sin(fp_radians((uint32_t)(deg_a4)));
+			samples_a4[i] = (int16_t)fp_sin(fp_radians((uint32_t)(deg_a4)));
 			deg_a4 += step_a4;
 			//printf("a4 %d %d\r\n", i, samples_a4[i]);
 		}
@@ -206,7 +215,7 @@ void tone_to_samples(void)
 		 * the rest of the buffer
 		 */
 		if(i < SAMPLES_PER_PERIOD_D5){
-			samples_d5[i] = fp_sin(fp_radians((uint32_t)(deg_d5)));
+			samples_d5[i] = (int16_t)fp_sin(fp_radians((uint32_t)(deg_d5)));
 			deg_d5 += step_d5;
 			//printf("d5 %d %d\r\n", i, samples_d5[i]);
 		}
@@ -216,7 +225,7 @@ void tone_to_samples(void)
 		 * the rest of the buffer
 		 */
 		if(i < SAMPLES_PER_PERIOD_E5){
-			samples_e5[i] = fp_sin(fp_radians((uint32_t)(deg_e5)));
+			samples_e5[i] = (int16_t)fp_sin(fp_radians((uint32_t)(deg_e5)));
 			deg_e5 += step_e5;
 			//printf("e5 %d %d\r\n", i, samples_e5[i]);
 		}
@@ -226,17 +235,39 @@ void tone_to_samples(void)
 		 * the rest of the buffer
 		 */
 		if(i < SAMPLES_PER_PERIOD_A5){
-			samples_a5[i] = fp_sin(fp_radians((uint32_t)(deg_a5)));
+			samples_a5[i] = (int16_t)fp_sin(fp_radians((uint32_t)(deg_a5)));
 			deg_a5 += step_a5;
 			//printf("a5 %d %d\r\n", i, samples_a5[i]);
 		}
 	}
 }
 
-void fill_dac_buffer(tone_t tone)
+/**
+ * \fn		int32_t repeat_period
+ * \param	const int16_t *period One period of samples, may be the start of dac_buffer
+ * \param	int32_t samples_per_period
+ * \return	Number of whole periods in dac_buffer
+ * \brief   Fills dac_buffer with period over and over. Runs from SRAM, see section.h
+ */
+static RAMFUNC int32_t repeat_period(const int16_t *period, int32_t samples_per_period)
 {
+	int32_t full_periods = 0;
 	int i;
 	int j;
+
+	for(i = 0, j = 0; i < DAC_BUF_SIZE; i++, j++){
+		if(j >= samples_per_period){
+			j = 0;
+			full_periods++;
+		}
+
+		dac_buffer[i] = period[j];
+	}
+	return full_periods;
+}
+
+void fill_dac_buffer(tone_t tone)
+{
 	dac_buffer_full_periods = 0;
 	switch(tone){
 
@@ -246,15 +277,7 @@ void fill_dac_buffer(tone_t tone)
 	case A4:
 		dac_buffer_samples_per_period = SAMPLES_PER_PERIOD_A4;
 		dac_buffer_hz = A4_HZ;
-		for(i = 0, j = 0; i < DAC_BUF_SIZE; i++, j++){
-			if(j >= SAMPLES_PER_PERIOD_A4){
-				j = 0;
-				dac_buffer_full_periods++;
-			}
-
-			dac_buffer[i] = samples_a4[j];
-			//printf("a4 %d %d\r\n", i, dac_buffer[i]);
-		}
+		dac_buffer_full_periods = repeat_period(samples_a4, SAMPLES_PER_PERIOD_A4);
 		dac_buffer_samples = dac_buffer_samples_per_period * dac_buffer_full_periods;
 		break;
 
@@ -264,15 +287,7 @@ void fill_dac_buffer(tone_t tone)
 	case D5:
 		dac_buffer_samples_per_period = SAMPLES_PER_PERIOD_D5;
 		dac_buffer_hz = D5_HZ;
-		for(i = 0, j = 0; i < DAC_BUF_SIZE; i++, j++){
-			if(j >= SAMPLES_PER_PERIOD_D5){
-				j = 0;
-				dac_buffer_full_periods++;
-			}
-
-			dac_buffer[i] = samples_d5[j];
-			//printf("d5 %d %d\r\n", i, dac_buffer[i]);
-		}
+		dac_buffer_full_periods = repeat_period(samples_d5, SAMPLES_PER_PERIOD_D5);
 		dac_buffer_samples = dac_buffer_samples_per_period * dac_buffer_full_periods;
 		break;
 
@@ -282,15 +297,7 @@ void fill_dac_buffer(tone_t tone)
 	case E5:
 		dac_buffer_samples_per_period = SAMPLES_PER_PERIOD_E5;
 		dac_buffer_hz = E5_HZ;
-		for(i = 0, j = 0; i < DAC_BUF_SIZE; i++, j++){
-			if(j >= SAMPLES_PER_PERIOD_E5){
-				j = 0;
-				dac_buffer_full_periods++;
-			}
-
-			dac_buffer[i] = samples_e5[j];
-			//printf("e5 %d %d\r\n", i, dac_buffer[i]);
-		}
+		dac_buffer_full_periods = repeat_period(samples_e5, SAMPLES_PER_PERIOD_E5);
 		dac_buffer_samples = dac_buffer_samples_per_period * dac_buffer_full_periods;
 		break;
 
@@ -300,15 +307,7 @@ void fill_dac_buffer(tone_t tone)
 	case A5:
 		dac_buffer_samples_per_period = SAMPLES_PER_PERIOD_A5;
 		dac_buffer_hz = A5_HZ;
-		for(i = 0, j = 0; i < DAC_BUF_SIZE; i++, j++){
-			if(j >= SAMPLES_PER_PERIOD_A5){
-				j = 0;
-				dac_buffer_full_periods++;
-			}
-
-			dac_buffer[i] = samples_a5[j];
-			//printf("a5 %d %d\r\n", i, dac_buffer[i]);
-		}
+		dac_buffer_full_periods = repeat_period(samples_a5, SAMPLES_PER_PERIOD_A5);
 		dac_buffer_samples = dac_buffer_samples_per_period * dac_buffer_full_periods;
 		break;
 
@@ -320,6 +319,58 @@ void fill_dac_buffer(tone_t tone)
 	}
 }
 
+/**
+ * \fn		bool fill_dac_buffer_period
+ * \param	int32_t period Samples per period at SAMPLE_RATE_DAC_HZ
+ * \param	uint32_t hz What dac_buffer_hz reports
+ * \return	true if the DAC buffer now holds the tone, false if period is out of range
+ */
+static bool fill_dac_buffer_period(int32_t period, uint32_t hz)
+{
+	int i;
+
+	if((period < TONE_MIN_SAMPLES_PER_PERIOD) || (period >= DAC_BUF_SIZE)){
+		return false;
+	}
+
+	/**
+	 * Compute 1 period straight into the DAC buffer, then repeat it until the
+	 * DAC buffer is filled up
+	 */
+	for(i = 0; i < period; i++){
+		dac_buffer[i] = fp_sin(i * TWO_PI / period);
+	}
+	dac_buffer_samples_per_period = period;
+	dac_buffer_hz = hz;
+	dac_buffer_full_periods = repeat_period(dac_buffer, period);
+	dac_buffer_samples = dac_buffer_samples_per_period * dac_buffer_full_periods;
+	return true;
+}
+
+bool fill_dac_buffer_hz(uint32_t hz)
+{
+	if(hz == 0){
+		return false;
+	}
+	return fill_dac_buffer_period(SAMPLE_RATE_DAC_HZ / hz, hz);
+}
+
+bool fill_dac_buffer_note(uint32_t midi)
+{
+	const note_t *note = note_from_midi(midi);
+
+	if(note == NULL){
+		return false;
+	}
+
+	/**
+	 * The period rounded from the note's phase step, rather than truncated from its
+	 * whole Hz
+	 */
+	return fill_dac_buffer_period((int32_t)((0x100000000ULL + note->dac_step / 2) / note->dac_step),
+			(note->hz_q16 + 0x8000) >> 16);
+}
+
 void fill_adc_buffer(void)
 {
 	/**
@@ -17,10 +17,20 @@
 
 /**
  * \def		ADC_BUF_SIZE
- * \brief	Size of the ADC sample buffer for each tone
+ * \brief	Size of the ADC sample buffer for each tone, ~21.3 ms at SAMPLE_RATE_ADC_HZ, two
+ * 			periods down to ~94 Hz. The largest power of 2 that fits the SRAM budget
+ * 			(arena.h). The detector stops at the first peak, so its work is the period
+ * 			times this, and the gate keeps silent blocks from reaching it
  */
 #define ADC_BUF_SIZE\
-	(1024)
+	(2048)
+
+/**
+ * \def		TONE_MIN_SAMPLES_PER_PERIOD
+ * \brief	Shortest period fill_dac_buffer_hz will generate, which sets the highest frequency
+ */
+#define TONE_MIN_SAMPLES_PER_PERIOD\
+	(4)
 
 /**
  * \typedef	typedef enum tone_e tone_t
@@ -40,11 +50,22 @@ enum tone_e{
 };
 
 /**
- * \var		dac_buffer
+ * \var		current_tone
+ * \brief	Defined in main.c
+ */
+extern tone_t current_tone;
+
+/**
+ * \var		tone_hold
  * \brief	Defined in tone.c
  */
-extern int16_t dac_buffer[DAC_BUF_SIZE];
-extern int16_t dac_buffer_test[DAC_BUF_SIZE];
+extern bool tone_hold;
+
+/**
+ * \var		dac_buffer
+ * \brief	Defined in tone.c. DAC_BUF_SIZE samples borrowed from the arena (arena.h)
+ */
+extern int16_t *dac_buffer;
 
 /**
  * \var		dac_buffer_samples_per_period
@@ -72,9 +93,10 @@ extern int32_t dac_buffer_samples;
 
 /**
  * \var		adc_buffer
- * \brief	Defined in tone.c
+ * \brief	Defined in tone.c. ADC_BUF_SIZE samples borrowed from the arena (arena.h),
+ * 			NULL while nothing captures
  */
-extern int16_t adc_buffer[ADC_BUF_SIZE];
+extern int16_t *adc_buffer;
 
 /**
  * \var		adc_buffer_i
@@ -108,6 +130,26 @@ void tone_to_samples(void);
  */
 void fill_dac_buffer(tone_t tone);
 
+/**
+ * \fn		bool fill_dac_buffer_hz
+ * \param	uint32_t hz
+ * \return	true if the DAC buffer now holds the tone, false if hz is out of range
+ * \brief   Stuffs DAC buffer with a sine of any frequency whose period at SAMPLE_RATE_DAC_HZ
+ * 			is between TONE_MIN_SAMPLES_PER_PERIOD and DAC_BUF_SIZE - 1 samples. Like the
+ * 			fixed tones, the period is truncated to whole samples
+ */
+bool fill_dac_buffer_hz(uint32_t hz);
+
+/**
+ * \fn		bool fill_dac_buffer_note
+ * \param	uint32_t midi MIDI note number, see note.h
+ * \return	true if the DAC buffer now holds the note, false if it isn't a piano key or
+ * 			its period is out of fill_dac_buffer_hz's range
+ * \brief   Stuffs DAC buffer with a note from the note table. The period is rounded to
+ * 			whole samples, and dac_buffer_hz is the note's frequency rounded
+ */
+bool fill_dac_buffer_note(uint32_t midi);
+
 /**
  * \fn		void fill_adc_buffer
  * \param	N/A
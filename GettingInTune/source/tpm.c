@@ -5,6 +5,9 @@
  * \brief   Function definitions for TPM (Timer PWM Module)
  */
 
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
 #include "board.h"
 #include "fsl_debug_console.h"
 
@@ -12,16 +15,10 @@
  * User-defined libraries
  */
 #include "bitops.h"
+#include "irq.h"
 #include "tone.h"
 #include "tpm.h"
 
-/**
- * \def		MAX_TPM_MOD_VALUE
- * \brief	The max division factor for 16-bit TPM->MOD register
- */
-#define MAX_TPM_MOD_VALUE\
-	(65536)
-
 /**
  * \def		TPM_CLOCK_SRC
  * \brief	Configuration for TPM clock source select
@@ -45,13 +42,6 @@
 #define TPM_DBGMODE\
 	(3)
 
-/**
- * \def		F_TPM_CLOCK_HZ
- * \brief	The frequency of TPM clock in Hz
- */
-#define F_TPM_CLOCK_HZ\
-	(48000000)
-
 /**
  * \def		SC_DMA
  * \brief	DMA Enable
@@ -63,28 +53,117 @@
 	(1)
 
 /**
- * \def		SC_PS
- * \brief	Prescale Factor Selection
- * \detail
- * 		000: Divide by 1
- * 		001: Divide by 2
- * 		010: Divide by 4
- * 		011: Divide by 8
- * 		100: Divide by 16
- * 		101: Divide by 32
- * 		110: Divide by 64
- * 		111: Divide by 128
+ * \def		TPM_AUDIO_COUNT
+ * \brief	TPMs init_onboard_tpm sets up: TPM0 for the DAC, TPM1 for the ADC
  */
-#define SC_PS\
-	(1)
+#define TPM_AUDIO_COUNT\
+	(2)
+
+/**
+ * \var		tpm_clock_hz
+ * \brief	Clock the TPMs count on now, see tpm_retime
+ */
+static uint32_t tpm_clock_hz = TPM_CLOCK_HZ;
+
+/**
+ * \var		tpm_audio
+ * \brief	TPM0 and TPM1, their names, the rates asked for and what they came to at
+ * 			TPM_CLOCK_HZ. A retimed TPM comes as near the rate as the new clock allows
+ */
+static struct{
+	TPM_Type *tpm;
+	const char *name;
+	uint32_t rate_hz;
+	tpm_rate_t rate;
+	bool paused;
+} tpm_audio[TPM_AUDIO_COUNT] = {
+	{ .tpm = TPM0, .name = "TPM0" },
+	{ .tpm = TPM1, .name = "TPM1" },
+};
+
+/**
+ * \var		tpm_started
+ * \brief	Set by start_onboard_tpm, so tpm_retime knows to restart what it stopped
+ */
+static bool tpm_started = false;
+
+/**
+ * \fn		uint64_t tpm_error
+ * \param	uint32_t clock_hz
+ * \param	uint32_t rate_hz
+ * \param	uint32_t divisor
+ * \return	|clock_hz - rate_hz * divisor|, which over divisor is the rate error in Hz
+ */
+static uint64_t tpm_error(uint32_t clock_hz, uint32_t rate_hz, uint32_t divisor)
+{
+	uint64_t product = (uint64_t)rate_hz * divisor;
+
+	return (product > clock_hz) ? (product - clock_hz) : (clock_hz - product);
+}
+
+bool tpm_solve(uint32_t clock_hz, uint32_t rate_hz, tpm_rate_t *rate)
+{
+	uint64_t best_error = 0;
+	uint32_t best = 0;
+
+	if((rate_hz == 0) || (rate_hz > clock_hz)){
+		return false;
+	}
+
+	for(uint32_t ps = 0; ps <= TPM_MAX_PS; ps++){
+		uint32_t counts = (uint32_t)(clock_hz / ((uint64_t)rate_hz << ps));
+
+		/**
+		 * The nearest rate for this prescaler is at counts or counts + 1. Errors are
+		 * compared as fractions, error / divisor, by cross-multiplying
+		 */
+		for(uint32_t n = counts; n <= counts + 1; n++){
+			uint32_t divisor = n << ps;
+			uint64_t error;
+
+			if((n == 0) || (n > TPM_MAX_COUNTS)){
+				continue;
+			}
+			error = tpm_error(clock_hz, rate_hz, divisor);
+			if((best == 0) || (error * best < best_error * divisor)){
+				best_error = error;
+				best = divisor;
+				rate->ps = ps;
+				rate->mod = n - 1;
+			}
+		}
+	}
+	if(best == 0){
+		return false;
+	}
+	rate->divisor = best;
+	rate->hz = (float)clock_hz / best;
+	return true;
+}
 
 /**
- * \var		uint8_t tpm_sc_ps;
- * \brief	Holds x for 2^x, where 2^x is the tpm_prescaler
+ * \fn		bool tpm_configure
+ * \param	uint32_t i Index into tpm_audio, whose TPM is disabled
+ * \param	uint32_t sc Other SC bits to set
+ * \return	true if the TPM is set up, false if its rate is out of reach
+ * \brief   Programs MOD and SC for the rate in tpm_audio. A rate out of reach leaves the
+ * 			TPM stopped
  */
-uint8_t tpm_sc_ps;
+static bool tpm_configure(uint32_t i, uint32_t sc)
+{
+	if(!tpm_solve(TPM_CLOCK_HZ, tpm_audio[i].rate_hz, &tpm_audio[i].rate)){
+		PRINTF("tpm: %s can't run at %u Hz from a %u Hz clock\r\n",
+				tpm_audio[i].name,
+				(unsigned)tpm_audio[i].rate_hz,
+				(unsigned)TPM_CLOCK_HZ);
+		return false;
+	}
+	tpm_audio[i].tpm->MOD = TPM_MOD_MOD(tpm_audio[i].rate.mod);
+	tpm_audio[i].tpm->SC = sc | TPM_SC_PS(tpm_audio[i].rate.ps);
+	return true;
+}
 
-void init_onboard_tpm(uint32_t dac_period_us, uint32_t adc_period_us)
+void init_onboard_tpm(uint32_t dac_rate_hz, uint32_t adc_rate_hz)
 {
 	/**
 	 * Enable clock to TPM module
@@ -108,27 +187,14 @@ void init_onboard_tpm(uint32_t dac_period_us, uint32_t adc_period_us)
 	TPM1->SC = 0;
 
 	/**
-     * Set the smallest needed prescaler for desired TPM period
-     */
-	//tpm_sc_ps = get_prescaler(period_us);
-
-	/**
-     * Load the TPM MOD register
-     */
-	TPM0->MOD = TPM_MOD_MOD(dac_period_us * 24);
-	TPM1->MOD = TPM_MOD_MOD(adc_period_us * 24);
-
-	/**
-     * Configure the TPM SC register:
-     * 	- Count up with divide by 2 prescaler
+     * Load the MOD and SC registers with the prescaler and MOD nearest each rate:
+     * 	- Count up
      * 	- DMA transfer enable (for DAC's TPM0 only)
      */
-	TPM0->SC =
-		TPM_SC_DMA(SC_DMA) |
-		TPM_SC_PS(SC_PS);
-	TPM1->SC =
-		//TPM_SC_DMA(SC_DMA) |
-		TPM_SC_PS(SC_PS);
+	tpm_audio[0].rate_hz = dac_rate_hz;
+	tpm_audio[1].rate_hz = adc_rate_hz;
+	tpm_audio[0].paused = !tpm_configure(0, TPM_SC_DMA(SC_DMA));
+	tpm_audio[1].paused = !tpm_configure(1, 0);
 
 	/**
      * Configure the TPM CONF register:
@@ -160,7 +226,7 @@ void init_onboard_tpm(uint32_t dac_period_us, uint32_t adc_period_us)
 	 * Enable interrupt for ADC's TPM1
 	 */
 	//TPM1->SC |= TPM_SC_TOIE_MASK;
-	NVIC_SetPriority(TPM1_IRQn, 128); // 0, 64, 128 or 192
+	NVIC_SetPriority(TPM1_IRQn, IRQ_PRIORITY_TPM1);
 	NVIC_ClearPendingIRQ(TPM1_IRQn);
 	NVIC_EnableIRQ(TPM1_IRQn);
 }
@@ -171,8 +237,74 @@ void start_onboard_tpm(void)
      * Configure the TPM SC register:
      * 	- Start TPM
      */
-	TPM0->SC |= TPM_SC_CMOD(1);
-	TPM1->SC |= TPM_SC_CMOD(1);
+	for(uint32_t i = 0; i < TPM_AUDIO_COUNT; i++){
+		if(!tpm_audio[i].paused){
+			tpm_audio[i].tpm->SC |= TPM_SC_CMOD(1);
+		}
+	}
+	tpm_started = true;
+}
+
+void tpm_retime(uint32_t clock_hz)
+{
+	for(uint32_t i = 0; i < TPM_AUDIO_COUNT; i++){
+		TPM_Type *tpm = tpm_audio[i].tpm;
+		uint32_t sc = tpm->SC & TPM_SC_DMA_MASK;
+		tpm_rate_t rate;
+
+		/**
+		 * SC[PS] only takes a write with the counter stopped
+		 */
+		tpm->SC = sc;
+
+		/**
+		 * The nearest rate clock_hz gives, which tpm_report measures against the rate
+		 * asked for. Only a rate out of reach stops the TPM
+		 */
+		if(!tpm_solve(clock_hz, tpm_audio[i].rate_hz, &rate)){
+			tpm_audio[i].paused = true;
+			continue;
+		}
+		tpm->CNT = 0;
+		tpm->MOD = TPM_MOD_MOD(rate.mod);
+		tpm->SC = sc | TPM_SC_PS(rate.ps) | (tpm_started ? TPM_SC_CMOD(1) : 0);
+		tpm_audio[i].paused = false;
+	}
+	tpm_clock_hz = clock_hz;
+}
+
+void tpm_report(void)
+{
+	for(uint32_t i = 0; i < TPM_AUDIO_COUNT; i++){
+		TPM_Type *tpm = tpm_audio[i].tpm;
+
+		if(tpm_audio[i].paused){
+			PRINTF("tpm: %s paused, no prescaler and MOD give %u Hz from a %u Hz clock\r\n",
+					tpm_audio[i].name,
+					(unsigned)tpm_audio[i].rate_hz,
+					(unsigned)tpm_clock_hz);
+			continue;
+		}
+		PRINTF("tpm: %s %.3f Hz (%+.0f ppm off %u Hz), PS = %u, MOD = %u, from a %u Hz clock\r\n",
+				tpm_audio[i].name,
+				tpm_overflow_rate_hz(tpm),
+				(tpm_overflow_rate_hz(tpm) / tpm_audio[i].rate_hz - 1.0f) * 1e6f,
+				(unsigned)tpm_audio[i].rate_hz,
+				(unsigned)((tpm->SC & TPM_SC_PS_MASK) >> TPM_SC_PS_SHIFT),
+				(unsigned)(tpm->MOD & TPM_MOD_MOD_MASK),
+				(unsigned)tpm_clock_hz);
+	}
+}
+
+float tpm_overflow_rate_hz(TPM_Type *tpm)
+{
+	uint32_t mod = tpm->MOD & TPM_MOD_MOD_MASK;
+	uint32_t ps = (tpm->SC & TPM_SC_PS_MASK) >> TPM_SC_PS_SHIFT;
+
+	/**
+	 * The counter goes 0 to MOD inclusive
+	 */
+	return ((float)tpm_clock_hz) / ((mod + 1) << ps);
 }
 
 void TPM1_IRQHandler(void)
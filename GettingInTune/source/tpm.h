@@ -8,6 +8,10 @@
 #ifndef TPM_H_
 #define TPM_H_
 
+#include <stdbool.h>
+#include <stdint.h>
+#include "board.h"
+
 /**
  * \def		PWM_FREQ_HZ
  * \brief	The desired frequency of the PWM in Hz
@@ -16,19 +20,65 @@
 	(500)
 
 /**
- * \var		extern uint8_t tpm_sc_ps;
- * \brief	Defined in tpm.c
+ * \def		TPM_CLOCK_HZ
+ * \brief	The frequency of TPM clock in Hz (MCGPLLCLK / 2 in the RUN clock profile), which
+ * 			init_onboard_tpm solves the rates for
+ */
+#define TPM_CLOCK_HZ\
+	(48000000)
+
+/**
+ * \def		TPM_MAX_PS
+ * \brief	Largest SC[PS], a prescaler of 2^7 = 128
+ */
+#define TPM_MAX_PS\
+	(7)
+
+/**
+ * \def		TPM_MAX_COUNTS
+ * \brief	Most counts per overflow: the counter runs 0 to MOD inclusive, and MOD has 16 bits
+ */
+#define TPM_MAX_COUNTS\
+	(65536)
+
+/**
+ * \typedef	typedef struct tpm_rate_s tpm_rate_t
+ * \brief   Easily declare TPM rate settings
+ */
+typedef struct tpm_rate_s tpm_rate_t;
+
+/**
+ * \struct	struct tpm_rate_s
+ * \brief   What tpm_solve found for a rate
+ */
+struct tpm_rate_s{
+	uint32_t mod;		/* For the MOD register */
+	uint32_t ps;		/* For SC[PS], the prescaler is 2^ps */
+	uint32_t divisor;	/* Clocks per overflow, (mod + 1) << ps */
+	float hz;			/* The rate it gives, clock / divisor */
+};
+
+/**
+ * \fn		bool tpm_solve
+ * \param	uint32_t clock_hz TPM clock
+ * \param	uint32_t rate_hz Overflows per second wanted
+ * \param	tpm_rate_t *rate Where to put the settings
+ * \return	true if rate_hz is within the TPM's reach, false if it is 0, above clock_hz
+ * 			or too slow for the largest prescaler and MOD
+ * \brief   Searches every prescaler for the MOD giving the rate nearest rate_hz. Ties go
+ * 			to the smaller prescaler, which keeps the counter's resolution
  */
-extern uint8_t tpm_sc_ps;
+bool tpm_solve(uint32_t clock_hz, uint32_t rate_hz, tpm_rate_t *rate);
 
 /**
  * \fn		void init_onboard_tpm
- * \param	uint32_t dac_period_us
- * \param	uint32_t adc_period_us
+ * \param	uint32_t dac_rate_hz Rate TPM0 triggers DAC transfers at
+ * \param	uint32_t adc_rate_hz Rate TPM1 triggers ADC conversions at
  * \return	N/A
- * \brief   Initialize the on-board timer PWM
+ * \brief   Initialize the on-board timer PWM, as near the rates as tpm_solve gets.
+ * 			tpm_overflow_rate_hz says what they came to
  */
-void init_onboard_tpm(uint32_t dac_period_us, uint32_t adc_period_us);
+void init_onboard_tpm(uint32_t dac_rate_hz, uint32_t adc_rate_hz);
 
 /**
  * \fn		void start_onboard_tpm
@@ -38,6 +88,56 @@ void init_onboard_tpm(uint32_t dac_period_us, uint32_t adc_period_us);
  */
 void start_onboard_tpm(void);
 
+/**
+ * \fn		void tpm_retime
+ * \param	uint32_t clock_hz The TPM clock from now on
+ * \return	N/A
+ * \brief   Reprograms TPM0 and TPM1 for a new TPM clock (see clocks.h), each as near
+ * 			its rate as tpm_solve gets from clock_hz. tpm_report gives the error, and
+ * 			anything timed off TPM1 should use tpm_overflow_rate_hz rather than the
+ * 			nominal rate. A rate out of reach stops the TPM until a later retime. Call
+ * 			with interrupts masked
+ */
+void tpm_retime(uint32_t clock_hz);
+
+/**
+ * \fn		void tpm_report
+ * \param	N/A
+ * \return	N/A
+ * \brief   Prints what TPM0 and TPM1 run at and how far that is from the rate asked
+ * 			for, or why they are paused
+ */
+void tpm_report(void);
+
+/**
+ * \fn		float tpm_overflow_rate_hz
+ * \param	TPM_Type *tpm
+ * \return	Overflows per second with the MOD and prescaler currently programmed, at
+ * 			the current TPM clock
+ * \brief   The rate a TPM actually runs at, including any rounding of MOD
+ */
+float tpm_overflow_rate_hz(TPM_Type *tpm);
+
+/**
+ * \fn		uint32_t tpm_cycles
+ * \param	TPM_Type *tpm
+ * \param	uint32_t from CNT read earlier
+ * \param	uint32_t to CNT read later, less than an overflow period after from
+ * \return	Core cycles from from to to. Every TPM counts on the core clock in both clock
+ * 			profiles (clocks.h), so that is counts times the prescaler
+ * \brief   For timing handlers off the TPM that woke them, see instr.h. Usable from any
+ * 			context
+ */
+static inline uint32_t tpm_cycles(TPM_Type *tpm, uint32_t from, uint32_t to)
+{
+	uint32_t counts = to - from;
+
+	if(to < from){
+		counts += (tpm->MOD & TPM_MOD_MOD_MASK) + 1;
+	}
+	return counts << ((tpm->SC & TPM_SC_PS_MASK) >> TPM_SC_PS_SHIFT);
+}
+
 /**
  * \fn		void TPM1_IRQHandler
  * \param	N/A
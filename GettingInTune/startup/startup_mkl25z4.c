@@ -183,6 +183,16 @@ extern void __main(void);
 #endif
 extern int main(void);
 
+//*****************************************************************************
+// Starts SysTick, which times the boot from here on (see source/boot.h)
+//*****************************************************************************
+extern void init_onboard_systick(void);
+
+//*****************************************************************************
+// Paints the free stack, so its high-water mark can be read back (see source/ram.h)
+//*****************************************************************************
+extern void ram_paint_stack(void);
+
 //*****************************************************************************
 // External declaration for the pointer to the stack top from the Linker Script
 //*****************************************************************************
@@ -260,21 +270,39 @@ void (* const g_pfnVectors[])(void) = {
 // are written as separate functions rather than being inlined within the
 // ResetISR() function in order to cope with MCUs with multiple banks of
 // memory.
+//
+// Both move four words per ldm/stm pair, rather than one word per ldr/str, then
+// finish off any remaining words one at a time. r7 is left alone as it is the
+// frame pointer in unoptimized builds. Variables placed in .noinit are in neither
+// table and are left as they are.
 //*****************************************************************************
 __attribute__ ((section(".after_vectors.init_data")))
 void data_init(unsigned int romstart, unsigned int start, unsigned int len) {
 	unsigned int *pulDest = (unsigned int*) start;
 	unsigned int *pulSrc = (unsigned int*) romstart;
-	unsigned int loop;
-	for (loop = 0; loop < len; loop = loop + 4)
+	for (; len >= 16; len -= 16)
+		__asm volatile ("ldmia %0!, {r3, r4, r5, r6}\n\t"
+				"stmia %1!, {r3, r4, r5, r6}"
+				: "+l" (pulSrc), "+l" (pulDest)
+				:
+				: "r3", "r4", "r5", "r6", "memory");
+	for (; len >= 4; len -= 4)
 		*pulDest++ = *pulSrc++;
 }
 
 __attribute__ ((section(".after_vectors.init_bss")))
 void bss_init(unsigned int start, unsigned int len) {
 	unsigned int *pulDest = (unsigned int*) start;
-	unsigned int loop;
-	for (loop = 0; loop < len; loop = loop + 4)
+	register unsigned int zero0 __asm ("r3") = 0;
+	register unsigned int zero1 __asm ("r4") = 0;
+	register unsigned int zero2 __asm ("r5") = 0;
+	register unsigned int zero3 __asm ("r6") = 0;
+	for (; len >= 16; len -= 16)
+		__asm volatile ("stmia %0!, {%1, %2, %3, %4}"
+				: "+l" (pulDest)
+				: "l" (zero0), "l" (zero1), "l" (zero2), "l" (zero3)
+				: "memory");
+	for (; len >= 4; len -= 4)
 		*pulDest++ = 0;
 }
 
@@ -310,6 +338,10 @@ void ResetISR(void) {
     *((volatile unsigned int *)0x40048100) = 0x00u;
 #endif // (__USE_CMSIS)
 
+    // Start SysTick so the rest of startup is timed. It only touches registers,
+    // so it can run before .data and .bss are set up
+    init_onboard_systick();
+
     //
     // Copy the data sections from flash to SRAM.
     //
@@ -335,6 +367,9 @@ void ResetISR(void) {
 		bss_init(ExeAddr, SectionLen);
 	}
 
+	// Paint the stack below this frame. After .bss, which holds whether it has been
+	ram_paint_stack();
+
 #if !defined (__USE_CMSIS)
 // Assume that if __USE_CMSIS defined, then CMSIS SystemInit code
 // will setup the VTOR register
@@ -60,6 +60,7 @@
 
 #include <stdarg.h>
 #include <stdlib.h>
+#include <string.h>
 #if defined(__CC_ARM)
 #include <stdio.h>
 #endif
@@ -165,6 +166,48 @@ typedef struct DebugConsoleState
     debug_console_ops_t ops; /*!< Operation function pointers for debug UART operations. */
 } debug_console_state_t;
 
+#if (DEBUG_CONSOLE_TRANSMIT_BUFFER_LEN > 0U) && defined(FSL_FEATURE_SOC_LPSCI_COUNT) && (FSL_FEATURE_SOC_LPSCI_COUNT > 0)
+#define DEBUG_CONSOLE_TX_BUFFERED 1U
+#else
+#define DEBUG_CONSOLE_TX_BUFFERED 0U
+#endif
+
+#if DEBUG_CONSOLE_TX_BUFFERED
+#if (DEBUG_CONSOLE_TRANSMIT_BUFFER_LEN & (DEBUG_CONSOLE_TRANSMIT_BUFFER_LEN - 1U))
+#error "DEBUG_CONSOLE_TRANSMIT_BUFFER_LEN must be a power of 2"
+#endif
+
+/*! @brief Transmit ring buffer. head and tail run freely and are masked on access; head is only
+ *  written by the writer and tail only by whoever sends, so neither needs a critical section. */
+typedef struct DebugConsoleTxRing
+{
+    uint8_t data[DEBUG_CONSOLE_TRANSMIT_BUFFER_LEN]; /*!< Queued characters. */
+    volatile uint32_t head;                          /*!< Count of characters ever queued. */
+    volatile uint32_t tail;                          /*!< Count of characters ever sent. */
+} debug_console_tx_ring_t;
+#endif /* DEBUG_CONSOLE_TX_BUFFERED */
+
+#if (DEBUG_CONSOLE_RECEIVE_BUFFER_LEN > 0U) && defined(FSL_FEATURE_SOC_LPSCI_COUNT) && (FSL_FEATURE_SOC_LPSCI_COUNT > 0)
+#define DEBUG_CONSOLE_RX_BUFFERED 1U
+#else
+#define DEBUG_CONSOLE_RX_BUFFERED 0U
+#endif
+
+#if DEBUG_CONSOLE_RX_BUFFERED
+#if (DEBUG_CONSOLE_RECEIVE_BUFFER_LEN & (DEBUG_CONSOLE_RECEIVE_BUFFER_LEN - 1U))
+#error "DEBUG_CONSOLE_RECEIVE_BUFFER_LEN must be a power of 2"
+#endif
+
+/*! @brief Receive ring buffer. head is only written by the receive interrupt and tail only by the
+ *  reader, as for the transmit ring buffer. */
+typedef struct DebugConsoleRxRing
+{
+    uint8_t data[DEBUG_CONSOLE_RECEIVE_BUFFER_LEN]; /*!< Received characters. */
+    volatile uint32_t head;                         /*!< Count of characters ever received. */
+    volatile uint32_t tail;                         /*!< Count of characters ever read. */
+} debug_console_rx_ring_t;
+#endif /* DEBUG_CONSOLE_RX_BUFFERED */
+
 /*! @brief Type of KSDK printf function pointer. */
 typedef int (*PUTCHAR_FUNC)(int a);
 
@@ -213,6 +256,19 @@ enum _debugconsole_scanf_flag
 /*! @brief Debug UART state information. */
 static debug_console_state_t s_debugConsole = {.type = DEBUG_CONSOLE_DEVICE_TYPE_NONE, .base = NULL, .ops = {{0}, {0}}};
 
+#if DEBUG_CONSOLE_TX_BUFFERED
+/*! @brief Debug UART transmit ring buffer and its counters. */
+static debug_console_tx_ring_t s_debugConsoleTx;
+static debug_console_tx_stats_t s_debugConsoleTxStats;
+/*! @brief Set while the transmitter is lent out, see DbgConsole_TxAcquire. */
+static volatile bool s_debugConsoleTxLent;
+#endif /* DEBUG_CONSOLE_TX_BUFFERED */
+
+#if DEBUG_CONSOLE_RX_BUFFERED
+/*! @brief Debug UART receive ring buffer. */
+static debug_console_rx_ring_t s_debugConsoleRx;
+#endif /* DEBUG_CONSOLE_RX_BUFFERED */
+
 /*******************************************************************************
  * Prototypes
  ******************************************************************************/
@@ -226,6 +282,242 @@ double modf(double input_dbl, double *intpart_ptr);
  * Code
  ******************************************************************************/
 
+/*************Code for the buffered LPSCI transmitter and receiver*******************************/
+
+#if DEBUG_CONSOLE_TX_BUFFERED || DEBUG_CONSOLE_RX_BUFFERED
+/*!
+ * @brief Tells whether the LPSCI interrupt can run while the caller waits.
+ *
+ * It cannot with interrupts masked, nor from inside a handler: the LPSCI interrupt has the
+ * lowest priority, so it never preempts one.
+ *
+ * @return true to wait for the LPSCI interrupt, false to poll instead.
+ */
+static bool DbgConsole_CanWait(void)
+{
+    if (SCB->ICSR & SCB_ICSR_VECTACTIVE_Msk)
+    {
+        return false;
+    }
+#if !defined(HOST_SIM) /* PRIMASK is not simulated on the host. */
+    if (__get_PRIMASK())
+    {
+        return false;
+    }
+#endif /* HOST_SIM */
+    return true;
+}
+#endif /* DEBUG_CONSOLE_TX_BUFFERED || DEBUG_CONSOLE_RX_BUFFERED */
+
+#if DEBUG_CONSOLE_TX_BUFFERED
+/*!
+ * @brief Sends the oldest queued character by polling.
+ *
+ * Only call this when the transmit interrupt cannot run, see DbgConsole_CanWait.
+ *
+ * @param base LPSCI peripheral base address.
+ */
+static void DbgConsole_TxPollOne(UART0_Type *base)
+{
+    uint32_t tail = s_debugConsoleTx.tail;
+
+    while (!(base->S1 & UART0_S1_TDRE_MASK))
+    {
+    }
+    base->D = s_debugConsoleTx.data[tail & (DEBUG_CONSOLE_TRANSMIT_BUFFER_LEN - 1U)];
+    s_debugConsoleTx.tail = tail + 1U;
+}
+
+/*!
+ * @brief Queues characters for the LPSCI transmit interrupt. Replaces LPSCI_WriteBlocking.
+ *
+ * Only one context may write at a time: printing from main and from a handler concurrently
+ * would interleave on head.
+ *
+ * @param base LPSCI peripheral base address.
+ * @param buffer Characters to send.
+ * @param length Number of characters to send.
+ */
+static void DbgConsole_LpsciWriteBuffered(UART0_Type *base, const uint8_t *buffer, size_t length)
+{
+    uint32_t head = s_debugConsoleTx.head;
+    uint32_t used;
+    bool blocked = false;
+
+    while (length)
+    {
+        if ((head - s_debugConsoleTx.tail) >= DEBUG_CONSOLE_TRANSMIT_BUFFER_LEN)
+        {
+#if (DEBUG_CONSOLE_TX_POLICY == DEBUG_CONSOLE_TX_POLICY_DROP)
+            s_debugConsoleTxStats.dropped += length;
+            break;
+#else
+            if (!blocked)
+            {
+                blocked = true;
+                s_debugConsoleTxStats.blocked++;
+            }
+            /* Publish what is queued so far, then let the transmitter make room. */
+            s_debugConsoleTx.head = head;
+            if (DbgConsole_CanWait())
+            {
+                if (!s_debugConsoleTxLent)
+                {
+                    base->C2 |= UART0_C2_TIE_MASK;
+                }
+                while ((head - s_debugConsoleTx.tail) >= DEBUG_CONSOLE_TRANSMIT_BUFFER_LEN)
+                {
+                }
+            }
+            else if (!s_debugConsoleTxLent)
+            {
+                DbgConsole_TxPollOne(base);
+            }
+            else
+            {
+                /* Polling would write over the other sender. */
+                s_debugConsoleTxStats.dropped += length;
+                break;
+            }
+#endif /* DEBUG_CONSOLE_TX_POLICY */
+        }
+        s_debugConsoleTx.data[head & (DEBUG_CONSOLE_TRANSMIT_BUFFER_LEN - 1U)] = *buffer++;
+        head++;
+        length--;
+        s_debugConsoleTxStats.queued++;
+    }
+    s_debugConsoleTx.head = head;
+
+    used = head - s_debugConsoleTx.tail;
+    if (used > s_debugConsoleTxStats.highWater)
+    {
+        s_debugConsoleTxStats.highWater = used;
+    }
+
+    /* TDRE is set whenever the transmitter has room, so this raises the interrupt at once. head is
+     * published first: a sender taking the transmitter from an interrupt sees it and backs off. */
+    if (!s_debugConsoleTxLent)
+    {
+        base->C2 |= UART0_C2_TIE_MASK;
+    }
+}
+
+#endif /* DEBUG_CONSOLE_TX_BUFFERED */
+
+#if DEBUG_CONSOLE_RX_BUFFERED
+/*!
+ * @brief Moves the character in the receiver, if any, into the receive ring buffer.
+ *
+ * The receiver holds a single character, so this runs once per receive interrupt. A character
+ * that does not fit is dropped. Error flags are cleared so that reception carries on.
+ *
+ * @param base LPSCI peripheral base address.
+ */
+static void DbgConsole_LpsciReceive(UART0_Type *base)
+{
+    uint8_t status = base->S1;
+    uint32_t head = s_debugConsoleRx.head;
+
+    if (status & UART0_S1_RDRF_MASK)
+    {
+        uint8_t ch = base->D;
+
+        if ((head - s_debugConsoleRx.tail) < DEBUG_CONSOLE_RECEIVE_BUFFER_LEN)
+        {
+            s_debugConsoleRx.data[head & (DEBUG_CONSOLE_RECEIVE_BUFFER_LEN - 1U)] = ch;
+            s_debugConsoleRx.head = head + 1U;
+        }
+    }
+    status &= (UART0_S1_OR_MASK | UART0_S1_NF_MASK | UART0_S1_FE_MASK | UART0_S1_PF_MASK);
+    if (status)
+    {
+        base->S1 = status;
+    }
+}
+
+/*!
+ * @brief Takes the oldest character from the receive ring buffer.
+ *
+ * @param ch Filled in with the character.
+ * @return true if there was one.
+ */
+static bool DbgConsole_RxPop(uint8_t *ch)
+{
+    uint32_t tail = s_debugConsoleRx.tail;
+
+    if (tail == s_debugConsoleRx.head)
+    {
+        return false;
+    }
+    *ch = s_debugConsoleRx.data[tail & (DEBUG_CONSOLE_RECEIVE_BUFFER_LEN - 1U)];
+    s_debugConsoleRx.tail = tail + 1U;
+    return true;
+}
+
+/*!
+ * @brief Reads characters from the receive ring buffer, waiting for them. Replaces LPSCI_ReadBlocking.
+ *
+ * @param base LPSCI peripheral base address.
+ * @param buffer Filled in with the characters.
+ * @param length Number of characters to read.
+ * @return kStatus_Success, or kStatus_Fail if the ring buffer ran dry where the receive interrupt
+ *         cannot run (see DbgConsole_CanWait).
+ */
+static status_t DbgConsole_LpsciReadBuffered(UART0_Type *base, uint8_t *buffer, size_t length)
+{
+    (void)base;
+
+    while (length--)
+    {
+        while (!DbgConsole_RxPop(buffer))
+        {
+            if (!DbgConsole_CanWait())
+            {
+                return kStatus_Fail;
+            }
+        }
+        buffer++;
+    }
+    return kStatus_Success;
+}
+#endif /* DEBUG_CONSOLE_RX_BUFFERED */
+
+#if DEBUG_CONSOLE_TX_BUFFERED || DEBUG_CONSOLE_RX_BUFFERED
+/*!
+ * @brief LPSCI interrupt: stores the received character and moves queued characters into the
+ * transmitter.
+ *
+ * The transmit interrupt is only enabled while characters are queued. While the transmitter is
+ * lent out (see DbgConsole_TxAcquire) the other sender owns the data register and TIE.
+ */
+void UART0_IRQHandler(void)
+{
+#if DEBUG_CONSOLE_RX_BUFFERED
+    DbgConsole_LpsciReceive(UART0);
+#endif /* DEBUG_CONSOLE_RX_BUFFERED */
+#if DEBUG_CONSOLE_TX_BUFFERED
+    uint32_t tail = s_debugConsoleTx.tail;
+
+    if (s_debugConsoleTxLent)
+    {
+        return;
+    }
+
+    while ((tail != s_debugConsoleTx.head) && (UART0->S1 & UART0_S1_TDRE_MASK))
+    {
+        UART0->D = s_debugConsoleTx.data[tail & (DEBUG_CONSOLE_TRANSMIT_BUFFER_LEN - 1U)];
+        tail++;
+    }
+    s_debugConsoleTx.tail = tail;
+
+    if (tail == s_debugConsoleTx.head)
+    {
+        UART0->C2 &= ~UART0_C2_TIE_MASK;
+    }
+#endif /* DEBUG_CONSOLE_TX_BUFFERED */
+}
+#endif /* DEBUG_CONSOLE_TX_BUFFERED || DEBUG_CONSOLE_RX_BUFFERED */
+
 /*************Code for DbgConsole Init, Deinit, Printf, Scanf *******************************/
 
 /* See fsl_debug_console.h for documentation of this function. */
@@ -273,8 +565,27 @@ status_t DbgConsole_Init(uint32_t baseAddr, uint32_t baudRate, uint8_t device, u
             LPSCI_EnableTx(s_debugConsole.base, true);
             LPSCI_EnableRx(s_debugConsole.base, true);
             /* Set the function pointer for send and receive for this kind of device. */
+#if DEBUG_CONSOLE_TX_BUFFERED
+            s_debugConsoleTx.head = 0U;
+            s_debugConsoleTx.tail = 0U;
+            s_debugConsoleTxLent = false;
+            memset(&s_debugConsoleTxStats, 0, sizeof(s_debugConsoleTxStats));
+            s_debugConsole.ops.tx_union.LPSCI_PutChar = DbgConsole_LpsciWriteBuffered;
+#else
             s_debugConsole.ops.tx_union.LPSCI_PutChar = LPSCI_WriteBlocking;
+#endif /* DEBUG_CONSOLE_TX_BUFFERED */
+#if DEBUG_CONSOLE_RX_BUFFERED
+            s_debugConsoleRx.head = 0U;
+            s_debugConsoleRx.tail = 0U;
+            LPSCI_EnableInterrupts(s_debugConsole.base, kLPSCI_RxDataRegFullInterruptEnable);
+            s_debugConsole.ops.rx_union.LPSCI_GetChar = DbgConsole_LpsciReadBuffered;
+#else
             s_debugConsole.ops.rx_union.LPSCI_GetChar = LPSCI_ReadBlocking;
+#endif /* DEBUG_CONSOLE_RX_BUFFERED */
+#if DEBUG_CONSOLE_TX_BUFFERED || DEBUG_CONSOLE_RX_BUFFERED
+            NVIC_SetPriority(UART0_IRQn, DEBUG_CONSOLE_IRQ_PRIORITY);
+            EnableIRQ(UART0_IRQn);
+#endif /* DEBUG_CONSOLE_TX_BUFFERED || DEBUG_CONSOLE_RX_BUFFERED */
         }
         break;
 #endif /* FSL_FEATURE_SOC_LPSCI_COUNT */
@@ -350,6 +661,11 @@ status_t DbgConsole_Deinit(void)
 #endif /* FSL_FEATURE_SOC_UART_COUNT */
 #if defined(FSL_FEATURE_SOC_LPSCI_COUNT) && (FSL_FEATURE_SOC_LPSCI_COUNT > 0)
         case DEBUG_CONSOLE_DEVICE_TYPE_LPSCI:
+#if DEBUG_CONSOLE_TX_BUFFERED || DEBUG_CONSOLE_RX_BUFFERED
+            /* Let queued output out before the module goes away. */
+            DbgConsole_Flush();
+            DisableIRQ(UART0_IRQn);
+#endif /* DEBUG_CONSOLE_TX_BUFFERED || DEBUG_CONSOLE_RX_BUFFERED */
             /* Disable LPSCI module. */
             LPSCI_Deinit(s_debugConsole.base);
             break;
@@ -388,6 +704,109 @@ status_t DbgConsole_Deinit(void)
     return kStatus_Success;
 }
 
+/* See fsl_debug_console.h for documentation of this function. */
+status_t DbgConsole_Flush(void)
+{
+    /* Do nothing if the debug UART is not initialized. */
+    if (s_debugConsole.type == DEBUG_CONSOLE_DEVICE_TYPE_NONE)
+    {
+        return kStatus_Fail;
+    }
+
+#if DEBUG_CONSOLE_TX_BUFFERED
+    if (s_debugConsole.type == DEBUG_CONSOLE_DEVICE_TYPE_LPSCI)
+    {
+        UART0_Type *base = (UART0_Type *)s_debugConsole.base;
+
+        while (s_debugConsoleTx.tail != s_debugConsoleTx.head)
+        {
+            if (!DbgConsole_CanWait())
+            {
+                if (s_debugConsoleTxLent)
+                {
+                    return kStatus_Fail;
+                }
+                DbgConsole_TxPollOne(base);
+            }
+        }
+        while (!(base->S1 & UART0_S1_TC_MASK))
+        {
+        }
+    }
+#endif /* DEBUG_CONSOLE_TX_BUFFERED */
+
+    return kStatus_Success;
+}
+
+/* See fsl_debug_console.h for documentation of this function. */
+void DbgConsole_GetTxStats(debug_console_tx_stats_t *stats)
+{
+#if DEBUG_CONSOLE_TX_BUFFERED
+    *stats = s_debugConsoleTxStats;
+#else
+    memset(stats, 0, sizeof(*stats));
+#endif /* DEBUG_CONSOLE_TX_BUFFERED */
+}
+
+/* See fsl_debug_console.h for documentation of this function. */
+bool DbgConsole_TxAcquire(void)
+{
+#if DEBUG_CONSOLE_TX_BUFFERED
+    if (s_debugConsoleTxLent || (s_debugConsoleTx.tail != s_debugConsoleTx.head))
+    {
+        return false;
+    }
+    s_debugConsoleTxLent = true;
+#endif /* DEBUG_CONSOLE_TX_BUFFERED */
+    return true;
+}
+
+/* See fsl_debug_console.h for documentation of this function. */
+void DbgConsole_TxRelease(void)
+{
+#if DEBUG_CONSOLE_TX_BUFFERED
+    s_debugConsoleTxLent = false;
+    if ((s_debugConsole.type == DEBUG_CONSOLE_DEVICE_TYPE_LPSCI) &&
+        (s_debugConsoleTx.tail != s_debugConsoleTx.head))
+    {
+        ((UART0_Type *)s_debugConsole.base)->C2 |= UART0_C2_TIE_MASK;
+    }
+#endif /* DEBUG_CONSOLE_TX_BUFFERED */
+}
+
+/* See fsl_debug_console.h for documentation of this function. */
+bool DbgConsole_TxPending(void)
+{
+#if DEBUG_CONSOLE_TX_BUFFERED
+    return (s_debugConsoleTx.tail != s_debugConsoleTx.head);
+#else
+    return false;
+#endif /* DEBUG_CONSOLE_TX_BUFFERED */
+}
+
+/* See fsl_debug_console.h for documentation of this function. */
+status_t DbgConsole_TryGetchar(char *ch)
+{
+#if defined(FSL_FEATURE_SOC_LPSCI_COUNT) && (FSL_FEATURE_SOC_LPSCI_COUNT > 0)
+    if (s_debugConsole.type == DEBUG_CONSOLE_DEVICE_TYPE_LPSCI)
+    {
+#if DEBUG_CONSOLE_RX_BUFFERED
+        return DbgConsole_RxPop((uint8_t *)ch) ? kStatus_Success : kStatus_Fail;
+#else
+        UART0_Type *base = (UART0_Type *)s_debugConsole.base;
+
+        if (base->S1 & UART0_S1_RDRF_MASK)
+        {
+            *ch = (char)base->D;
+            return kStatus_Success;
+        }
+#endif /* DEBUG_CONSOLE_RX_BUFFERED */
+    }
+#endif /* FSL_FEATURE_SOC_LPSCI_COUNT */
+    (void)ch;
+    return kStatus_Fail;
+}
+
 #if SDK_DEBUGCONSOLE
 /* See fsl_debug_console.h for documentation of this function. */
 int DbgConsole_Printf(const char *fmt_s, ...)
@@ -473,7 +892,7 @@ int DbgConsole_Scanf(char *fmt_ptr, ...)
 /* See fsl_debug_console.h for documentation of this function. */
 int DbgConsole_Getchar(void)
 {
-    char ch;
+    char ch = 0;
     /* Do nothing if the debug UART is not initialized. */
     if (s_debugConsole.type == DEBUG_CONSOLE_DEVICE_TYPE_NONE)
     {
@@ -760,6 +1179,94 @@ static int32_t DbgConsole_ConvertFloatRadixNumToString(char *numstr,
 }
 #endif /* PRINTF_FLOAT_ENABLE */
 
+#if PRINTF_FIXED_ENABLE
+/*!
+ * @brief Converts a Q-format fixed point number to a decimal string and return its length.
+ *
+ * Only integer arithmetic is used. The sign is part of the string.
+ *
+ * @param[in] numstr            Converted string of the number.
+ * @param[in] value             The fixed point number.
+ * @param[in] frac_bits         Number of fractional bits in value, at most 28.
+ * @param[in] precision_width   Number of decimals, at most 9.
+
+ * @return Length of the converted string.
+ */
+static int32_t DbgConsole_ConvertFixedRadixNumToString(char *numstr,
+                                                       int32_t value,
+                                                       uint32_t frac_bits,
+                                                       uint32_t precision_width)
+{
+    uint32_t magnitude;
+    uint32_t intpart;
+    uint32_t fractpart;
+    uint32_t mask;
+    uint32_t scale = 1U;
+    uint32_t decimals = 0U;
+    uint32_t i;
+    int32_t nlen;
+    char *nstrp;
+
+    if (frac_bits > 28U)
+    {
+        frac_bits = 28U;
+    }
+    if (precision_width > 9U)
+    {
+        precision_width = 9U;
+    }
+    mask = (1U << frac_bits) - 1U;
+    magnitude = (value < 0) ? (0U - (uint32_t)value) : (uint32_t)value;
+    intpart = magnitude >> frac_bits;
+    fractpart = magnitude & mask;
+
+    /* Decimals, rounded half up: fractpart * 10 stays below 2^32 because frac_bits <= 28. */
+    for (i = 0U; i < precision_width; i++)
+    {
+        fractpart *= 10U;
+        decimals = (decimals * 10U) + (fractpart >> frac_bits);
+        fractpart &= mask;
+        scale *= 10U;
+    }
+    if ((frac_bits > 0U) && ((fractpart * 2U) > mask))
+    {
+        if (++decimals == scale)
+        {
+            decimals = 0U;
+            intpart++;
+        }
+    }
+
+    /* Build the string in reverse order, like DbgConsole_ConvertRadixNumToString. */
+    nlen = 0;
+    nstrp = numstr;
+    *nstrp++ = '\0';
+    for (i = 0U; i < precision_width; i++)
+    {
+        *nstrp++ = (char)('0' + (decimals % 10U));
+        decimals /= 10U;
+        ++nlen;
+    }
+    if (precision_width > 0U)
+    {
+        *nstrp++ = '.';
+        ++nlen;
+    }
+    do
+    {
+        *nstrp++ = (char)('0' + (intpart % 10U));
+        intpart /= 10U;
+        ++nlen;
+    } while (intpart != 0U);
+    if (value < 0)
+    {
+        *nstrp++ = '-';
+        ++nlen;
+    }
+    return nlen;
+}
+#endif /* PRINTF_FIXED_ENABLE */
+
 /*!
  * @brief This function outputs its parameters according to a formatted string.
  *
@@ -959,7 +1466,7 @@ static int DbgConsole_PrintfFormattedData(PUTCHAR_FUNC func_ptr, const char *fmt
         c = *++p;
         {
             if ((c == 'd') || (c == 'i') || (c == 'f') || (c == 'F') || (c == 'x') || (c == 'X') || (c == 'o') ||
-                (c == 'b') || (c == 'p') || (c == 'u'))
+                (c == 'b') || (c == 'p') || (c == 'u') || (c == 'q'))
             {
                 if ((c == 'd') || (c == 'i'))
                 {
@@ -1102,7 +1609,39 @@ static int DbgConsole_PrintfFormattedData(PUTCHAR_FUNC func_ptr, const char *fmt
                     }
 #endif /* PRINTF_ADVANCED_ENABLE */
                 }
+#else
+                if ((c == 'f') || (c == 'F'))
+                {
+                    /* Not in this formatter profile: consume the argument and print nothing. */
+                    (void)va_arg(ap, double);
+                    vstrp = NULL;
+                    vlen = 0;
+                }
 #endif /* PRINTF_FLOAT_ENABLE */
+#if PRINTF_FIXED_ENABLE
+                if (c == 'q')
+                {
+                    uval = (uint32_t)va_arg(ap, uint32_t);
+                    ival = (int32_t)va_arg(ap, int32_t);
+                    vlen = DbgConsole_ConvertFixedRadixNumToString(vstr, (int32_t)ival, (uint32_t)uval, precision_width);
+                    vstrp = &vstr[vlen];
+#if PRINTF_ADVANCED_ENABLE
+                    if (!(flags_used & kPRINTF_Minus))
+                    {
+                        DbgConsole_PrintfPaddingCharacter(' ', vlen, field_width, &count, func_ptr);
+                    }
+#endif /* PRINTF_ADVANCED_ENABLE */
+                }
+#else
+                if (c == 'q')
+                {
+                    /* Not in this formatter profile: consume the arguments and print nothing. */
+                    (void)va_arg(ap, uint32_t);
+                    (void)va_arg(ap, int32_t);
+                    vstrp = NULL;
+                    vlen = 0;
+                }
+#endif /* PRINTF_FIXED_ENABLE */
                 if ((c == 'X') || (c == 'x'))
                 {
                     if (c == 'x')
@@ -1819,7 +2358,9 @@ size_t __read(int handle, unsigned char *buffer, size_t size)
 /* support LPC Xpresso with RedLib */
 #elif(defined(__REDLIB__))
 
-#if (!SDK_DEBUGCONSOLE) && (defined(SDK_DEBUGCONSOLE_UART))
+/* Kept with SDK_DEBUGCONSOLE too: PRINTF formats here, but stdio writes (fwrite, putchar) still
+ * reach the same UART through these. */
+#if defined(SDK_DEBUGCONSOLE_UART)
 int __attribute__((weak)) __sys_write(int handle, char *buffer, int size)
 {
     if (buffer == 0)
@@ -1864,7 +2405,7 @@ int __attribute__((weak)) __sys_readc(void)
 #elif(defined(__GNUC__))
 
 #if ((defined(__GNUC__) && (!defined(__MCUXPRESSO))) || \
-     (defined(__MCUXPRESSO) && (!SDK_DEBUGCONSOLE) && (defined(SDK_DEBUGCONSOLE_UART))))
+     (defined(__MCUXPRESSO) && (defined(SDK_DEBUGCONSOLE_UART))))
 
 int __attribute__((weak)) _write(int handle, char *buffer, int size)
 {
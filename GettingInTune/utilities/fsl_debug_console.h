@@ -64,10 +64,34 @@
 #include <stdio.h>
 #endif
 
-/*! @brief Definition to printf the float number. */
-#ifndef PRINTF_FLOAT_ENABLE
-#define PRINTF_FLOAT_ENABLE 0U
+/*! @brief Formatter profiles for printf. Each one adds conversions to the previous; the code for
+ *  conversions a profile leaves out is not compiled, so it does not reach the binary. */
+#define PRINTF_PROFILE_INTEGER 0U /*!< %d %i %u %o %x %X %b %p %c %s only, no floating point code. */
+#define PRINTF_PROFILE_FIXED 1U   /*!< Adds %q for Q-format fixed point, still no floating point code. */
+#define PRINTF_PROFILE_FULL 2U    /*!< Adds %f through double arithmetic, modf and pow. */
+/* Conversions outside the selected profile consume their arguments and print nothing. */
+
+/*! @brief Definition to select the printf formatter profile. Defaults to the profile matching
+ *  PRINTF_FLOAT_ENABLE, which it then overrides. */
+#ifndef PRINTF_PROFILE
+#if defined(PRINTF_FLOAT_ENABLE) && (PRINTF_FLOAT_ENABLE)
+#define PRINTF_PROFILE PRINTF_PROFILE_FULL
+#else
+#define PRINTF_PROFILE PRINTF_PROFILE_INTEGER
 #endif /* PRINTF_FLOAT_ENABLE */
+#endif /* PRINTF_PROFILE */
+
+/*! @brief Definition to printf the float number. */
+#undef PRINTF_FLOAT_ENABLE
+#define PRINTF_FLOAT_ENABLE (PRINTF_PROFILE >= PRINTF_PROFILE_FULL)
+
+/*! @brief Definition to printf Q-format fixed point numbers with %q.
+ *
+ *  %q takes two arguments: the number of fractional bits (0 to 28), then the int32_t value.
+ *  Precision is the number of decimals, 6 by default and at most 9. For example
+ *  PRINTF("%.4q", 15, 0x4000) prints 0.5000.
+ */
+#define PRINTF_FIXED_ENABLE (PRINTF_PROFILE >= PRINTF_PROFILE_FIXED)
 
 /*! @brief Definition to scanf the float number. */
 #ifndef SCANF_FLOAT_ENABLE
@@ -84,6 +108,35 @@
 #define SCANF_ADVANCED_ENABLE 0U
 #endif /* SCANF_ADVANCED_ENABLE */
 
+/*! @brief Size of the transmit ring buffer in bytes, a power of 2. Output is queued here and the
+ *  LPSCI transmit interrupt drains it, so a printf costs formatting time instead of character
+ *  times. 0 keeps the blocking writes. Only the LPSCI device is buffered. */
+#ifndef DEBUG_CONSOLE_TRANSMIT_BUFFER_LEN
+#define DEBUG_CONSOLE_TRANSMIT_BUFFER_LEN 512U
+#endif /* DEBUG_CONSOLE_TRANSMIT_BUFFER_LEN */
+
+/*! @brief Transmit ring buffer full policies. */
+#define DEBUG_CONSOLE_TX_POLICY_DROP 0U  /*!< Discard what does not fit and count it. */
+#define DEBUG_CONSOLE_TX_POLICY_BLOCK 1U /*!< Wait until the transmit interrupt makes room. */
+
+/*! @brief What a write does when the transmit ring buffer is full. */
+#ifndef DEBUG_CONSOLE_TX_POLICY
+#define DEBUG_CONSOLE_TX_POLICY DEBUG_CONSOLE_TX_POLICY_BLOCK
+#endif /* DEBUG_CONSOLE_TX_POLICY */
+
+/*! @brief NVIC priority of the LPSCI interrupt. It must stay the lowest (3 on the Cortex-M0+)
+ *  so that it never preempts another handler, see DbgConsole_Flush. */
+#ifndef DEBUG_CONSOLE_IRQ_PRIORITY
+#define DEBUG_CONSOLE_IRQ_PRIORITY 3U
+#endif /* DEBUG_CONSOLE_IRQ_PRIORITY */
+
+/*! @brief Size of the receive ring buffer in bytes, a power of 2. The LPSCI receive interrupt fills
+ *  it, so DbgConsole_TryGetchar can look for input without waiting. Characters that arrive while it
+ *  is full are dropped. 0 keeps the blocking reads. Only the LPSCI device is buffered. */
+#ifndef DEBUG_CONSOLE_RECEIVE_BUFFER_LEN
+#define DEBUG_CONSOLE_RECEIVE_BUFFER_LEN 64U
+#endif /* DEBUG_CONSOLE_RECEIVE_BUFFER_LEN */
+
 #if SDK_DEBUGCONSOLE /* Select printf, scanf, putchar, getchar of SDK version. */
 #define PRINTF DbgConsole_Printf
 #define SCANF DbgConsole_Scanf
@@ -96,6 +149,15 @@
 #define GETCHAR getchar
 #endif /* SDK_DEBUGCONSOLE */
 
+/*! @brief Transmit ring buffer counters. */
+typedef struct _debug_console_tx_stats
+{
+    uint32_t queued;    /*!< Characters accepted into the ring buffer. */
+    uint32_t dropped;   /*!< Characters discarded because the ring buffer was full. */
+    uint32_t blocked;   /*!< Writes that found the ring buffer full and had to wait. */
+    uint32_t highWater; /*!< Most characters ever waiting in the ring buffer. */
+} debug_console_tx_stats_t;
+
 /*******************************************************************************
  * Prototypes
  ******************************************************************************/
@@ -140,6 +202,66 @@ status_t DbgConsole_Init(uint32_t baseAddr, uint32_t baudRate, uint8_t device, u
  */
 status_t DbgConsole_Deinit(void);
 
+/*!
+ * @brief Waits until all queued output has left the transmitter.
+ *
+ * Call this function before anything that stops or retimes the UART clock (low power modes,
+ * clock changes) and before a reset. Outside of an interrupt handler and with interrupts enabled
+ * it waits for the transmit interrupt; otherwise it sends the queued characters by polling.
+ *
+ * @return Indicates whether the flush was successful or not.
+ * @retval kStatus_Success  Nothing left to send
+ * @retval kStatus_Fail     The debug console is not initialized, or it cannot wait while its
+ *                          transmitter is lent out (see DbgConsole_TxAcquire)
+ */
+status_t DbgConsole_Flush(void);
+
+/*!
+ * @brief Reads the transmit ring buffer counters.
+ *
+ * All counters read 0 when the transmit ring buffer is disabled.
+ *
+ * @param stats Filled in with the counters since DbgConsole_Init.
+ */
+void DbgConsole_GetTxStats(debug_console_tx_stats_t *stats);
+
+/*!
+ * @brief Lends the transmitter to another sender, such as a DMA stream, if no output is queued.
+ *
+ * While lent, output is queued but not sent, and a write that cannot wait for room is dropped.
+ * With the transmit ring buffer disabled writes go out at once, so the caller has to keep them
+ * apart from its own.
+ *
+ * @return true if the caller now owns the transmitter, false if queued output has to go first.
+ */
+bool DbgConsole_TxAcquire(void);
+
+/*!
+ * @brief Gives the transmitter back after DbgConsole_TxAcquire. Queued output resumes.
+ */
+void DbgConsole_TxRelease(void);
+
+/*!
+ * @brief Tells whether output is queued, so a sender holding the transmitter can make way for it.
+ *
+ * @return true if characters are waiting to be sent.
+ */
+bool DbgConsole_TxPending(void);
+
+/*!
+ * @brief Takes one received character if there is one, without waiting.
+ *
+ * Lets a main loop read commands between its other work. With the receive ring buffer disabled
+ * it checks the receiver directly, so characters that arrive while nobody looks are lost. Only the
+ * LPSCI device is supported; other devices never report input.
+ *
+ * @param ch Filled in with the character.
+ * @return Indicates whether a character was taken or not.
+ * @retval kStatus_Success  ch holds the oldest character received
+ * @retval kStatus_Fail     Nothing was received, or the debug console is not initialized
+ */
+status_t DbgConsole_TryGetchar(char *ch);
+
 #if SDK_DEBUGCONSOLE
 /*!
  * @brief Writes formatted output to the standard output stream.